@@ -76,6 +76,18 @@ static constexpr const uint MAX_PATCHBAY_PLUGINS = 255;
  */
 static constexpr const uint MAX_DEFAULT_PARAMETERS = 200;
 
+/*!
+ * Maximum number of threads used for processing, including the audio thread.
+ * @see ENGINE_OPTION_PROCESS_THREADS, ENGINE_OPTION_RACK_LANES
+ */
+static constexpr const uint MAX_PROCESS_THREADS = 32;
+
+/*!
+ * Maximum number of non-realtime worker threads.
+ * @see ENGINE_OPTION_WORKER_THREADS, ENGINE_OPTION_LOADER_THREADS
+ */
+static constexpr const uint MAX_WORKER_THREADS = 16;
+
 /*!
  * The "plugin Id" for the global Carla instance.
  * Currently only used for audio peaks.
@@ -665,6 +677,8 @@ typedef enum {
 
     /*!
      * SF2/3 file (SoundFont).
+     * The number of threads used for rendering can be set through the "cpuCores" string custom data,
+     * from 1 (the default) to MAX_PROCESS_THREADS. It is saved in the project like any other custom data.
      */
     PLUGIN_SF2 = 10,
 
@@ -1550,7 +1564,67 @@ typedef enum {
     /*!
      * Treat loaded plugins as standalone (that is, there is no host UI to manage them)
      */
-    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
+    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35,
+
+    /*!
+     * Number of threads used to process the internal patchbay graph, including the audio thread.
+     * Independent branches of the graph are then processed in parallel.
+     * Default is 1, meaning everything runs serially in the audio thread.
+     * @note Only used in ENGINE_PROCESS_MODE_PATCHBAY, and only applied on engine start
+     */
+    ENGINE_OPTION_PROCESS_THREADS = 36,
+
+    /*!
+     * Number of parallel stereo lanes the rack can be split into.
+     * Lane 0 is the main chain, which every plugin belongs to unless moved to another lane with
+     * carla_set_plugin_rack_lane(). Each lane runs its plugins serially, in order of Id, on its own thread.
+     * Lanes start from the rack inputs or from silence, see ENGINE_OPTION_RACK_LANE_INPUTS,
+     * all receive the rack input events, and their audio outputs are summed together.
+     * If a plugin is assigned to a lane that does not exist, the whole rack runs serially and a warning is logged.
+     * Default is 1, meaning the classic single serial chain.
+     * @note Only used in ENGINE_PROCESS_MODE_CONTINUOUS_RACK, and only applied on engine start
+     */
+    ENGINE_OPTION_RACK_LANES = 37,
+
+    /*!
+     * Number of non-realtime threads that run work scheduled by plugins from the audio thread,
+     * like LV2 worker jobs (sample loading, IR swapping, etc).
+     * Default is 2, 0 means the work is run from the engine idle calls instead.
+     * @note Only applied on engine start
+     */
+    ENGINE_OPTION_WORKER_THREADS = 38,
+
+    /*!
+     * Integration window used for RMS and true-peak plugin meters, in milliseconds.
+     * Default is 300, valid range is 10 to 10000.
+     * @note Meters are only computed for plugins being watched, see CarlaEngine::subscribeMeters()
+     */
+    ENGINE_OPTION_METER_WINDOW = 39,
+
+    /*!
+     * Number of threads used to create plugins when loading a project.
+     * Plugins that need the main thread (bridges, VST2, VST3, CLAP, AU, JSFX and JACK applications) are still
+     * created on it, while the others are created in parallel.
+     * Their state is always restored on the main thread, once they have been added to the engine.
+     * Default is 1, meaning plugins are loaded one after another.
+     */
+    ENGINE_OPTION_LOADER_THREADS = 40,
+
+    /*!
+     * Minimum size of plugin chunks stored as raw files next to saved projects, in KiB.
+     * Such chunks are kept in a "<project-name>.chunks" folder, named after their SHA1 hash,
+     * instead of being base64-encoded inside the project file.
+     * Default is 0, which keeps all chunks inside the project file.
+     */
+    ENGINE_OPTION_EXTERNAL_CHUNKS = 41,
+
+    /*!
+     * Which rack lanes are fed by the rack inputs, as a bitmask of lane indexes.
+     * Lanes not set here start from silence, like a layered synth followed by its own effects.
+     * Default is 1, meaning only the main chain receives the rack inputs.
+     * @see ENGINE_OPTION_RACK_LANES
+     */
+    ENGINE_OPTION_RACK_LANE_INPUTS = 42
 
 } EngineOption;
 
@@ -26,6 +26,9 @@ class MemoryOutputStream;
 class XmlDocument;
 }
 
+class CarlaMappedFile;
+class CarlaWorkerPool;
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
@@ -174,6 +177,29 @@ enum EngineControlEventType {
  */
 static const uint8_t kEngineEventNonMidiChannel = 0x30;
 
+/*!
+ * Plugin meter types, used as flags.
+ * @see CarlaEngine::subscribeMeters()
+ */
+enum EngineMeterType {
+    /*!
+     * Sample peak, the same values as returned by CarlaEngine::getPeaks().
+     */
+    kEngineMeterPeak = 0x1,
+
+    /*!
+     * RMS over the meter window.
+     * @see ENGINE_OPTION_METER_WINDOW
+     */
+    kEngineMeterRms = 0x2,
+
+    /*!
+     * True-peak (4x oversampled, as in ITU-R BS.1770-4) over the meter window.
+     * @see ENGINE_OPTION_METER_WINDOW
+     */
+    kEngineMeterTruePeak = 0x4
+};
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -232,6 +258,119 @@ struct CARLA_API EngineEvent {
     void fillFromMidiData(uint8_t size, const uint8_t* data, uint8_t midiPortOffset) noexcept;
 };
 
+/*!
+ * Engine event buffer, used internally in Rack, Patchbay and Bridge modes.
+ * Keeps track of how many events are in use, so that clearing and appending don't need to touch the whole buffer.
+ * Events past @a count are always null.
+ */
+struct CARLA_API EngineEventBuffer {
+    EngineEvent* data; //!< Pre-allocated events
+    uint32_t count;    //!< Number of events in use
+
+    EngineEventBuffer() noexcept;
+    ~EngineEventBuffer() noexcept;
+
+    /*!
+     * Allocate and zero the events.
+     */
+    bool alloc() noexcept;
+
+    /*!
+     * Free the events.
+     */
+    void free() noexcept;
+
+    /*!
+     * Remove all events, only zeroing the ones in use.
+     * @note RT call
+     */
+    void clear() noexcept;
+
+    /*!
+     * Get the next free event and count it as used, or null if the buffer is full.
+     * @note RT call
+     */
+    EngineEvent* append() noexcept;
+
+    /*!
+     * Replace all events with the ones from @a other.
+     * @note RT call
+     */
+    void copyFrom(const EngineEventBuffer& other) noexcept;
+
+    /*!
+     * Merge the events from @a other into this buffer, sorted by time.
+     * Both buffers are expected to be sorted already, events of this buffer go first on equal times.
+     * If there is not enough room, the latest events are dropped.
+     * @note RT call
+     */
+    void mergeFrom(const EngineEventBuffer& other) noexcept;
+
+    /*!
+     * Swap events with @a other, without copying them.
+     * @note RT call
+     */
+    void swapWith(EngineEventBuffer& other) noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(EngineEventBuffer)
+};
+
+// -----------------------------------------------------------------------
+
+/*!
+ * Statistics about how the last audio period was spread across processing threads.
+ * @see ENGINE_OPTION_PROCESS_THREADS
+ */
+struct CARLA_API EngineProcessThreadsStats {
+    uint numThreads; //!< Number of threads, including the audio one
+    uint numTasks;   //!< Number of independent tasks the graph was split into
+    uint numSteals;  //!< Number of tasks taken by a thread from another thread's queue
+    uint tasksPerThread[MAX_PROCESS_THREADS];        //!< Tasks run by each thread, the audio one is index 0
+    uint32_t busyTimePerThread[MAX_PROCESS_THREADS]; //!< Time spent running tasks on each thread, in microseconds
+    uint32_t periodTime; //!< Wall time spent processing the graph, in microseconds
+    float efficiency;    //!< Total busy time divided by (period time * number of threads)
+};
+
+/*!
+ * Statistics about the non-realtime work scheduled by a plugin.
+ * @see ENGINE_OPTION_WORKER_THREADS
+ */
+struct CARLA_API EngineWorkerStats {
+    uint32_t queueDepth;    //!< Jobs scheduled but not run yet
+    uint32_t maxQueueDepth; //!< Highest queue depth seen so far
+    uint64_t numJobs;       //!< Number of jobs run so far
+    uint32_t lastLatency;   //!< Time between the last schedule and a worker thread picking it up, in microseconds
+    uint32_t maxLatency;    //!< Highest latency seen so far, in microseconds
+    uint32_t lastWorkTime;  //!< Time spent running the last batch of jobs, in microseconds
+};
+
+/*!
+ * Statistics about a freewheel render.
+ * @see CarlaEngine::renderFreewheel()
+ */
+struct CARLA_API EngineFreewheelStats {
+    uint32_t numPeriods;    //!< Number of periods rendered
+    uint64_t totalTime;     //!< Wall time spent rendering all periods, in microseconds
+    uint32_t minPeriodTime; //!< Fastest period, in microseconds
+    uint32_t avgPeriodTime; //!< Average period, in microseconds
+    uint32_t p50PeriodTime; //!< Median period, in microseconds
+    uint32_t p90PeriodTime; //!< 90th percentile period, in microseconds
+    uint32_t p99PeriodTime; //!< 99th percentile period, in microseconds
+    uint32_t maxPeriodTime; //!< Slowest period, in microseconds
+    float realtimeFactor;   //!< Audio time rendered divided by wall time
+};
+
+/*!
+ * Meter values of a plugin.
+ * Channels are input left/right followed by output left/right, all values use a linear scale.
+ * @see CarlaEngine::getMeterValues()
+ */
+struct CARLA_API EngineMeterValues {
+    float peaks[4];     //!< Sample peaks of the last audio period
+    float rms[4];       //!< RMS of the last complete meter window
+    float truePeaks[4]; //!< True-peaks of the last complete meter window
+};
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -253,6 +392,13 @@ struct CARLA_API EngineOptions {
     float uiScale;
 
     uint maxParameters;
+    uint processThreads;
+    uint rackLanes;
+    uint rackLaneInputs;
+    uint workerThreads;
+    uint meterWindow;
+    uint loaderThreads;
+    uint externalChunks;
     uint uiBridgesTimeout;
     uint audioBufferSize;
     uint audioSampleRate;
@@ -628,7 +774,7 @@ public:
 #ifndef DOXYGEN
 protected:
     const EngineProcessMode kProcessMode;
-    EngineEvent* fBuffer;
+    EngineEventBuffer* fBuffer;
     friend class CarlaPluginInstance;
     friend class CarlaEngineCVSourcePorts;
 
@@ -801,6 +947,8 @@ protected:
      */
     CarlaEngineClient(ProtectedData* pData);
 
+    friend class CarlaEngineEventPort;
+
     CARLA_DECLARE_NON_COPYABLE(CarlaEngineClient)
 #endif
 };
@@ -974,6 +1122,19 @@ public:
      */
     virtual bool showDeviceControlPanel() const noexcept;
 
+    /*!
+     * Render @a periods audio periods back-to-back as fast as possible, then go back to normal processing.
+     * Blocks until done. Time spent by each plugin is available afterwards with getPluginProcessTime().
+     * Only supported by the Dummy engine, other engines return false.
+     */
+    virtual bool renderFreewheel(uint32_t periods, EngineFreewheelStats& stats);
+
+    /*!
+     * Get the time a plugin spent processing during the last freewheel render, in microseconds.
+     * @see renderFreewheel()
+     */
+    uint64_t getPluginProcessTime(uint pluginId) const noexcept;
+
     // -------------------------------------------------------------------
     // Plugin management
 
@@ -1029,6 +1190,12 @@ public:
      * Switch plugins with id @a idA and @a idB.
      */
     virtual bool switchPlugins(uint idA, uint idB) noexcept;
+
+    /*!
+     * Move plugin with id @a id to rack lane @a lane, 0 being the main chain.
+     * @see ENGINE_OPTION_RACK_LANES
+     */
+    bool setPluginRackLane(uint id, uint lane) noexcept;
 #endif
 
     /*!
@@ -1094,6 +1261,19 @@ public:
      * Clear the currently set project filename.
      */
     void clearCurrentProjectFilename() noexcept;
+
+    /*!
+     * Store a plugin chunk as a raw file next to the project being saved.
+     * Returns the file name to save in the plugin state, or null if the chunk must be kept inside the project.
+     * Returned variable must be deleted if non-null.
+     * @see ENGINE_OPTION_EXTERNAL_CHUNKS
+     */
+    const char* saveProjectChunkFile(const void* data, std::size_t dataSize);
+
+    /*!
+     * Map a raw chunk file of the project being loaded into memory.
+     */
+    bool loadProjectChunkFile(const char* chunkFile, CarlaMappedFile& mappedFile) const;
 #endif
 
     // -------------------------------------------------------------------
@@ -1124,6 +1304,13 @@ public:
      */
     const EngineOptions& getOptions() const noexcept;
 
+    /*!
+     * Get the pool of non-realtime threads that run work scheduled by plugins.
+     * Returns null if the engine has no such threads, plugins must then run their work during idle.
+     * @see ENGINE_OPTION_WORKER_THREADS
+     */
+    CarlaWorkerPool* getWorkerPool() const noexcept;
+
     /*!
      * Get the current Time information (read-only).
      */
@@ -1148,6 +1335,25 @@ public:
      */
     float getOutputPeak(uint pluginId, bool isLeft) const noexcept;
 
+    /*!
+     * Start watching some of a plugin's meters, using EngineMeterType flags.
+     * Meters are only computed while watched, either by a subscription or by reading peaks,
+     * which keeps peak metering alive for a short while.
+     * Each call must be paired with unsubscribeMeters().
+     */
+    void subscribeMeters(uint pluginId, uint meterTypes) noexcept;
+
+    /*!
+     * Stop watching some of a plugin's meters.
+     */
+    void unsubscribeMeters(uint pluginId, uint meterTypes) noexcept;
+
+    /*!
+     * Get all of a plugin's meter values.
+     * Values of meters not being watched are 0.
+     */
+    bool getMeterValues(uint pluginId, EngineMeterValues& values) const noexcept;
+
     // -------------------------------------------------------------------
     // Callback
 
@@ -1205,6 +1411,13 @@ public:
      * Force the engine to resend all patchbay clients, ports and connections again.
      */
     virtual bool patchbayRefresh(bool sendHost, bool sendOSC, bool external);
+
+    /*!
+     * Get statistics of the last audio period processed in parallel.
+     * Returns false if the internal graph is not using more than 1 processing thread.
+     * @see ENGINE_OPTION_PROCESS_THREADS
+     */
+    bool getProcessThreadsStats(EngineProcessThreadsStats& stats) const noexcept;
 #endif
 
     // -------------------------------------------------------------------
@@ -1318,6 +1531,7 @@ protected:
      */
     friend class CarlaEngineEventPort;
     friend class CarlaEngineOsc;
+    friend class CarlaEngineProjectLoader;
     friend class CarlaEngineRunner;
     friend class CarlaPluginInstance;
     friend class EngineInternalGraph;
@@ -1354,6 +1568,41 @@ protected:
      */
     void setPluginPeaksRT(uint pluginId, float const inPeaks[2], float const outPeaks[2]) noexcept;
 
+    /*!
+     * Get which of a plugin's meters (EngineMeterType flags) need to be computed this audio period.
+     * @note RT call, must be called once per period
+     */
+    uint getPluginMeterTypesRT(uint pluginId) noexcept;
+
+    /*!
+     * Feed a plugin's RMS and true-peak meters with its (stereo) input or output audio.
+     * Null buffers count as silence.
+     * @note RT call
+     */
+    void processPluginMetersRT(uint pluginId, bool isOutput, const float* left, const float* right,
+                               uint32_t frames, uint meterTypes) noexcept;
+
+    /*!
+     * Check if plugin process calls are being timed, as done during freewheel renders.
+     * @note RT call
+     */
+    bool isTimingPluginsRT() const noexcept;
+
+    /*!
+     * Add time spent in a plugin process call, in nanoseconds.
+     * @note RT call
+     */
+    void addPluginProcessTimeRT(uint pluginId, uint64_t time) noexcept;
+
+    /*!
+     * Create a new plugin using @a id, without adding it to the engine.
+     * Returns null and sets the last error on failure.
+     * @note Also called from project loader threads
+     */
+    CarlaPluginPtr createPlugin(uint id, BinaryType btype, PluginType ptype,
+                                const char* filename, const char* name, const char* label, int64_t uniqueId,
+                                const void* extra, uint options);
+
 public:
     /*!
      * Common save project function for main engine and plugin.
@@ -1373,7 +1622,7 @@ protected:
      * Return internal data, needed for EventPorts when used in Rack, Patchbay and Bridge modes.
      * @note RT call
      */
-    EngineEvent* getInternalEventBuffer(bool isInput) const noexcept;
+    EngineEventBuffer* getInternalEventBuffer(bool isInput) const noexcept;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     // -------------------------------------------------------------------
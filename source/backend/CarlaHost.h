@@ -678,6 +678,22 @@ CARLA_API_EXPORT bool carla_replace_plugin(CarlaHostHandle handle, uint pluginId
  * @param pluginIdB Plugin B
  */
 CARLA_API_EXPORT bool carla_switch_plugins(CarlaHostHandle handle, uint pluginIdA, uint pluginIdB);
+
+/*!
+ * Get the rack lane a plugin runs on, 0 being the main chain.
+ * @param pluginId Plugin
+ * @see ENGINE_OPTION_RACK_LANES
+ */
+CARLA_API_EXPORT uint carla_get_plugin_rack_lane(CarlaHostHandle handle, uint pluginId);
+
+/*!
+ * Move a plugin to another rack lane, 0 being the main chain.
+ * The lane is stored in the plugin state, and so saved in projects.
+ * @param pluginId Plugin
+ * @param lane     New lane, must be lower than ENGINE_OPTION_RACK_LANES for the rack to run in parallel
+ * @see ENGINE_OPTION_RACK_LANES and ENGINE_OPTION_RACK_LANE_INPUTS
+ */
+CARLA_API_EXPORT bool carla_set_plugin_rack_lane(CarlaHostHandle handle, uint pluginId, uint lane);
 #endif
 
 /*!
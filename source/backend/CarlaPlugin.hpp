@@ -54,6 +54,7 @@ class CarlaEngineCVSourcePorts;
 class CarlaEngineBridge;
 struct CarlaStateSave;
 struct EngineEvent;
+struct EngineWorkerStats;
 
 // -----------------------------------------------------------------------
 
@@ -127,6 +128,15 @@ public:
      */
     bool isEnabled() const noexcept;
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    /*!
+     * Get the rack lane this plugin runs on, 0 being the main chain.
+     *
+     * @see setRackLane() and ENGINE_OPTION_RACK_LANES
+     */
+    uint getRackLane() const noexcept;
+#endif
+
     /*!
      * Get the plugin's internal name.
      * This name is unique within all plugins in an engine.
@@ -259,6 +269,13 @@ public:
      */
     bool isParameterOutput(uint32_t parameterId) const noexcept;
 
+    /*!
+     * Find the next output parameter whose value changed since it was last found, starting at @a parameterId.
+     * Start with 0 and increment @a parameterId after each call, until this returns false.
+     * Plugin types that do not track output changes from the audio thread report all output parameters.
+     */
+    bool getNextChangedParameterOutput(uint32_t& parameterId) noexcept;
+
     /*!
      * Get the MIDI program at @a index.
      *
@@ -571,6 +588,17 @@ public:
      */
     virtual void setCtrlChannel(int8_t channel, bool sendOsc, bool sendCallback) noexcept;
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    /*!
+     * Set the rack lane this plugin runs on, 0 being the main chain.
+     * The engine only picks up the change on its next rack lanes update,
+     * use CarlaEngine::setPluginRackLane() for plugins already added to it.
+     *
+     * @see getRackLane() and ENGINE_OPTION_RACK_LANES
+     */
+    void setRackLane(uint lane) noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Set data (plugin-specific stuff)
 
@@ -719,6 +747,25 @@ public:
     virtual void process(const float* const* audioIn, float** audioOut,
                          const float* const* cvIn, float** cvOut, uint32_t frames) = 0;
 
+    /*!
+     * Whether this plugin benefits from processing in two phases, see processStart().
+     * This is the case for plugins running in a separate process.
+     */
+    virtual bool canProcessAsync() const noexcept;
+
+    /*!
+     * Start processing without waiting for the result.
+     * Must be followed by processFinish() in the same audio cycle, buffers must remain valid until then.
+     * The default implementation simply calls process().
+     */
+    virtual void processStart(const float* const* audioIn, float** audioOut,
+                              const float* const* cvIn, float** cvOut, uint32_t frames);
+
+    /*!
+     * Wait for and collect the results of a previous processStart() call.
+     */
+    virtual void processFinish();
+
     /*!
      * Tell the plugin the current buffer size changed.
      */
@@ -743,6 +790,13 @@ public:
      */
     virtual void idle();
 
+    /*!
+     * Get statistics about the non-realtime work scheduled by this plugin.
+     * Returns false if the plugin does not schedule any such work.
+     * @see ENGINE_OPTION_WORKER_THREADS
+     */
+    virtual bool getWorkerStats(EngineWorkerStats& stats) const noexcept;
+
     /*!
      * Try to lock the plugin's master mutex.
      * @param forcedOffline When true, always locks and returns true
@@ -388,6 +388,20 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
     engine->setOption(CB::ENGINE_OPTION_CLIENT_NAME_PREFIX, 0, standalone.engineOptions.clientNamePrefix);
 
     engine->setOption(CB::ENGINE_OPTION_PLUGINS_ARE_STANDALONE, standalone.engineOptions.pluginsAreStandalone, nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_PROCESS_THREADS, static_cast<int>(standalone.engineOptions.processThreads), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_RACK_LANES, static_cast<int>(standalone.engineOptions.rackLanes), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_RACK_LANE_INPUTS, static_cast<int>(standalone.engineOptions.rackLaneInputs), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_WORKER_THREADS, static_cast<int>(standalone.engineOptions.workerThreads), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_METER_WINDOW, static_cast<int>(standalone.engineOptions.meterWindow), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_LOADER_THREADS, static_cast<int>(standalone.engineOptions.loaderThreads), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_EXTERNAL_CHUNKS, static_cast<int>(standalone.engineOptions.externalChunks), nullptr);
 #endif // BUILD_BRIDGE
 }
 
@@ -1006,6 +1020,40 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
             CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
             shandle.engineOptions.pluginsAreStandalone = (value != 0);
             break;
+
+        case CB::ENGINE_OPTION_PROCESS_THREADS:
+            CARLA_SAFE_ASSERT_RETURN(value >= 1 && value <= static_cast<int>(CB::MAX_PROCESS_THREADS),);
+            shandle.engineOptions.processThreads = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_RACK_LANES:
+            CARLA_SAFE_ASSERT_RETURN(value >= 1 && value <= static_cast<int>(CB::MAX_PROCESS_THREADS),);
+            shandle.engineOptions.rackLanes = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_WORKER_THREADS:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= static_cast<int>(CB::MAX_WORKER_THREADS),);
+            shandle.engineOptions.workerThreads = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_METER_WINDOW:
+            CARLA_SAFE_ASSERT_RETURN(value >= 10 && value <= 10000,);
+            shandle.engineOptions.meterWindow = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_LOADER_THREADS:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= static_cast<int>(CB::MAX_WORKER_THREADS),);
+            shandle.engineOptions.loaderThreads = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_EXTERNAL_CHUNKS:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.externalChunks = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_RACK_LANE_INPUTS:
+            shandle.engineOptions.rackLaneInputs = static_cast<uint>(value);
+            break;
         }
     }
 
@@ -1303,6 +1351,25 @@ bool carla_switch_plugins(CarlaHostHandle handle, uint pluginIdA, uint pluginIdB
 
     return handle->engine->switchPlugins(pluginIdA, pluginIdB);
 }
+
+uint carla_get_plugin_rack_lane(CarlaHostHandle handle, uint pluginId)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        return plugin->getRackLane();
+
+    return 0;
+}
+
+bool carla_set_plugin_rack_lane(CarlaHostHandle handle, uint pluginId, uint lane)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_set_plugin_rack_lane(%p, %i, %i)", handle, pluginId, lane);
+
+    return handle->engine->setPluginRackLane(pluginId, lane);
+}
 #endif
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -242,6 +242,24 @@ CARLA_PLUGIN_EXPORT void carla_plugin_discovery_stop(CarlaPluginDiscoveryHandle
  */
 CARLA_PLUGIN_EXPORT void carla_plugin_discovery_set_option(EngineOption option, int value, const char* valueStr);
 
+/*!
+ * Set the folder of the plugin discovery cache, to be applied globally.
+ * Carla keeps the plugins found in each scanned binary in there, so binaries are only scanned again once modified.
+ * Cached plugins are reported through the discovery callback as if they were just scanned.
+ * By default a "carla" folder inside the user cache folder is used.
+ * Passing null disables the cache, an empty string restores the default folder.
+ */
+CARLA_PLUGIN_EXPORT void carla_plugin_discovery_set_cache_folder(const char* folder);
+
+/*!
+ * Remove cached discovery results of binaries inside @p pluginPath, so they are scanned again next time.
+ * If @p pluginPath is null or empty, all cached results for this binary and plugin type are removed.
+ * If @p onlyInvalid is true, only results of binaries without plugins are removed.
+ * LV2 results are cached per bundle and always removed as a whole, regardless of @p pluginPath.
+ */
+CARLA_PLUGIN_EXPORT void carla_plugin_discovery_clear_cache(BinaryType btype, PluginType ptype, const char* pluginPath,
+                                                            bool onlyInvalid);
+
 /* --------------------------------------------------------------------------------------------------------------------
  * cached plugins */
 
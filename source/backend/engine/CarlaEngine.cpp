@@ -25,10 +25,12 @@
 #include "CarlaEngineClient.hpp"
 #include "CarlaEngineInit.hpp"
 #include "CarlaEngineInternal.hpp"
+#include "CarlaEngineProjectLoader.hpp"
 #include "CarlaPlugin.hpp"
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBinaryUtils.hpp"
+#include "CarlaChunkFileUtils.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaPipeUtils.hpp"
@@ -69,6 +71,42 @@ using water::XmlElement;
 
 CARLA_BACKEND_START_NAMESPACE
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+// -----------------------------------------------------------------------
+// External chunk files
+
+/*
+ * Folder of the raw chunk files of a project, "name.carxp" uses "name.chunks".
+ */
+static File getProjectChunksFolder(const File& projectFile)
+{
+    return projectFile.getSiblingFile(projectFile.getFileNameWithoutExtension() + ".chunks");
+}
+
+/*
+ * Remove chunk files no longer used after saving a project, and the folder itself when nothing is left.
+ */
+static void removeUnusedChunkFiles(const File& folder, CarlaStringList& usedFiles)
+{
+    if (! folder.isDirectory())
+        return;
+
+    std::vector<File> files;
+    folder.findChildFiles(files, File::findFiles, false, String("*") + kChunkFileExtension);
+
+    for (std::vector<File>::iterator it = files.begin(); it != files.end(); ++it)
+    {
+        const String filename(it->getFileName());
+
+        if (carla_isValidChunkFileName(filename.toRawUTF8()) && ! usedFiles.contains(filename.toRawUTF8()))
+            it->deleteFile();
+    }
+
+    if (usedFiles.isEmpty() && folder.getNumberOfChildFiles(File::findFilesAndDirectories) == 0)
+        folder.deleteFile();
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Carla Engine
 
@@ -542,6 +580,19 @@ bool CarlaEngine::setBufferSizeAndSampleRate(const uint, const double)
     return false;
 }
 
+bool CarlaEngine::renderFreewheel(const uint32_t, EngineFreewheelStats&)
+{
+    setLastError("Unsupported operation");
+    return false;
+}
+
+uint64_t CarlaEngine::getPluginProcessTime(const uint pluginId) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, 0);
+
+    return pData->plugins[pluginId].processTime / 1000;
+}
+
 // -----------------------------------------------------------------------
 // Plugin management
 
@@ -602,6 +653,80 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
        #endif
     }
 
+    const CarlaPluginPtr plugin = createPlugin(id, btype, ptype, filename, name, label, uniqueId, extra, options);
+
+    if (plugin.get() == nullptr)
+        return false;
+
+    EnginePluginData& pluginData(pData->plugins[id]);
+    pluginData.plugin = plugin;
+    carla_zeroFloats(pluginData.peaks, 4);
+
+   #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (oldPlugin.get() != nullptr)
+    {
+        CARLA_SAFE_ASSERT(! pData->loadingProject);
+
+        const ScopedRunnerStopper srs(this);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.replacePlugin(oldPlugin, plugin);
+
+        const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
+        const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
+        const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
+
+        oldPlugin->prepareForDeletion();
+        {
+            const CarlaMutexLocker cml(pData->pluginsToDeleteMutex);
+            pData->pluginsToDelete.push_back(oldPlugin);
+        }
+
+        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
+            plugin->setDryWet(oldDryWet, true, true);
+
+        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
+            plugin->setVolume(oldVolume, true, true);
+
+        plugin->setActive(wasActive, true, true);
+        plugin->setEnabled(true);
+
+        callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0, 0.0f, nullptr);
+    }
+    else if (! pData->loadingProject)
+   #endif
+    {
+        plugin->setEnabled(true);
+
+        ++pData->curPluginCount;
+        callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, id, plugin->getType(), 0, 0, 0.0f, plugin->getName());
+
+        if (getType() != kEngineTypeBridge)
+            plugin->setActive(true, true, true);
+
+       #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.addPlugin(plugin);
+       #endif
+    }
+
+   #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->graph.updateRackLanes(pData);
+   #endif
+
+    return true;
+}
+
+CarlaPluginPtr CarlaEngine::createPlugin(const uint id,
+                                         const BinaryType btype,
+                                         const PluginType ptype,
+                                         const char* const filename,
+                                         const char* const name,
+                                         const char* const label,
+                                         const int64_t uniqueId,
+                                         const void* const extra,
+                                         const uint options)
+{
     CarlaPlugin::Initializer initializer = {
         this,
         id,
@@ -729,7 +854,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
     else
     {
         setLastError("Cannot load plugin, the required plugin bridge is not available");
-        return false;
+        return plugin;
     }
    #elif !defined(CARLA_OS_WASM)
     if (canBeBridged && (needsArchBridge || btype != BINARY_NATIVE || (preferBridges && bridgeBinary.isNotEmpty())))
@@ -741,7 +866,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
         else
         {
             setLastError("This Carla build cannot handle this binary");
-            return false;
+            return plugin;
         }
     }
     else
@@ -849,7 +974,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
    #endif // CARLA_PLUGIN_ONLY_BRIDGE
 
     if (plugin.get() == nullptr)
-        return false;
+        return plugin;
 
     plugin->reload();
 
@@ -877,63 +1002,9 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
     }
 
     if (! canRun)
-    {
-        return false;
-    }
-
-    EnginePluginData& pluginData(pData->plugins[id]);
-    pluginData.plugin = plugin;
-    carla_zeroFloats(pluginData.peaks, 4);
-
-   #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    if (oldPlugin.get() != nullptr)
-    {
-        CARLA_SAFE_ASSERT(! pData->loadingProject);
-
-        const ScopedRunnerStopper srs(this);
-
-        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-            pData->graph.replacePlugin(oldPlugin, plugin);
-
-        const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
-        const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
-        const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
-
-        oldPlugin->prepareForDeletion();
-        {
-            const CarlaMutexLocker cml(pData->pluginsToDeleteMutex);
-            pData->pluginsToDelete.push_back(oldPlugin);
-        }
-
-        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
-            plugin->setDryWet(oldDryWet, true, true);
-
-        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
-            plugin->setVolume(oldVolume, true, true);
-
-        plugin->setActive(wasActive, true, true);
-        plugin->setEnabled(true);
-
-        callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0, 0.0f, nullptr);
-    }
-    else if (! pData->loadingProject)
-   #endif
-    {
-        plugin->setEnabled(true);
-
-        ++pData->curPluginCount;
-        callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, id, plugin->getType(), 0, 0, 0.0f, plugin->getName());
+        return CarlaPluginPtr();
 
-        if (getType() != kEngineTypeBridge)
-            plugin->setActive(true, true, true);
-
-       #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-            pData->graph.addPlugin(plugin);
-       #endif
-    }
-
-    return true;
+    return plugin;
 
    #if defined(BUILD_BRIDGE_ALTERNATIVE_ARCH) || defined(CARLA_PLUGIN_ONLY_BRIDGE)
     // unused
@@ -977,6 +1048,8 @@ bool CarlaEngine::removePlugin(const uint id)
 
     const ScopedActionLock sal(this, kEnginePostActionRemovePlugin, id, 0);
 
+    pData->graph.updateRackLanes(pData);
+
     /*
     for (uint i=id; i < pData->curPluginCount; ++i)
     {
@@ -1025,6 +1098,10 @@ bool CarlaEngine::removeAllPlugins()
 
     const ScopedActionLock sal(this, kEnginePostActionZeroCount, 0, 0);
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->graph.updateRackLanes(pData);
+#endif
+
     callback(true, false, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
 
     for (uint i=0; i < curPluginCount; ++i)
@@ -1169,6 +1246,8 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
 
     const ScopedActionLock sal(this, kEnginePostActionSwitchPlugins, idA, idB);
 
+    pData->graph.updateRackLanes(pData);
+
     // TODO
     /*
     pluginA->updateOscURL();
@@ -1180,6 +1259,24 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
 
     return true;
 }
+
+bool CarlaEngine::setPluginRackLane(const uint id, const uint lane) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
+    CARLA_SAFE_ASSERT_RETURN_ERR(lane < MAX_PROCESS_THREADS, "Invalid rack lane");
+    carla_debug("CarlaEngine::setPluginRackLane(%i, %i)", id, lane);
+
+    const CarlaPluginPtr plugin = pData->plugins[id].plugin;
+
+    CARLA_SAFE_ASSERT_RETURN_ERR(plugin.get() != nullptr, "Could not find plugin to move");
+    CARLA_SAFE_ASSERT_RETURN_ERR(plugin->getId() == id, "Invalid engine internal data");
+
+    plugin->setRackLane(lane);
+    pData->graph.updateRackLanes(pData);
+
+    return true;
+}
 #endif
 
 void CarlaEngine::touchPluginParameter(const uint, const uint32_t, const bool) noexcept
@@ -1495,7 +1592,18 @@ bool CarlaEngine::loadProject(const char* const filename, const bool setAsCurren
     }
 
     XmlDocument xml(file);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // plugins map their external chunks from here, possibly from loader threads
+    pData->currentChunksFolder = getProjectChunksFolder(file).getFullPathName().toRawUTF8();
+
+    const bool ok = loadProjectInternal(xml, !setAsCurrentProject);
+
+    pData->currentChunksFolder.clear();
+    return ok;
+#else
     return loadProjectInternal(xml, !setAsCurrentProject);
+#endif
 }
 
 bool CarlaEngine::saveProject(const char* const filename, const bool setAsCurrentProject)
@@ -1526,17 +1634,39 @@ bool CarlaEngine::saveProject(const char* const filename, const bool setAsCurren
 #endif
     }
 
+    const String jfilename = String(CharPointer_UTF8(filename));
+    File file(jfilename);
+
     MemoryOutputStream out;
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    const File chunksFolder(getProjectChunksFolder(file));
+
+    if (pData->options.externalChunks != 0)
+        pData->currentChunksFolder = chunksFolder.getFullPathName().toRawUTF8();
+
     saveProjectInternal(out);
 
-    const String jfilename = String(CharPointer_UTF8(filename));
-    File file(jfilename);
+    pData->currentChunksFolder.clear();
+#else
+    saveProjectInternal(out);
+#endif
 
-    if (file.replaceWithData(out.getData(), out.getDataSize()))
-        return true;
+    if (! file.replaceWithData(out.getData(), out.getDataSize()))
+    {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        pData->savedChunkFiles.clear();
+#endif
+        setLastError("Failed to write file");
+        return false;
+    }
 
-    setLastError("Failed to write file");
-    return false;
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    removeUnusedChunkFiles(chunksFolder, pData->savedChunkFiles);
+    pData->savedChunkFiles.clear();
+#endif
+
+    return true;
 }
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -1556,6 +1686,55 @@ void CarlaEngine::clearCurrentProjectFilename() noexcept
     pData->currentProjectFilename.clear();
     pData->currentProjectFolder.clear();
 }
+
+const char* CarlaEngine::saveProjectChunkFile(const void* const data, const std::size_t dataSize)
+{
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr && dataSize != 0, nullptr);
+
+    if (pData->currentChunksFolder.isEmpty())
+        return nullptr;
+    if (dataSize < static_cast<std::size_t>(pData->options.externalChunks) * 1024)
+        return nullptr;
+
+    const File folder(String(CharPointer_UTF8(pData->currentChunksFolder.buffer())));
+    const CarlaString chunkFile(carla_writeChunkFile(folder, data, dataSize));
+
+    // keep the chunk inside the project if writing failed
+    if (chunkFile.isEmpty())
+        return nullptr;
+
+    pData->savedChunkFiles.appendUnique(chunkFile);
+    return chunkFile.dup();
+}
+
+bool CarlaEngine::loadProjectChunkFile(const char* const chunkFile, CarlaMappedFile& mappedFile) const
+{
+    CARLA_SAFE_ASSERT_RETURN(chunkFile != nullptr && chunkFile[0] != '\0', false);
+    carla_debug("CarlaEngine::loadProjectChunkFile(\"%s\", %p)", chunkFile, &mappedFile);
+
+    if (! carla_isValidChunkFileName(chunkFile))
+    {
+        carla_stderr2("CarlaEngine::loadProjectChunkFile(\"%s\") - invalid chunk file name", chunkFile);
+        return false;
+    }
+
+    if (pData->currentChunksFolder.isEmpty())
+    {
+        carla_stderr2("CarlaEngine::loadProjectChunkFile(\"%s\") - not loading a project file", chunkFile);
+        return false;
+    }
+
+    const File folder(String(CharPointer_UTF8(pData->currentChunksFolder.buffer())));
+    const File file(folder.getChildFile(chunkFile));
+
+    if (! file.existsAsFile())
+    {
+        carla_stderr2("CarlaEngine::loadProjectChunkFile(\"%s\") - file does not exist", chunkFile);
+        return false;
+    }
+
+    return mappedFile.open(file.getFullPathName().toRawUTF8());
+}
 #endif
 
 // -----------------------------------------------------------------------
@@ -1586,6 +1765,16 @@ const EngineOptions& CarlaEngine::getOptions() const noexcept
     return pData->options;
 }
 
+CarlaWorkerPool* CarlaEngine::getWorkerPool() const noexcept
+{
+#ifndef CARLA_OS_WASM
+    if (pData->workerPool.getNumThreads() != 0)
+        return &pData->workerPool;
+#endif
+
+    return nullptr;
+}
+
 EngineTimeInfo CarlaEngine::getTimeInfo() const noexcept
 {
     return pData->timeInfo;
@@ -1603,6 +1792,7 @@ const float* CarlaEngine::getPeaks(const uint pluginId) const noexcept
         // get peak from first plugin, if available
         if (const uint count = pData->curPluginCount)
         {
+            pData->touchPluginMeters(pluginId);
             pData->peaks[0] = pData->plugins[0].peaks[0];
             pData->peaks[1] = pData->plugins[0].peaks[1];
             pData->peaks[2] = pData->plugins[count-1].peaks[2];
@@ -1618,6 +1808,7 @@ const float* CarlaEngine::getPeaks(const uint pluginId) const noexcept
 
     CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, kFallback);
 
+    pData->touchPluginMeters(pluginId);
     return pData->plugins[pluginId].peaks;
 }
 
@@ -1627,12 +1818,16 @@ float CarlaEngine::getInputPeak(const uint pluginId, const bool isLeft) const no
     {
         // get peak from first plugin, if available
         if (pData->curPluginCount > 0)
+        {
+            pData->touchPluginMeters(pluginId);
             return pData->plugins[0].peaks[isLeft ? 0 : 1];
+        }
         return 0.0f;
     }
 
     CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, 0.0f);
 
+    pData->touchPluginMeters(pluginId);
     return pData->plugins[pluginId].peaks[isLeft ? 0 : 1];
 }
 
@@ -1642,15 +1837,45 @@ float CarlaEngine::getOutputPeak(const uint pluginId, const bool isLeft) const n
     {
         // get peak from last plugin, if available
         if (pData->curPluginCount > 0)
+        {
+            pData->touchPluginMeters(pluginId);
             return pData->plugins[pData->curPluginCount-1].peaks[isLeft ? 2 : 3];
+        }
         return 0.0f;
     }
 
     CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, 0.0f);
 
+    pData->touchPluginMeters(pluginId);
     return pData->plugins[pluginId].peaks[isLeft ? 2 : 3];
 }
 
+void CarlaEngine::subscribeMeters(const uint pluginId, const uint meterTypes) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount,);
+
+    pData->plugins[pluginId].meters.subscribe(meterTypes);
+}
+
+void CarlaEngine::unsubscribeMeters(const uint pluginId, const uint meterTypes) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount,);
+
+    pData->plugins[pluginId].meters.unsubscribe(meterTypes);
+}
+
+bool CarlaEngine::getMeterValues(const uint pluginId, EngineMeterValues& values) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, false);
+
+    const EnginePluginData& pluginData(pData->plugins[pluginId]);
+
+    pData->touchPluginMeters(pluginId);
+    carla_copyFloats(values.peaks, pluginData.peaks, 4);
+    pluginData.meters.getValues(values.rms, values.truePeaks);
+    return true;
+}
+
 // -----------------------------------------------------------------------
 // Callback
 
@@ -1672,6 +1897,12 @@ void CarlaEngine::callback(const bool sendHost, const bool sendOSC,
                     static_cast<double>(valuef), valueStr);
 #endif
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // plugins being loaded in parallel are not known to the host yet
+    if (CarlaEngineProjectLoader::isLoaderThread())
+        return;
+#endif
+
     if (sendHost && pData->callback != nullptr)
     {
         if (action == ENGINE_CALLBACK_IDLE)
@@ -1861,11 +2092,25 @@ void CarlaEngine::transportRelocate(const uint64_t frame) noexcept
 
 const char* CarlaEngine::getLastError() const noexcept
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (const CarlaString* const loaderError = CarlaEngineProjectLoader::getLoaderThreadLastError())
+        return *loaderError;
+#endif
+
     return pData->lastError;
 }
 
 void CarlaEngine::setLastError(const char* const error) const noexcept
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // errors of plugins being loaded in parallel are kept per thread
+    if (CarlaString* const loaderError = CarlaEngineProjectLoader::getLoaderThreadLastError())
+    {
+        *loaderError = error;
+        return;
+    }
+#endif
+
     pData->lastError = error;
 }
 
@@ -1915,6 +2160,9 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         switch (option)
         {
         case ENGINE_OPTION_PROCESS_MODE:
+        case ENGINE_OPTION_PROCESS_THREADS:
+        case ENGINE_OPTION_RACK_LANES:
+        case ENGINE_OPTION_WORKER_THREADS:
         case ENGINE_OPTION_AUDIO_TRIPLE_BUFFER:
         case ENGINE_OPTION_AUDIO_DRIVER:
         case ENGINE_OPTION_AUDIO_DEVICE:
@@ -2276,6 +2524,40 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
         pData->options.pluginsAreStandalone = (value != 0);
         break;
+
+    case ENGINE_OPTION_PROCESS_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 1 && value <= static_cast<int>(MAX_PROCESS_THREADS),);
+        pData->options.processThreads = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_RACK_LANES:
+        CARLA_SAFE_ASSERT_RETURN(value >= 1 && value <= static_cast<int>(MAX_PROCESS_THREADS),);
+        pData->options.rackLanes = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_WORKER_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= static_cast<int>(MAX_WORKER_THREADS),);
+        pData->options.workerThreads = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_METER_WINDOW:
+        CARLA_SAFE_ASSERT_RETURN(value >= 10 && value <= 10000,);
+        pData->options.meterWindow = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_LOADER_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= static_cast<int>(MAX_WORKER_THREADS),);
+        pData->options.loaderThreads = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_EXTERNAL_CHUNKS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.externalChunks = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_RACK_LANE_INPUTS:
+        pData->options.rackLaneInputs = static_cast<uint>(value);
+        break;
     }
 }
 
@@ -2402,6 +2684,30 @@ void CarlaEngine::setPluginPeaksRT(const uint pluginId, float const inPeaks[2],
     pluginData.peaks[3] = outPeaks[1];
 }
 
+bool CarlaEngine::isTimingPluginsRT() const noexcept
+{
+    return pData->timingPlugins;
+}
+
+void CarlaEngine::addPluginProcessTimeRT(const uint pluginId, const uint64_t time) noexcept
+{
+    pData->plugins[pluginId].processTime += time;
+}
+
+uint CarlaEngine::getPluginMeterTypesRT(const uint pluginId) noexcept
+{
+    return pData->plugins[pluginId].meters.getMeterTypesRT();
+}
+
+void CarlaEngine::processPluginMetersRT(const uint pluginId, const bool isOutput,
+                                        const float* const left, const float* const right,
+                                        const uint32_t frames, const uint meterTypes) noexcept
+{
+    const uint32_t windowFrames = static_cast<uint32_t>(pData->sampleRate * pData->options.meterWindow / 1000);
+
+    pData->plugins[pluginId].meters.processRT(isOutput ? 1 : 0, left, right, frames, meterTypes, windowFrames);
+}
+
 void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) const
 {
     // send initial prepareForSave first, giving time for bridges to act
@@ -2448,6 +2754,9 @@ void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) cons
         outSettings << "  <MaxParameters>"       << String(options.maxParameters)    << "</MaxParameters>\n";
         outSettings << "  <UIBridgesTimeout>"    << String(options.uiBridgesTimeout) << "</UIBridgesTimeout>\n";
 
+        if (options.rackLaneInputs != 0x1)
+            outSettings << "  <RackLaneInputs>0x" << String::toHexString(static_cast<int>(options.rackLaneInputs)) << "</RackLaneInputs>\n";
+
         if (isPlugin)
         {
             outSettings << "  <LADSPA_PATH>" << xmlSafeString(options.pathLADSPA, true) << "</LADSPA_PATH>\n";
@@ -2831,6 +3140,11 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
                 option = ENGINE_OPTION_UI_BRIDGES_TIMEOUT;
                 value  = text.getIntValue();
             }
+            else if (tag == "RackLaneInputs")
+            {
+                option = ENGINE_OPTION_RACK_LANE_INPUTS;
+                value  = text.getHexValue32();
+            }
             else if (isPlugin)
             {
                 /**/ if (tag == "LADSPA_PATH")
@@ -2943,6 +3257,16 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
         }
     }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // plugins that do not need the main thread are created in parallel
+    CarlaScopedPointer<CarlaEngineProjectLoader> loader;
+
+   #ifndef CARLA_OS_WASM
+    if (! isPreset && pData->options.loaderThreads > 1)
+        loader = new CarlaEngineProjectLoader(this);
+   #endif
+#endif
+
     // and we handle plugins
     for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
     {
@@ -2950,7 +3274,8 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
 
         if (isPreset || tagName == "Plugin")
         {
-            CarlaStateSave stateSave;
+            CarlaScopedPointer<ProjectPluginJob> job(new ProjectPluginJob());
+            CarlaStateSave& stateSave(job->stateSave);
             stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem);
 
             if (pData->aboutToClose)
@@ -2969,6 +3294,16 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
             // FIXME Remove on 2.1 release
             if (std::strcmp(stateSave.type, "GIG") == 0)
             {
+                // keep project order, pending plugins go first
+                if (loader != nullptr && loader->hasJobs() && ! loader->run(pData->options.loaderThreads))
+                {
+                    if (pData->aboutToClose)
+                        return true;
+
+                    setLastError("Project load canceled");
+                    return false;
+                }
+
                 if (addPlugin(PLUGIN_LV2, "", stateSave.name, "http://linuxsampler.org/plugins/linuxsampler", 0, nullptr))
                 {
                     const uint pluginId = pData->curPluginCount;
@@ -3028,6 +3363,16 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
            #ifdef SFZ_FILES_USING_SFIZZ
             if (std::strcmp(stateSave.type, "SFZ") == 0)
             {
+                // keep project order, pending plugins go first
+                if (loader != nullptr && loader->hasJobs() && ! loader->run(pData->options.loaderThreads))
+                {
+                    if (pData->aboutToClose)
+                        return true;
+
+                    setLastError("Project load canceled");
+                    return false;
+                }
+
                 if (addPlugin(PLUGIN_LV2, "", stateSave.name, "http://sfztools.github.io/sfizz", 0, nullptr))
                 {
                     const uint pluginId = pData->curPluginCount;
@@ -3181,6 +3526,17 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
                 break;
             }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+            if (loader != nullptr)
+            {
+                job->btype = btype;
+                job->ptype = ptype;
+                job->extra = extraStuff;
+                loader->addJob(job.release());
+                continue;
+            }
+#endif
+
             if (addPlugin(btype, ptype, stateSave.binary,
                           stateSave.name, stateSave.label, stateSave.uniqueId, extraStuff, stateSave.options))
             {
@@ -3246,6 +3602,15 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
     }
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (loader != nullptr && loader->hasJobs() && ! loader->run(pData->options.loaderThreads))
+    {
+        if (pData->aboutToClose)
+            return true;
+
+        setLastError("Project load canceled");
+        return false;
+    }
+
     // tell bridges we're done loading
     for (uint i=0; i < pData->curPluginCount; ++i)
     {
@@ -3254,6 +3619,9 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
                 plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "true", false);
     }
 
+    // rack lanes come from the plugin states, which are only restored now
+    pData->graph.updateRackLanes(pData);
+
     if (pData->aboutToClose)
         return true;
 
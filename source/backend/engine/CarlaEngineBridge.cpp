@@ -1543,17 +1543,16 @@ protected:
                     carla_zeroBytes(midiData, kBridgeBaseMidiOutHeaderSize);
                     std::size_t curMidiDataPos = 0;
 
-                    if (pData->events.in[0].type != kEngineEventTypeNull)
-                        carla_zeroStructs(pData->events.in, kMaxEngineEventInternalCount);
+                    pData->events.in.clear();
 
-                    if (pData->events.out[0].type != kEngineEventTypeNull)
+                    if (pData->events.out.count != 0)
                     {
-                        for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+                        for (uint32_t i=0; i < pData->events.out.count; ++i)
                         {
-                            const EngineEvent& event(pData->events.out[i]);
+                            const EngineEvent& event(pData->events.out.data[i]);
 
                             if (event.type == kEngineEventTypeNull)
-                                break;
+                                continue;
 
                             if (event.type == kEngineEventTypeControl)
                             {
@@ -1619,7 +1618,7 @@ protected:
                             curMidiDataPos + kBridgeBaseMidiOutHeaderSize < kBridgeRtClientDataMidiOutSize)
                             carla_zeroBytes(midiData, kBridgeBaseMidiOutHeaderSize);
 
-                        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+                        pData->events.out.clear();
                     }
 
                 }   break;
@@ -1651,14 +1650,7 @@ protected:
     // called from process thread above
     EngineEvent* getNextFreeInputEvent() const noexcept
     {
-        for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
-        {
-            EngineEvent* const event(&pData->events.in[i]);
-
-            if (event->type == kEngineEventTypeNull)
-                return event;
-        }
-        return nullptr;
+        return pData->events.in.append();
     }
 
     void latencyChanged(const uint32_t samples) noexcept override
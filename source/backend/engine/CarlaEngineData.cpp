@@ -15,7 +15,7 @@
  * For a full copy of the GNU General Public License see the doc/GPL.txt file.
  */
 
-#include "CarlaEngine.hpp"
+#include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 
@@ -188,6 +188,115 @@ void EngineEvent::fillFromMidiData(const uint8_t size, const uint8_t* const data
     }
 }
 
+// -----------------------------------------------------------------------
+// EngineEventBuffer
+
+EngineEventBuffer::EngineEventBuffer() noexcept
+    : data(nullptr),
+      count(0) {}
+
+EngineEventBuffer::~EngineEventBuffer() noexcept
+{
+    CARLA_SAFE_ASSERT(data == nullptr);
+}
+
+bool EngineEventBuffer::alloc() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(data == nullptr, false);
+
+    try {
+        data = new EngineEvent[kMaxEngineEventInternalCount];
+    } CARLA_SAFE_EXCEPTION_RETURN("EngineEventBuffer::alloc", false);
+
+    carla_zeroStructs(data, kMaxEngineEventInternalCount);
+    count = 0;
+    return true;
+}
+
+void EngineEventBuffer::free() noexcept
+{
+    if (data != nullptr)
+    {
+        delete[] data;
+        data = nullptr;
+    }
+
+    count = 0;
+}
+
+void EngineEventBuffer::clear() noexcept
+{
+    if (count == 0)
+        return;
+
+    carla_zeroStructs(data, count);
+    count = 0;
+}
+
+EngineEvent* EngineEventBuffer::append() noexcept
+{
+    if (count >= kMaxEngineEventInternalCount)
+        return nullptr;
+
+    return &data[count++];
+}
+
+void EngineEventBuffer::copyFrom(const EngineEventBuffer& other) noexcept
+{
+    // zero what the new events won't overwrite
+    if (count > other.count)
+        carla_zeroStructs(data + other.count, count - other.count);
+
+    if (other.count != 0)
+        carla_copyStructs(data, other.data, other.count);
+
+    count = other.count;
+}
+
+void EngineEventBuffer::mergeFrom(const EngineEventBuffer& other) noexcept
+{
+    if (other.count == 0)
+        return;
+    if (count == 0)
+        return copyFrom(other);
+
+    // merge from the back, so no temporary storage is needed and our own events never get overwritten
+    const uint32_t total = count + other.count;
+    uint32_t i = count, j = other.count, k = total;
+
+    while (j != 0)
+    {
+        --k;
+
+        if (i == 0 || other.data[j-1].time >= data[i-1].time)
+        {
+            --j;
+            if (k < kMaxEngineEventInternalCount)
+                data[k] = other.data[j];
+        }
+        else
+        {
+            --i;
+            if (k < kMaxEngineEventInternalCount)
+                data[k] = data[i];
+        }
+    }
+
+    count = std::min<uint32_t>(total, kMaxEngineEventInternalCount);
+}
+
+void EngineEventBuffer::swapWith(EngineEventBuffer& other) noexcept
+{
+    EngineEvent* const tmpData = data;
+    const uint32_t tmpCount = count;
+
+    data  = other.data;
+    count = other.count;
+
+    other.data  = tmpData;
+    other.count = tmpCount;
+}
+
 // -----------------------------------------------------------------------
 // EngineOptions
 
@@ -214,6 +323,13 @@ EngineOptions::EngineOptions() noexcept
       fgColor(0xffffffff),
       uiScale(1.0f),
       maxParameters(MAX_DEFAULT_PARAMETERS),
+      processThreads(1),
+      rackLanes(1),
+      rackLaneInputs(0x1),
+      workerThreads(2),
+      meterWindow(300),
+      loaderThreads(1),
+      externalChunks(0),
       uiBridgesTimeout(4000),
       audioBufferSize(512),
       audioSampleRate(44100),
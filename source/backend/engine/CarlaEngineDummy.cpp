@@ -18,8 +18,13 @@
 #include "CarlaEngineGraph.hpp"
 #include "CarlaEngineInit.hpp"
 #include "CarlaEngineInternal.hpp"
+#include "CarlaSemUtils.hpp"
 #include "CarlaTimeUtils.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -32,17 +37,26 @@ public:
     CarlaEngineDummy()
         : CarlaEngine(),
           CarlaThread("CarlaEngineDummy"),
-          fRunning(false)
+          fRunning(false),
+          fFreewheel(false),
+          fFreewheelPeriods(0),
+          fFreewheelRendered(0),
+          fFreewheelTimes(nullptr),
+          fFreewheelTotalTime(0)
     {
         carla_debug("CarlaEngineDummy::CarlaEngineDummy()");
 
         // just to make sure
         pData->options.transportMode = ENGINE_TRANSPORT_MODE_INTERNAL;
+
+        carla_sem_create2(fFreewheelSem, false);
     }
 
     ~CarlaEngineDummy() override
     {
         carla_debug("CarlaEngineDummy::~CarlaEngineDummy()");
+
+        carla_sem_destroy2(fFreewheelSem);
     }
 
     // -------------------------------------
@@ -52,7 +66,7 @@ public:
         CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
         carla_debug("CarlaEngineDummy::init(\"%s\")", clientName);
 
-        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK && pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
         {
             setLastError("Invalid process mode");
             return false;
@@ -82,6 +96,9 @@ public:
 
         patchbayRefresh(true, false, false);
 
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            refreshExternalGraphPorts<PatchbayGraph>(pData->graph.getPatchbayGraph(), false, false);
+
         callback(true, true,
                  ENGINE_CALLBACK_ENGINE_STARTED,
                  0,
@@ -117,7 +134,7 @@ public:
 
     bool isOffline() const noexcept override
     {
-        return false;
+        return fFreewheel;
     }
 
     EngineType getType() const noexcept override
@@ -130,14 +147,95 @@ public:
         return "Dummy";
     }
 
+    bool renderFreewheel(const uint32_t periods, EngineFreewheelStats& stats) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(periods != 0, false);
+        carla_debug("CarlaEngineDummy::renderFreewheel(%u)", periods);
+
+        if (! fRunning || ! isThreadRunning())
+        {
+            setLastError("Engine is not running");
+            return false;
+        }
+
+        std::vector<uint32_t> times;
+
+        try {
+            times.resize(periods);
+        } CARLA_SAFE_EXCEPTION_RETURN("renderFreewheel times", false);
+
+        // the patchbay render order is usually updated from a timer, make sure it is current
+        if (PatchbayGraph* const graph = pData->graph.getPatchbayGraphOrNull())
+            graph->graph.reorderNowIfNeeded();
+
+        for (uint i=0; i < pData->curPluginCount; ++i)
+            pData->plugins[i].processTime = 0;
+
+        fFreewheel = true;
+        offlineModeChanged(true);
+        pData->timingPlugins = true;
+
+        fFreewheelTimes = times.data();
+        fFreewheelRendered = 0;
+
+        // a previous interrupted render could have left a post behind
+        drainFreewheelSem();
+
+        fFreewheelPeriods = periods;
+
+        // wait for the audio thread, which can take a while on heavy graphs
+        while (! carla_sem_timedwait(fFreewheelSem, 1000))
+        {
+            if (! isThreadRunning())
+            {
+                fFreewheelPeriods = 0;
+                drainFreewheelSem();
+                break;
+            }
+        }
+
+        pData->timingPlugins = false;
+        fFreewheelTimes = nullptr;
+        fFreewheel = false;
+        offlineModeChanged(false);
+
+        const uint32_t rendered = fFreewheelRendered;
+
+        if (rendered == 0)
+        {
+            setLastError("Freewheel render was interrupted");
+            return false;
+        }
+
+        times.resize(rendered);
+
+        uint64_t sum = 0;
+        for (uint32_t i=0; i < rendered; ++i)
+            sum += times[i];
+
+        std::sort(times.begin(), times.end());
+
+        stats.numPeriods    = rendered;
+        stats.totalTime     = fFreewheelTotalTime / 1000;
+        stats.minPeriodTime = times.front() / 1000;
+        stats.avgPeriodTime = static_cast<uint32_t>(sum / rendered / 1000);
+        stats.p50PeriodTime = times[rendered * 50 / 100] / 1000;
+        stats.p90PeriodTime = times[rendered * 90 / 100] / 1000;
+        stats.p99PeriodTime = times[rendered * 99 / 100] / 1000;
+        stats.maxPeriodTime = times.back() / 1000;
+        stats.realtimeFactor = fFreewheelTotalTime != 0
+                             ? static_cast<float>(static_cast<double>(rendered) * pData->bufferSize / pData->sampleRate
+                                                  * 1000000000.0 / static_cast<double>(fFreewheelTotalTime))
+                             : 0.0f;
+        return true;
+    }
+
     // -------------------------------------------------------------------
     // Patchbay
 
-    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool) override
+    template<class Graph>
+    bool refreshExternalGraphPorts(Graph* const graph, const bool sendHost, const bool sendOSC)
     {
-        CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
-
-        RackGraph* const graph = pData->graph.getRackGraph();
         CARLA_SAFE_ASSERT_RETURN(graph != nullptr, false);
 
         ExternalGraph& extGraph(graph->extGraph);
@@ -182,11 +280,29 @@ public:
         // now refresh
 
         if (sendHost || sendOSC)
-            graph->refresh(sendHost, sendOSC, false, "Dummy");
+            graph->refresh(sendHost, sendOSC, true, "Dummy");
 
         return true;
     }
 
+    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool external) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+            return refreshExternalGraphPorts<RackGraph>(pData->graph.getRackGraph(), sendHost, sendOSC);
+
+        if (sendHost)
+            pData->graph.setUsingExternalHost(external);
+        if (sendOSC)
+            pData->graph.setUsingExternalOSC(external);
+
+        if (external)
+            return refreshExternalGraphPorts<PatchbayGraph>(pData->graph.getPatchbayGraph(), sendHost, sendOSC);
+
+        return CarlaEngine::patchbayRefresh(sendHost, sendOSC, false);
+    }
+
     // -------------------------------------------------------------------
 
 protected:
@@ -220,24 +336,23 @@ protected:
 
         carla_zeroFloats(audioIns[0], bufferSize);
         carla_zeroFloats(audioIns[1], bufferSize);
-        carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
 
         int64_t oldTime, newTime;
 
         while (! shouldThreadExit())
         {
+            if (const uint32_t periods = fFreewheelPeriods)
+            {
+                runFreewheel(periods, audioIns, audioOuts);
+                continue;
+            }
+
             if (delay > 0)
                 carla_sleep(static_cast<uint>(delay));
 
             oldTime = carla_gettime_us();
 
-            const PendingRtEventsRunner prt(this, bufferSize, true);
-
-            carla_zeroFloats(audioOuts[0], bufferSize);
-            carla_zeroFloats(audioOuts[1], bufferSize);
-            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
-
-            pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+            processPeriod(audioIns, audioOuts, true);
 
             newTime = carla_gettime_us();
             CARLA_SAFE_ASSERT_CONTINUE(newTime >= oldTime);
@@ -265,11 +380,76 @@ protected:
         carla_stdout("CarlaEngineDummy audio thread finished with %u Xruns", pData->xruns);
     }
 
+    void processPeriod(float* audioIns[2], float* audioOuts[2], const bool calcDSPLoad)
+    {
+        const uint32_t bufferSize = pData->bufferSize;
+        const PendingRtEventsRunner prt(this, bufferSize, calcDSPLoad);
+
+        carla_zeroFloats(audioOuts[0], bufferSize);
+        carla_zeroFloats(audioOuts[1], bufferSize);
+        pData->events.in.clear();
+        pData->events.out.clear();
+
+        pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+    }
+
+    // render periods back-to-back, as requested by renderFreewheel()
+    void runFreewheel(const uint32_t periods, float* audioIns[2], float* audioOuts[2])
+    {
+        const uint32_t bufferSize = pData->bufferSize;
+
+        // feed low-level noise, so plugins do not take shortcuts on silence
+        uint32_t seed = 1;
+        for (uint32_t i=0; i<2; ++i)
+        {
+            for (uint32_t k=0; k<bufferSize; ++k)
+            {
+                seed = seed * 1664525 + 1013904223;
+                audioIns[i][k] = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.2f;
+            }
+        }
+
+        const uint64_t startTime = carla_gettime_ns();
+        uint64_t periodStartTime = startTime, periodEndTime;
+        uint32_t rendered = 0;
+
+        for (; rendered < periods && ! shouldThreadExit(); ++rendered)
+        {
+            processPeriod(audioIns, audioOuts, false);
+
+            periodEndTime = carla_gettime_ns();
+            fFreewheelTimes[rendered] = static_cast<uint32_t>(periodEndTime - periodStartTime);
+            periodStartTime = periodEndTime;
+        }
+
+        fFreewheelTotalTime = carla_gettime_ns() - startTime;
+        fFreewheelRendered = rendered;
+        fFreewheelPeriods = 0;
+
+        carla_zeroFloats(audioIns[0], bufferSize);
+        carla_zeroFloats(audioIns[1], bufferSize);
+
+        carla_sem_post(fFreewheelSem);
+    }
+
+    void drainFreewheelSem() noexcept
+    {
+        while (carla_sem_timedwait(fFreewheelSem, 0)) {}
+    }
+
     // -------------------------------------------------------------------
 
 private:
     bool fRunning;
 
+    // freewheel render state, set by renderFreewheel() before waking up the audio thread
+    std::atomic<bool> fFreewheel;
+    std::atomic<uint32_t> fFreewheelPeriods;
+    uint32_t fFreewheelRendered;
+    uint32_t* fFreewheelTimes; // per period, in nanoseconds
+    uint64_t fFreewheelTotalTime; // in nanoseconds
+    carla_sem_t fFreewheelSem;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineDummy)
 };
 
@@ -21,6 +21,7 @@
 
 #include "CarlaMathUtils.hpp"
 #include "CarlaScopeUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "CarlaMIDI.h"
 
@@ -831,28 +832,173 @@ void RackGraph::Buffers::setBufferSize(const uint32_t bufferSize, const bool cre
     }
 }
 
+#ifndef CARLA_OS_WASM
+// -----------------------------------------------------------------------
+// Thread pool stats, shared between rack and patchbay
+
+static bool fillProcessThreadsStats(const CarlaRtThreadPool& threadPool, EngineProcessThreadsStats& stats) noexcept
+{
+    CarlaRtThreadPoolStats poolStats;
+    threadPool.getStats(poolStats);
+
+    stats.numThreads = poolStats.numThreads;
+    stats.numTasks   = poolStats.numTasks;
+    stats.numSteals  = poolStats.numSteals;
+    stats.periodTime = poolStats.cycleTime;
+    stats.efficiency = poolStats.efficiency;
+
+    for (uint i=0; i<MAX_PROCESS_THREADS; ++i)
+    {
+        stats.tasksPerThread[i]    = i < kMaxRtThreadPoolThreads ? poolStats.tasksPerThread[i] : 0;
+        stats.busyTimePerThread[i] = i < kMaxRtThreadPoolThreads ? poolStats.busyTimePerThread[i] : 0;
+    }
+
+    return true;
+}
+#endif
+
+// -----------------------------------------------------------------------
+// RackGraph Lane
+
+RackGraph::Lane::Lane() noexcept
+    : unusedBuf(nullptr),
+      eventsIn(),
+      eventsOut(),
+      processed(false)
+{
+    inBufTmp[0] = inBufTmp[1] = nullptr;
+    outBuf[0]   = outBuf[1]   = nullptr;
+}
+
+RackGraph::Lane::~Lane() noexcept
+{
+    clear();
+
+    eventsIn.free();
+    eventsOut.free();
+}
+
+bool RackGraph::Lane::init() noexcept
+{
+    return eventsIn.alloc() && eventsOut.alloc();
+}
+
+void RackGraph::Lane::setBufferSize(const uint32_t bufferSize) noexcept
+{
+    clear();
+
+    CARLA_SAFE_ASSERT_RETURN(bufferSize > 0,);
+
+    try {
+        inBufTmp[0] = new float[bufferSize];
+        inBufTmp[1] = new float[bufferSize];
+        outBuf[0]   = new float[bufferSize];
+        outBuf[1]   = new float[bufferSize];
+        unusedBuf   = new float[bufferSize];
+    }
+    catch(...) {
+        clear();
+        return;
+    }
+
+    carla_zeroFloats(inBufTmp[0], bufferSize);
+    carla_zeroFloats(inBufTmp[1], bufferSize);
+    carla_zeroFloats(outBuf[0], bufferSize);
+    carla_zeroFloats(outBuf[1], bufferSize);
+}
+
+void RackGraph::Lane::clear() noexcept
+{
+    if (inBufTmp[0] != nullptr) { delete[] inBufTmp[0]; inBufTmp[0] = nullptr; }
+    if (inBufTmp[1] != nullptr) { delete[] inBufTmp[1]; inBufTmp[1] = nullptr; }
+    if (outBuf[0]   != nullptr) { delete[] outBuf[0];   outBuf[0]   = nullptr; }
+    if (outBuf[1]   != nullptr) { delete[] outBuf[1];   outBuf[1]   = nullptr; }
+    if (unusedBuf   != nullptr) { delete[] unusedBuf;   unusedBuf   = nullptr; }
+}
+
 // -----------------------------------------------------------------------
 // RackGraph
 
+// lanes are fully independent, so their task graph has no dependencies at all
+static const uint kRackLaneNoDependencies[MAX_PROCESS_THREADS + 1] = {};
+
+// processChain() lane for running all plugins, regardless of their lane
+static const uint kRackLaneAll = MAX_PROCESS_THREADS;
+
 RackGraph::RackGraph(CarlaEngine* const engine, const uint32_t ins, const uint32_t outs) noexcept
     : extGraph(engine),
       inputs(ins),
       outputs(outs),
       isOffline(false),
       audioBuffers(),
+#ifndef CARLA_OS_WASM
+      fThreadPool("Carla Rack Worker"),
+#endif
+      fLanes(nullptr),
+      fNumLanes(0),
+      fNumActiveLanes(0),
+      fProcessingLanes(false),
+      fLanesFallback(false),
+      fCurrentData(nullptr),
+      fCurrentInBuf(nullptr),
+      fCurrentFrames(0),
       kEngine(engine)
 {
+    carla_zeroStructs(fPluginLanes, MAX_RACK_PLUGINS);
+
+#ifndef CARLA_OS_WASM
+    const uint numLanes = engine->getOptions().rackLanes;
+
+    if (numLanes > 1 && numLanes <= MAX_PROCESS_THREADS)
+    {
+        try {
+            fLanes = new Lane[numLanes];
+        } CARLA_SAFE_EXCEPTION("RackGraph lanes");
+
+        bool ok = fLanes != nullptr;
+
+        for (uint i=0; ok && i<numLanes; ++i)
+            ok = fLanes[i].init();
+
+        if (ok && fThreadPool.start(numLanes, numLanes))
+        {
+            fNumLanes = numLanes;
+        }
+        else if (fLanes != nullptr)
+        {
+            carla_stderr2("RackGraph: failed to setup %u parallel lanes, using a single chain", numLanes);
+            delete[] fLanes;
+            fLanes = nullptr;
+        }
+    }
+#endif
+
     setBufferSize(engine->getBufferSize());
 }
 
 RackGraph::~RackGraph() noexcept
 {
+#ifndef CARLA_OS_WASM
+    fThreadPool.stop();
+#endif
+
+    if (fLanes != nullptr)
+    {
+        delete[] fLanes;
+        fLanes = nullptr;
+    }
+
     extGraph.clear();
 }
 
 void RackGraph::setBufferSize(const uint32_t bufferSize) noexcept
 {
+    const CarlaRecursiveMutexLocker cml(audioBuffers.mutex);
+
     audioBuffers.setBufferSize(bufferSize, (inputs > 0 || outputs > 0));
+
+    for (uint i=0; i<fNumLanes; ++i)
+        fLanes[i].setBufferSize(bufferSize);
 }
 
 void RackGraph::setOffline(const bool offline) noexcept
@@ -974,8 +1120,17 @@ bool RackGraph::getGroupAndPortIdFromFullName(const char* const fullPortName, ui
 void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inBufReal[2], float* outBufReal[2], const uint32_t frames)
 {
     CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(data->events.in != nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(data->events.out != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(data->events.in.data != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(data->events.out.data != nullptr,);
+
+    if (fNumLanes > 1)
+    {
+        // the lane layout is only changed while holding this lock
+        const CarlaRecursiveMutexTryLocker cmtl(audioBuffers.mutex);
+
+        if (cmtl.wasLocked() && setupLanes(data))
+            return processLanes(data, inBufReal, outBufReal, frames);
+    }
 
     // safe copy
     float* const dummyBuf = audioBuffers.unusedBuf;
@@ -991,8 +1146,16 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     carla_zeroFloats(outBufReal[1], frames);
 
     // initialize event outputs (zero)
-    carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
+    data->events.out.clear();
 
+    processChain(data, kRackLaneAll, inBuf0, inBuf1, dummyBuf, outBufReal, data->events.in, data->events.out, frames);
+}
+
+bool RackGraph::processChain(CarlaEngine::ProtectedData* const data, const uint lane,
+                             float* const inBuf0, float* const inBuf1, float* const dummyBuf,
+                             float* outBufReal[2], EngineEventBuffer& eventsIn, EngineEventBuffer& eventsOut,
+                             const uint32_t frames)
+{
     const float* inBuf[MAX_GRAPH_AUDIO_IO];
     float* outBuf[MAX_GRAPH_AUDIO_IO];
     float* cvBuf[MAX_GRAPH_CV_IO];
@@ -1002,41 +1165,61 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     uint32_t oldMidiOutCount  = 0;
     bool processed = false;
 
+    // peaks of the current audio inputs, found while copying them
+    float inPeaks[2] = { -1.0f, -1.0f };
+
     // process plugins
     for (uint i=0; i < data->curPluginCount; ++i)
     {
+        if (lane != kRackLaneAll && fPluginLanes[i] != lane)
+            continue;
+
         const CarlaPluginPtr plugin = data->plugins[i].plugin;
 
         if (plugin.get() == nullptr || ! plugin->isEnabled() || ! plugin->tryLock(isOffline))
             continue;
 
+        // only scan buffers for meters someone is watching
+        const uint meterTypes = kEngine->getPluginMeterTypesRT(i);
+        const bool meterPeaks = meterTypes & kEngineMeterPeak;
+
         if (processed)
         {
             // initialize audio inputs (from previous outputs)
-            carla_copyFloats(inBuf0, outBufReal[0], frames);
-            carla_copyFloats(inBuf1, outBufReal[1], frames);
+            if (meterPeaks)
+            {
+                inPeaks[0] = carla_copyFloatsFindMaxNormalized(inBuf0, outBufReal[0], frames);
+                inPeaks[1] = carla_copyFloatsFindMaxNormalized(inBuf1, outBufReal[1], frames);
+            }
+            else
+            {
+                carla_copyFloats(inBuf0, outBufReal[0], frames);
+                carla_copyFloats(inBuf1, outBufReal[1], frames);
+                inPeaks[0] = inPeaks[1] = 0.0f;
+            }
 
             // initialize audio outputs (zero)
             carla_zeroFloats(outBufReal[0], frames);
             carla_zeroFloats(outBufReal[1], frames);
 
             // if plugin has no midi out, add previous events
-            if (oldMidiOutCount == 0 && data->events.in[0].type != kEngineEventTypeNull)
+            if (oldMidiOutCount == 0 && eventsIn.count != 0)
             {
-                if (data->events.out[0].type != kEngineEventTypeNull)
+                // merge any events the plugin still wrote (like parameter outputs), sorted by time
+                if (eventsOut.count != 0)
                 {
-                    // TODO: carefully add to input, sorted events
-                    //carla_stderr("TODO midi event mixing here %s", plugin->getName());
+                    eventsIn.mergeFrom(eventsOut);
+                    eventsOut.clear();
                 }
                 // else nothing needed
             }
             else
             {
-                // initialize event inputs from previous outputs
-                carla_copyStructs(data->events.in, data->events.out, kMaxEngineEventInternalCount);
+                // initialize event inputs from previous outputs, swapping buffers instead of copying
+                eventsIn.swapWith(eventsOut);
 
                 // initialize event outputs (zero)
-                carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
+                eventsOut.clear();
             }
         }
 
@@ -1048,9 +1231,9 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
         const uint32_t numOutBufs = std::max(oldAudioOutCount, 2U);
         const uint32_t numCvBufs  = std::max(plugin->getCVInCount(), plugin->getCVOutCount());
 
-        CARLA_SAFE_ASSERT_RETURN(numInBufs <= MAX_GRAPH_AUDIO_IO, plugin->unlock());
-        CARLA_SAFE_ASSERT_RETURN(numOutBufs <= MAX_GRAPH_AUDIO_IO, plugin->unlock());
-        CARLA_SAFE_ASSERT_RETURN(numCvBufs <= MAX_GRAPH_CV_IO, plugin->unlock());
+        CARLA_SAFE_ASSERT_RETURN(numInBufs <= MAX_GRAPH_AUDIO_IO, (plugin->unlock(), processed));
+        CARLA_SAFE_ASSERT_RETURN(numOutBufs <= MAX_GRAPH_AUDIO_IO, (plugin->unlock(), processed));
+        CARLA_SAFE_ASSERT_RETURN(numCvBufs <= MAX_GRAPH_CV_IO, (plugin->unlock(), processed));
 
         inBuf[0] = inBuf0;
         inBuf[1] = inBuf1;
@@ -1072,55 +1255,300 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
                 outBuf[j] = dummyBuf;
         }
 
+        EnginePluginData& pluginData(data->plugins[i]);
+
         // process
+        const uint64_t processStartTime = data->timingPlugins ? carla_gettime_ns() : 0;
+
         plugin->initBuffers();
         plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
         plugin->unlock();
 
-        // if plugin has no audio inputs, add input buffer
-        if (oldAudioInCount == 0)
+        if (data->timingPlugins)
+            pluginData.processTime += carla_gettime_ns() - processStartTime;
+
+        // set input peaks
+        if (oldAudioInCount > 0 && meterPeaks)
         {
-            carla_addFloats(outBufReal[0], inBuf0, frames);
-            carla_addFloats(outBufReal[1], inBuf1, frames);
-        }
+            // first plugin in the chain, inputs were copied by the caller
+            if (inPeaks[0] < 0.0f)
+            {
+                inPeaks[0] = carla_findMaxNormalizedFloat(inBuf0, frames);
+                inPeaks[1] = carla_findMaxNormalizedFloat(inBuf1, frames);
+            }
 
-        // if plugin only has 1 output, copy it to the 2nd
-        if (oldAudioOutCount == 1)
+            pluginData.peaks[0] = inPeaks[0];
+            pluginData.peaks[1] = inPeaks[1];
+        }
+        else
         {
-            carla_copyFloats(outBufReal[1], outBufReal[0], frames);
+            pluginData.peaks[0] = 0.0f;
+            pluginData.peaks[1] = 0.0f;
         }
 
-        // set peaks
-        {
-            EnginePluginData& pluginData(data->plugins[i]);
+        if (meterTypes & (kEngineMeterRms|kEngineMeterTruePeak))
+            kEngine->processPluginMetersRT(i, false,
+                                           oldAudioInCount > 0 ? inBuf0 : nullptr,
+                                           oldAudioInCount > 0 ? inBuf1 : nullptr,
+                                           frames, meterTypes);
 
-            if (oldAudioInCount > 0)
+        // set output peaks, while adding input buffer if plugin has no audio inputs,
+        // or copying the 1st output to the 2nd if plugin only has 1 output
+        if (! meterPeaks)
+        {
+            if (oldAudioInCount == 0)
             {
-                pluginData.peaks[0] = carla_findMaxNormalizedFloat(inBuf0, frames);
-                pluginData.peaks[1] = carla_findMaxNormalizedFloat(inBuf1, frames);
+                carla_addFloats(outBufReal[0], inBuf0, frames);
+
+                if (oldAudioOutCount == 1)
+                    carla_copyFloats(outBufReal[1], outBufReal[0], frames);
+                else
+                    carla_addFloats(outBufReal[1], inBuf1, frames);
             }
-            else
+            else if (oldAudioOutCount == 1)
             {
-                pluginData.peaks[0] = 0.0f;
-                pluginData.peaks[1] = 0.0f;
+                carla_copyFloats(outBufReal[1], outBufReal[0], frames);
             }
 
-            if (oldAudioOutCount > 0)
-            {
-                pluginData.peaks[2] = carla_findMaxNormalizedFloat(outBufReal[0], frames);
-                pluginData.peaks[3] = carla_findMaxNormalizedFloat(outBufReal[1], frames);
-            }
+            pluginData.peaks[2] = 0.0f;
+            pluginData.peaks[3] = 0.0f;
+        }
+        else if (oldAudioInCount == 0)
+        {
+            pluginData.peaks[2] = carla_addFloatsFindMaxNormalized(outBufReal[0], inBuf0, frames);
+
+            if (oldAudioOutCount == 1)
+                pluginData.peaks[3] = carla_copyFloatsFindMaxNormalized(outBufReal[1], outBufReal[0], frames);
             else
+                pluginData.peaks[3] = carla_addFloatsFindMaxNormalized(outBufReal[1], inBuf1, frames);
+
+            if (oldAudioOutCount == 0)
+                pluginData.peaks[2] = pluginData.peaks[3] = 0.0f;
+        }
+        else if (oldAudioOutCount == 1)
+        {
+            pluginData.peaks[2] = pluginData.peaks[3]
+                                = carla_copyFloatsFindMaxNormalized(outBufReal[1], outBufReal[0], frames);
+        }
+        else if (oldAudioOutCount > 0)
+        {
+            pluginData.peaks[2] = carla_findMaxNormalizedFloat(outBufReal[0], frames);
+            pluginData.peaks[3] = carla_findMaxNormalizedFloat(outBufReal[1], frames);
+        }
+        else
+        {
+            pluginData.peaks[2] = 0.0f;
+            pluginData.peaks[3] = 0.0f;
+        }
+
+        if (meterTypes & (kEngineMeterRms|kEngineMeterTruePeak))
+            kEngine->processPluginMetersRT(i, true,
+                                           oldAudioOutCount > 0 ? outBufReal[0] : nullptr,
+                                           oldAudioOutCount > 0 ? outBufReal[1] : nullptr,
+                                           frames, meterTypes);
+
+        processed = true;
+    }
+
+    return processed;
+}
+
+void RackGraph::updateLanes(const CarlaEngine::ProtectedData* const data) noexcept
+{
+    // lanes are assigned again on every cycle, this only reports the ones that cannot be used
+    const CarlaPlugin* missingLanePlugin = nullptr;
+
+    for (uint i=0; i < data->curPluginCount; ++i)
+    {
+        const CarlaPlugin* const plugin = data->plugins[i].plugin.get();
+
+        if (plugin != nullptr && plugin->getRackLane() != 0 && plugin->getRackLane() >= fNumLanes)
+        {
+            missingLanePlugin = plugin;
+            break;
+        }
+    }
+
+    if (missingLanePlugin != nullptr && ! fLanesFallback)
+        carla_stderr2("RackGraph: plugin '%s' is assigned to rack lane %u, but only %u lanes are available, "
+                      "running the whole rack serially",
+                      missingLanePlugin->getName(), missingLanePlugin->getRackLane(), std::max(fNumLanes, 1U));
+
+    fLanesFallback = missingLanePlugin != nullptr;
+}
+
+bool RackGraph::setupLanes(const CarlaEngine::ProtectedData* const data) noexcept
+{
+    const uint numPlugins = data->curPluginCount;
+    CARLA_SAFE_ASSERT_RETURN(numPlugins <= MAX_RACK_PLUGINS, false);
+
+    uint numActiveLanes = 1;
+
+    for (uint i=0; i < numPlugins; ++i)
+    {
+        const CarlaPlugin* const plugin = data->plugins[i].plugin.get();
+        const uint lane = plugin != nullptr ? plugin->getRackLane() : 0;
+
+        // a plugin wants a lane we do not have, keep the serial chain instead of guessing
+        if (lane >= fNumLanes)
+            return false;
+
+        fPluginLanes[i] = static_cast<uint8_t>(lane);
+
+        if (lane >= numActiveLanes)
+            numActiveLanes = lane + 1;
+    }
+
+    if (numActiveLanes < 2)
+        return false;
+
+    fNumActiveLanes = numActiveLanes;
+    return true;
+}
+
+void RackGraph::processLanes(CarlaEngine::ProtectedData* const data, const float* inBufReal[2], float* outBufReal[2], const uint32_t frames)
+{
+    const uint numLanes = fNumActiveLanes;
+
+    fCurrentData     = data;
+    fCurrentInBuf    = inBufReal;
+    fCurrentFrames   = frames;
+    fProcessingLanes = true;
+
+#ifndef CARLA_OS_WASM
+    const CarlaRtTaskGraph taskGraph = {
+        numLanes,
+        kRackLaneNoDependencies,
+        kRackLaneNoDependencies,
+        kRackLaneNoDependencies
+    };
+
+    if (! fThreadPool.process(taskGraph, *this))
+#endif
+    {
+        for (uint i=0; i<numLanes; ++i)
+            processLane(i);
+    }
+
+    fProcessingLanes = false;
+    fCurrentData     = nullptr;
+    fCurrentInBuf    = nullptr;
+    fCurrentFrames   = 0;
+
+    // sum lane outputs, lanes where no plugin ran are silent, same as an empty serial chain
+    carla_zeroFloats(outBufReal[0], frames);
+    carla_zeroFloats(outBufReal[1], frames);
+
+    for (uint i=0; i<numLanes; ++i)
+    {
+        if (! fLanes[i].processed)
+            continue;
+
+        carla_addFloats(outBufReal[0], fLanes[i].outBuf[0], frames);
+        carla_addFloats(outBufReal[1], fLanes[i].outBuf[1], frames);
+    }
+
+    // merge lane event outputs by time, earlier lanes first on ties
+    uint32_t laneEventIndex[MAX_PROCESS_THREADS] = {};
+
+    EngineEventBuffer& eventsOut(data->events.out);
+    eventsOut.clear();
+
+    for (;;)
+    {
+        const EngineEvent* next = nullptr;
+        uint nextLane = 0;
+
+        for (uint i=0; i<numLanes; ++i)
+        {
+            const EngineEventBuffer& laneEvents(fLanes[i].eventsOut);
+
+            if (laneEventIndex[i] >= laneEvents.count)
+                continue;
+
+            const EngineEvent& event(laneEvents.data[laneEventIndex[i]]);
+
+            if (next == nullptr || event.time < next->time)
             {
-                pluginData.peaks[2] = 0.0f;
-                pluginData.peaks[3] = 0.0f;
+                next = &event;
+                nextLane = i;
             }
         }
 
-        processed = true;
+        if (next == nullptr)
+            break;
+
+        EngineEvent* const event = eventsOut.append();
+
+        if (event == nullptr)
+            break;
+
+        *event = *next;
+        ++laneEventIndex[nextLane];
     }
 }
 
+EngineEventBuffer* RackGraph::getLaneEventBuffer(const uint pluginId, const bool isInput) const noexcept
+{
+    if (! fProcessingLanes || pluginId >= MAX_RACK_PLUGINS)
+        return nullptr;
+
+    Lane& lane(fLanes[fPluginLanes[pluginId]]);
+
+    return isInput ? &lane.eventsIn : &lane.eventsOut;
+}
+
+void RackGraph::processLane(const uint index) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(index < fNumActiveLanes,);
+
+    Lane& lane(fLanes[index]);
+    const uint32_t frames = fCurrentFrames;
+
+    // each lane starts from the rack inputs or from silence, as declared in the engine options
+    if (fCurrentData->options.rackLaneInputs & (1U << index))
+    {
+        carla_copyFloats(lane.inBufTmp[0], fCurrentInBuf[0], frames);
+        carla_copyFloats(lane.inBufTmp[1], fCurrentInBuf[1], frames);
+    }
+    else
+    {
+        carla_zeroFloats(lane.inBufTmp[0], frames);
+        carla_zeroFloats(lane.inBufTmp[1], frames);
+    }
+
+    lane.eventsIn.copyFrom(fCurrentData->events.in);
+
+    carla_zeroFloats(lane.outBuf[0], frames);
+    carla_zeroFloats(lane.outBuf[1], frames);
+    lane.eventsOut.clear();
+
+    lane.processed = processChain(fCurrentData, index,
+                                  lane.inBufTmp[0], lane.inBufTmp[1], lane.unusedBuf,
+                                  lane.outBuf, lane.eventsIn, lane.eventsOut, frames);
+}
+
+#ifndef CARLA_OS_WASM
+void RackGraph::runTask(const uint taskIndex) noexcept
+{
+    processLane(taskIndex);
+}
+#endif
+
+bool RackGraph::getProcessThreadsStats(EngineProcessThreadsStats& stats) const noexcept
+{
+#ifndef CARLA_OS_WASM
+    if (fNumLanes <= 1)
+        return false;
+
+    return fillProcessThreadsStats(fThreadPool, stats);
+#else
+    return false;
+    // unused
+    (void)stats;
+#endif
+}
+
 void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
 {
     CARLA_SAFE_ASSERT_RETURN(audioBuffers.outBuf[1] != nullptr,);
@@ -1496,7 +1924,8 @@ class CarlaPluginInstance : public AudioProcessor
 public:
     CarlaPluginInstance(CarlaEngine* const engine, const CarlaPluginPtr plugin)
         : kEngine(engine),
-          fPlugin(plugin)
+          fPlugin(plugin),
+          fBlock()
     {
         CarlaEngineClient* const client = plugin->getEngineClient();
 
@@ -1554,102 +1983,76 @@ public:
     {
         const CarlaPluginPtr plugin = fPlugin;
 
-        if (plugin.get() == nullptr || !plugin->isEnabled() || !plugin->tryLock(kEngine->isOffline()))
-        {
-            audio.clear();
-            cvOut.clear();
-            midi.clear();
+        if (! prepareBlock(plugin, audio, cvIn, cvOut, midi))
             return;
-        }
 
-        if (CarlaEngineEventPort* const port = plugin->getDefaultEventInPort())
-        {
-            EngineEvent* const engineEvents(port->fBuffer);
-            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
+        const bool timing = kEngine->isTimingPluginsRT();
+        const uint64_t processStartTime = timing ? carla_gettime_ns() : 0;
 
-            carla_zeroStructs(engineEvents, kMaxEngineEventInternalCount);
-            fillEngineEventsFromWaterMidiBuffer(engineEvents, midi);
-        }
+        plugin->process(fBlock.audioIn(), fBlock.audioOut(), fBlock.cvIn(), fBlock.cvOut(), fBlock.numSamples);
 
-        midi.clear();
+        if (timing)
+            kEngine->addPluginProcessTimeRT(plugin->getId(), carla_gettime_ns() - processStartTime);
 
-        plugin->initBuffers();
+        completeBlock(plugin, audio, midi);
+    }
 
-        const uint32_t numSamples   = audio.getNumSamples();
-        const uint32_t numAudioChan = audio.getNumChannels();
-        const uint32_t numCVInChan  = cvIn.getNumChannels();
-        const uint32_t numCVOutChan = cvOut.getNumChannels();
+    bool canStartBlocks() const override
+    {
+        const CarlaPluginPtr plugin = fPlugin;
 
-        if (numAudioChan+numCVInChan+numCVOutChan == 0)
-        {
-            // nothing to process
-            plugin->process(nullptr, nullptr, nullptr, nullptr, numSamples);
-        }
-        else if (numAudioChan != 0)
-        {
-            // processing audio, include code for peaks
-            const uint32_t numChan2 = jmin(numAudioChan, 2U);
-
-            if (plugin->getAudioInCount() == 0)
-                audio.clear();
-
-            float* audioBuffers[MAX_GRAPH_AUDIO_IO];
-            float* cvOutBuffers[MAX_GRAPH_CV_IO];
-            const float* cvInBuffers[MAX_GRAPH_CV_IO];
-            CARLA_SAFE_ASSERT_RETURN(numAudioChan <= MAX_GRAPH_AUDIO_IO, plugin->unlock());
-            CARLA_SAFE_ASSERT_RETURN(numCVOutChan <= MAX_GRAPH_CV_IO, plugin->unlock());
-            CARLA_SAFE_ASSERT_RETURN(numCVInChan <= MAX_GRAPH_CV_IO, plugin->unlock());
-
-            for (uint32_t i=0; i<numAudioChan; ++i)
-                audioBuffers[i] = audio.getWritePointer(i);
-            for (uint32_t i=0; i<numCVOutChan; ++i)
-                cvOutBuffers[i] = cvOut.getWritePointer(i);
-            for (uint32_t i=0; i<numCVInChan; ++i)
-                cvInBuffers[i] = cvIn.getReadPointer(i);
-
-            float inPeaks[2] = { 0.0f };
-            float outPeaks[2] = { 0.0f };
+        return plugin.get() != nullptr && plugin->canProcessAsync();
+    }
 
-            for (uint32_t i=0, count=jmin(plugin->getAudioInCount(), numChan2); i<count; ++i)
-                inPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+    bool startBlockWithCV(AudioSampleBuffer& audio,
+                          const AudioSampleBuffer& cvIn,
+                          AudioSampleBuffer& cvOut,
+                          MidiBuffer& midi) override
+    {
+        const CarlaPluginPtr plugin = fPlugin;
 
-            plugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
-                            cvInBuffers, cvOutBuffers,
-                            numSamples);
+        if (plugin.get() == nullptr || ! plugin->canProcessAsync())
+            return false;
 
-            for (uint32_t i=0, count=jmin(plugin->getAudioOutCount(), numChan2); i<count; ++i)
-                outPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+        fBlock.started = prepareBlock(plugin, audio, cvIn, cvOut, midi);
 
-            kEngine->setPluginPeaksRT(plugin->getId(), inPeaks, outPeaks);
-        }
-        else
+        if (fBlock.started)
         {
-            // processing CV only, skip audiopeaks
-            float* cvOutBuffers[MAX_GRAPH_CV_IO];
-            const float* cvInBuffers[MAX_GRAPH_CV_IO];
+            // only the host side of async processing is timed
+            const bool timing = kEngine->isTimingPluginsRT();
+            const uint64_t processStartTime = timing ? carla_gettime_ns() : 0;
 
-            for (uint32_t i=0; i<numCVOutChan; ++i)
-                cvOutBuffers[i] = cvOut.getWritePointer(i);
-            for (uint32_t i=0; i<numCVInChan; ++i)
-                cvInBuffers[i] = cvIn.getReadPointer(i);
+            plugin->processStart(fBlock.audioIn(), fBlock.audioOut(), fBlock.cvIn(), fBlock.cvOut(), fBlock.numSamples);
 
-            plugin->process(nullptr, nullptr,
-                            cvInBuffers, cvOutBuffers,
-                            numSamples);
+            if (timing)
+                kEngine->addPluginProcessTimeRT(plugin->getId(), carla_gettime_ns() - processStartTime);
         }
 
-        midi.clear();
+        return true;
+    }
 
-        if (CarlaEngineEventPort* const port = plugin->getDefaultEventOutPort())
-        {
-            /*const*/ EngineEvent* const engineEvents(port->fBuffer);
-            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
+    void finishBlockWithCV(AudioSampleBuffer& audio,
+                           const AudioSampleBuffer&,
+                           AudioSampleBuffer&,
+                           MidiBuffer& midi) override
+    {
+        if (! fBlock.started)
+            return;
 
-            fillWaterMidiBufferFromEngineEvents(midi, engineEvents);
-            carla_zeroStructs(engineEvents, kMaxEngineEventInternalCount);
-        }
+        fBlock.started = false;
 
-        plugin->unlock();
+        const CarlaPluginPtr plugin = fPlugin;
+        CARLA_SAFE_ASSERT_RETURN(plugin.get() != nullptr,);
+
+        const bool timing = kEngine->isTimingPluginsRT();
+        const uint64_t processStartTime = timing ? carla_gettime_ns() : 0;
+
+        plugin->processFinish();
+
+        if (timing)
+            kEngine->addPluginProcessTimeRT(plugin->getId(), carla_gettime_ns() - processStartTime);
+
+        completeBlock(plugin, audio, midi);
     }
 
     const String getInputChannelName(ChannelType t, uint i) const override
@@ -1715,6 +2118,161 @@ private:
     CarlaEngine* const kEngine;
     CarlaPluginPtr fPlugin;
 
+    // buffers of the block being processed, kept between startBlockWithCV() and finishBlockWithCV()
+    struct BlockState {
+        enum Kind {
+            kNothing,
+            kAudio,
+            kCVOnly
+        } kind;
+        bool started;
+        uint32_t numSamples;
+        float* audioBuffers[MAX_GRAPH_AUDIO_IO];
+        const float* cvInBuffers[MAX_GRAPH_CV_IO];
+        float* cvOutBuffers[MAX_GRAPH_CV_IO];
+        float inPeaks[2];
+        uint meterTypes;
+
+        const float* const* audioIn() const noexcept { return kind == kAudio ? audioBuffers : nullptr; }
+        float** audioOut() noexcept { return kind == kAudio ? audioBuffers : nullptr; }
+        const float* const* cvIn() const noexcept { return kind != kNothing ? cvInBuffers : nullptr; }
+        float** cvOut() noexcept { return kind != kNothing ? cvOutBuffers : nullptr; }
+    } fBlock;
+
+    // locks the plugin and sets up its inputs, returns false if the block was cleared instead
+    bool prepareBlock(const CarlaPluginPtr& plugin,
+                      AudioSampleBuffer& audio,
+                      const AudioSampleBuffer& cvIn,
+                      AudioSampleBuffer& cvOut,
+                      MidiBuffer& midi)
+    {
+        if (plugin.get() == nullptr || !plugin->isEnabled() || !plugin->tryLock(kEngine->isOffline()))
+        {
+            audio.clear();
+            cvOut.clear();
+            midi.clear();
+            return false;
+        }
+
+        if (CarlaEngineEventPort* const port = plugin->getDefaultEventInPort())
+        {
+            EngineEventBuffer* const engineEvents(port->fBuffer);
+
+            if (engineEvents == nullptr)
+            {
+                carla_safe_assert("engineEvents != nullptr", __FILE__, __LINE__);
+                plugin->unlock();
+                return false;
+            }
+
+            engineEvents->clear();
+            fillEngineEventsFromWaterMidiBuffer(*engineEvents, midi);
+        }
+
+        midi.clear();
+
+        plugin->initBuffers();
+
+        const uint32_t numSamples   = audio.getNumSamples();
+        const uint32_t numAudioChan = audio.getNumChannels();
+        const uint32_t numCVInChan  = cvIn.getNumChannels();
+        const uint32_t numCVOutChan = cvOut.getNumChannels();
+
+        fBlock.numSamples = numSamples;
+        fBlock.inPeaks[0] = fBlock.inPeaks[1] = 0.0f;
+
+        if (numAudioChan+numCVInChan+numCVOutChan == 0)
+        {
+            // nothing to process
+            fBlock.kind = BlockState::kNothing;
+            return true;
+        }
+
+        if (numAudioChan > MAX_GRAPH_AUDIO_IO || numCVOutChan > MAX_GRAPH_CV_IO || numCVInChan > MAX_GRAPH_CV_IO)
+        {
+            carla_safe_assert("channel count <= MAX_GRAPH_IO", __FILE__, __LINE__);
+            plugin->unlock();
+            return false;
+        }
+
+        for (uint32_t i=0; i<numCVOutChan; ++i)
+            fBlock.cvOutBuffers[i] = cvOut.getWritePointer(i);
+        for (uint32_t i=0; i<numCVInChan; ++i)
+            fBlock.cvInBuffers[i] = cvIn.getReadPointer(i);
+
+        if (numAudioChan == 0)
+        {
+            // processing CV only, skip audiopeaks
+            fBlock.kind = BlockState::kCVOnly;
+            return true;
+        }
+
+        // processing audio, include code for peaks
+        fBlock.kind = BlockState::kAudio;
+
+        if (plugin->getAudioInCount() == 0)
+            audio.clear();
+
+        for (uint32_t i=0; i<numAudioChan; ++i)
+            fBlock.audioBuffers[i] = audio.getWritePointer(i);
+
+        // only scan buffers for meters someone is watching
+        const uint meterTypes = fBlock.meterTypes = kEngine->getPluginMeterTypesRT(plugin->getId());
+        const uint32_t numInPeaks = jmin(plugin->getAudioInCount(), jmin(numAudioChan, 2U));
+
+        if (meterTypes & kEngineMeterPeak)
+        {
+            for (uint32_t i=0; i<numInPeaks; ++i)
+                fBlock.inPeaks[i] = carla_findMaxNormalizedFloat(fBlock.audioBuffers[i], numSamples);
+        }
+
+        // audio is processed in place, so inputs must be metered now
+        if (meterTypes & (kEngineMeterRms|kEngineMeterTruePeak))
+            kEngine->processPluginMetersRT(plugin->getId(), false,
+                                           numInPeaks > 0 ? fBlock.audioBuffers[0] : nullptr,
+                                           numInPeaks > 1 ? fBlock.audioBuffers[1] : nullptr,
+                                           numSamples, meterTypes);
+
+        return true;
+    }
+
+    // handles outputs and unlocks the plugin, after a successful prepareBlock()
+    void completeBlock(const CarlaPluginPtr& plugin, AudioSampleBuffer& audio, MidiBuffer& midi)
+    {
+        if (fBlock.kind == BlockState::kAudio)
+        {
+            const uint32_t numOutPeaks = jmin(plugin->getAudioOutCount(), jmin(audio.getNumChannels(), 2U));
+            float outPeaks[2] = { 0.0f };
+
+            if (fBlock.meterTypes & kEngineMeterPeak)
+            {
+                for (uint32_t i=0; i<numOutPeaks; ++i)
+                    outPeaks[i] = carla_findMaxNormalizedFloat(fBlock.audioBuffers[i], fBlock.numSamples);
+            }
+
+            kEngine->setPluginPeaksRT(plugin->getId(), fBlock.inPeaks, outPeaks);
+
+            if (fBlock.meterTypes & (kEngineMeterRms|kEngineMeterTruePeak))
+                kEngine->processPluginMetersRT(plugin->getId(), true,
+                                               numOutPeaks > 0 ? fBlock.audioBuffers[0] : nullptr,
+                                               numOutPeaks > 1 ? fBlock.audioBuffers[1] : nullptr,
+                                               fBlock.numSamples, fBlock.meterTypes);
+        }
+
+        midi.clear();
+
+        if (CarlaEngineEventPort* const port = plugin->getDefaultEventOutPort())
+        {
+            EngineEventBuffer* const engineEvents(port->fBuffer);
+            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr, plugin->unlock());
+
+            fillWaterMidiBufferFromEngineEvents(midi, *engineEvents);
+            engineEvents->clear();
+        }
+
+        plugin->unlock();
+    }
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginInstance)
 };
 
@@ -1777,6 +2335,10 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine,
       usingExternalHost(false),
       usingExternalOSC(false),
       extGraph(engine),
+#ifndef CARLA_OS_WASM
+      fThreadPool("Carla Patchbay Worker"),
+      fGraphBeingRendered(nullptr),
+#endif
       kEngine(engine)
 {
     const uint32_t bufferSize(engine->getBufferSize());
@@ -1896,6 +2458,14 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine,
         node->properties.isOSC = false;
     }
 
+#ifndef CARLA_OS_WASM
+    if (const uint numThreads = engine->getOptions().processThreads)
+    {
+        if (numThreads > 1 && fThreadPool.start(numThreads, 0))
+            graph.setParallelRenderer(this);
+    }
+#endif
+
     startRunner(100);
 }
 
@@ -1903,6 +2473,11 @@ PatchbayGraph::~PatchbayGraph()
 {
     stopRunner();
 
+#ifndef CARLA_OS_WASM
+    graph.setParallelRenderer(nullptr);
+    fThreadPool.stop();
+#endif
+
     connections.clear();
     extGraph.clear();
 
@@ -2592,8 +3167,8 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
                             const uint32_t frames)
 {
     CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(data->events.in != nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(data->events.out != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(data->events.in.data != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(data->events.out.data != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(frames > 0,);
 
     // put events in water buffer
@@ -2648,18 +3223,62 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
 
     // put water events in carla buffer
     {
-        carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
+        data->events.out.clear();
         fillEngineEventsFromWaterMidiBuffer(data->events.out, midiBuffer);
         midiBuffer.clear();
     }
 }
 
+bool PatchbayGraph::getProcessThreadsStats(EngineProcessThreadsStats& stats) const noexcept
+{
+#ifndef CARLA_OS_WASM
+    if (fThreadPool.getNumThreads() <= 1)
+        return false;
+
+    return fillProcessThreadsStats(fThreadPool, stats);
+#else
+    return false;
+    // unused
+    (void)stats;
+#endif
+}
+
 bool PatchbayGraph::run()
 {
     graph.reorderNowIfNeeded();
     return true;
 }
 
+#ifndef CARLA_OS_WASM
+void PatchbayGraph::prepareRenderingSequence(const uint numOps)
+{
+    if (! fThreadPool.reserve(numOps))
+        carla_stderr2("PatchbayGraph::prepareRenderingSequence(%u) - failed to reserve thread pool tasks", numOps);
+}
+
+bool PatchbayGraph::performRenderingSequence(AudioProcessorGraph& g,
+                                             const AudioProcessorGraph::RenderingOpDependencies& deps) noexcept
+{
+    const CarlaRtTaskGraph taskGraph = {
+        static_cast<uint>(deps.numDependencies.size()),
+        deps.numDependencies.begin(),
+        deps.successorOffsets.begin(),
+        deps.successors.begin()
+    };
+
+    fGraphBeingRendered = &g;
+    const bool ok = fThreadPool.process(taskGraph, *this);
+    fGraphBeingRendered = nullptr;
+
+    return ok;
+}
+
+void PatchbayGraph::runTask(const uint taskIndex) noexcept
+{
+    fGraphBeingRendered->performRenderingOp(taskIndex);
+}
+#endif
+
 // -----------------------------------------------------------------------
 // InternalGraph
 
@@ -2786,6 +3405,20 @@ PatchbayGraph* EngineInternalGraph::getPatchbayGraphOrNull() const noexcept
     return fIsRack ? nullptr : fPatchbay;
 }
 
+EngineEventBuffer* EngineInternalGraph::getRackLaneEventBuffer(const uint pluginId, const bool isInput) const noexcept
+{
+    if (! fIsRack || fRack == nullptr)
+        return nullptr;
+
+    return fRack->getLaneEventBuffer(pluginId, isInput);
+}
+
+void EngineInternalGraph::updateRackLanes(const CarlaEngine::ProtectedData* const data) noexcept
+{
+    if (fIsRack && fRack != nullptr)
+        fRack->updateLanes(data);
+}
+
 void EngineInternalGraph::process(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
 {
     if (fIsRack)
@@ -2976,6 +3609,24 @@ bool CarlaEngine::patchbayRefresh(const bool sendHost, const bool sendOSC, const
     return false;
 }
 
+bool CarlaEngine::getProcessThreadsStats(EngineProcessThreadsStats& stats) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
+
+    if (pData->graph.isRack())
+    {
+        RackGraph* const graph = pData->graph.getRackGraph();
+        CARLA_SAFE_ASSERT_RETURN(graph != nullptr, false);
+
+        return graph->getProcessThreadsStats(stats);
+    }
+
+    if (PatchbayGraph* const graph = pData->graph.getPatchbayGraphOrNull())
+        return graph->getProcessThreadsStats(stats);
+
+    return false;
+}
+
 // -----------------------------------------------------------------------
 // Patchbay stuff
 
@@ -24,6 +24,10 @@
 #include "CarlaStringList.hpp"
 #include "CarlaRunner.hpp"
 
+#ifndef CARLA_OS_WASM
+# include "CarlaRtThreadPool.hpp"
+#endif
+
 #include "water/processors/AudioProcessorGraph.h"
 #include "water/text/StringArray.h"
 
@@ -115,7 +119,11 @@ struct ExternalGraph {
 // -----------------------------------------------------------------------
 // RackGraph
 
-struct RackGraph {
+struct RackGraph
+#ifndef CARLA_OS_WASM
+    : private CarlaRtTaskRunner
+#endif
+{
     ExternalGraph extGraph;
     const uint32_t inputs;
     const uint32_t outputs;
@@ -138,6 +146,22 @@ struct RackGraph {
         CARLA_DECLARE_NON_COPYABLE(Buffers)
     } audioBuffers;
 
+    // a parallel lane, running the plugins assigned to it as a serial chain with its own buffers
+    struct Lane {
+        float* inBufTmp[2];
+        float* outBuf[2];
+        float* unusedBuf;
+        EngineEventBuffer eventsIn;
+        EngineEventBuffer eventsOut;
+        bool processed;
+        Lane() noexcept;
+        ~Lane() noexcept;
+        bool init() noexcept;
+        void setBufferSize(uint32_t bufferSize) noexcept;
+        void clear() noexcept;
+        CARLA_DECLARE_NON_COPYABLE(Lane)
+    };
+
     RackGraph(CarlaEngine* engine, uint32_t inputs, uint32_t outputs) noexcept;
     ~RackGraph() noexcept;
 
@@ -157,6 +181,48 @@ struct RackGraph {
     // extended, will call process() in the middle
     void processHelper(CarlaEngine::ProtectedData* data, const float* const* inBuf, float* const* outBuf, uint32_t frames);
 
+    // check the lanes plugins are assigned to, called when the plugin list or lane assignments change
+    void updateLanes(const CarlaEngine::ProtectedData* data) noexcept;
+
+    // event buffer of the lane a plugin belongs to, null if not processing lanes
+    EngineEventBuffer* getLaneEventBuffer(uint pluginId, bool isInput) const noexcept;
+
+    bool getProcessThreadsStats(EngineProcessThreadsStats& stats) const noexcept;
+
+private:
+    // process the plugins of @a lane (or all of them) as a serial chain, returns false if none of them ran
+    bool processChain(CarlaEngine::ProtectedData* data, uint lane,
+                      float* inBuf0, float* inBuf1, float* dummyBuf,
+                      float* outBufReal[2], EngineEventBuffer& eventsIn, EngineEventBuffer& eventsOut, uint32_t frames);
+
+    bool setupLanes(const CarlaEngine::ProtectedData* data) noexcept;
+    void processLanes(CarlaEngine::ProtectedData* data, const float* inBufReal[2], float* outBufReal[2], uint32_t frames);
+    void processLane(uint index) noexcept;
+
+#ifndef CARLA_OS_WASM
+    // CarlaRtTaskRunner
+    void runTask(uint taskIndex) noexcept override;
+
+    CarlaRtThreadPool fThreadPool;
+#endif
+
+    Lane* fLanes;
+    uint fNumLanes;
+
+    // current cycle layout, set by setupLanes()
+    uint8_t fPluginLanes[MAX_RACK_PLUGINS];
+    uint fNumActiveLanes;
+    bool fProcessingLanes;
+
+    // lane assignments that cannot be used were reported, see updateLanes()
+    bool fLanesFallback;
+
+    // current cycle, for lane tasks
+    CarlaEngine::ProtectedData* fCurrentData;
+    const float** fCurrentInBuf;
+    uint32_t fCurrentFrames;
+
+public:
     CarlaEngine* const kEngine;
     CARLA_DECLARE_NON_COPYABLE(RackGraph)
 };
@@ -164,7 +230,12 @@ struct RackGraph {
 // -----------------------------------------------------------------------
 // PatchbayGraph
 
-class PatchbayGraph : private CarlaRunner {
+class PatchbayGraph : private CarlaRunner
+#ifndef CARLA_OS_WASM
+                    , private AudioProcessorGraph::ParallelRenderer
+                    , private CarlaRtTaskRunner
+#endif
+{
 public:
     PatchbayConnectionList connections;
     AudioProcessorGraph graph;
@@ -217,9 +288,24 @@ public:
                  float* const* outBuf,
                  uint32_t frames);
 
+    bool getProcessThreadsStats(EngineProcessThreadsStats& stats) const noexcept;
+
 private:
     bool run() override;
 
+#ifndef CARLA_OS_WASM
+    // AudioProcessorGraph::ParallelRenderer
+    void prepareRenderingSequence(uint numOps) override;
+    bool performRenderingSequence(AudioProcessorGraph& graph,
+                                  const AudioProcessorGraph::RenderingOpDependencies& deps) noexcept override;
+
+    // CarlaRtTaskRunner
+    void runTask(uint taskIndex) noexcept override;
+
+    CarlaRtThreadPool fThreadPool;
+    AudioProcessorGraph* fGraphBeingRendered;
+#endif
+
     CarlaEngine* const kEngine;
     CARLA_DECLARE_NON_COPYABLE(PatchbayGraph)
 };
@@ -42,28 +42,19 @@ CARLA_BACKEND_START_NAMESPACE
 // InternalEvents
 
 EngineInternalEvents::EngineInternalEvents() noexcept
-    : in(nullptr),
-      out(nullptr) {}
+    : in(),
+      out() {}
 
 EngineInternalEvents::~EngineInternalEvents() noexcept
 {
-    CARLA_SAFE_ASSERT(in == nullptr);
-    CARLA_SAFE_ASSERT(out == nullptr);
+    CARLA_SAFE_ASSERT(in.data == nullptr);
+    CARLA_SAFE_ASSERT(out.data == nullptr);
 }
 
 void EngineInternalEvents::clear() noexcept
 {
-    if (in != nullptr)
-    {
-        delete[] in;
-        in = nullptr;
-    }
-
-    if (out != nullptr)
-    {
-        delete[] out;
-        out = nullptr;
-    }
+    in.free();
+    out.free();
 }
 
 // -----------------------------------------------------------------------
@@ -374,9 +365,9 @@ void EngineNextAction::clearAndReset() noexcept
 // -----------------------------------------------------------------------
 // Helper functions
 
-EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexcept
+EngineEventBuffer* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexcept
 {
-    return isInput ? pData->events.in : pData->events.out;
+    return isInput ? &pData->events.in : &pData->events.out;
 }
 
 // -----------------------------------------------------------------------
@@ -384,6 +375,9 @@ EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexc
 
 CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
     : runner(engine),
+#ifndef CARLA_OS_WASM
+      workerPool("Carla Worker"),
+#endif
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
       osc(engine),
 #endif
@@ -397,10 +391,13 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
       ignoreClientPrefix(false),
       currentProjectFilename(),
       currentProjectFolder(),
+      currentChunksFolder(),
+      savedChunkFiles(),
 #endif
       bufferSize(0),
       sampleRate(0.0),
       aboutToClose(false),
+      timingPlugins(false),
       isIdling(0),
       curPluginCount(0),
       maxPluginNumber(0),
@@ -459,8 +456,8 @@ CarlaEngine::ProtectedData::~ProtectedData()
 bool CarlaEngine::ProtectedData::init(const char* const clientName)
 {
     CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(name.isEmpty(), "Invalid engine internal data (err #1)");
-    CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(events.in  == nullptr, "Invalid engine internal data (err #4)");
-    CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(events.out == nullptr, "Invalid engine internal data (err #5)");
+    CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(events.in.data  == nullptr, "Invalid engine internal data (err #4)");
+    CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(events.out.data == nullptr, "Invalid engine internal data (err #5)");
     CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(clientName != nullptr && clientName[0] != '\0', "Invalid client name");
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(plugins == nullptr, "Invalid engine internal data (err #3)");
@@ -492,10 +489,7 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
     case ENGINE_PROCESS_MODE_CONTINUOUS_RACK:
     case ENGINE_PROCESS_MODE_PATCHBAY:
     case ENGINE_PROCESS_MODE_BRIDGE:
-        events.in  = new EngineEvent[kMaxEngineEventInternalCount];
-        events.out = new EngineEvent[kMaxEngineEventInternalCount];
-        carla_zeroStructs(events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStructs(events.out, kMaxEngineEventInternalCount);
+        CARLA_SAFE_ASSERT_RETURN_INTERNAL_ERR(events.in.alloc() && events.out.alloc(), "Failed to allocate internal events");
         break;
     default:
         break;
@@ -522,6 +516,10 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
     nextAction.clearAndReset();
     runner.start();
 
+#ifndef CARLA_OS_WASM
+    workerPool.start(options.workerThreads);
+#endif
+
     return true;
 }
 
@@ -538,6 +536,10 @@ void CarlaEngine::ProtectedData::close()
     runner.stop();
     nextAction.clearAndReset();
 
+#ifndef CARLA_OS_WASM
+    workerPool.stop();
+#endif
+
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
     osc.close();
 #endif
@@ -622,6 +624,8 @@ void CarlaEngine::ProtectedData::doPluginRemove(const uint pluginId) noexcept
         plugin->setId(i);
 
         plugins[i].plugin = plugin;
+        plugins[i].meters.moveFrom(plugins[i+1].meters);
+        plugins[i].processTime = plugins[i+1].processTime;
         carla_zeroStruct(plugins[i].peaks);
     }
 
@@ -629,6 +633,8 @@ void CarlaEngine::ProtectedData::doPluginRemove(const uint pluginId) noexcept
 
     // reset last plugin (now removed)
     plugins[id].plugin.reset();
+    plugins[id].meters.reset();
+    plugins[id].processTime = 0;
     carla_zeroFloats(plugins[id].peaks, 4);
 }
 
@@ -650,9 +656,33 @@ void CarlaEngine::ProtectedData::doPluginsSwitch(const uint idA, const uint idB)
 
     pluginB->setId(idA);
     plugins[idB].plugin = pluginA;
+
+    plugins[idA].meters.swapWith(plugins[idB].meters);
+    std::swap(plugins[idA].processTime, plugins[idB].processTime);
 }
 #endif
 
+void CarlaEngine::ProtectedData::touchPluginMeters(const uint pluginId) const noexcept
+{
+    const uint32_t periods = bufferSize != 0
+                           ? static_cast<uint32_t>(sampleRate * kMeterReadLeaseTime / 1000 / bufferSize)
+                           : 0;
+
+    if (pluginId == MAIN_CARLA_PLUGIN_ID)
+    {
+        if (curPluginCount == 0)
+            return;
+
+        plugins[0].meters.touch(periods);
+        plugins[curPluginCount-1].meters.touch(periods);
+        return;
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(pluginId < curPluginCount,);
+
+    plugins[pluginId].meters.touch(periods);
+}
+
 void CarlaEngine::ProtectedData::doNextPluginAction() noexcept
 {
     if (! nextAction.mutex.tryLock())
@@ -18,11 +18,17 @@
 #ifndef CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 #define CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 
+#include "CarlaEngineMeters.hpp"
 #include "CarlaEngineRunner.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaPlugin.hpp"
+#include "CarlaStringList.hpp"
 #include "LinkedList.hpp"
 
+#ifndef CARLA_OS_WASM
+# include "CarlaWorkerPool.hpp"
+#endif
+
 #ifndef BUILD_BRIDGE
 # include "CarlaEngineOsc.hpp"
 # include "hylia/hylia.h"
@@ -57,8 +63,8 @@ CARLA_BACKEND_START_NAMESPACE
 // InternalEvents
 
 struct EngineInternalEvents {
-    EngineEvent* in;
-    EngineEvent* out;
+    EngineEventBuffer in;
+    EngineEventBuffer out;
 
     EngineInternalEvents() noexcept;
     ~EngineInternalEvents() noexcept;
@@ -108,6 +114,12 @@ public:
     PatchbayGraph* getPatchbayGraph() const noexcept;
     PatchbayGraph* getPatchbayGraphOrNull() const noexcept;
 
+    // event buffer of the rack lane a plugin belongs to, null if not using parallel lanes
+    EngineEventBuffer* getRackLaneEventBuffer(uint pluginId, bool isInput) const noexcept;
+
+    // to be called after the rack plugin list or plugin rack lanes change
+    void updateRackLanes(const CarlaEngine::ProtectedData* data) noexcept;
+
     void process(CarlaEngine::ProtectedData* data, const float* const* inBuf, float* const* outBuf, uint32_t frames);
 
     // special direct process with connections already handled, used in JACK and Plugin
@@ -250,17 +262,25 @@ struct EngineNextAction {
 struct EnginePluginData {
     CarlaPluginPtr plugin;
     float peaks[4];
+    EnginePluginMeters meters;
+    uint64_t processTime; // in nanoseconds, only measured during freewheel renders
 
     EnginePluginData()
         : plugin(nullptr),
 #ifdef CARLA_PROPER_CPP11_SUPPORT
-          peaks{0.0f, 0.0f, 0.0f, 0.0f} {}
+          peaks{0.0f, 0.0f, 0.0f, 0.0f},
+          meters(),
+          processTime(0) {}
 #else
-          peaks()
+          peaks(),
+          meters(),
+          processTime(0)
     {
         carla_zeroStruct(peaks);
     }
 #endif
+
+    CARLA_DECLARE_NON_COPYABLE(EnginePluginData)
 };
 
 // -----------------------------------------------------------------------
@@ -269,6 +289,10 @@ struct EnginePluginData {
 struct CarlaEngine::ProtectedData {
     CarlaEngineRunner runner;
 
+#ifndef CARLA_OS_WASM
+    CarlaWorkerPool workerPool;
+#endif
+
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
     CarlaEngineOsc osc;
 #endif
@@ -286,12 +310,15 @@ struct CarlaEngine::ProtectedData {
     bool ignoreClientPrefix; // backwards compat only
     CarlaString currentProjectFilename;
     CarlaString currentProjectFolder;
+    CarlaString currentChunksFolder; // only set while saving or loading a project file
+    CarlaStringList savedChunkFiles;  // chunk files used by the project being saved
 #endif
 
     uint32_t bufferSize;
     double   sampleRate;
 
     bool aboutToClose;    // don't re-activate runner if true
+    bool timingPlugins;   // measure plugin process time, used for freewheel renders
     int  isIdling;        // don't allow any operations while idling
     uint curPluginCount;  // number of plugins loaded (0...max)
     uint maxPluginNumber; // number of plugins allowed (0, 16, 99 or 255)
@@ -344,6 +371,9 @@ struct CarlaEngine::ProtectedData {
     void doPluginsSwitch(uint idA, uint idB) noexcept;
     void doNextPluginAction() noexcept;
 
+    // keep a plugin's peaks being metered for a while, called when reading them
+    void touchPluginMeters(uint pluginId) const noexcept;
+
     // -------------------------------------------------------------------
 
 #ifdef CARLA_PROPER_CPP11_SUPPORT
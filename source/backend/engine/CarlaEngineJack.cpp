@@ -2978,8 +2978,8 @@ protected:
         else if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK ||
                  pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
         {
-            CARLA_SAFE_ASSERT_RETURN(pData->events.in  != nullptr,);
-            CARLA_SAFE_ASSERT_RETURN(pData->events.out != nullptr,);
+            CARLA_SAFE_ASSERT_RETURN(pData->events.in.data  != nullptr,);
+            CARLA_SAFE_ASSERT_RETURN(pData->events.out.data != nullptr,);
 
             // get buffers from jack
             float* const audioIn1  = (float*)jackbridge_port_get_buffer(fRackPorts[kRackPortAudioIn1], nframes);
@@ -3000,13 +3000,11 @@ protected:
             /**/  float* outBuf[2] = { audioOut1, audioOut2 };
 
             // initialize events
-            carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
-            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+            pData->events.in.clear();
+            pData->events.out.clear();
 
             if (eventIn != nullptr)
             {
-                ushort engineEventIndex = 0;
-
                 jack_midi_event_t jackEvent;
                 const uint32_t jackEventCount(jackbridge_midi_get_event_count(eventIn));
 
@@ -3017,12 +3015,12 @@ protected:
 
                     CARLA_SAFE_ASSERT_CONTINUE(jackEvent.size < 0xFF /* uint8_t max */);
 
-                    EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
+                    EngineEvent& engineEvent(pData->events.in.data[pData->events.in.count++]);
 
                     engineEvent.time = jackEvent.time;
                     engineEvent.fillFromMidiData(static_cast<uint8_t>(jackEvent.size), jackEvent.buffer, 0);
 
-                    if (engineEventIndex >= kMaxEngineEventInternalCount)
+                    if (pData->events.in.count >= kMaxEngineEventInternalCount)
                         break;
                 }
             }
@@ -3047,13 +3045,13 @@ protected:
                 uint8_t  mdataTmp[EngineMidiEvent::kDataSize];
                 const uint8_t* mdataPtr;
 
-                for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+                for (uint32_t i=0; i < pData->events.out.count; ++i)
                 {
-                    const EngineEvent& engineEvent(pData->events.out[i]);
+                    const EngineEvent& engineEvent(pData->events.out.data[i]);
 
                     /**/ if (engineEvent.type == kEngineEventTypeNull)
                     {
-                        break;
+                        continue;
                     }
                     else if (engineEvent.type == kEngineEventTypeControl)
                     {
@@ -4130,33 +4128,54 @@ private:
                 cvOut[i] = nullptr;
         }
 
+        // only scan buffers for meters someone is watching
+        const uint meterTypes = getPluginMeterTypesRT(plugin->getId());
+
         float inPeaks[2] = { 0.0f };
         float outPeaks[2] = { 0.0f };
 
-        for (uint32_t i=0; i < audioInCount && i < 2; ++i)
+        if (meterTypes & kEngineMeterPeak)
         {
-            for (uint32_t j=0; j < nframes; ++j)
+            for (uint32_t i=0; i < audioInCount && i < 2; ++i)
             {
-                const float absV(std::abs(audioIn[i][j]));
+                for (uint32_t j=0; j < nframes; ++j)
+                {
+                    const float absV(std::abs(audioIn[i][j]));
 
-                if (absV > inPeaks[i])
-                    inPeaks[i] = absV;
+                    if (absV > inPeaks[i])
+                        inPeaks[i] = absV;
+                }
             }
         }
 
+        if (meterTypes & (kEngineMeterRms|kEngineMeterTruePeak))
+            processPluginMetersRT(plugin->getId(), false,
+                                  audioInCount > 0 ? audioIn[0] : nullptr,
+                                  audioInCount > 1 ? audioIn[1] : nullptr,
+                                  nframes, meterTypes);
+
         plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
 
-        for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
+        if (meterTypes & kEngineMeterPeak)
         {
-            for (uint32_t j=0; j < nframes; ++j)
+            for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
             {
-                const float absV(std::abs(audioOut[i][j]));
+                for (uint32_t j=0; j < nframes; ++j)
+                {
+                    const float absV(std::abs(audioOut[i][j]));
 
-                if (absV > outPeaks[i])
-                    outPeaks[i] = absV;
+                    if (absV > outPeaks[i])
+                        outPeaks[i] = absV;
+                }
             }
         }
 
+        if (meterTypes & (kEngineMeterRms|kEngineMeterTruePeak))
+            processPluginMetersRT(plugin->getId(), true,
+                                  audioOutCount > 0 ? audioOut[0] : nullptr,
+                                  audioOutCount > 1 ? audioOut[1] : nullptr,
+                                  nframes, meterTypes);
+
         setPluginPeaksRT(plugin->getId(), inPeaks, outPeaks);
     }
 
@@ -619,12 +619,11 @@ protected:
             carla_zeroFloats(outputChannelData[i], nframes);
 
         // initialize events
-        carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+        pData->events.in.clear();
+        pData->events.out.clear();
 
         if (fMidiInEvents.mutex.tryLock())
         {
-            uint32_t engineEventIndex = 0;
             fMidiInEvents.splice();
 
             for (LinkedList<RtMidiEvent>::Itenerator it = fMidiInEvents.data.begin2(); it.valid(); it.next())
@@ -632,7 +631,7 @@ protected:
                 const RtMidiEvent& midiEvent(it.getValue(kRtMidiEventFallback));
                 CARLA_SAFE_ASSERT_CONTINUE(midiEvent.size > 0);
 
-                EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
+                EngineEvent& engineEvent(pData->events.in.data[pData->events.in.count++]);
 
                 if (midiEvent.time < pData->timeInfo.frame)
                 {
@@ -648,7 +647,7 @@ protected:
 
                 engineEvent.fillFromMidiData(midiEvent.size, midiEvent.data, 0);
 
-                if (engineEventIndex >= kMaxEngineEventInternalCount)
+                if (pData->events.in.count >= kMaxEngineEventInternalCount)
                     break;
             }
 
@@ -666,12 +665,12 @@ protected:
             uint8_t        data[3] = { 0, 0, 0 };
             const uint8_t* dataPtr = data;
 
-            for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+            for (uint32_t i=0; i < pData->events.out.count; ++i)
             {
-                const EngineEvent& engineEvent(pData->events.out[i]);
+                const EngineEvent& engineEvent(pData->events.out.data[i]);
 
                 if (engineEvent.type == kEngineEventTypeNull)
-                    break;
+                    continue;
 
                 else if (engineEvent.type == kEngineEventTypeControl)
                 {
@@ -0,0 +1,257 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineMeters.hpp"
+
+#include "CarlaMathUtils.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// 4x oversampling interpolation filter, from ITU-R BS.1770-4 annex 2
+
+static const float kTruePeakCoeffs[kMeterTruePeakPhases][kMeterTruePeakTaps] = {
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+      -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+       0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+      -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+       0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+      -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+       0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+      -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+       0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f },
+};
+
+// -----------------------------------------------------------------------
+// EnginePluginMeters
+
+EnginePluginMeters::EnginePluginMeters() noexcept
+    : fPeakSubscribers(0),
+      fRmsSubscribers(0),
+      fTruePeakSubscribers(0),
+      fReadLease(0)
+{
+    clear();
+}
+
+void EnginePluginMeters::subscribe(const uint meterTypes) noexcept
+{
+    if (meterTypes & kEngineMeterPeak)
+        ++fPeakSubscribers;
+    if (meterTypes & kEngineMeterRms)
+        ++fRmsSubscribers;
+    if (meterTypes & kEngineMeterTruePeak)
+        ++fTruePeakSubscribers;
+}
+
+void EnginePluginMeters::unsubscribe(const uint meterTypes) noexcept
+{
+    if (meterTypes & kEngineMeterPeak)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fPeakSubscribers.load() != 0,);
+        --fPeakSubscribers;
+    }
+    if (meterTypes & kEngineMeterRms)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fRmsSubscribers.load() != 0,);
+        --fRmsSubscribers;
+    }
+    if (meterTypes & kEngineMeterTruePeak)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fTruePeakSubscribers.load() != 0,);
+        --fTruePeakSubscribers;
+    }
+}
+
+void EnginePluginMeters::touch(const uint32_t periods) const noexcept
+{
+    fReadLease.store(std::max(periods, 1U), std::memory_order_relaxed);
+}
+
+void EnginePluginMeters::getValues(float rms[4], float truePeaks[4]) const noexcept
+{
+    for (uint i=0; i<4; ++i)
+    {
+        rms[i] = fRms[i].load(std::memory_order_relaxed);
+        truePeaks[i] = fTruePeaks[i].load(std::memory_order_relaxed);
+    }
+}
+
+void EnginePluginMeters::clear() noexcept
+{
+    for (uint i=0; i<4; ++i)
+    {
+        fRms[i].store(0.0f, std::memory_order_relaxed);
+        fTruePeaks[i].store(0.0f, std::memory_order_relaxed);
+        fHistoryPos[i] = 0;
+        carla_zeroFloats(fHistory[i], kMeterTruePeakTaps * 2);
+    }
+
+    carla_zeroStructs(fWindows, 2);
+}
+
+void EnginePluginMeters::reset() noexcept
+{
+    fPeakSubscribers.store(0);
+    fRmsSubscribers.store(0);
+    fTruePeakSubscribers.store(0);
+    fReadLease.store(0);
+
+    clear();
+}
+
+void EnginePluginMeters::moveFrom(EnginePluginMeters& other) noexcept
+{
+    fPeakSubscribers.store(other.fPeakSubscribers.exchange(0));
+    fRmsSubscribers.store(other.fRmsSubscribers.exchange(0));
+    fTruePeakSubscribers.store(other.fTruePeakSubscribers.exchange(0));
+    fReadLease.store(other.fReadLease.exchange(0));
+
+    clear();
+    other.clear();
+}
+
+void EnginePluginMeters::swapWith(EnginePluginMeters& other) noexcept
+{
+    fPeakSubscribers.store(other.fPeakSubscribers.exchange(fPeakSubscribers.load()));
+    fRmsSubscribers.store(other.fRmsSubscribers.exchange(fRmsSubscribers.load()));
+    fTruePeakSubscribers.store(other.fTruePeakSubscribers.exchange(fTruePeakSubscribers.load()));
+    fReadLease.store(other.fReadLease.exchange(fReadLease.load()));
+
+    clear();
+    other.clear();
+}
+
+uint EnginePluginMeters::getMeterTypesRT() noexcept
+{
+    uint meterTypes = 0x0;
+
+    // a failed exchange means a reader just renewed the lease, keep it
+    uint32_t lease = fReadLease.load(std::memory_order_relaxed);
+
+    if (lease != 0)
+    {
+        fReadLease.compare_exchange_strong(lease, lease - 1, std::memory_order_relaxed);
+        meterTypes |= kEngineMeterPeak;
+    }
+
+    if (fPeakSubscribers.load(std::memory_order_relaxed) != 0)
+        meterTypes |= kEngineMeterPeak;
+    if (fRmsSubscribers.load(std::memory_order_relaxed) != 0)
+        meterTypes |= kEngineMeterRms;
+    if (fTruePeakSubscribers.load(std::memory_order_relaxed) != 0)
+        meterTypes |= kEngineMeterTruePeak;
+
+    return meterTypes;
+}
+
+void EnginePluginMeters::processRT(const uint index, const float* const left, const float* const right,
+                                   const uint32_t frames, const uint meterTypes, const uint32_t windowFrames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(index < 2,);
+
+    if ((meterTypes & (kEngineMeterRms|kEngineMeterTruePeak)) == 0x0 || frames == 0)
+        return;
+
+    Window& window(fWindows[index]);
+    const float* const buffers[2] = { left, right };
+
+    for (uint i=0; i<2; ++i)
+    {
+        const float* const buffer = buffers[i];
+
+        if (buffer == nullptr)
+            continue;
+
+        if (meterTypes & kEngineMeterRms)
+        {
+            float sum = 0.0f;
+
+            for (uint32_t k=0; k<frames; ++k)
+                sum += buffer[k] * buffer[k];
+
+            window.sumSquares[i] += sum;
+        }
+
+        if (meterTypes & kEngineMeterTruePeak)
+        {
+            const float peak = _processTruePeak(index * 2 + i, buffer, frames);
+
+            if (peak > window.truePeaks[i])
+                window.truePeaks[i] = peak;
+        }
+    }
+
+    window.frames += frames;
+
+    if (window.frames < windowFrames)
+        return;
+
+    for (uint i=0; i<2; ++i)
+    {
+        if (meterTypes & kEngineMeterRms)
+            fRms[index * 2 + i].store(std::sqrt(window.sumSquares[i] / static_cast<float>(window.frames)),
+                                      std::memory_order_relaxed);
+
+        if (meterTypes & kEngineMeterTruePeak)
+            fTruePeaks[index * 2 + i].store(window.truePeaks[i], std::memory_order_relaxed);
+    }
+
+    carla_zeroStruct(window);
+}
+
+float EnginePluginMeters::_processTruePeak(const uint channel, const float* const buffer, const uint32_t frames) noexcept
+{
+    float* const history = fHistory[channel];
+    uint pos = fHistoryPos[channel];
+    float peak = 0.0f;
+
+    for (uint32_t k=0; k<frames; ++k)
+    {
+        history[pos] = history[pos + kMeterTruePeakTaps] = buffer[k];
+
+        if (++pos == kMeterTruePeakTaps)
+            pos = 0;
+
+        // newest sample is last
+        const float* const samples = history + pos;
+
+        for (uint p=0; p<kMeterTruePeakPhases; ++p)
+        {
+            const float* const coeffs = kTruePeakCoeffs[p];
+            float value = 0.0f;
+
+            for (uint t=0; t<kMeterTruePeakTaps; ++t)
+                value += coeffs[t] * samples[kMeterTruePeakTaps - 1 - t];
+
+            value = std::abs(value);
+
+            if (value > peak)
+                peak = value;
+        }
+    }
+
+    fHistoryPos[channel] = pos;
+    return peak;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,125 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_METERS_HPP_INCLUDED
+#define CARLA_ENGINE_METERS_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+
+#include <atomic>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Meter constants
+
+// how long peaks keep being metered after someone reads them, in milliseconds
+static const uint kMeterReadLeaseTime = 2000;
+
+// true-peak oversampling factor and interpolation filter length
+static const uint kMeterTruePeakPhases = 4;
+static const uint kMeterTruePeakTaps = 12;
+
+// -----------------------------------------------------------------------
+// EnginePluginMeters
+
+/*
+ * Meters of a single plugin (stereo inputs and outputs).
+ *
+ * Meters only run while watched, either through explicit subscriptions or by reading peaks,
+ * which keeps peak metering alive for kMeterReadLeaseTime.
+ * Peak values live in EnginePluginData, this class only keeps track of who is watching,
+ * plus the RMS and true-peak state.
+ */
+class EnginePluginMeters
+{
+public:
+    EnginePluginMeters() noexcept;
+
+    // -------------------------------------------------------------------
+    // non-RT calls
+
+    // add a subscription to some EngineMeterType flags
+    void subscribe(uint meterTypes) noexcept;
+
+    // remove a subscription added with subscribe()
+    void unsubscribe(uint meterTypes) noexcept;
+
+    // keep peak metering alive for the next @a periods audio periods
+    void touch(uint32_t periods) const noexcept;
+
+    // get the last completed RMS and true-peak values, 4 each
+    void getValues(float rms[4], float truePeaks[4]) const noexcept;
+
+    // clear all meter values, subscriptions are kept
+    void clear() noexcept;
+
+    // clear all meter values and drop all subscriptions, used when a plugin is removed
+    void reset() noexcept;
+
+    // take over the state of another plugin's meters, used when plugins are moved around
+    void moveFrom(EnginePluginMeters& other) noexcept;
+    void swapWith(EnginePluginMeters& other) noexcept;
+
+    // -------------------------------------------------------------------
+    // RT calls
+
+    /*
+     * Get which EngineMeterType flags are being watched.
+     * This counts down the lease given by touch(), so it must be called once per period.
+     */
+    uint getMeterTypesRT() noexcept;
+
+    /*
+     * Feed RMS and true-peak meters with a stereo buffer, as requested by @a meterTypes.
+     * Index 0 is for the plugin inputs, index 1 for the outputs. Null buffers count as silence.
+     * Values are published every @a windowFrames frames.
+     */
+    void processRT(uint index, const float* left, const float* right, uint32_t frames,
+                   uint meterTypes, uint32_t windowFrames) noexcept;
+
+private:
+    std::atomic<uint> fPeakSubscribers;
+    std::atomic<uint> fRmsSubscribers;
+    std::atomic<uint> fTruePeakSubscribers;
+    mutable std::atomic<uint32_t> fReadLease;
+
+    // published values, channels are input left/right and output left/right
+    std::atomic<float> fRms[4];
+    std::atomic<float> fTruePeaks[4];
+
+    // RT state, per input/output side
+    struct Window {
+        uint32_t frames;
+        float sumSquares[2];
+        float truePeaks[2];
+    } fWindows[2];
+
+    // last samples per channel, written twice so that the newest kMeterTruePeakTaps are always contiguous
+    float fHistory[4][kMeterTruePeakTaps * 2];
+    uint fHistoryPos[4];
+
+    float _processTruePeak(uint channel, const float* buffer, uint32_t frames) noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(EnginePluginMeters)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_METERS_HPP_INCLUDED
@@ -1159,25 +1159,23 @@ protected:
         // ---------------------------------------------------------------
         // initialize events
 
-        carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+        pData->events.in.clear();
+        pData->events.out.clear();
 
         // ---------------------------------------------------------------
         // events input (before processing)
 
         if (kHasMidiIn)
         {
-            uint32_t engineEventIndex = 0;
-
-            for (uint32_t i=0; i < midiEventCount && engineEventIndex < kMaxEngineEventInternalCount; ++i)
+            for (uint32_t i=0; i < midiEventCount && pData->events.in.count < kMaxEngineEventInternalCount; ++i)
             {
                 const NativeMidiEvent& midiEvent(midiEvents[i]);
-                EngineEvent&           engineEvent(pData->events.in[engineEventIndex++]);
+                EngineEvent&           engineEvent(pData->events.in.data[pData->events.in.count++]);
 
                 engineEvent.time = midiEvent.time;
                 engineEvent.fillFromMidiData(midiEvent.size, midiEvent.data, 0);
 
-                if (engineEventIndex >= kMaxEngineEventInternalCount)
+                if (pData->events.in.count >= kMaxEngineEventInternalCount)
                     break;
             }
         }
@@ -1206,18 +1204,18 @@ protected:
         // ---------------------------------------------------------------
         // events output (after processing)
 
-        carla_zeroStructs(pData->events.in, kMaxEngineEventInternalCount);
+        pData->events.in.clear();
 
         if (kHasMidiOut)
         {
             NativeMidiEvent midiEvent;
 
-            for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
+            for (uint32_t i=0; i < pData->events.out.count; ++i)
             {
-                const EngineEvent& engineEvent(pData->events.out[i]);
+                const EngineEvent& engineEvent(pData->events.out.data[i]);
 
                 if (engineEvent.type == kEngineEventTypeNull)
-                    break;
+                    continue;
 
                 carla_zeroStruct(midiEvent);
                 midiEvent.time = engineEvent.time;
@@ -1498,6 +1496,9 @@ protected:
             const EnginePluginData& plugData(pData->plugins[i]);
             const CarlaPluginPtr plugin = pData->plugins[i].plugin;
 
+            // the UI keeps showing peaks while open
+            pData->touchPluginMeters(i);
+
             std::snprintf(tmpBuf, STR_MAX, "PEAKS_%i\n", i);
             CARLA_SAFE_ASSERT_RETURN(fUiServer.writeMessage(tmpBuf),);
             std::snprintf(tmpBuf, STR_MAX, "%.12g:%.12g:%.12g:%.12g\n",
@@ -2083,6 +2084,15 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
         ok = fEngine->switchPlugins(pluginIdA, pluginIdB);
         fEngine->reloadFromUI();
     }
+    else if (std::strcmp(msg, "set_plugin_rack_lane") == 0)
+    {
+        uint32_t pluginId, lane;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(lane), true);
+
+        ok = fEngine->setPluginRackLane(pluginId, lane);
+    }
     else if (std::strcmp(msg, "load_plugin_state") == 0)
     {
         uint32_t pluginId;
@@ -21,7 +21,9 @@
 #include "CarlaMIDI.h"
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+#include "CarlaEngineClient.hpp"
 #include "CarlaEngineGraph.hpp"
+#include "CarlaEngineInternal.hpp"
 #endif
 
 #include "lv2/lv2.h"
@@ -127,8 +129,13 @@ CarlaEngineEventPort::CarlaEngineEventPort(const CarlaEngineClient& client, cons
 
     if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY)
     {
-        fBuffer = new EngineEvent[kMaxEngineEventInternalCount];
-        carla_zeroStructs(fBuffer, kMaxEngineEventInternalCount);
+        fBuffer = new EngineEventBuffer();
+
+        if (! fBuffer->alloc())
+        {
+            delete fBuffer;
+            fBuffer = nullptr;
+        }
     }
 }
 
@@ -140,17 +147,30 @@ CarlaEngineEventPort::~CarlaEngineEventPort() noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr,);
 
-        delete[] fBuffer;
+        fBuffer->free();
+        delete fBuffer;
         fBuffer = nullptr;
     }
 }
 
 void CarlaEngineEventPort::initBuffer() noexcept
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (kProcessMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK && kClient.pData->plugin.get() != nullptr)
+    {
+        // plugins running on a parallel rack lane use that lane's buffers
+        if (EngineEventBuffer* const laneBuffer = kClient.pData->egraph.getRackLaneEventBuffer(kClient.pData->plugin->getId(), kIsInput))
+        {
+            fBuffer = laneBuffer;
+            return;
+        }
+    }
+#endif
+
     if (kProcessMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK || kProcessMode == ENGINE_PROCESS_MODE_BRIDGE)
         fBuffer = kClient.getEngine().getInternalEventBuffer(kIsInput);
-    else if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY && ! kIsInput)
-        carla_zeroStructs(fBuffer, kMaxEngineEventInternalCount);
+    else if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY && ! kIsInput && fBuffer != nullptr)
+        fBuffer->clear();
 }
 
 uint32_t CarlaEngineEventPort::getEventCount() const noexcept
@@ -159,15 +179,7 @@ uint32_t CarlaEngineEventPort::getEventCount() const noexcept
     CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
     CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, 0);
 
-    uint32_t i=0;
-
-    for (; i < kMaxEngineEventInternalCount; ++i)
-    {
-        if (fBuffer[i].type == kEngineEventTypeNull)
-            break;
-    }
-
-    return i;
+    return fBuffer->count;
 }
 
 EngineEvent& CarlaEngineEventPort::getEvent(const uint32_t index) const noexcept
@@ -177,12 +189,12 @@ EngineEvent& CarlaEngineEventPort::getEvent(const uint32_t index) const noexcept
     CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, kFallbackEngineEvent);
     CARLA_SAFE_ASSERT_RETURN(index < kMaxEngineEventInternalCount, kFallbackEngineEvent);
 
-    return fBuffer[index];
+    return fBuffer->data[index];
 }
 
 EngineEvent& CarlaEngineEventPort::getEventUnchecked(const uint32_t index) const noexcept
 {
-    return fBuffer[index];
+    return fBuffer->data[index];
 }
 
 bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t channel, const EngineControlEvent& ctrl) noexcept
@@ -207,27 +219,26 @@ bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t
         CARLA_SAFE_ASSERT(! MIDI_IS_CONTROL_BANK_SELECT(param));
     }
 
-    for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
+    EngineEvent* const eventPtr = fBuffer->append();
+
+    if (eventPtr == nullptr)
     {
-        EngineEvent& event(fBuffer[i]);
+        carla_stderr2("CarlaEngineEventPort::writeControlEvent() - buffer full");
+        return false;
+    }
 
-        if (event.type != kEngineEventTypeNull)
-            continue;
+    EngineEvent& event(*eventPtr);
 
-        event.type    = kEngineEventTypeControl;
-        event.time    = time;
-        event.channel = channel;
+    event.type    = kEngineEventTypeControl;
+    event.time    = time;
+    event.channel = channel;
 
-        event.ctrl.type            = type;
-        event.ctrl.param           = param;
-        event.ctrl.midiValue       = midiValue;
-        event.ctrl.normalizedValue = carla_fixedValue<float>(0.0f, 1.0f, normalizedValue);
+    event.ctrl.type            = type;
+    event.ctrl.param           = param;
+    event.ctrl.midiValue       = midiValue;
+    event.ctrl.normalizedValue = carla_fixedValue<float>(0.0f, 1.0f, normalizedValue);
 
-        return true;
-    }
-
-    carla_stderr2("CarlaEngineEventPort::writeControlEvent() - buffer full");
-    return false;
+    return true;
 }
 
 bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t size, const uint8_t* const data) noexcept
@@ -250,94 +261,97 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
     CARLA_SAFE_ASSERT_RETURN(size > 0 && size <= EngineMidiEvent::kDataSize, false);
     CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
 
-    for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
-    {
-        EngineEvent& event(fBuffer[i]);
+    const uint8_t status(uint8_t(MIDI_GET_STATUS_FROM_DATA(data)));
 
-        if (event.type != kEngineEventTypeNull)
-            continue;
+    if (status == MIDI_STATUS_CONTROL_CHANGE || status == MIDI_STATUS_PROGRAM_CHANGE)
+    {
+        CARLA_SAFE_ASSERT_RETURN(size >= 2, true);
 
-        event.time    = time;
-        event.channel = channel;
+        if (status == MIDI_STATUS_CONTROL_CHANGE && MIDI_IS_CONTROL_BANK_SELECT(data[1])) {
+            CARLA_SAFE_ASSERT_RETURN(size >= 3, true);
+        }
+    }
 
-        const uint8_t status(uint8_t(MIDI_GET_STATUS_FROM_DATA(data)));
+    EngineEvent* const eventPtr = fBuffer->append();
 
-        if (status == MIDI_STATUS_CONTROL_CHANGE)
-        {
-            CARLA_SAFE_ASSERT_RETURN(size >= 2, true);
+    if (eventPtr == nullptr)
+    {
+        carla_stderr2("CarlaEngineEventPort::writeMidiEvent() - buffer full");
+        return false;
+    }
 
-            switch (data[1])
-            {
-            case MIDI_CONTROL_BANK_SELECT:
-            case MIDI_CONTROL_BANK_SELECT__LSB:
-                CARLA_SAFE_ASSERT_RETURN(size >= 3, true);
-                event.type                 = kEngineEventTypeControl;
-                event.ctrl.type            = kEngineControlEventTypeMidiBank;
-                event.ctrl.param           = data[2];
-                event.ctrl.midiValue       = -1;
-                event.ctrl.normalizedValue = 0.0f;
-                event.ctrl.handled         = true;
-                return true;
+    EngineEvent& event(*eventPtr);
 
-            case MIDI_CONTROL_ALL_SOUND_OFF:
-                event.type                 = kEngineEventTypeControl;
-                event.ctrl.type            = kEngineControlEventTypeAllSoundOff;
-                event.ctrl.param           = 0;
-                event.ctrl.midiValue       = -1;
-                event.ctrl.normalizedValue = 0.0f;
-                event.ctrl.handled         = true;
-                return true;
+    event.time    = time;
+    event.channel = channel;
 
-            case MIDI_CONTROL_ALL_NOTES_OFF:
-                event.type                 = kEngineEventTypeControl;
-                event.ctrl.type            = kEngineControlEventTypeAllNotesOff;
-                event.ctrl.param           = 0;
-                event.ctrl.midiValue       = -1;
-                event.ctrl.normalizedValue = 0.0f;
-                event.ctrl.handled         = true;
-                return true;
-            }
-        }
-
-        if (status == MIDI_STATUS_PROGRAM_CHANGE)
+    if (status == MIDI_STATUS_CONTROL_CHANGE)
+    {
+        switch (data[1])
         {
-            CARLA_SAFE_ASSERT_RETURN(size >= 2, true);
-
+        case MIDI_CONTROL_BANK_SELECT:
+        case MIDI_CONTROL_BANK_SELECT__LSB:
             event.type                 = kEngineEventTypeControl;
-            event.ctrl.type            = kEngineControlEventTypeMidiProgram;
-            event.ctrl.param           = data[1];
+            event.ctrl.type            = kEngineControlEventTypeMidiBank;
+            event.ctrl.param           = data[2];
             event.ctrl.midiValue       = -1;
             event.ctrl.normalizedValue = 0.0f;
             event.ctrl.handled         = true;
             return true;
-        }
 
-        event.type      = kEngineEventTypeMidi;
-        event.midi.size = size;
+        case MIDI_CONTROL_ALL_SOUND_OFF:
+            event.type                 = kEngineEventTypeControl;
+            event.ctrl.type            = kEngineControlEventTypeAllSoundOff;
+            event.ctrl.param           = 0;
+            event.ctrl.midiValue       = -1;
+            event.ctrl.normalizedValue = 0.0f;
+            event.ctrl.handled         = true;
+            return true;
 
-        if (kIndexOffset < 0xFF /* uint8_t max */)
-        {
-            event.midi.port = static_cast<uint8_t>(kIndexOffset);
-        }
-        else
-        {
-            event.midi.port = 0;
-            carla_safe_assert_uint("kIndexOffset < 0xFF", __FILE__, __LINE__, kIndexOffset);
+        case MIDI_CONTROL_ALL_NOTES_OFF:
+            event.type                 = kEngineEventTypeControl;
+            event.ctrl.type            = kEngineControlEventTypeAllNotesOff;
+            event.ctrl.param           = 0;
+            event.ctrl.midiValue       = -1;
+            event.ctrl.normalizedValue = 0.0f;
+            event.ctrl.handled         = true;
+            return true;
         }
+    }
 
-        event.midi.data[0] = status;
+    if (status == MIDI_STATUS_PROGRAM_CHANGE)
+    {
+        event.type                 = kEngineEventTypeControl;
+        event.ctrl.type            = kEngineControlEventTypeMidiProgram;
+        event.ctrl.param           = data[1];
+        event.ctrl.midiValue       = -1;
+        event.ctrl.normalizedValue = 0.0f;
+        event.ctrl.handled         = true;
+        return true;
+    }
 
-        uint8_t j=1;
-        for (; j < size; ++j)
-            event.midi.data[j] = data[j];
-        for (; j < EngineMidiEvent::kDataSize; ++j)
-            event.midi.data[j] = 0;
+    event.type      = kEngineEventTypeMidi;
+    event.midi.size = size;
 
-        return true;
+    if (kIndexOffset < 0xFF /* uint8_t max */)
+    {
+        event.midi.port = static_cast<uint8_t>(kIndexOffset);
+    }
+    else
+    {
+        event.midi.port = 0;
+        carla_safe_assert_uint("kIndexOffset < 0xFF", __FILE__, __LINE__, kIndexOffset);
     }
 
-    carla_stderr2("CarlaEngineEventPort::writeMidiEvent() - buffer full");
-    return false;
+    event.midi.data[0] = status;
+
+    uint8_t j=1;
+    for (; j < size; ++j)
+        event.midi.data[j] = data[j];
+    for (; j < EngineMidiEvent::kDataSize; ++j)
+        event.midi.data[j] = 0;
+
+    return true;
 }
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -426,18 +440,12 @@ void CarlaEngineCVSourcePorts::initPortBuffers(const float* const* const buffers
     if (numCVs == 0)
         return;
 
-    EngineEvent* const buffer = eventPort->fBuffer;
+    EngineEventBuffer* const buffer = eventPort->fBuffer;
     CARLA_SAFE_ASSERT_RETURN(buffer != nullptr,);
 
-    uint32_t eventCount = 0;
+    const uint32_t eventCount = buffer->count;
     float v, min, max;
 
-    for (; eventCount < kMaxEngineEventInternalCount; ++eventCount)
-    {
-        if (buffer[eventCount].type == kEngineEventTypeNull)
-            break;
-    }
-
     if (eventCount == kMaxEngineEventInternalCount)
         return;
 
@@ -445,9 +453,9 @@ void CarlaEngineCVSourcePorts::initPortBuffers(const float* const* const buffers
 
     if (true || ! sampleAccurate)
     {
-        const uint32_t eventFrame = eventCount == 0 ? 0 : std::min(buffer[eventCount-1].time, frames-1U);
+        const uint32_t eventFrame = eventCount == 0 ? 0 : std::min(buffer->data[eventCount-1].time, frames-1U);
 
-        for (int i = 0; i < numCVs && eventCount < kMaxEngineEventInternalCount; ++i)
+        for (int i = 0; i < numCVs; ++i)
         {
             CarlaEngineEventCV& ecv(pData->cvs.getReference(i));
             CARLA_SAFE_ASSERT_CONTINUE(ecv.cvPort != nullptr);
@@ -460,9 +468,14 @@ void CarlaEngineCVSourcePorts::initPortBuffers(const float* const* const buffers
 
             if (carla_isNotEqual(v, previousValue))
             {
+                EngineEvent* const eventPtr = buffer->append();
+
+                if (eventPtr == nullptr)
+                    break;
+
                 previousValue = v;
 
-                EngineEvent& event(buffer[eventCount++]);
+                EngineEvent& event(*eventPtr);
 
                 event.type    = kEngineEventTypeControl;
                 event.time    = eventFrame;
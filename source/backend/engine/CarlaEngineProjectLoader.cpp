@@ -0,0 +1,411 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineProjectLoader.hpp"
+#include "CarlaEngineInternal.hpp"
+#include "CarlaPlugin.hpp"
+
+#include "CarlaThread.hpp"
+#include "CarlaTimeUtils.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+// Time between idle callbacks while waiting for loader threads, in ms
+static const uint kIdleWaitTime = 20;
+
+// Thread-specific data of loader threads, pointing to their last error
+static pthread_key_t  sLoaderThreadKey;
+static pthread_once_t sLoaderThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static void createLoaderThreadKey()
+{
+    pthread_key_create(&sLoaderThreadKey, nullptr);
+}
+
+static bool isSameString(const char* const a, const char* const b) noexcept
+{
+    if (a == nullptr || b == nullptr)
+        return a == b;
+
+    return std::strcmp(a, b) == 0;
+}
+
+static bool isSamePlugin(const ProjectPluginJob* const a, const ProjectPluginJob* const b) noexcept
+{
+    return a->ptype == b->ptype
+        && isSameString(a->stateSave.binary, b->stateSave.binary)
+        && isSameString(a->stateSave.label, b->stateSave.label);
+}
+
+static bool canLoadOnLoaderThread(const ProjectPluginJob* const job, const EngineOptions& options) noexcept
+{
+   #ifdef CARLA_PLUGIN_ONLY_BRIDGE
+    return false;
+
+    // unused
+    (void)job;
+    (void)options;
+   #else
+    // plugin bridges are handled from the main thread
+    if (job->btype != BINARY_NATIVE)
+        return false;
+
+    switch (job->ptype)
+    {
+    case PLUGIN_LADSPA:
+    case PLUGIN_DSSI:
+    case PLUGIN_LV2:
+        return ! options.preferPluginBridges;
+
+    case PLUGIN_INTERNAL:
+        // carla-rack and carla-patchbay run a full engine of their own
+        return job->stateSave.label == nullptr || std::strncmp(job->stateSave.label, "carla", 5) != 0;
+
+    case PLUGIN_DLS:
+    case PLUGIN_GIG:
+    case PLUGIN_SF2:
+    case PLUGIN_SFZ:
+        return true;
+
+    default:
+        // VST2, VST3, AU and CLAP plugins expect to be created on the main thread, JSFX and JACK apps are kept there too
+        return false;
+    }
+   #endif
+}
+
+// -----------------------------------------------------------------------
+// ScopedLoaderContext
+
+/*
+ * Makes the calling thread act as a loader thread while in scope, so that engine callbacks are not sent from it.
+ * Used when restoring the state of plugins created on the main thread, as their id is not final yet.
+ */
+class ScopedLoaderContext
+{
+public:
+    ScopedLoaderContext() noexcept
+        : fWasLoaderThread(CarlaEngineProjectLoader::isLoaderThread()),
+          fLastError()
+    {
+        if (! fWasLoaderThread)
+            pthread_setspecific(sLoaderThreadKey, &fLastError);
+    }
+
+    ~ScopedLoaderContext() noexcept
+    {
+        if (! fWasLoaderThread)
+            pthread_setspecific(sLoaderThreadKey, nullptr);
+    }
+
+private:
+    const bool fWasLoaderThread;
+    CarlaString fLastError;
+
+    CARLA_DECLARE_NON_COPYABLE(ScopedLoaderContext)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineProjectLoader::LoaderThread
+
+class CarlaEngineProjectLoader::LoaderThread : public CarlaThread
+{
+public:
+    LoaderThread(CarlaEngineProjectLoader* const loader) noexcept
+        : CarlaThread("CarlaProjectLoader"),
+          kLoader(loader),
+          fLastError() {}
+
+protected:
+    void run() override
+    {
+        pthread_setspecific(sLoaderThreadKey, &fLastError);
+
+        while (std::vector<ProjectPluginJob*>* const group = kLoader->takeGroup())
+        {
+            for (std::vector<ProjectPluginJob*>::iterator it = group->begin(); it != group->end(); ++it)
+                kLoader->loadJob(*it);
+        }
+
+        pthread_setspecific(sLoaderThreadKey, nullptr);
+    }
+
+private:
+    CarlaEngineProjectLoader* const kLoader;
+    CarlaString fLastError;
+
+    CARLA_DECLARE_NON_COPYABLE(LoaderThread)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineProjectLoader
+
+CarlaEngineProjectLoader::CarlaEngineProjectLoader(CarlaEngine* const engine) noexcept
+    : kEngine(engine),
+      fJobs(),
+      fGroups(),
+      fNextGroup(0),
+      fThreads(),
+      fMutex()
+{
+    CARLA_SAFE_ASSERT(engine != nullptr);
+    carla_debug("CarlaEngineProjectLoader::CarlaEngineProjectLoader(%p)", engine);
+
+    pthread_once(&sLoaderThreadKeyOnce, createLoaderThreadKey);
+}
+
+CarlaEngineProjectLoader::~CarlaEngineProjectLoader()
+{
+    carla_debug("CarlaEngineProjectLoader::~CarlaEngineProjectLoader()");
+    CARLA_SAFE_ASSERT(fThreads.empty());
+
+    clear();
+}
+
+void CarlaEngineProjectLoader::addJob(ProjectPluginJob* const job)
+{
+    CARLA_SAFE_ASSERT_RETURN(job != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(fThreads.empty(),);
+
+    fJobs.push_back(job);
+
+    job->id = kEngine->pData->curPluginCount + static_cast<uint>(fJobs.size() - 1);
+
+    if (job->id >= kEngine->pData->maxPluginNumber)
+    {
+        job->error = "Maximum number of plugins reached";
+        return;
+    }
+
+    job->needsMainThread = ! canLoadOnLoaderThread(job, kEngine->pData->options);
+
+    if (job->needsMainThread)
+        return;
+
+    // instances of the same plugin are loaded one after the other, in case it is not thread-safe
+    for (std::vector<std::vector<ProjectPluginJob*> >::iterator it = fGroups.begin(); it != fGroups.end(); ++it)
+    {
+        if (isSamePlugin(it->front(), job))
+        {
+            it->push_back(job);
+            return;
+        }
+    }
+
+    fGroups.push_back(std::vector<ProjectPluginJob*>(1, job));
+}
+
+bool CarlaEngineProjectLoader::hasJobs() const noexcept
+{
+    return !fJobs.empty();
+}
+
+bool CarlaEngineProjectLoader::run(const uint numThreads)
+{
+    CARLA_SAFE_ASSERT_RETURN(fThreads.empty(), false);
+    carla_debug("CarlaEngineProjectLoader::run(%u)", numThreads);
+
+    {
+        // loader threads wait here until all of them are started
+        const CarlaMutexLocker cml(fMutex);
+
+        for (uint i=0; i < numThreads && i < fGroups.size(); ++i)
+        {
+            LoaderThread* const thread = new LoaderThread(this);
+
+            if (! thread->startThread())
+            {
+                delete thread;
+                break;
+            }
+
+            fThreads.push_back(thread);
+        }
+    }
+
+    // plugins that need the main thread are loaded in the meantime
+    for (std::vector<ProjectPluginJob*>::iterator it = fJobs.begin(); it != fJobs.end(); ++it)
+    {
+        ProjectPluginJob* const job = *it;
+
+        if (! job->needsMainThread || job->error.isNotEmpty())
+            continue;
+
+        loadJob(job);
+        kEngine->callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+    }
+
+    // then help with the rest
+    while (std::vector<ProjectPluginJob*>* const group = takeGroup())
+    {
+        for (std::vector<ProjectPluginJob*>::iterator it = group->begin(); it != group->end(); ++it)
+        {
+            loadJob(*it);
+            kEngine->callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+        }
+    }
+
+    for (std::vector<LoaderThread*>::iterator it = fThreads.begin(); it != fThreads.end(); ++it)
+    {
+        LoaderThread* const thread = *it;
+
+        while (thread->isThreadRunning())
+        {
+            kEngine->callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+            carla_msleep(kIdleWaitTime);
+        }
+
+        thread->stopThread(-1);
+        delete thread;
+    }
+
+    fThreads.clear();
+
+    if (kEngine->pData->aboutToClose || kEngine->pData->actionCanceled)
+    {
+        clear();
+        return false;
+    }
+
+    for (std::vector<ProjectPluginJob*>::iterator it = fJobs.begin(); it != fJobs.end(); ++it)
+        addToEngine(*it);
+
+    clear();
+    return true;
+}
+
+bool CarlaEngineProjectLoader::isLoaderThread() noexcept
+{
+    return getLoaderThreadLastError() != nullptr;
+}
+
+CarlaString* CarlaEngineProjectLoader::getLoaderThreadLastError() noexcept
+{
+    pthread_once(&sLoaderThreadKeyOnce, createLoaderThreadKey);
+
+    return static_cast<CarlaString*>(pthread_getspecific(sLoaderThreadKey));
+}
+
+std::vector<ProjectPluginJob*>* CarlaEngineProjectLoader::takeGroup() noexcept
+{
+    const CarlaMutexLocker cml(fMutex);
+
+    if (fNextGroup >= fGroups.size())
+        return nullptr;
+
+    return &fGroups[fNextGroup++];
+}
+
+void CarlaEngineProjectLoader::loadJob(ProjectPluginJob* const job)
+{
+    if (kEngine->pData->aboutToClose || kEngine->pData->actionCanceled)
+        return;
+
+    const CarlaStateSave& stateSave(job->stateSave);
+    const uint64_t startTime = carla_gettime_ns();
+
+    job->plugin = kEngine->createPlugin(job->id, job->btype, job->ptype, stateSave.binary,
+                                        stateSave.name, stateSave.label, stateSave.uniqueId,
+                                        job->extra, stateSave.options);
+
+    if (const CarlaPluginPtr plugin = job->plugin)
+    {
+        // deactivate bridge client-side ping check, since some plugins block during load
+        if ((plugin->getHints() & PLUGIN_IS_BRIDGE) != 0)
+            plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "false", false);
+
+        // restore state before the plugin is enabled and known to the host
+        // its id might still change, so engine callbacks are not sent meanwhile
+        const ScopedLoaderContext slc;
+        plugin->loadStateSave(stateSave);
+    }
+    else
+    {
+        job->error = kEngine->getLastError();
+    }
+
+    job->loadTime = carla_gettime_ns() - startTime;
+}
+
+void CarlaEngineProjectLoader::addToEngine(ProjectPluginJob* const job)
+{
+    const CarlaPluginPtr plugin = job->plugin;
+
+    if (plugin.get() == nullptr)
+    {
+        carla_stderr2("Failed to load a plugin '%s', error was:\n%s", job->stateSave.name, job->error.buffer());
+        return;
+    }
+
+    CarlaEngine::ProtectedData* const pData = kEngine->pData;
+    const uint id = pData->curPluginCount;
+
+    CARLA_SAFE_ASSERT_RETURN(id < pData->maxPluginNumber,);
+    CARLA_SAFE_ASSERT_RETURN(pData->plugins[id].plugin.get() == nullptr,);
+
+    // a previous plugin failed to load
+    if (plugin->getId() != id)
+        plugin->setId(id);
+
+    // names were only checked against plugins already in the engine
+    const char* const uniqueName = kEngine->getUniquePluginName(plugin->getName());
+
+    EnginePluginData& pluginData(pData->plugins[id]);
+    pluginData.plugin = plugin;
+    carla_zeroFloats(pluginData.peaks, 4);
+
+    plugin->setEnabled(true);
+
+    ++pData->curPluginCount;
+    kEngine->callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, id, plugin->getType(),
+                      0, 0, 0.0f,
+                      plugin->getName());
+
+    if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+        pData->graph.addPlugin(plugin);
+    else
+        pData->graph.updateRackLanes(pData);
+
+    if (uniqueName != nullptr)
+    {
+        if (std::strcmp(uniqueName, plugin->getName()) != 0)
+            kEngine->renamePlugin(id, uniqueName);
+
+        delete[] uniqueName;
+    }
+
+    carla_stdout("Loaded plugin '%s' in %.1f ms%s",
+                 plugin->getName(),
+                 static_cast<double>(job->loadTime) / 1000000.0,
+                 job->needsMainThread ? " (main thread)" : "");
+}
+
+void CarlaEngineProjectLoader::clear()
+{
+    for (std::vector<ProjectPluginJob*>::iterator it = fJobs.begin(); it != fJobs.end(); ++it)
+        delete *it;
+
+    fJobs.clear();
+    fGroups.clear();
+    fNextGroup = 0;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,138 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_PROJECT_LOADER_HPP_INCLUDED
+#define CARLA_ENGINE_PROJECT_LOADER_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+#include "CarlaMutex.hpp"
+#include "CarlaStateUtils.hpp"
+#include "CarlaString.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include <vector>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// ProjectPluginJob
+
+/*
+ * A plugin to be loaded from a project.
+ */
+struct ProjectPluginJob {
+    CarlaStateSave stateSave;
+    BinaryType  btype;
+    PluginType  ptype;
+    const void* extra;
+
+    uint id;              // id used on creation, it might get lower if a previous plugin fails to load
+    bool needsMainThread; // created on the main thread
+
+    CarlaPluginPtr plugin; // null if loading failed
+    CarlaString error;
+    uint64_t loadTime;     // time spent creating and restoring state, in nanoseconds
+
+    ProjectPluginJob() noexcept
+        : stateSave(),
+          btype(BINARY_NATIVE),
+          ptype(PLUGIN_NONE),
+          extra(nullptr),
+          id(0),
+          needsMainThread(true),
+          plugin(),
+          error(),
+          loadTime(0) {}
+
+    CARLA_DECLARE_NON_COPYABLE(ProjectPluginJob)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineProjectLoader
+
+/*
+ * Creates the plugins of a project using several threads.
+ * Plugins that need the main thread are created on it meanwhile, instances of the same plugin are always created
+ * one after the other on a single thread.
+ * The state of each plugin is restored right after it is created, on the same thread, with engine callbacks
+ * disabled as plugin ids are not final yet.
+ * Once everything is loaded the plugins are enabled and added to the engine in project order.
+ */
+class CarlaEngineProjectLoader
+{
+public:
+    CarlaEngineProjectLoader(CarlaEngine* engine) noexcept;
+    ~CarlaEngineProjectLoader();
+
+    /*
+     * Add a plugin to be loaded, in project order.
+     * Takes ownership of @a job.
+     */
+    void addJob(ProjectPluginJob* job);
+
+    /*
+     * Check if there are plugins waiting to be loaded.
+     */
+    bool hasJobs() const noexcept;
+
+    /*
+     * Load all pending plugins and add them to the engine.
+     * Returns false if loading was canceled, in which case no plugins are added.
+     * @note Must be called from the main thread, which keeps sending idle callbacks while plugins load
+     */
+    bool run(uint numThreads);
+
+    /*
+     * Check if the calling thread is a loader thread.
+     * Engine callbacks are not sent from loader threads, as their plugins are not known to the host yet.
+     * The main thread also counts as a loader thread while restoring the state of plugins it created.
+     */
+    static bool isLoaderThread() noexcept;
+
+    /*
+     * Get the last error storage of the calling thread, or null if it is not a loader thread.
+     */
+    static CarlaString* getLoaderThreadLastError() noexcept;
+
+private:
+    class LoaderThread;
+
+    CarlaEngine* const kEngine;
+
+    std::vector<ProjectPluginJob*> fJobs;
+
+    // groups of jobs using the same plugin, loader threads take one group at a time
+    std::vector<std::vector<ProjectPluginJob*> > fGroups;
+    std::size_t fNextGroup;
+
+    std::vector<LoaderThread*> fThreads;
+    CarlaMutex fMutex;
+
+    std::vector<ProjectPluginJob*>* takeGroup() noexcept;
+    void loadJob(ProjectPluginJob* job);
+    void addToEngine(ProjectPluginJob* job);
+    void clear();
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineProjectLoader)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_PROJECT_LOADER_HPP_INCLUDED
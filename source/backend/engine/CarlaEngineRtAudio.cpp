@@ -677,12 +677,11 @@ protected:
         }
 
         // initialize events
-        carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+        pData->events.in.clear();
+        pData->events.out.clear();
 
         if (fMidiInEvents.mutex.tryLock())
         {
-            uint32_t engineEventIndex = 0;
             fMidiInEvents.splice();
 
             for (LinkedList<RtMidiEvent>::Itenerator it = fMidiInEvents.data.begin2(); it.valid(); it.next())
@@ -692,7 +691,7 @@ protected:
                 const RtMidiEvent& midiEvent(it.getValue(fallback));
                 CARLA_SAFE_ASSERT_CONTINUE(midiEvent.size > 0);
 
-                EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
+                EngineEvent& engineEvent(pData->events.in.data[pData->events.in.count++]);
 
                 if (midiEvent.time < pData->timeInfo.frame)
                 {
@@ -708,7 +707,7 @@ protected:
 
                 engineEvent.fillFromMidiData(midiEvent.size, midiEvent.data, 0);
 
-                if (engineEventIndex >= kMaxEngineEventInternalCount)
+                if (pData->events.in.count >= kMaxEngineEventInternalCount)
                     break;
             }
 
@@ -727,13 +726,13 @@ protected:
             uint8_t mdataTmp[EngineMidiEvent::kDataSize];
             const uint8_t* mdataPtr;
 
-            for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+            for (uint32_t i=0; i < pData->events.out.count; ++i)
             {
-                const EngineEvent& engineEvent(pData->events.out[i]);
+                const EngineEvent& engineEvent(pData->events.out.data[i]);
 
                 /**/ if (engineEvent.type == kEngineEventTypeNull)
                 {
-                    break;
+                    continue;
                 }
                 else if (engineEvent.type == kEngineEventTypeControl)
                 {
@@ -25,12 +25,19 @@ CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
 
+// Changed output parameters of a plugin are sent at most once per this window (in ms), later changes are coalesced
+static const uint32_t kParameterOutputsCoalesceTime = 50;
+
+// -----------------------------------------------------------------------
+
 CarlaEngineRunner::CarlaEngineRunner(CarlaEngine* const engine) noexcept
     : CarlaRunner("CarlaEngineRunner"),
       kEngine(engine),
       fEngineHasIdleOnMainThread(false),
       fIsAlwaysRunning(false),
-      fIsPlugin(false)
+      fIsPlugin(false),
+      fParameterOutputTimes(nullptr),
+      fParameterOutputTimesCount(0)
 {
     CARLA_SAFE_ASSERT(engine != nullptr);
     carla_debug("CarlaEngineRunner::CarlaEngineRunner(%p)", engine);
@@ -39,6 +46,8 @@ CarlaEngineRunner::CarlaEngineRunner(CarlaEngine* const engine) noexcept
 CarlaEngineRunner::~CarlaEngineRunner() noexcept
 {
     carla_debug("CarlaEngineRunner::~CarlaEngineRunner()");
+
+    delete[] fParameterOutputTimes;
 }
 
 void CarlaEngineRunner::start()
@@ -51,6 +60,17 @@ void CarlaEngineRunner::start()
     fIsPlugin = kEngine->getType() == kEngineTypePlugin;
     fIsAlwaysRunning = kEngine->getType() == kEngineTypeBridge || fIsPlugin;
 
+    const uint maxPluginNumber = kEngine->getMaxPluginNumber();
+
+    if (fParameterOutputTimesCount != maxPluginNumber)
+    {
+        delete[] fParameterOutputTimes;
+        fParameterOutputTimes = maxPluginNumber != 0 ? new uint32_t[maxPluginNumber] : nullptr;
+        fParameterOutputTimesCount = maxPluginNumber;
+    }
+
+    carla_zeroStructs(fParameterOutputTimes, fParameterOutputTimesCount);
+
     startRunner(25);
 }
 
@@ -68,6 +88,8 @@ bool CarlaEngineRunner::run() noexcept
 
     float value;
 
+    const uint32_t timeNow = water::Time::getMillisecondCounter();
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     // int64_t lastPingTime = 0;
     const CarlaEngineOsc& engineOsc(kEngine->pData->osc);
@@ -114,23 +136,29 @@ bool CarlaEngineRunner::run() noexcept
         if (oscRegistedForUDP || updateUI)
         {
             // -------------------------------------------------------
-            // Update parameter outputs
+            // Update changed parameter outputs
 
-            for (uint32_t j=0, pcount=plugin->getParameterCount(); j < pcount; ++j)
+            if (i >= fParameterOutputTimesCount || timeNow - fParameterOutputTimes[i] >= kParameterOutputsCoalesceTime)
             {
-                if (! plugin->isParameterOutput(j))
-                    continue;
+                bool changed = false;
 
-                value = plugin->getParameterValue(j);
+                for (uint32_t j=0; plugin->getNextChangedParameterOutput(j); ++j)
+                {
+                    changed = true;
+                    value = plugin->getParameterValue(j);
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
-                // Update OSC engine client
-                if (oscRegistedForUDP)
-                    engineOsc.sendParameterValue(i, j, value);
+                    // Update OSC engine client
+                    if (oscRegistedForUDP)
+                        engineOsc.sendParameterValue(i, j, value);
 #endif
-                // Update UI
-                if (updateUI)
-                    plugin->uiParameterChange(j, value);
+                    // Update UI
+                    if (updateUI)
+                        plugin->uiParameterChange(j, value);
+                }
+
+                if (changed && i < fParameterOutputTimesCount)
+                    fParameterOutputTimes[i] = timeNow;
             }
 
             if (updateUI)
@@ -47,6 +47,10 @@ private:
     bool fIsAlwaysRunning;
     bool fIsPlugin;
 
+    // per plugin, last time changed output parameters were sent
+    uint32_t* fParameterOutputTimes;
+    uint fParameterOutputTimesCount;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineRunner)
 };
 
@@ -343,8 +343,8 @@ protected:
             carla_zeroFloats(fAudioIntBufOut[i], ulen);
 
         // initialize events
-        carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+        pData->events.in.clear();
+        pData->events.out.clear();
 
         pData->graph.process(pData, nullptr, fAudioIntBufOut, ulen);
 
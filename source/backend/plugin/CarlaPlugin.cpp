@@ -20,6 +20,7 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
+#include "CarlaChunkFileUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 #include "CarlaPluginUI.hpp"
@@ -140,6 +141,13 @@ bool CarlaPlugin::isEnabled() const noexcept
     return pData->enabled;
 }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+uint CarlaPlugin::getRackLane() const noexcept
+{
+    return pData->rackLane;
+}
+#endif
+
 const char* CarlaPlugin::getName() const noexcept
 {
     return pData->name;
@@ -265,6 +273,20 @@ bool CarlaPlugin::isParameterOutput(const uint32_t parameterId) const noexcept
     return (pData->param.data[parameterId].type == PARAMETER_OUTPUT);
 }
 
+bool CarlaPlugin::getNextChangedParameterOutput(uint32_t& parameterId) noexcept
+{
+    if (pData->param.outputsTracked)
+        return pData->param.takeNextChangedOutput(parameterId);
+
+    for (; parameterId < pData->param.count; ++parameterId)
+    {
+        if (pData->param.data[parameterId].type == PARAMETER_OUTPUT)
+            return true;
+    }
+
+    return false;
+}
+
 const MidiProgramData& CarlaPlugin::getMidiProgramData(const uint32_t index) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(index < pData->midiprog.count, kMidiProgramDataNull);
@@ -554,6 +576,7 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
     pData->stateSave.balanceRight = pData->postProc.balanceRight;
     pData->stateSave.panning      = pData->postProc.panning;
     pData->stateSave.ctrlChannel  = pData->ctrlChannel;
+    pData->stateSave.rackLane     = pData->rackLane;
    #endif
 
     if (pData->hints & PLUGIN_IS_BRIDGE)
@@ -571,7 +594,13 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
 
         if (data != nullptr && dataSize > 0)
         {
-            pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
+           #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+            // big chunks can be stored as raw files next to the project being saved
+            pData->stateSave.chunkFile = pData->engine->saveProjectChunkFile(data, dataSize);
+
+            if (pData->stateSave.chunkFile == nullptr)
+           #endif
+                pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
 
             if (pluginType != PLUGIN_INTERNAL && pluginType != PLUGIN_JSFX)
                 usingChunk = true;
@@ -706,6 +735,8 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
             pass();
         else if (usesMultiProgs && std::strcmp(key, "midiPrograms") == 0)
             pass();
+        else if (pluginType == PLUGIN_SF2 && std::strcmp(key, "cpuCores") == 0)
+            pass();
         else
             continue;
 
@@ -911,6 +942,8 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
             continue;
         if (usesMultiProgs && std::strcmp(key, "midiPrograms") == 0)
             continue;
+        if (pluginType == PLUGIN_SF2 && std::strcmp(key, "cpuCores") == 0)
+            continue;
 
         setCustomData(stateCustomData->type, key, stateCustomData->value, true);
     }
@@ -936,6 +969,19 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
     // ---------------------------------------------------------------
     // Part 6 - set chunk
 
+   #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (stateSave.chunkFile != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+    {
+        // used directly from the mapped file, without copies
+        CarlaMappedFile mappedFile;
+
+        if (pData->engine->loadProjectChunkFile(stateSave.chunkFile, mappedFile))
+            setChunkData(mappedFile.getData(), mappedFile.getSize());
+        else
+            carla_stderr2("Failed to load chunk file '%s' of plugin '%s'", stateSave.chunkFile, pData->name);
+    }
+    else
+   #endif
     if (stateSave.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
     {
         std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateSave.chunk));
@@ -966,6 +1012,7 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
     setBalanceRight(stateSave.balanceRight, true, true);
     setPanning(stateSave.panning, true, true);
     setCtrlChannel(stateSave.ctrlChannel, true, true);
+    setRackLane(stateSave.rackLane);
     setActive(stateSave.active, true, true);
 
     if (! pData->engine->isLoadingProject())
@@ -1656,6 +1703,15 @@ void CarlaPlugin::setCtrlChannel(const int8_t channel, const bool sendOsc, const
 #endif
 }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+void CarlaPlugin::setRackLane(const uint lane) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(lane < MAX_PROCESS_THREADS,);
+
+    pData->rackLane = lane;
+}
+#endif
+
 // -------------------------------------------------------------------
 // Set data (plugin-specific stuff)
 
@@ -2081,15 +2137,23 @@ void CarlaPlugin::deactivate() noexcept
     CARLA_SAFE_ASSERT(pData->active);
 }
 
-void CarlaPlugin::bufferSizeChanged(const uint32_t newBufferSize)
+bool CarlaPlugin::canProcessAsync() const noexcept
+{
+    return false;
+}
+
+void CarlaPlugin::processStart(const float* const* const audioIn, float** const audioOut,
+                               const float* const* const cvIn, float** const cvOut, const uint32_t frames)
+{
+    process(audioIn, audioOut, cvIn, cvOut, frames);
+}
+
+void CarlaPlugin::processFinish()
+{
+}
+
+void CarlaPlugin::bufferSizeChanged(const uint32_t)
 {
-   #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    delete[] pData->postProc.extraBuffer;
-    pData->postProc.extraBuffer = new float[newBufferSize];
-   #else
-    // unused
-    (void)newBufferSize;
-   #endif
 }
 
 void CarlaPlugin::sampleRateChanged(const double)
@@ -2329,6 +2393,11 @@ void CarlaPlugin::idle()
     }
 }
 
+bool CarlaPlugin::getWorkerStats(EngineWorkerStats&) const noexcept
+{
+    return false;
+}
+
 bool CarlaPlugin::tryLock(const bool forcedOffline) noexcept
 {
     if (forcedOffline)
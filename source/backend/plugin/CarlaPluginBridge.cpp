@@ -456,6 +456,11 @@ public:
           fBufferSize(engine->getBufferSize()),
           fProcWaitTime(0),
           fPendingEmbedCustomUI(0),
+          fProcPending(false),
+          fProcAudioIn(nullptr),
+          fProcAudioOut(nullptr),
+          fProcCVOut(nullptr),
+          fProcFrames(0),
           fBridgeBinary(),
           fBridgeThread(engine, this),
           fShmAudioPool(),
@@ -474,6 +479,7 @@ public:
         carla_debug("CarlaPluginBridge::CarlaPluginBridge(%p, %i, %s, %s)", engine, id, BinaryType2Str(btype), PluginType2Str(ptype));
 
         pData->hints |= PLUGIN_IS_BRIDGE;
+        pData->param.outputsTracked = true;
     }
 
     ~CarlaPluginBridge() override
@@ -1436,6 +1442,42 @@ public:
                  const float* const* const cvIn,
                  float** const cvOut,
                  const uint32_t frames) override
+    {
+        if (processBegin(audioIn, audioOut, cvIn, cvOut, frames))
+            processEnd();
+    }
+
+    bool canProcessAsync() const noexcept override
+    {
+        return true;
+    }
+
+    void processStart(const float* const* const audioIn,
+                      float** const audioOut,
+                      const float* const* const cvIn,
+                      float** const cvOut,
+                      const uint32_t frames) override
+    {
+        CARLA_SAFE_ASSERT(! fProcPending);
+
+        fProcPending = processBegin(audioIn, audioOut, cvIn, cvOut, frames);
+    }
+
+    void processFinish() override
+    {
+        if (! fProcPending)
+            return;
+
+        fProcPending = false;
+        processEnd();
+    }
+
+    // sends events and audio to the bridge and tells it to process, returns true if processEnd() must follow
+    bool processBegin(const float* const* const audioIn,
+                      float** const audioOut,
+                      const float* const* const cvIn,
+                      float** const cvOut,
+                      const uint32_t frames)
     {
         // --------------------------------------------------------------------------------------------------------
         // Check if active
@@ -1447,7 +1489,7 @@ public:
                 carla_zeroFloats(audioOut[i], frames);
             for (uint32_t i=0; i < pData->cvOut.count; ++i)
                 carla_zeroFloats(cvOut[i], frames);
-            return;
+            return false;
         }
 
         // --------------------------------------------------------------------------------------------------------
@@ -1747,7 +1789,13 @@ public:
 
         } // End of Event Input
 
-        if (! processSingle(audioIn, audioOut, cvIn, cvOut, frames))
+        return processSingleBegin(audioIn, audioOut, cvIn, cvOut, frames);
+    }
+
+    // waits for the bridge started in processBegin() and collects its output
+    void processEnd()
+    {
+        if (! processSingleEnd())
             return;
 
         // --------------------------------------------------------------------------------------------------------
@@ -1812,8 +1860,8 @@ public:
         } // End of Control and MIDI Output
     }
 
-    bool processSingle(const float* const* const audioIn, float** const audioOut,
-                       const float* const* const cvIn, float** const cvOut, const uint32_t frames)
+    bool processSingleBegin(const float* const* const audioIn, float** const audioOut,
+                            const float* const* const cvIn, float** const cvOut, const uint32_t frames)
     {
         CARLA_SAFE_ASSERT_RETURN(! fTimedError, false);
         CARLA_SAFE_ASSERT_RETURN(frames > 0, false);
@@ -1897,7 +1945,28 @@ public:
             fShmRtClientControl.commitWrite();
         }
 
-        waitForClient("process", fProcWaitTime);
+        fShmRtClientControl.postClient();
+
+        fProcAudioIn  = audioIn;
+        fProcAudioOut = audioOut;
+        fProcCVOut    = cvOut;
+        fProcFrames   = frames;
+        return true;
+    }
+
+    bool processSingleEnd()
+    {
+        const float* const* const audioIn = fProcAudioIn;
+        float** const audioOut = fProcAudioOut;
+        float** const cvOut = fProcCVOut;
+        const uint32_t frames = fProcFrames;
+
+        fProcAudioIn  = nullptr;
+        fProcAudioOut = nullptr;
+        fProcCVOut    = nullptr;
+        fProcFrames   = 0;
+
+        waitForClientReply("process", fProcWaitTime);
 
         if (fTimedOut)
         {
@@ -1912,80 +1981,9 @@ public:
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
+        // Post-processing (dry/wet, volume, balance and panning)
 
-            bool isPair;
-            float bufValue;
-            float* const oldBufLeft = pData->postProc.extraBuffer;
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-# ifndef BUILD_BRIDGE
-                        if (k < pData->latency.frames && pData->latency.buffers != nullptr)
-                            bufValue = pData->latency.buffers[c][k];
-                        else if (pData->latency.frames < frames)
-                            bufValue = audioIn[c][k-pData->latency.frames];
-                        else
-# endif
-                            bufValue = audioIn[c][k];
-
-                        audioOut[i][k] = (audioOut[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, audioOut[i], frames);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            audioOut[i][k]  = oldBufLeft[k]     * (1.0f - balRangeL);
-                            audioOut[i][k] += audioOut[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            audioOut[i][k]  = audioOut[i][k] * balRangeR;
-                            audioOut[i][k] += oldBufLeft[k]   * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k] *= pData->postProc.volume;
-                }
-            }
-
-        } // End of Post-processing
+        pData->postProcess(audioIn, 0, true, audioOut, 0, audioOut, 0, frames);
 
 # ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
@@ -2435,6 +2433,9 @@ public:
                 {
                     const float fixedValue(pData->param.getFixedValue(index, value));
                     fParams[index].value = fixedValue;
+
+                    if (pData->param.data[index].type == PARAMETER_OUTPUT)
+                        pData->param.updateOutputValue(index, fixedValue);
                 }
             }   break;
 
@@ -2912,6 +2913,13 @@ private:
     uint fProcWaitTime;
     uint64_t fPendingEmbedCustomUI;
 
+    // process cycle started but not yet collected, see processStart()
+    bool fProcPending;
+    const float* const* fProcAudioIn;
+    float** fProcAudioOut;
+    float** fProcCVOut;
+    uint32_t fProcFrames;
+
     CarlaString             fBridgeBinary;
     CarlaPluginBridgeThread fBridgeThread;
 
@@ -3131,6 +3139,18 @@ private:
         carla_stderr2("waitForClient(%s) timed out", action);
     }
 
+    void waitForClientReply(const char* const action, const uint msecs)
+    {
+        CARLA_SAFE_ASSERT_RETURN(! fTimedOut,);
+        CARLA_SAFE_ASSERT_RETURN(! fTimedError,);
+
+        if (fShmRtClientControl.waitForClientReply(msecs))
+            return;
+
+        fTimedOut = true;
+        carla_stderr2("waitForClientReply(%s) timed out", action);
+    }
+
     bool restartBridgeThread()
     {
         fInitiated  = false;
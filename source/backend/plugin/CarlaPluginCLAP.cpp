@@ -731,6 +731,8 @@ public:
           fNeedsIdleCallback(false)
     {
         carla_debug("CarlaPluginCLAP::CarlaPluginCLAP(%p, %i)", engine, id);
+
+        pData->param.outputsTracked = true;
     }
 
     ~CarlaPluginCLAP() override
@@ -2468,70 +2470,9 @@ public:
 
        #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue;
-            float* const oldBufLeft = pData->postProc.extraBuffer;
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        bufValue = audioIn[c][k];
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, fAudioOutBuffers[i], frames);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
+        // Post-processing (dry/wet, volume, balance and panning)
 
-        } // End of Post-processing
+        pData->postProcess(audioIn, 0, false, fAudioOutBuffers, 0, audioOut, 0, frames);
        #endif // BUILD_BRIDGE_ALTERNATIVE_ARCH
 
         // --------------------------------------------------------------------------------------------------------
@@ -2583,6 +2524,8 @@ public:
                     if (pData->param.data[j].rindex != static_cast<int32_t>(ev.param.param_id))
                         continue;
                     pData->postponeParameterChangeRtEvent(true, static_cast<int32_t>(j), ev.param.value);
+                    if (pData->param.data[j].type == PARAMETER_OUTPUT)
+                        pData->param.updateOutputValue(j, static_cast<float>(ev.param.value));
                     break;
                 }
                 break;
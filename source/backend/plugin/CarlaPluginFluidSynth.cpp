@@ -22,22 +22,1069 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaMathUtils.hpp"
+#include "CarlaMemUtils.hpp"
+#include "CarlaThread.hpp"
 
+#include "water/files/File.h"
+#include "water/files/FileInputStream.h"
+#include "water/memory/ByteOrder.h"
 #include "water/text/StringArray.h"
 
 #include <fluidsynth.h>
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
 #define FLUID_DEFAULT_POLYPHONY 64
 
-using water::String;
-using water::StringArray;
+using water::String;
+using water::StringArray;
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -------------------------------------------------------------------------------------------------------------------
+// Fallback data
+
+static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
+
+// -------------------------------------------------------------------------------------------------------------------
+// SoundFonts shared between all instances
+
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+/*
+ * SoundFont 2 files are parsed here instead of by FluidSynth, so that all instances share their sample data.
+ * FluidSynth modifies SoundFont, preset and sample objects while in use, so every synth gets its own set of them
+ * from FluidSoundFontLoader, with samples pointing into the single read-only buffer kept in FluidSoundFontData.
+ * Files not handled here, like SF3 or DLS, are left to the default FluidSynth loader.
+ */
+
+static const int kFluidGenCount = GEN_OVERRIDEROOTKEY + 1;
+
+struct FluidSoundFontModulator {
+    int src1, flags1;
+    int src2, flags2;
+    int dest;
+    double amount;
+
+    // as in fluid_mod_test_identity(), identical modulators in a zone replace each other
+    bool isIdentical(const FluidSoundFontModulator& other) const noexcept
+    {
+        return dest == other.dest
+            && src1 == other.src1 && flags1 == other.flags1
+            && src2 == other.src2 && flags2 == other.flags2;
+    }
+};
+
+struct FluidSoundFontZone {
+    uint64_t genMask;
+    float gens[kFluidGenCount];
+    int keyLo, keyHi;
+    int velLo, velHi;
+    int index; // instrument of preset zones, sample of instrument zones
+    std::vector<FluidSoundFontModulator> modulators;
+    std::vector<fluid_mod_t*> mods; // created from the modulators above once parsing is done
+
+    FluidSoundFontZone() noexcept
+        : genMask(0),
+          keyLo(0),
+          keyHi(127),
+          velLo(0),
+          velHi(127),
+          index(-1),
+          modulators(),
+          mods()
+    {
+        carla_zeroFloats(gens, kFluidGenCount);
+    }
+
+    bool contains(const int key, const int vel) const noexcept
+    {
+        return key >= keyLo && key <= keyHi && vel >= velLo && vel <= velHi;
+    }
+};
+
+struct FluidSoundFontPreset {
+    char name[21];
+    int bank;
+    int program;
+    std::vector<FluidSoundFontZone> zones;
+};
+
+struct FluidSoundFontInstrument {
+    std::vector<FluidSoundFontZone> zones;
+};
+
+struct FluidSoundFontSample {
+    char name[21];
+    uint32_t start;
+    uint32_t frames;
+    uint32_t loopStart; // relative to start
+    uint32_t loopEnd;   // relative to start
+    uint32_t sampleRate;
+    int rootKey;
+    int fineTune;
+    bool valid;
+};
+
+/*
+ * The contents of a SoundFont 2 file, read-only once loaded.
+ * Presets are sorted by bank and program, global zones are already merged into local ones.
+ */
+struct FluidSoundFontData {
+    const CarlaString filename;
+    const int64_t mtime;
+
+    int16_t* pcm;
+    char* pcm24; // optional lower byte of 24-bit samples
+    size_t pcmFrames;
+    bool pcmLocked;
+
+    std::vector<FluidSoundFontPreset> presets;
+    std::vector<FluidSoundFontInstrument> instruments;
+    std::vector<FluidSoundFontSample> samples;
+
+    uint refcount; // protected by the cache mutex
+    bool loaded;   // loading was attempted, protected by the mutex below
+    bool valid;
+
+    // held while loading
+    CarlaMutex mutex;
+
+    FluidSoundFontData(const char* const fname, const int64_t fmtime) noexcept
+        : filename(fname),
+          mtime(fmtime),
+          pcm(nullptr),
+          pcm24(nullptr),
+          pcmFrames(0),
+          pcmLocked(false),
+          presets(),
+          instruments(),
+          samples(),
+          refcount(1),
+          loaded(false),
+          valid(false),
+          mutex() {}
+
+    ~FluidSoundFontData()
+    {
+        deleteMods(presets);
+        deleteMods(instruments);
+
+        if (pcmLocked)
+            carla_munlock(pcm, pcmFrames * sizeof(int16_t));
+
+        delete[] pcm;
+        delete[] pcm24;
+    }
+
+    void load()
+    {
+        loaded = true;
+
+        water::FileInputStream stream(water::File(filename.buffer()));
+
+        if (stream.failedToOpen())
+            return;
+
+        try {
+            valid = readFile(stream);
+        } CARLA_SAFE_EXCEPTION("FluidSoundFontData::load");
+
+        if (! valid)
+            return;
+
+        createMods(presets);
+        createMods(instruments);
+
+        // same as the default loader with synth.lock-memory enabled
+        pcmLocked = carla_mlock(pcm, pcmFrames * sizeof(int16_t));
+    }
+
+private:
+    struct ListChunk {
+        const uint8_t* data;
+        uint32_t count;
+    };
+
+    bool readFile(water::FileInputStream& stream)
+    {
+        char id[4];
+        uint32_t size;
+
+        if (! readChunkHeader(stream, id, size) || std::memcmp(id, "RIFF", 4) != 0)
+            return false;
+        if (stream.read(id, 4) != 4 || std::memcmp(id, "sfbk", 4) != 0)
+            return false;
+
+        const int64_t riffEnd = std::min<int64_t>(8 + static_cast<int64_t>(size), stream.getTotalLength());
+        std::vector<uint8_t> pdta;
+
+        for (int64_t pos = 12; pos + 12 <= riffEnd;)
+        {
+            if (! stream.setPosition(pos) || ! readChunkHeader(stream, id, size))
+                return false;
+
+            const int64_t listEnd = std::min<int64_t>(pos + 8 + size, riffEnd);
+            pos += 8 + size + (size & 1);
+
+            if (std::memcmp(id, "LIST", 4) != 0 || size < 4 || stream.read(id, 4) != 4)
+                continue;
+
+            if (std::memcmp(id, "INFO", 4) == 0)
+            {
+                // SF3 and later are left to FluidSynth
+                if (! readVersion(stream, listEnd))
+                    return false;
+            }
+            else if (std::memcmp(id, "sdta", 4) == 0)
+            {
+                if (! readSampleData(stream, listEnd))
+                    return false;
+            }
+            else if (std::memcmp(id, "pdta", 4) == 0)
+            {
+                pdta.resize(static_cast<size_t>(listEnd - stream.getPosition()));
+
+                if (! readFully(stream, pdta.data(), pdta.size()))
+                    return false;
+            }
+        }
+
+        if (pcm == nullptr || pdta.empty())
+            return false;
+
+        return readPresetData(pdta.data(), pdta.size());
+    }
+
+    bool readVersion(water::FileInputStream& stream, const int64_t listEnd)
+    {
+        char id[4];
+        uint32_t size;
+        uint8_t version[2];
+
+        for (int64_t pos = stream.getPosition(); pos + 8 <= listEnd; pos += 8 + size + (size & 1))
+        {
+            if (! stream.setPosition(pos) || ! readChunkHeader(stream, id, size))
+                return false;
+
+            if (std::memcmp(id, "ifil", 4) == 0)
+                return size >= 4 && stream.read(version, 2) == 2 && version[0] == 2 && version[1] == 0;
+        }
+
+        return false;
+    }
+
+    bool readSampleData(water::FileInputStream& stream, const int64_t listEnd)
+    {
+        char id[4];
+        uint32_t size;
+        int64_t sm24Pos = -1;
+        uint32_t sm24Size = 0;
+
+        for (int64_t pos = stream.getPosition(); pos + 8 <= listEnd; pos += 8 + size + (size & 1))
+        {
+            if (! stream.setPosition(pos) || ! readChunkHeader(stream, id, size))
+                return false;
+            if (pos + 8 + size > listEnd)
+                return false;
+
+            if (std::memcmp(id, "smpl", 4) == 0 && pcm == nullptr)
+            {
+                pcmFrames = size / sizeof(int16_t);
+                pcm = new int16_t[pcmFrames];
+
+                if (! readFully(stream, pcm, pcmFrames * sizeof(int16_t)))
+                    return false;
+
+                for (size_t i=0; i < pcmFrames; ++i)
+                    pcm[i] = water::ByteOrder::swapIfBigEndian(pcm[i]);
+            }
+            else if (std::memcmp(id, "sm24", 4) == 0)
+            {
+                sm24Pos = pos + 8;
+                sm24Size = size;
+            }
+        }
+
+        // a lower byte chunk not matching the samples is ignored, as per the specification
+        if (pcm != nullptr && sm24Pos >= 0 && sm24Size >= pcmFrames && stream.setPosition(sm24Pos))
+        {
+            pcm24 = new char[pcmFrames];
+
+            if (! readFully(stream, pcm24, pcmFrames))
+            {
+                delete[] pcm24;
+                pcm24 = nullptr;
+            }
+        }
+
+        return pcm != nullptr;
+    }
+
+    bool readPresetData(const uint8_t* const data, const size_t size)
+    {
+        ListChunk phdr = {}, pbag = {}, pmod = {}, pgen = {}, inst = {}, ibag = {}, imod = {}, igen = {}, shdr = {};
+
+        struct {
+            const char* id;
+            uint32_t recordSize;
+            ListChunk* chunk;
+        } const kChunks[] = {
+            { "phdr", 38, &phdr }, { "pbag", 4, &pbag }, { "pmod", 10, &pmod },
+            { "pgen", 4, &pgen }, { "inst", 22, &inst }, { "ibag", 4, &ibag },
+            { "imod", 10, &imod }, { "igen", 4, &igen }, { "shdr", 46, &shdr },
+        };
+
+        for (size_t pos = 0; pos + 8 <= size;)
+        {
+            const uint8_t* const header = data + pos;
+            const uint32_t chunkSize = readU32(header + 4);
+
+            if (chunkSize > size - pos - 8)
+                return false;
+
+            for (size_t i=0; i < sizeof(kChunks)/sizeof(kChunks[0]); ++i)
+            {
+                if (std::memcmp(header, kChunks[i].id, 4) != 0)
+                    continue;
+                if (chunkSize % kChunks[i].recordSize != 0)
+                    return false;
+
+                kChunks[i].chunk->data  = header + 8;
+                kChunks[i].chunk->count = chunkSize / kChunks[i].recordSize;
+                break;
+            }
+
+            pos += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        // every list ends with a terminal record
+        if (phdr.count < 2 || pbag.count < 1 || pmod.count < 1 || pgen.count < 1 ||
+            inst.count < 2 || ibag.count < 1 || imod.count < 1 || igen.count < 1 || shdr.count < 2)
+            return false;
+
+        samples.resize(shdr.count - 1);
+
+        for (uint32_t i=0; i < shdr.count - 1; ++i)
+            readSample(shdr.data + i * 46, samples[i]);
+
+        instruments.resize(inst.count - 1);
+
+        for (uint32_t i=0; i < inst.count - 1; ++i)
+        {
+            const uint16_t firstBag = readU16(inst.data + i * 22 + 20);
+            const uint16_t lastBag  = readU16(inst.data + i * 22 + 22 + 20);
+
+            if (! readZones(ibag, igen, imod, firstBag, lastBag, false,
+                            static_cast<uint32_t>(samples.size()), instruments[i].zones))
+                return false;
+        }
+
+        presets.resize(phdr.count - 1);
+
+        for (uint32_t i=0; i < phdr.count - 1; ++i)
+        {
+            const uint8_t* const record = phdr.data + i * 38;
+            FluidSoundFontPreset& preset(presets[i]);
+
+            std::memcpy(preset.name, record, 20);
+            preset.name[20] = '\0';
+            preset.program = readU16(record + 20);
+            preset.bank    = readU16(record + 22);
+
+            const uint16_t firstBag = readU16(record + 24);
+            const uint16_t lastBag  = readU16(record + 38 + 24);
+
+            if (! readZones(pbag, pgen, pmod, firstBag, lastBag, true,
+                            static_cast<uint32_t>(instruments.size()), preset.zones))
+                return false;
+        }
+
+        std::stable_sort(presets.begin(), presets.end(), comparePresets);
+        return true;
+    }
+
+    void readSample(const uint8_t* const record, FluidSoundFontSample& sample) const noexcept
+    {
+        const uint32_t start     = readU32(record + 20);
+        const uint32_t end       = readU32(record + 24);
+        const uint32_t loopStart = readU32(record + 28);
+        const uint32_t loopEnd   = readU32(record + 32);
+        const uint16_t type      = readU16(record + 44);
+
+        std::memcpy(sample.name, record, 20);
+        sample.name[20]   = '\0';
+        sample.sampleRate = readU32(record + 36);
+        sample.rootKey    = record[40] <= 127 ? record[40] : 60;
+        sample.fineTune   = static_cast<int8_t>(record[41]);
+
+        // ROM samples are not part of the file
+        sample.valid = (type & 0x8000) == 0 && start < end && end <= pcmFrames && sample.sampleRate != 0;
+
+        if (! sample.valid)
+            return;
+
+        sample.start     = start;
+        sample.frames    = end - start;
+        sample.loopStart = std::min(loopStart > start ? loopStart - start : 0, sample.frames);
+        sample.loopEnd   = std::min(loopEnd > start ? loopEnd - start : 0, sample.frames);
+
+        if (sample.loopStart > sample.loopEnd)
+            std::swap(sample.loopStart, sample.loopEnd);
+    }
+
+    /*
+     * Read the zones between @a firstBag and @a lastBag, skipping the global zone after merging it into the others.
+     * Like the default loader, generators after the instrument or sample one are ignored,
+     * and preset zones ignore generators only valid for instruments.
+     */
+    static bool readZones(const ListChunk& bags, const ListChunk& gens, const ListChunk& mods,
+                          const uint32_t firstBag, const uint32_t lastBag, const bool isPreset,
+                          const uint32_t indexCount, std::vector<FluidSoundFontZone>& zones)
+    {
+        if (firstBag > lastBag || lastBag >= bags.count)
+            return false;
+
+        const uint16_t indexGen = isPreset ? GEN_INSTRUMENT : GEN_SAMPLEID;
+        FluidSoundFontZone globalZone;
+
+        for (uint32_t b = firstBag; b < lastBag; ++b)
+        {
+            const uint8_t* const bag = bags.data + b * 4;
+            const uint16_t firstGen = readU16(bag);
+            const uint16_t firstMod = readU16(bag + 2);
+            const uint16_t lastGen  = readU16(bag + 4);
+            const uint16_t lastMod  = readU16(bag + 6);
+
+            if (firstGen > lastGen || lastGen > gens.count || firstMod > lastMod || lastMod > mods.count)
+                return false;
+
+            FluidSoundFontZone zone;
+
+            for (uint32_t g = firstGen; g < lastGen; ++g)
+            {
+                const uint8_t* const record = gens.data + g * 4;
+                const uint16_t oper = readU16(record);
+
+                if (oper == indexGen)
+                {
+                    zone.index = readU16(record + 2);
+                    break;
+                }
+
+                switch (oper)
+                {
+                case GEN_KEYRANGE:
+                    zone.keyLo = record[2];
+                    zone.keyHi = record[3];
+                    break;
+                case GEN_VELRANGE:
+                    zone.velLo = record[2];
+                    zone.velHi = record[3];
+                    break;
+                default:
+                    if (! isUsableGenerator(oper, isPreset))
+                        break;
+                    zone.gens[oper] = static_cast<int16_t>(readU16(record + 2));
+                    zone.genMask |= uint64_t(1) << oper;
+                    break;
+                }
+            }
+
+            for (uint32_t m = firstMod; m < lastMod; ++m)
+            {
+                FluidSoundFontModulator modulator;
+
+                if (! readModulator(mods.data + m * 10, isPreset, modulator))
+                    continue;
+
+                bool duplicated = false;
+
+                for (size_t i=0; i < zone.modulators.size() && ! duplicated; ++i)
+                    duplicated = zone.modulators[i].isIdentical(modulator);
+
+                if (! duplicated)
+                    zone.modulators.push_back(modulator);
+            }
+
+            if (zone.index < 0)
+            {
+                // only the first zone can be global, others without instrument or sample are discarded
+                if (b == firstBag)
+                    globalZone = zone;
+                continue;
+            }
+
+            if (static_cast<uint32_t>(zone.index) >= indexCount)
+                continue;
+
+            for (int i=0; i < kFluidGenCount; ++i)
+            {
+                const uint64_t bit = uint64_t(1) << i;
+
+                if ((zone.genMask & bit) == 0 && (globalZone.genMask & bit) != 0)
+                {
+                    zone.gens[i] = globalZone.gens[i];
+                    zone.genMask |= bit;
+                }
+            }
+
+            // local modulators override identical global ones
+            std::vector<FluidSoundFontModulator> modulators;
+
+            for (size_t i=0; i < globalZone.modulators.size(); ++i)
+            {
+                bool overridden = false;
+
+                for (size_t j=0; j < zone.modulators.size() && ! overridden; ++j)
+                    overridden = zone.modulators[j].isIdentical(globalZone.modulators[i]);
+
+                if (! overridden)
+                    modulators.push_back(globalZone.modulators[i]);
+            }
+
+            modulators.insert(modulators.end(), zone.modulators.begin(), zone.modulators.end());
+            zone.modulators.swap(modulators);
+
+            zones.push_back(zone);
+        }
+
+        return true;
+    }
+
+    static bool isUsableGenerator(const uint16_t oper, const bool isPreset) noexcept
+    {
+        switch (oper)
+        {
+        case GEN_UNUSED1:
+        case GEN_UNUSED2:
+        case GEN_UNUSED3:
+        case GEN_UNUSED4:
+        case GEN_INSTRUMENT:
+        case GEN_RESERVED1:
+        case GEN_RESERVED2:
+        case GEN_SAMPLEID:
+        case GEN_RESERVED3:
+            return false;
+        case GEN_STARTADDROFS:
+        case GEN_ENDADDROFS:
+        case GEN_STARTLOOPADDROFS:
+        case GEN_ENDLOOPADDROFS:
+        case GEN_STARTADDRCOARSEOFS:
+        case GEN_ENDADDRCOARSEOFS:
+        case GEN_STARTLOOPADDRCOARSEOFS:
+        case GEN_KEYNUM:
+        case GEN_VELOCITY:
+        case GEN_ENDLOOPADDRCOARSEOFS:
+        case GEN_SAMPLEMODE:
+        case GEN_EXCLUSIVECLASS:
+        case GEN_OVERRIDEROOTKEY:
+            return ! isPreset;
+        default:
+            return oper < kFluidGenCount;
+        }
+    }
+
+    /*
+     * Read a modulator record, returning false for ones FluidSynth would not use.
+     * Modulators without effect are kept for instruments, where they can disable a default modulator.
+     */
+    static bool readModulator(const uint8_t* const record, const bool isPreset, FluidSoundFontModulator& modulator)
+    {
+        const uint16_t dest   = readU16(record + 2);
+        const int16_t  amount = static_cast<int16_t>(readU16(record + 4));
+        const uint16_t trans  = readU16(record + 8);
+
+        // linked modulators and transforms are not supported
+        if (dest >= kFluidGenCount || trans != 0 || (isPreset && amount == 0))
+            return false;
+
+        if (! readModulatorSource(readU16(record), modulator.src1, modulator.flags1))
+            return false;
+        if (! readModulatorSource(readU16(record + 6), modulator.src2, modulator.flags2))
+            return false;
+
+        // a modulator without primary source always outputs 0
+        if (modulator.src1 == FLUID_MOD_NONE && (modulator.flags1 & FLUID_MOD_CC) == 0)
+            return false;
+
+        modulator.dest   = dest;
+        modulator.amount = amount;
+        return true;
+    }
+
+    static bool readModulatorSource(const uint16_t source, int& index, int& flags) noexcept
+    {
+        const uint type = source >> 10;
+
+        // linear, concave, convex and switch, matching FluidSynth flags
+        if (type > 3)
+            return false;
+
+        index = source & 0x7f;
+        flags = static_cast<int>(type << 2);
+
+        if (source & 0x80)
+            flags |= FLUID_MOD_CC;
+        if (source & 0x100)
+            flags |= FLUID_MOD_NEGATIVE;
+        if (source & 0x200)
+            flags |= FLUID_MOD_BIPOLAR;
+
+        if (flags & FLUID_MOD_CC)
+            return index != 0 && index != 6 && (index < 32 || index > 63)
+                               && (index < 98 || index > 101) && index < 120;
+
+        switch (index)
+        {
+        case FLUID_MOD_NONE:
+        case FLUID_MOD_VELOCITY:
+        case FLUID_MOD_KEY:
+        case FLUID_MOD_KEYPRESSURE:
+        case FLUID_MOD_CHANNELPRESSURE:
+        case FLUID_MOD_PITCHWHEEL:
+        case FLUID_MOD_PITCHWHEELSENS:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool comparePresets(const FluidSoundFontPreset& a, const FluidSoundFontPreset& b) noexcept
+    {
+        return a.bank != b.bank ? a.bank < b.bank : a.program < b.program;
+    }
+
+    // records in the file are not aligned
+    static uint16_t readU16(const uint8_t* const data) noexcept
+    {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    static uint32_t readU32(const uint8_t* const data) noexcept
+    {
+        return static_cast<uint32_t>(data[0])
+            | (static_cast<uint32_t>(data[1]) << 8)
+            | (static_cast<uint32_t>(data[2]) << 16)
+            | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    static bool readChunkHeader(water::FileInputStream& stream, char id[4], uint32_t& size)
+    {
+        uint8_t header[8];
+
+        if (stream.read(header, 8) != 8)
+            return false;
+
+        std::memcpy(id, header, 4);
+        size = readU32(header + 4);
+        return true;
+    }
+
+    static bool readFully(water::FileInputStream& stream, void* const buffer, const size_t size)
+    {
+        uint8_t* ptr = static_cast<uint8_t*>(buffer);
+
+        for (size_t left = size; left != 0;)
+        {
+            const int chunk = static_cast<int>(std::min<size_t>(left, 1 << 24));
+
+            if (stream.read(ptr, chunk) != chunk)
+                return false;
+
+            ptr  += chunk;
+            left -= static_cast<size_t>(chunk);
+        }
+
+        return true;
+    }
+
+    template<typename Container>
+    static void createMods(Container& container)
+    {
+        for (typename Container::iterator it = container.begin(); it != container.end(); ++it)
+            createMods(it->zones);
+    }
+
+    static void createMods(std::vector<FluidSoundFontZone>& zones)
+    {
+        for (std::vector<FluidSoundFontZone>::iterator zit = zones.begin(); zit != zones.end(); ++zit)
+        {
+            for (std::vector<FluidSoundFontModulator>::const_iterator mit = zit->modulators.begin();
+                 mit != zit->modulators.end(); ++mit)
+            {
+                fluid_mod_t* const mod = new_fluid_mod();
+                CARLA_SAFE_ASSERT_CONTINUE(mod != nullptr);
+
+                fluid_mod_set_source1(mod, mit->src1, mit->flags1);
+                fluid_mod_set_source2(mod, mit->src2, mit->flags2);
+                fluid_mod_set_dest(mod, mit->dest);
+                fluid_mod_set_amount(mod, mit->amount);
+                zit->mods.push_back(mod);
+            }
+
+            zit->modulators.clear();
+        }
+    }
+
+    template<typename Container>
+    static void deleteMods(Container& container)
+    {
+        for (typename Container::iterator it = container.begin(); it != container.end(); ++it)
+            deleteMods(it->zones);
+    }
+
+    static void deleteMods(std::vector<FluidSoundFontZone>& zones)
+    {
+        for (std::vector<FluidSoundFontZone>::iterator zit = zones.begin(); zit != zones.end(); ++zit)
+        {
+            for (std::vector<fluid_mod_t*>::iterator mit = zit->mods.begin(); mit != zit->mods.end(); ++mit)
+                delete_fluid_mod(*mit);
+        }
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(FluidSoundFontData)
+};
+
+class FluidSoundFontCache
+{
+public:
+    static FluidSoundFontCache& getInstance()
+    {
+        static FluidSoundFontCache cache;
+        return cache;
+    }
+
+    /*
+     * Get the shared data of @a filename, loading it if needed.
+     * SoundFonts are matched by path and modification time, a modified file is loaded again.
+     * Returns null if the file could not be loaded.
+     */
+    FluidSoundFontData* acquire(const char* const filename)
+    {
+        const int64_t mtime = water::File(filename).getLastModificationTime();
+
+        FluidSoundFontData* soundFont;
+
+        {
+            const CarlaMutexLocker cml(fMutex);
+
+            const std::map<std::string, FluidSoundFontData*>::iterator it = fSoundFonts.find(filename);
+
+            if (it != fSoundFonts.end() && it->second->mtime == mtime)
+            {
+                soundFont = it->second;
+                ++soundFont->refcount;
+            }
+            else
+            {
+                // outdated entries stay alive until released by the instances using them
+                soundFont = new FluidSoundFontData(filename, mtime);
+                fSoundFonts[filename] = soundFont;
+            }
+        }
+
+        // loading happens outside the cache lock, so different files can load in parallel
+        {
+            const CarlaMutexLocker cml(soundFont->mutex);
 
-CARLA_BACKEND_START_NAMESPACE
+            if (! soundFont->loaded)
+                soundFont->load();
+        }
 
-// -------------------------------------------------------------------------------------------------------------------
-// Fallback data
+        if (! soundFont->valid)
+        {
+            release(soundFont);
+            return nullptr;
+        }
 
-static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
+        return soundFont;
+    }
+
+    /*
+     * Release data previously acquired, it is deleted once unused.
+     * Must only be called after deleting all samples pointing to it.
+     */
+    void release(FluidSoundFontData* const soundFont)
+    {
+        CARLA_SAFE_ASSERT_RETURN(soundFont != nullptr,);
+
+        const CarlaMutexLocker cml(fMutex);
+        CARLA_SAFE_ASSERT_RETURN(soundFont->refcount != 0,);
+
+        if (--soundFont->refcount != 0)
+            return;
+
+        const std::map<std::string, FluidSoundFontData*>::iterator it
+            = fSoundFonts.find(soundFont->filename.buffer());
+
+        if (it != fSoundFonts.end() && it->second == soundFont)
+            fSoundFonts.erase(it);
+
+        delete soundFont;
+    }
+
+private:
+    CarlaMutex fMutex;
+    std::map<std::string, FluidSoundFontData*> fSoundFonts;
+
+    FluidSoundFontCache() noexcept
+        : fMutex(),
+          fSoundFonts() {}
+
+    CARLA_DECLARE_NON_COPYABLE(FluidSoundFontCache)
+};
+
+/*
+ * SoundFont loader added to every synth, creating per-synth objects on top of the shared data.
+ * Returning null from the load callback makes FluidSynth try its default loader.
+ */
+class FluidSoundFontLoader
+{
+public:
+    static void addToSynth(fluid_synth_t* const synth)
+    {
+        // the synth takes ownership of the loader
+        fluid_sfloader_t* const loader = new_fluid_sfloader(load, delete_fluid_sfloader);
+        CARLA_SAFE_ASSERT_RETURN(loader != nullptr,);
+
+        fluid_synth_add_sfloader(synth, loader);
+    }
+
+private:
+    struct SoundFont;
+
+    struct PresetRef {
+        SoundFont* font;
+        const FluidSoundFontPreset* preset;
+    };
+
+    struct SoundFont {
+        FluidSoundFontData* const data;
+        std::vector<fluid_sample_t*> samples;
+        std::vector<fluid_preset_t*> presets;
+        std::vector<PresetRef> presetRefs;
+        size_t iteration;
+
+        SoundFont(FluidSoundFontData* const d)
+            : data(d),
+              samples(d->samples.size(), nullptr),
+              presets(d->presets.size(), nullptr),
+              presetRefs(d->presets.size()),
+              iteration(0) {}
+
+        CARLA_DECLARE_NON_COPYABLE(SoundFont)
+    };
+
+    static fluid_sfont_t* load(fluid_sfloader_t*, const char* const filename)
+    {
+        FluidSoundFontData* const data = FluidSoundFontCache::getInstance().acquire(filename);
+
+        if (data == nullptr)
+            return nullptr;
+
+        fluid_sfont_t* const sfont = new_fluid_sfont(getName, getPreset, iterationStart, iterationNext, freeSoundFont);
+
+        if (sfont == nullptr)
+        {
+            FluidSoundFontCache::getInstance().release(data);
+            return nullptr;
+        }
+
+        SoundFont* const font = new SoundFont(data);
+        fluid_sfont_set_data(sfont, font);
+
+        for (size_t i=0; i < data->samples.size(); ++i)
+        {
+            const FluidSoundFontSample& s(data->samples[i]);
+
+            if (! s.valid)
+                continue;
+
+            fluid_sample_t* const sample = new_fluid_sample();
+            CARLA_SAFE_ASSERT_CONTINUE(sample != nullptr);
+
+            // without copying, samples use the shared buffer and leave it alone when deleted
+            fluid_sample_set_name(sample, s.name);
+            fluid_sample_set_sound_data(sample,
+                                        data->pcm + s.start,
+                                        data->pcm24 != nullptr ? data->pcm24 + s.start : nullptr,
+                                        s.frames, s.sampleRate, 0);
+            fluid_sample_set_loop(sample, s.loopStart, s.loopEnd);
+            fluid_sample_set_pitch(sample, s.rootKey, s.fineTune);
+            fluid_voice_optimize_sample(sample);
+
+            font->samples[i] = sample;
+        }
+
+        for (size_t i=0; i < data->presets.size(); ++i)
+        {
+            fluid_preset_t* const preset = new_fluid_preset(sfont, getPresetName, getPresetBank, getPresetNum,
+                                                            presetNoteOn, delete_fluid_preset);
+
+            if (preset == nullptr)
+            {
+                freeSoundFont(sfont);
+                return nullptr;
+            }
+
+            font->presetRefs[i].font   = font;
+            font->presetRefs[i].preset = &data->presets[i];
+            fluid_preset_set_data(preset, &font->presetRefs[i]);
+
+            font->presets[i] = preset;
+        }
+
+        return sfont;
+    }
+
+    static const char* getName(fluid_sfont_t* const sfont)
+    {
+        return static_cast<SoundFont*>(fluid_sfont_get_data(sfont))->data->filename.buffer();
+    }
+
+    static fluid_preset_t* getPreset(fluid_sfont_t* const sfont, const int bank, const int program)
+    {
+        const SoundFont* const font = static_cast<SoundFont*>(fluid_sfont_get_data(sfont));
+        const std::vector<FluidSoundFontPreset>& presets(font->data->presets);
+
+        size_t first = 0, last = presets.size();
+
+        while (first < last)
+        {
+            const size_t mid = (first + last) / 2;
+
+            if (presets[mid].bank < bank || (presets[mid].bank == bank && presets[mid].program < program))
+                first = mid + 1;
+            else
+                last = mid;
+        }
+
+        if (first == presets.size() || presets[first].bank != bank || presets[first].program != program)
+            return nullptr;
+
+        return font->presets[first];
+    }
+
+    static void iterationStart(fluid_sfont_t* const sfont)
+    {
+        static_cast<SoundFont*>(fluid_sfont_get_data(sfont))->iteration = 0;
+    }
+
+    static fluid_preset_t* iterationNext(fluid_sfont_t* const sfont)
+    {
+        SoundFont* const font = static_cast<SoundFont*>(fluid_sfont_get_data(sfont));
+
+        if (font->iteration >= font->presets.size())
+            return nullptr;
+
+        return font->presets[font->iteration++];
+    }
+
+    static int freeSoundFont(fluid_sfont_t* const sfont)
+    {
+        SoundFont* const font = static_cast<SoundFont*>(fluid_sfont_get_data(sfont));
+
+        for (size_t i=0; i < font->presets.size(); ++i)
+        {
+            if (font->presets[i] != nullptr)
+                delete_fluid_preset(font->presets[i]);
+        }
+
+        for (size_t i=0; i < font->samples.size(); ++i)
+        {
+            if (font->samples[i] != nullptr)
+                delete_fluid_sample(font->samples[i]);
+        }
+
+        FluidSoundFontCache::getInstance().release(font->data);
+        delete font;
+
+        delete_fluid_sfont(sfont);
+        return 0;
+    }
+
+    static const char* getPresetName(fluid_preset_t* const preset)
+    {
+        return static_cast<PresetRef*>(fluid_preset_get_data(preset))->preset->name;
+    }
+
+    static int getPresetBank(fluid_preset_t* const preset)
+    {
+        return static_cast<PresetRef*>(fluid_preset_get_data(preset))->preset->bank;
+    }
+
+    static int getPresetNum(fluid_preset_t* const preset)
+    {
+        return static_cast<PresetRef*>(fluid_preset_get_data(preset))->preset->program;
+    }
+
+    /*
+     * Start the voices of a note, called from the audio thread so it must not allocate.
+     * Same as the default loader: instrument generators are set and preset ones added to them,
+     * instrument modulators replace the default ones and preset ones are added to them.
+     */
+    static int presetNoteOn(fluid_preset_t* const preset, fluid_synth_t* const synth,
+                            const int chan, const int key, const int vel)
+    {
+        const PresetRef* const ref = static_cast<PresetRef*>(fluid_preset_get_data(preset));
+        const std::vector<FluidSoundFontInstrument>& instruments(ref->font->data->instruments);
+        const std::vector<fluid_sample_t*>& samples(ref->font->samples);
+
+        for (std::vector<FluidSoundFontZone>::const_iterator pit = ref->preset->zones.begin();
+             pit != ref->preset->zones.end(); ++pit)
+        {
+            const FluidSoundFontZone& presetZone(*pit);
+
+            if (! presetZone.contains(key, vel))
+                continue;
+
+            const FluidSoundFontInstrument& instrument(instruments[static_cast<size_t>(presetZone.index)]);
+
+            for (std::vector<FluidSoundFontZone>::const_iterator iit = instrument.zones.begin();
+                 iit != instrument.zones.end(); ++iit)
+            {
+                const FluidSoundFontZone& instrumentZone(*iit);
+                fluid_sample_t* const sample = samples[static_cast<size_t>(instrumentZone.index)];
+
+                if (sample == nullptr || ! instrumentZone.contains(key, vel))
+                    continue;
+
+                fluid_voice_t* const voice = fluid_synth_alloc_voice(synth, sample, chan, key, vel);
+
+                if (voice == nullptr)
+                    return FLUID_FAILED;
+
+                for (int i=0; i < kFluidGenCount; ++i)
+                {
+                    if (instrumentZone.genMask & (uint64_t(1) << i))
+                        fluid_voice_gen_set(voice, i, instrumentZone.gens[i]);
+                }
+
+                for (std::vector<fluid_mod_t*>::const_iterator mit = instrumentZone.mods.begin();
+                     mit != instrumentZone.mods.end(); ++mit)
+                    fluid_voice_add_mod(voice, *mit, FLUID_VOICE_OVERWRITE);
+
+                for (int i=0; i < kFluidGenCount; ++i)
+                {
+                    if (presetZone.genMask & (uint64_t(1) << i))
+                        fluid_voice_gen_incr(voice, i, presetZone.gens[i]);
+                }
+
+                for (std::vector<fluid_mod_t*>::const_iterator mit = presetZone.mods.begin();
+                     mit != presetZone.mods.end(); ++mit)
+                    fluid_voice_add_mod(voice, *mit, FLUID_VOICE_ADD);
+
+                fluid_synth_start_voice(synth, voice);
+            }
+        }
+
+        return FLUID_OK;
+    }
+};
+#endif // FLUIDSYNTH_VERSION_MAJOR >= 2
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -50,11 +1097,14 @@ public:
           fSettings(nullptr),
           fSynth(nullptr),
           fSynthId(0),
+          fCpuCores(1),
           fAudio16Buffers(nullptr),
           fLabel(nullptr)
     {
         carla_debug("CarlaPluginFluidSynth::CarlaPluginFluidSynth(%p, %i, %s)", engine, id,  bool2str(use16Outs));
 
+        pData->param.outputsTracked = true;
+
         carla_zeroFloats(fParamBuffers, FluidSynthParametersMax);
         carla_fill<int32_t>(fCurMidiProgs, 0, MAX_MIDI_CHANNELS);
 
@@ -66,7 +1116,8 @@ public:
         fluid_settings_setint(fSettings, "synth.audio-channels", use16Outs ? 16 : 1);
         fluid_settings_setint(fSettings, "synth.audio-groups", use16Outs ? 16 : 1);
         fluid_settings_setnum(fSettings, "synth.sample-rate", pData->engine->getSampleRate());
-        //fluid_settings_setnum(fSettings, "synth.cpu-cores", 2);
+        fluid_settings_setint(fSettings, "synth.cpu-cores", 1);
+        fluid_settings_setint(fSettings, "audio.realtime-prio", kCarlaThreadRealtimePriority);
         fluid_settings_setint(fSettings, "synth.ladspa.active", 0);
         fluid_settings_setint(fSettings, "synth.lock-memory", 1);
 #if FLUIDSYNTH_VERSION_MAJOR < 2
@@ -81,33 +1132,11 @@ public:
         fSynth = new_fluid_synth(fSettings);
         CARLA_SAFE_ASSERT_RETURN(fSynth != nullptr,);
 
-        initializeFluidDefaultsIfNeeded();
-
-#if FLUIDSYNTH_VERSION_MAJOR < 2
-        fluid_synth_set_sample_rate(fSynth, static_cast<float>(pData->engine->getSampleRate()));
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+        FluidSoundFontLoader::addToSynth(fSynth);
 #endif
-
-        // set default values
-        fluid_synth_set_reverb_on(fSynth, 1);
-        fluid_synth_set_reverb(fSynth,
-                               sFluidDefaults[FluidSynthReverbRoomSize],
-                               sFluidDefaults[FluidSynthReverbDamp],
-                               sFluidDefaults[FluidSynthReverbWidth],
-                               sFluidDefaults[FluidSynthReverbLevel]);
-
-        fluid_synth_set_chorus_on(fSynth, 1);
-        fluid_synth_set_chorus(fSynth,
-                               static_cast<int>(sFluidDefaults[FluidSynthChorusNr] + 0.5f),
-                               sFluidDefaults[FluidSynthChorusLevel],
-                               sFluidDefaults[FluidSynthChorusSpeedHz],
-                               sFluidDefaults[FluidSynthChorusDepthMs],
-                               static_cast<int>(sFluidDefaults[FluidSynthChorusType] + 0.5f));
-
-        fluid_synth_set_polyphony(fSynth, FLUID_DEFAULT_POLYPHONY);
-        fluid_synth_set_gain(fSynth, 1.0f);
-
-        for (int i=0; i < MAX_MIDI_CHANNELS; ++i)
-            fluid_synth_set_interp_method(fSynth, i, static_cast<int>(sFluidDefaults[FluidSynthInterpolation] + 0.5f));
+        initializeFluidDefaultsIfNeeded();
+        setSynthDefaults(fSynth);
     }
 
     ~CarlaPluginFluidSynth() override
@@ -438,11 +1467,18 @@ public:
         const float fixedValue(pData->param.getFixedValue(parameterId, value));
         fParamBuffers[parameterId] = fixedValue;
 
+        applyParameterToSynth(fSynth, parameterId, fixedValue);
+        return fixedValue;
+    }
+
+    // some parameters are set in groups, those read the rest of their values from fParamBuffers
+    void applyParameterToSynth(fluid_synth_t* const synth, const uint32_t parameterId, const float value) noexcept
+    {
         switch (parameterId)
         {
         case FluidSynthReverbOnOff:
             try {
-                fluid_synth_set_reverb_on(fSynth, (fixedValue > 0.5f) ? 1 : 0);
+                fluid_synth_set_reverb_on(synth, (value > 0.5f) ? 1 : 0);
             } CARLA_SAFE_EXCEPTION("fluid_synth_set_reverb_on")
             break;
 
@@ -451,7 +1487,7 @@ public:
         case FluidSynthReverbLevel:
         case FluidSynthReverbWidth:
             try {
-                fluid_synth_set_reverb(fSynth,
+                fluid_synth_set_reverb(synth,
                                        fParamBuffers[FluidSynthReverbRoomSize],
                                        fParamBuffers[FluidSynthReverbDamp],
                                        fParamBuffers[FluidSynthReverbWidth],
@@ -461,7 +1497,7 @@ public:
 
         case FluidSynthChorusOnOff:
             try {
-                fluid_synth_set_chorus_on(fSynth, (value > 0.5f) ? 1 : 0);
+                fluid_synth_set_chorus_on(synth, (value > 0.5f) ? 1 : 0);
             } CARLA_SAFE_EXCEPTION("fluid_synth_set_chorus_on")
             break;
 
@@ -471,7 +1507,7 @@ public:
         case FluidSynthChorusDepthMs:
         case FluidSynthChorusType:
             try {
-                fluid_synth_set_chorus(fSynth,
+                fluid_synth_set_chorus(synth,
                                        static_cast<int>(fParamBuffers[FluidSynthChorusNr] + 0.5f),
                                        fParamBuffers[FluidSynthChorusLevel],
                                        fParamBuffers[FluidSynthChorusSpeedHz],
@@ -482,7 +1518,7 @@ public:
 
         case FluidSynthPolyphony:
             try {
-                fluid_synth_set_polyphony(fSynth, static_cast<int>(value + 0.5f));
+                fluid_synth_set_polyphony(synth, static_cast<int>(value + 0.5f));
             } CARLA_SAFE_EXCEPTION("fluid_synth_set_polyphony")
             break;
 
@@ -490,7 +1526,7 @@ public:
             for (int i=0; i < MAX_MIDI_CHANNELS; ++i)
             {
                 try {
-                    fluid_synth_set_interp_method(fSynth, i, static_cast<int>(value + 0.5f));
+                    fluid_synth_set_interp_method(synth, i, static_cast<int>(value + 0.5f));
                 } CARLA_SAFE_EXCEPTION_BREAK("fluid_synth_set_interp_method")
             }
             break;
@@ -498,8 +1534,6 @@ public:
         default:
             break;
         }
-
-        return fixedValue;
     }
 
     void setCustomData(const char* const type, const char* const key, const char* const value, const bool sendGui) override
@@ -516,6 +1550,20 @@ public:
         if (std::strcmp(type, CUSTOM_DATA_TYPE_STRING) != 0)
             return carla_stderr2("CarlaPluginFluidSynth::setCustomData(\"%s\", \"%s\", \"%s\", %s) - type is not string", type, key, value, bool2str(sendGui));
 
+        if (std::strcmp(key, "cpuCores") == 0)
+        {
+            const int cpuCores = std::atoi(value);
+            CARLA_SAFE_ASSERT_RETURN(cpuCores >= 1 && cpuCores <= static_cast<int>(MAX_PROCESS_THREADS),);
+
+            if (cpuCores != fCpuCores)
+            {
+                if (! recreateSynth(cpuCores))
+                    return carla_stderr2("CarlaPluginFluidSynth::setCustomData(\"%s\", \"%s\", \"%s\", %s) - failed to create synth", type, key, value, bool2str(sendGui));
+            }
+
+            return CarlaPlugin::setCustomData(type, key, value, sendGui);
+        }
+
         if (std::strcmp(key, "midiPrograms") != 0)
             return carla_stderr2("CarlaPluginFluidSynth::setCustomData(\"%s\", \"%s\", \"%s\", %s) - type is not string", type, key, value, bool2str(sendGui));
 
@@ -1470,6 +2518,7 @@ public:
             uint32_t k = FluidSynthVoiceCount;
             fParamBuffers[k] = float(fluid_synth_get_active_voice_count(fSynth));
             pData->param.ranges[k].fixValue(fParamBuffers[k]);
+            pData->param.updateOutputValue(k, fParamBuffers[k]);
 
             if (pData->param.data[k].mappedControlIndex > 0)
             {
@@ -1536,55 +2585,11 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (volume and balance)
 
-        {
-            // note - balance not possible with kUse16Outs, so we can safely skip fAudioOutBuffers
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-
-            float* const oldBufLeft = pData->postProc.extraBuffer;
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Balance
-                if (doBalance)
-                {
-                    if (i % 2 == 0)
-                        carla_copyFloats(oldBufLeft, outBuffer[i]+timeOffset, frames);
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            // left
-                            outBuffer[i][k+timeOffset]  = oldBufLeft[k]                * (1.0f - balRangeL);
-                            outBuffer[i][k+timeOffset] += outBuffer[i+1][k+timeOffset] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            outBuffer[i][k+timeOffset]  = outBuffer[i][k+timeOffset] * balRangeR;
-                            outBuffer[i][k+timeOffset] += oldBufLeft[k]              * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume
-                if (kUse16Outs)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] = fAudio16Buffers[i][k] * pData->postProc.volume;
-                }
-                else if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] *= pData->postProc.volume;
-                }
-            }
-
-        } // End of Post-processing
+        // note - balance not possible with kUse16Outs, the plugin outputs are copied while applying volume
+        if (kUse16Outs)
+            pData->postProcess(nullptr, 0, false, fAudio16Buffers, 0, outBuffer, timeOffset, frames);
+        else
+            pData->postProcess(nullptr, 0, false, outBuffer, timeOffset, outBuffer, timeOffset, frames);
 #else
         if (kUse16Outs)
         {
@@ -1769,6 +2774,127 @@ public:
     }
 
 private:
+    // Apply default values to a newly created synth
+    void setSynthDefaults(fluid_synth_t* const synth)
+    {
+#if FLUIDSYNTH_VERSION_MAJOR < 2
+        fluid_synth_set_sample_rate(synth, static_cast<float>(pData->engine->getSampleRate()));
+#endif
+
+        fluid_synth_set_reverb_on(synth, 1);
+        fluid_synth_set_reverb(synth,
+                               sFluidDefaults[FluidSynthReverbRoomSize],
+                               sFluidDefaults[FluidSynthReverbDamp],
+                               sFluidDefaults[FluidSynthReverbWidth],
+                               sFluidDefaults[FluidSynthReverbLevel]);
+
+        fluid_synth_set_chorus_on(synth, 1);
+        fluid_synth_set_chorus(synth,
+                               static_cast<int>(sFluidDefaults[FluidSynthChorusNr] + 0.5f),
+                               sFluidDefaults[FluidSynthChorusLevel],
+                               sFluidDefaults[FluidSynthChorusSpeedHz],
+                               sFluidDefaults[FluidSynthChorusDepthMs],
+                               static_cast<int>(sFluidDefaults[FluidSynthChorusType] + 0.5f));
+
+        fluid_synth_set_polyphony(synth, FLUID_DEFAULT_POLYPHONY);
+        fluid_synth_set_gain(synth, 1.0f);
+
+        for (int i=0; i < MAX_MIDI_CHANNELS; ++i)
+            fluid_synth_set_interp_method(synth, i, static_cast<int>(sFluidDefaults[FluidSynthInterpolation] + 0.5f));
+    }
+
+    /*
+     * Replace the synth with a new one rendering on @a cpuCores threads, keeping current parameters and programs.
+     * FluidSynth only reads its number of cores on synth creation.
+     * The SoundFont is loaded again into the new synth, getting its own objects over the cached sample data,
+     * so nothing is shared with the old synth and its threads.
+     * The new synth is set up without blocking processing, which is only locked to swap them.
+     */
+    bool recreateSynth(const int cpuCores)
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->filename != nullptr, false);
+
+        fluid_settings_setint(fSettings, "synth.cpu-cores", cpuCores);
+
+        fluid_synth_t* synth = new_fluid_synth(fSettings);
+
+        if (synth == nullptr)
+        {
+            fluid_settings_setint(fSettings, "synth.cpu-cores", fCpuCores);
+            return false;
+        }
+
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+        FluidSoundFontLoader::addToSynth(synth);
+#endif
+        const int synthId = fluid_synth_sfload(synth, pData->filename, 0);
+
+        if (synthId < 0)
+        {
+            delete_fluid_synth(synth);
+            fluid_settings_setint(fSettings, "synth.cpu-cores", fCpuCores);
+            return false;
+        }
+
+        const uint32_t paramCount = std::min<uint32_t>(pData->param.count, FluidSynthVoiceCount);
+        float paramValues[FluidSynthVoiceCount];
+        int32_t midiProgs[MAX_MIDI_CHANNELS];
+
+        setSynthDefaults(synth);
+
+        for (uint32_t i=0; i < paramCount; ++i)
+            applyParameterToSynth(synth, i, paramValues[i] = fParamBuffers[i]);
+
+        for (int i=0; i < MAX_MIDI_CHANNELS; ++i)
+            applyMidiProgramToSynth(synth, synthId, i, midiProgs[i] = fCurMidiProgs[i]);
+
+        {
+            const ScopedSingleProcessLocker spl(this, true);
+
+            // catch up with changes done from the audio thread in the meantime
+            for (uint32_t i=0; i < paramCount; ++i)
+            {
+                if (carla_isNotEqual(fParamBuffers[i], paramValues[i]))
+                    applyParameterToSynth(synth, i, fParamBuffers[i]);
+            }
+
+            for (int i=0; i < MAX_MIDI_CHANNELS; ++i)
+            {
+                if (fCurMidiProgs[i] != midiProgs[i])
+                    applyMidiProgramToSynth(synth, synthId, i, fCurMidiProgs[i]);
+            }
+
+            std::swap(fSynth, synth);
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+            fSynthId = synthId;
+#else
+            fSynthId = static_cast<uint>(synthId);
+#endif
+            fCpuCores = cpuCores;
+        }
+
+        // the old synth is not used anymore, deleting it stops its threads which can take a while
+        delete_fluid_synth(synth);
+
+        return true;
+    }
+
+    void applyMidiProgramToSynth(fluid_synth_t* const synth, const int synthId, const int channel, const int32_t index)
+    {
+        if (index < 0 || index >= static_cast<int32_t>(pData->midiprog.count))
+            return;
+
+        const uint32_t bank    = pData->midiprog.data[index].bank;
+        const uint32_t program = pData->midiprog.data[index].program;
+
+        fluid_synth_set_channel_type(synth, channel, (channel == 9 && bank == 128) ? CHANNEL_TYPE_DRUM : CHANNEL_TYPE_MELODIC);
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+        fluid_synth_program_select(synth, channel, synthId, static_cast<int>(bank), static_cast<int>(program));
+#else
+        fluid_synth_program_select(synth, channel, static_cast<uint>(synthId), bank, program);
+#endif
+    }
+
     void initializeFluidDefaultsIfNeeded()
     {
         if (sFluidDefaultsStored)
@@ -1866,6 +2992,7 @@ private:
 #else
     uint fSynthId;
 #endif
+    int fCpuCores;
 
     float** fAudio16Buffers;
     float   fParamBuffers[FluidSynthParametersMax];
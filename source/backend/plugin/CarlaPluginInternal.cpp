@@ -22,6 +22,8 @@
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 
+#include <limits>
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -------------------------------------------------------------------
@@ -198,7 +200,11 @@ PluginParameterData::PluginParameterData() noexcept
     : count(0),
       data(nullptr),
       ranges(nullptr),
-      special(nullptr) {}
+      special(nullptr),
+      outputsTracked(false),
+      outputValues(nullptr),
+      outputsChanged(nullptr),
+      anyOutputChanged(false) {}
 
 PluginParameterData::~PluginParameterData() noexcept
 {
@@ -206,6 +212,8 @@ PluginParameterData::~PluginParameterData() noexcept
     CARLA_SAFE_ASSERT(data == nullptr);
     CARLA_SAFE_ASSERT(ranges == nullptr);
     CARLA_SAFE_ASSERT(special == nullptr);
+    CARLA_SAFE_ASSERT(outputValues == nullptr);
+    CARLA_SAFE_ASSERT(outputsChanged == nullptr);
 }
 
 void PluginParameterData::createNew(const uint32_t newCount, const bool withSpecial)
@@ -214,6 +222,8 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
     CARLA_SAFE_ASSERT_RETURN(data == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(ranges == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(special == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(outputValues == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(outputsChanged == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(newCount > 0,);
 
     data = new ParameterData[newCount];
@@ -237,6 +247,20 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
         carla_zeroStructs(special, newCount);
     }
 
+    // NaN never compares equal, so the first value of every output counts as a change
+    outputValues = new float[newCount];
+
+    for (uint32_t i=0; i < newCount; ++i)
+        outputValues[i] = std::numeric_limits<float>::quiet_NaN();
+
+    const uint32_t numWords = (newCount + 31) / 32;
+    outputsChanged = new std::atomic<uint32_t>[numWords];
+
+    for (uint32_t i=0; i < numWords; ++i)
+        outputsChanged[i].store(0, std::memory_order_relaxed);
+
+    anyOutputChanged.store(false);
+
     count = newCount;
 }
 
@@ -260,9 +284,61 @@ void PluginParameterData::clear() noexcept
         special = nullptr;
     }
 
+    if (outputValues != nullptr)
+    {
+        delete[] outputValues;
+        outputValues = nullptr;
+    }
+
+    if (outputsChanged != nullptr)
+    {
+        delete[] outputsChanged;
+        outputsChanged = nullptr;
+    }
+
+    anyOutputChanged.store(false);
+
     count = 0;
 }
 
+void PluginParameterData::updateOutputValue(const uint32_t parameterId, const float value) noexcept
+{
+    CARLA_SAFE_ASSERT_UINT2_RETURN(parameterId < count, parameterId, count,);
+
+    if (carla_isEqual(outputValues[parameterId], value))
+        return;
+
+    outputValues[parameterId] = value;
+    outputsChanged[parameterId / 32].fetch_or(1U << (parameterId % 32), std::memory_order_release);
+    anyOutputChanged.store(true, std::memory_order_release);
+}
+
+bool PluginParameterData::takeNextChangedOutput(uint32_t& parameterId) noexcept
+{
+    // a new pass, skip everything if nothing changed since the last one
+    if (parameterId == 0 && ! anyOutputChanged.exchange(false, std::memory_order_acquire))
+        return false;
+
+    for (uint32_t word = parameterId / 32, numWords = (count + 31) / 32; word < numWords; ++word)
+    {
+        uint32_t bits = outputsChanged[word].load(std::memory_order_acquire);
+
+        if (word == parameterId / 32)
+            bits &= ~0U << (parameterId % 32);
+
+        if (bits == 0)
+            continue;
+
+        const uint32_t bit = static_cast<uint32_t>(__builtin_ctz(bits));
+        outputsChanged[word].fetch_and(~(1U << bit), std::memory_order_acq_rel);
+
+        parameterId = word * 32 + bit;
+        return true;
+    }
+
+    return false;
+}
+
 float PluginParameterData::getFixedValue(const uint32_t parameterId, float value) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(parameterId < count, 0.0f);
@@ -710,7 +786,8 @@ CarlaPlugin::ProtectedData::PostProc::PostProc() noexcept
       balanceLeft(-1.0f),
       balanceRight(1.0f),
       panning(0.0f),
-      extraBuffer(nullptr) {}
+      lastGains(),
+      lastGainsValid(false) {}
 #endif
 
 // -----------------------------------------------------------------------
@@ -733,6 +810,7 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       extraHints(0x0),
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
       midiLearnParameterIndex(-1),
+      rackLane(0),
       transientTryCounter(0),
       transientFirstTry(true),
 #endif
@@ -867,14 +945,137 @@ void CarlaPlugin::ProtectedData::clearBuffers() noexcept
 #ifndef BUILD_BRIDGE
     latency.clearBuffers();
 #endif
+}
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    if (postProc.extraBuffer != nullptr)
+// -----------------------------------------------------------------------
+// Post-processing
+
+static inline
+void carla_postProcSegment(const bool isPair,
+                           const float* const* const wet, const float* const* const dry, float* const* const out,
+                           const uint32_t start, const uint32_t frames,
+                           const CarlaPostProcGains& gains, const CarlaPostProcGains* const steps) noexcept
+{
+    if (isPair)
+        carla_postProcStereo(wet[0] + start, wet[1] + start, dry[0], dry[1], out[0] + start, out[1] + start,
+                             frames, gains, steps, start);
+    else
+        carla_postProcMono(wet[0] + start, dry[0], out[0] + start, frames, gains, steps, start);
+}
+
+void CarlaPlugin::ProtectedData::postProcess(const float* const* const inBuffers, const uint32_t inOffset,
+                                             const bool useLatencyBuffers,
+                                             const float* const* const wetBuffers, const uint32_t wetOffset,
+                                             float* const* const outBuffers, const uint32_t outOffset,
+                                             const uint32_t frames) noexcept
+{
+    if (audioOut.count == 0 || frames == 0)
+        return;
+
+    CARLA_SAFE_ASSERT_RETURN(wetBuffers != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(outBuffers != nullptr,);
+
+    const bool canBalance = (hints & PLUGIN_CAN_BALANCE) != 0;
+
+    const CarlaPostProcGains gains = carla_postProcGains((hints & PLUGIN_CAN_DRYWET) != 0 ? postProc.dryWet : 1.0f,
+                                                         postProc.volume,
+                                                         canBalance ? postProc.balanceLeft : -1.0f,
+                                                         canBalance ? postProc.balanceRight : 1.0f,
+                                                         (hints & PLUGIN_CAN_PANNING) != 0 ? postProc.panning : 0.0f);
+
+    const CarlaPostProcGains startGains = postProc.lastGainsValid ? postProc.lastGains : gains;
+    postProc.lastGains = gains;
+    postProc.lastGainsValid = true;
+
+    const bool inPlace = static_cast<const void*>(wetBuffers) == static_cast<const void*>(outBuffers)
+                      && wetOffset == outOffset;
+
+    // nothing to do, at most a plain copy
+    if (startGains == gains && gains.isIdentity())
     {
-        delete[] postProc.extraBuffer;
-        postProc.extraBuffer = nullptr;
+        if (! inPlace)
+        {
+            for (uint32_t i=0; i < audioOut.count; ++i)
+                carla_copyFloats(outBuffers[i] + outOffset, wetBuffers[i] + wetOffset, frames);
+        }
+        return;
     }
+
+    // smooth gains over this block
+    CarlaPostProcGains steps;
+    const bool ramp = startGains != gains;
+
+    if (ramp)
+    {
+        const float invFrames = 1.0f / static_cast<float>(frames);
+        steps.dryWet = (gains.dryWet - startGains.dryWet) * invFrames;
+        steps.volume = (gains.volume - startGains.volume) * invFrames;
+        steps.gainLL = (gains.gainLL - startGains.gainLL) * invFrames;
+        steps.gainRL = (gains.gainRL - startGains.gainRL) * invFrames;
+        steps.gainLR = (gains.gainLR - startGains.gainLR) * invFrames;
+        steps.gainRR = (gains.gainRR - startGains.gainRR) * invFrames;
+    }
+
+    const bool doDryWet = inBuffers != nullptr && audioIn.count != 0
+                       && (carla_isNotEqual(startGains.dryWet, 1.0f) || carla_isNotEqual(gains.dryWet, 1.0f));
+
+    // the first frames of dry signal come from the latency buffers, if any
+    uint32_t latencyFrames = 0;
+#ifndef BUILD_BRIDGE
+    if (doDryWet && useLatencyBuffers && latency.frames != 0 && latency.buffers != nullptr)
+        latencyFrames = std::min(latency.frames, frames);
+#else
+    // unused
+    (void)useLatencyBuffers;
+#endif
+
+    const float* wet[2];
+    const float* dry[2];
+    const float* dryLatency[2];
+    float* out[2];
+
+    for (uint32_t i=0; i < audioOut.count; i += 2)
+    {
+        const bool isPair = i + 1 < audioOut.count;
+        const uint32_t numChannels = isPair ? 2 : 1;
+
+        for (uint32_t j=0; j < numChannels; ++j)
+        {
+            const uint32_t c = audioIn.count == 1 ? 0 : i + j;
+
+            wet[j] = wetBuffers[i + j] + wetOffset;
+            out[j] = outBuffers[i + j] + outOffset;
+            dry[j] = doDryWet && c < audioIn.count ? inBuffers[c] + inOffset : nullptr;
+            dryLatency[j] = nullptr;
+
+#ifndef BUILD_BRIDGE
+            if (latencyFrames != 0 && dry[j] != nullptr)
+            {
+                CARLA_SAFE_ASSERT_CONTINUE(c < latency.channels);
+                dryLatency[j] = latency.buffers[c];
+            }
 #endif
+        }
+
+        if (! isPair)
+            dry[1] = dryLatency[1] = nullptr;
+
+        if (dryLatency[0] != nullptr && (! isPair || dryLatency[1] != nullptr))
+        {
+            carla_postProcSegment(isPair, wet, dryLatency, out, 0, latencyFrames, startGains, ramp ? &steps : nullptr);
+
+            if (latencyFrames < frames)
+                carla_postProcSegment(isPair, wet, dry, out, latencyFrames, frames - latencyFrames,
+                                      startGains, ramp ? &steps : nullptr);
+        }
+        else
+        {
+            carla_postProcSegment(isPair, wet, dry, out, 0, frames, startGains, ramp ? &steps : nullptr);
+        }
+    }
 }
+#endif
 
 // -----------------------------------------------------------------------
 // Post-poned events
@@ -26,9 +26,12 @@
 
 #include "CarlaMIDI.h"
 #include "CarlaMutex.hpp"
+#include "CarlaPostProcUtils.hpp"
 #include "CarlaString.hpp"
 #include "RtLinkedList.hpp"
 
+#include <atomic>
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
@@ -191,6 +194,13 @@ struct PluginParameterData {
     ParameterRanges* ranges;
     SpecialParameterType* special;
 
+    // Output parameter changes, reported by the plugin through updateOutputValue().
+    // Plugin types that do not report them leave outputsTracked false and get polled instead.
+    bool outputsTracked;
+    float* outputValues;
+    std::atomic<uint32_t>* outputsChanged;
+    std::atomic<bool> anyOutputChanged;
+
     PluginParameterData() noexcept;
     ~PluginParameterData() noexcept;
     void createNew(uint32_t newCount, bool withSpecial);
@@ -199,6 +209,12 @@ struct PluginParameterData {
     float getFinalUnnormalizedValue(uint32_t parameterId, float normalizedValue) const noexcept;
     float getFinalValueWithMidiDelta(uint32_t parameterId, float value, int8_t delta) const noexcept;
 
+    // mark an output parameter as changed if its value is different from the last one, RT safe
+    void updateOutputValue(uint32_t parameterId, float value) noexcept;
+
+    // find the next changed output parameter, starting at parameterId, and clear its change
+    bool takeNextChangedOutput(uint32_t& parameterId) noexcept;
+
     CARLA_DECLARE_NON_COPYABLE(PluginParameterData)
 };
 
@@ -261,6 +277,7 @@ struct CarlaPlugin::ProtectedData {
     uint   extraHints;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     int32_t midiLearnParameterIndex;
+    uint    rackLane;
     uint    transientTryCounter;
     bool    transientFirstTry;
 #endif
@@ -392,7 +409,10 @@ struct CarlaPlugin::ProtectedData {
         float balanceLeft;
         float balanceRight;
         float panning;
-        float* extraBuffer;
+
+        // gains used at the end of the last processed block, smoothed into the current ones
+        CarlaPostProcGains lastGains;
+        bool lastGainsValid;
 
         PostProc() noexcept;
 
@@ -409,6 +429,22 @@ struct CarlaPlugin::ProtectedData {
 
     void clearBuffers() noexcept;
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // -------------------------------------------------------------------
+    // Post-processing
+
+    /*
+     * Apply dry/wet, balance, panning and volume to the plugin audio outputs, in a single pass.
+     * Gains are smoothed from the ones used in the previous call over the @a frames of this one.
+     *
+     * @a wetBuffers are the plugin outputs and can be the same as @a outBuffers.
+     * Dry signal is read from @a inBuffers, or from the latency buffers when @a useLatencyBuffers is set.
+     */
+    void postProcess(const float* const* inBuffers, uint32_t inOffset, bool useLatencyBuffers,
+                     const float* const* wetBuffers, uint32_t wetOffset,
+                     float* const* outBuffers, uint32_t outOffset, uint32_t frames) noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Post-poned events
 
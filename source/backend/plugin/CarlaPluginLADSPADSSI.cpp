@@ -316,6 +316,8 @@ public:
     {
         carla_debug("CarlaPluginLADSPADSSI::CarlaPluginLADSPADSSI(%p, %i)", engine, id);
 
+        pData->param.outputsTracked = true;
+
         carla_zeroPointers(fExtraStereoBuffer, 2);
     }
 
@@ -1937,27 +1939,21 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Control Output
 
-        if (pData->event.portOut != nullptr)
+        for (uint32_t k=0; k < pData->param.count; ++k)
         {
-            uint8_t  channel;
-            uint16_t param;
-            float    value;
-
-            for (uint32_t k=0; k < pData->param.count; ++k)
-            {
-                if (pData->param.data[k].type != PARAMETER_OUTPUT)
-                    continue;
+            if (pData->param.data[k].type != PARAMETER_OUTPUT)
+                continue;
 
-                pData->param.ranges[k].fixValue(fParamBuffers[k]);
+            pData->param.ranges[k].fixValue(fParamBuffers[k]);
+            pData->param.updateOutputValue(k, fParamBuffers[k]);
 
-                if (pData->param.data[k].mappedControlIndex > 0)
-                {
-                    channel = pData->param.data[k].midiChannel;
-                    param   = static_cast<uint16_t>(pData->param.data[k].mappedControlIndex);
-                    value   = pData->param.ranges[k].getNormalizedValue(fParamBuffers[k]);
-                    pData->event.portOut->writeControlEvent(0, channel, kEngineControlEventTypeParameter,
-                                                            param, -1, value);
-                }
+            if (pData->event.portOut != nullptr && pData->param.data[k].mappedControlIndex > 0)
+            {
+                const uint8_t  channel = pData->param.data[k].midiChannel;
+                const uint16_t param   = static_cast<uint16_t>(pData->param.data[k].mappedControlIndex);
+                const float    value   = pData->param.ranges[k].getNormalizedValue(fParamBuffers[k]);
+                pData->event.portOut->writeControlEvent(0, channel, kEngineControlEventTypeParameter,
+                                                        param, -1, value);
             }
         } // End of Control Output
 
@@ -2067,78 +2063,9 @@ public:
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue;
-            float* const oldBufLeft = pData->postProc.extraBuffer;
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-# ifndef BUILD_BRIDGE
-                        if (k < pData->latency.frames && pData->latency.buffers != nullptr)
-                            bufValue = pData->latency.buffers[c][k];
-                        else if (pData->latency.frames < frames)
-                            bufValue = fAudioInBuffers[c][k-pData->latency.frames];
-                        else
-# endif
-                            bufValue = fAudioInBuffers[c][k];
-
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, fAudioOutBuffers[i], frames);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
+        // Post-processing (dry/wet, volume, balance and panning)
 
-        } // End of Post-processing
+        pData->postProcess(fAudioInBuffers, 0, true, fAudioOutBuffers, 0, audioOut, timeOffset, frames);
 
 # ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
@@ -30,7 +30,9 @@
 #include "CarlaPipeUtils.hpp"
 #include "CarlaPluginUI.hpp"
 #include "CarlaScopeUtils.hpp"
+#include "CarlaWorkerPool.hpp"
 #include "Lv2AtomRingBuffer.hpp"
+#include "Lv2UridTable.hpp"
 
 #include "../modules/lilv/config/lilv_config.h"
 
@@ -53,6 +55,7 @@ extern "C" {
 # define LV2_UIS_ONLY_INPROCESS
 #endif
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -162,6 +165,167 @@ enum CarlaLv2URIDs {
     kUridCount
 };
 
+// -------------------------------------------------------------------------------------------------------------------
+// URIs of the fixed URIDs above
+
+static const char* carla_lv2_fixed_urid_unmap(const LV2_URID urid) noexcept
+{
+    switch (urid)
+    {
+    // Atom types
+    case kUridAtomBlank:
+        return LV2_ATOM__Blank;
+    case kUridAtomBool:
+        return LV2_ATOM__Bool;
+    case kUridAtomChunk:
+        return LV2_ATOM__Chunk;
+    case kUridAtomDouble:
+        return LV2_ATOM__Double;
+    case kUridAtomEvent:
+        return LV2_ATOM__Event;
+    case kUridAtomFloat:
+        return LV2_ATOM__Float;
+    case kUridAtomInt:
+        return LV2_ATOM__Int;
+    case kUridAtomLiteral:
+        return LV2_ATOM__Literal;
+    case kUridAtomLong:
+        return LV2_ATOM__Long;
+    case kUridAtomNumber:
+        return LV2_ATOM__Number;
+    case kUridAtomObject:
+        return LV2_ATOM__Object;
+    case kUridAtomPath:
+        return LV2_ATOM__Path;
+    case kUridAtomProperty:
+        return LV2_ATOM__Property;
+    case kUridAtomResource:
+        return LV2_ATOM__Resource;
+    case kUridAtomSequence:
+        return LV2_ATOM__Sequence;
+    case kUridAtomSound:
+        return LV2_ATOM__Sound;
+    case kUridAtomString:
+        return LV2_ATOM__String;
+    case kUridAtomTuple:
+        return LV2_ATOM__Tuple;
+    case kUridAtomURI:
+        return LV2_ATOM__URI;
+    case kUridAtomURID:
+        return LV2_ATOM__URID;
+    case kUridAtomVector:
+        return LV2_ATOM__Vector;
+    case kUridAtomTransferAtom:
+        return LV2_ATOM__atomTransfer;
+    case kUridAtomTransferEvent:
+        return LV2_ATOM__eventTransfer;
+
+    // BufSize types
+    case kUridBufMaxLength:
+        return LV2_BUF_SIZE__maxBlockLength;
+    case kUridBufMinLength:
+        return LV2_BUF_SIZE__minBlockLength;
+    case kUridBufNominalLength:
+        return LV2_BUF_SIZE__nominalBlockLength;
+    case kUridBufSequenceSize:
+        return LV2_BUF_SIZE__sequenceSize;
+
+    // Log types
+    case kUridLogError:
+        return LV2_LOG__Error;
+    case kUridLogNote:
+        return LV2_LOG__Note;
+    case kUridLogTrace:
+        return LV2_LOG__Trace;
+    case kUridLogWarning:
+        return LV2_LOG__Warning;
+
+    // Patch types
+    case kUridPatchSet:
+        return LV2_PATCH__Set;
+    case kUridPatchProperty:
+        return LV2_PATCH__property;
+    case kUridPatchSubject:
+        return LV2_PATCH__subject;
+    case kUridPatchValue:
+        return LV2_PATCH__value;
+
+    // Time types
+    case kUridTimePosition:
+        return LV2_TIME__Position;
+    case kUridTimeBar:
+        return LV2_TIME__bar;
+    case kUridTimeBarBeat:
+        return LV2_TIME__barBeat;
+    case kUridTimeBeat:
+        return LV2_TIME__beat;
+    case kUridTimeBeatUnit:
+        return LV2_TIME__beatUnit;
+    case kUridTimeBeatsPerBar:
+        return LV2_TIME__beatsPerBar;
+    case kUridTimeBeatsPerMinute:
+        return LV2_TIME__beatsPerMinute;
+    case kUridTimeFrame:
+        return LV2_TIME__frame;
+    case kUridTimeFramesPerSecond:
+        return LV2_TIME__framesPerSecond;
+    case kUridTimeSpeed:
+        return LV2_TIME__speed;
+    case kUridTimeTicksPerBeat:
+        return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
+
+    // Others
+    case kUridMidiEvent:
+        return LV2_MIDI__MidiEvent;
+    case kUridParamSampleRate:
+        return LV2_PARAMETERS__sampleRate;
+    case kUridBackgroundColor:
+        return LV2_UI__backgroundColor;
+    case kUridForegroundColor:
+        return LV2_UI__foregroundColor;
+#ifndef CARLA_OS_MAC
+    case kUridScaleFactor:
+        return LV2_UI__scaleFactor;
+#endif
+    case kUridWindowTitle:
+        return LV2_UI__windowTitle;
+
+    // Custom Carla types
+    case kUridCarlaAtomWorkerIn:
+        return URI_CARLA_ATOM_WORKER_IN;
+    case kUridCarlaAtomWorkerResp:
+        return URI_CARLA_ATOM_WORKER_RESP;
+    case kUridCarlaParameterChange:
+        return URI_CARLA_PARAMETER_CHANGE;
+    case kUridCarlaTransientWindowId:
+        return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
+    }
+
+
+    return nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+// URID table shared by all LV2 plugins, fixed URIDs are always mapped first and in order
+
+struct CarlaLv2SharedUridTable : Lv2UridTable {
+    CarlaLv2SharedUridTable() noexcept
+        : Lv2UridTable()
+    {
+        for (LV2_URID urid = 1; urid < kUridCount; ++urid)
+        {
+            const LV2_URID mapped = map(carla_lv2_fixed_urid_unmap(urid));
+            CARLA_SAFE_ASSERT_UINT2(mapped == urid, mapped, urid);
+        }
+    }
+
+    static Lv2UridTable& getInstance() noexcept
+    {
+        static CarlaLv2SharedUridTable table;
+        return table;
+    }
+};
+
 // LV2 Feature Ids
 enum CarlaLv2Features {
     // DSP features
@@ -643,10 +807,132 @@ static void initAtomForge(LV2_Atom_Forge& atomForge) noexcept
 #endif
 }
 
+#ifndef LV2_UIS_ONLY_INPROCESS
+// -------------------------------------------------------------------------------------------------------------------
+// Translation of URIDs inside atoms going to or coming from bridged UIs
+
+typedef std::map<LV2_URID, LV2_URID> Lv2UridRemap;
+
+static void lv2_urid_remap(LV2_URID& urid, const Lv2UridRemap& remap)
+{
+    const Lv2UridRemap::const_iterator it = remap.find(urid);
+
+    if (it != remap.end())
+        urid = it->second;
+}
+
+static void lv2_atom_remap_urids(LV2_Atom* const atom, const uint32_t maxSize, const Lv2UridRemap& remap)
+{
+    CARLA_SAFE_ASSERT_RETURN(maxSize >= sizeof(LV2_Atom),);
+    CARLA_SAFE_ASSERT_RETURN(atom->size <= maxSize - sizeof(LV2_Atom),);
+
+    // the type is always one of ours on either side, but might have been mapped by the UI first
+    const LV2_URID origType = atom->type;
+    lv2_urid_remap(atom->type, remap);
+    const LV2_URID type = origType < kLv2UridBridgedUiOffset ? origType : atom->type;
+
+    uint8_t* const body = static_cast<uint8_t*>(LV2_ATOM_BODY(atom));
+
+    switch (type)
+    {
+    case kUridAtomURID:
+        if (atom->size >= sizeof(LV2_URID))
+            lv2_urid_remap(((LV2_Atom_URID*)atom)->body, remap);
+        break;
+
+    case kUridAtomLiteral:
+        if (atom->size >= sizeof(LV2_Atom_Literal_Body))
+        {
+            LV2_Atom_Literal_Body* const litBody = (LV2_Atom_Literal_Body*)body;
+            lv2_urid_remap(litBody->datatype, remap);
+            lv2_urid_remap(litBody->lang, remap);
+        }
+        break;
+
+    case kUridAtomBlank:
+    case kUridAtomObject:
+    case kUridAtomResource:
+        if (atom->size >= sizeof(LV2_Atom_Object_Body))
+        {
+            LV2_Atom_Object_Body* const objBody = (LV2_Atom_Object_Body*)body;
+            lv2_urid_remap(objBody->id, remap);
+            lv2_urid_remap(objBody->otype, remap);
+
+            for (uint32_t offset = sizeof(LV2_Atom_Object_Body); offset + sizeof(LV2_Atom_Property_Body) <= atom->size;)
+            {
+                LV2_Atom_Property_Body* const prop = (LV2_Atom_Property_Body*)(body + offset);
+                lv2_urid_remap(prop->key, remap);
+                lv2_urid_remap(prop->context, remap);
+
+                const uint32_t valueOffset = offset + sizeof(LV2_Atom_Property_Body) - sizeof(LV2_Atom);
+                lv2_atom_remap_urids(&prop->value, atom->size - valueOffset, remap);
+
+                offset += lv2_atom_pad_size(sizeof(LV2_Atom_Property_Body) + prop->value.size);
+            }
+        }
+        break;
+
+    case kUridAtomProperty:
+        if (atom->size >= sizeof(LV2_Atom_Property_Body))
+        {
+            LV2_Atom_Property_Body* const prop = (LV2_Atom_Property_Body*)body;
+            lv2_urid_remap(prop->key, remap);
+            lv2_urid_remap(prop->context, remap);
+            lv2_atom_remap_urids(&prop->value, atom->size - (sizeof(LV2_Atom_Property_Body) - sizeof(LV2_Atom)), remap);
+        }
+        break;
+
+    case kUridAtomTuple:
+        for (uint32_t offset = 0; offset + sizeof(LV2_Atom) <= atom->size;)
+        {
+            LV2_Atom* const child = (LV2_Atom*)(body + offset);
+            lv2_atom_remap_urids(child, atom->size - offset, remap);
+
+            offset += lv2_atom_pad_size(lv2_atom_total_size(child));
+        }
+        break;
+
+    case kUridAtomSequence:
+        if (atom->size >= sizeof(LV2_Atom_Sequence_Body))
+        {
+            lv2_urid_remap(((LV2_Atom_Sequence_Body*)body)->unit, remap);
+
+            for (uint32_t offset = sizeof(LV2_Atom_Sequence_Body); offset + sizeof(LV2_Atom_Event) <= atom->size;)
+            {
+                LV2_Atom_Event* const ev = (LV2_Atom_Event*)(body + offset);
+                lv2_atom_remap_urids(&ev->body, atom->size - offset - sizeof(ev->time), remap);
+
+                offset += lv2_atom_pad_size(sizeof(LV2_Atom_Event) + ev->body.size);
+            }
+        }
+        break;
+
+    case kUridAtomVector:
+        if (atom->size >= sizeof(LV2_Atom_Vector_Body))
+        {
+            LV2_Atom_Vector_Body* const vecBody = (LV2_Atom_Vector_Body*)body;
+            const LV2_URID origChildType = vecBody->child_type;
+            lv2_urid_remap(vecBody->child_type, remap);
+
+            if ((origChildType == kUridAtomURID || vecBody->child_type == kUridAtomURID) && vecBody->child_size == sizeof(LV2_URID))
+            {
+                LV2_URID* const elems = (LV2_URID*)(body + sizeof(LV2_Atom_Vector_Body));
+                const uint32_t count = (atom->size - sizeof(LV2_Atom_Vector_Body)) / sizeof(LV2_URID);
+
+                for (uint32_t i=0; i < count; ++i)
+                    lv2_urid_remap(elems[i], remap);
+            }
+        }
+        break;
+    }
+}
+#endif
+
 // -------------------------------------------------------------------------------------------------------------------
 
 class CarlaPluginLV2 : public CarlaPlugin,
-                       private CarlaPluginUI::Callback
+                       private CarlaPluginUI::Callback,
+                       private CarlaWorkerClient
 {
 public:
     CarlaPluginLV2(CarlaEngine* const engine, const uint id)
@@ -676,13 +962,22 @@ public:
           fAtomBufferWorkerInTmpData(nullptr),
           fAtomBufferRealtime(nullptr),
           fAtomBufferRealtimeSize(0),
+          fWorkerPool(nullptr),
           fEventsIn(),
           fEventsOut(),
           fLv2Options(),
 #ifndef LV2_UIS_ONLY_INPROCESS
           fPipeServer(engine, this),
 #endif
-          fCustomURIDs(kUridCount, std::string("urn:null")),
+          fUridTable(CarlaLv2SharedUridTable::getInstance()),
+#ifndef LV2_UIS_ONLY_INPROCESS
+          fUsedURIDsMutex(),
+          fUsedURIDs(),
+          fIsUsedURID(),
+          fUsedURIDsSentToUI(0),
+          fUiToHostURIDs(),
+          fHostToUiURIDs(),
+#endif
           fFirstActive(true),
           fLastStateChunk(nullptr),
           fLastTimeInfo(),
@@ -691,7 +986,8 @@ public:
           fUI()
     {
         carla_debug("CarlaPluginLV2::CarlaPluginLV2(%p, %i)", engine, id);
-        CARLA_SAFE_ASSERT(fCustomURIDs.size() == kUridCount);
+
+        pData->param.outputsTracked = true;
 
         carla_zeroPointers(fFeatures, kFeatureCountAll+1);
         carla_zeroPointers(fStateFeatures, kStateFeatureCountAll+1);
@@ -761,6 +1057,12 @@ public:
             pData->active = false;
         }
 
+        if (fWorkerPool != nullptr)
+        {
+            fWorkerPool->removeClient(this);
+            fWorkerPool = nullptr;
+        }
+
         if (fExt.state != nullptr)
         {
             const File tmpDir(handleStateMapToAbsolutePath(false, false, true, "."));
@@ -1855,13 +2157,14 @@ public:
                     const CarlaMutexLocker cml(fPipeServer.getPipeLock());
                     const CarlaScopedLocale csl;
 
-                    // write URI mappings
-                    uint32_t u = 0;
-                    for (std::vector<std::string>::iterator it=fCustomURIDs.begin(), end=fCustomURIDs.end(); it != end; ++it, ++u)
+                    // write URI mappings, only the ones this plugin has used
+                    const CarlaMutexLocker cml2(fUsedURIDsMutex);
+
+                    for (std::vector<LV2_URID>::const_iterator it = fUsedURIDs.begin(), end = fUsedURIDs.end(); it != end; ++it)
                     {
-                        if (u < kUridCount)
-                            continue;
-                        const std::string& uri(*it);
+                        const LV2_URID u = *it;
+                        const char* const uri = fUridTable.unmap(u);
+                        CARLA_SAFE_ASSERT_CONTINUE(uri != nullptr);
 
                         if (! fPipeServer.writeMessage("urid\n", 5))
                             return;
@@ -1870,14 +2173,20 @@ public:
                         if (! fPipeServer.writeMessage(tmpBuf))
                             return;
 
-                        std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(uri.length()));
+                        std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(std::strlen(uri)));
                         if (! fPipeServer.writeMessage(tmpBuf))
                             return;
 
-                        if (! fPipeServer.writeAndFixMessage(uri.c_str()))
+                        if (! fPipeServer.writeAndFixMessage(uri))
                             return;
                     }
 
+                    fUsedURIDsSentToUI = fUsedURIDs.size();
+
+                    // a new UI process starts with no ids of its own
+                    fUiToHostURIDs.clear();
+                    fHostToUiURIDs.clear();
+
                     // write UI options
                     if (! fPipeServer.writeMessage("uiOptions\n", 10))
                         return;
@@ -2150,26 +2459,9 @@ public:
 
     void idle() override
     {
-        if (fAtomBufferWorkerIn.isDataAvailableForReading())
-        {
-            Lv2AtomRingBuffer tmpRingBuffer(fAtomBufferWorkerIn, fAtomBufferWorkerInTmpData);
-            CARLA_SAFE_ASSERT_RETURN(tmpRingBuffer.isDataAvailableForReading(),);
-            CARLA_SAFE_ASSERT_RETURN(fExt.worker != nullptr && fExt.worker->work != nullptr,);
-
-            const size_t localSize = fAtomBufferWorkerIn.getSize();
-            uint8_t* const localData = new uint8_t[localSize];
-            LV2_Atom* const localAtom = static_cast<LV2_Atom*>(static_cast<void*>(localData));
-            localAtom->size = localSize;
-            uint32_t portIndex;
-
-            for (; tmpRingBuffer.get(portIndex, localAtom); localAtom->size = localSize)
-            {
-                CARLA_SAFE_ASSERT_CONTINUE(localAtom->type == kUridCarlaAtomWorkerIn);
-                fExt.worker->work(fHandle, carla_lv2_worker_respond, this, localAtom->size, LV2_ATOM_BODY_CONST(localAtom));
-            }
-
-            delete[] localData;
-        }
+        // without engine worker threads, run worker jobs here
+        if (fWorkerPool == nullptr && fAtomBufferWorkerIn.isDataAvailableForReading())
+            CarlaWorkerPool::runNow(this);
 
         if (fInlineDisplayNeedsRedraw)
         {
@@ -2225,6 +2517,12 @@ public:
             return;
         }
 
+#ifndef LV2_UIS_ONLY_INPROCESS
+        // the UI needs to know the URIDs the plugin mapped before receiving atoms that use them
+        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
+            sendNewURIDsToUI();
+#endif
+
         if (fAtomBufferUiOut.isDataAvailableForReading())
         {
             Lv2AtomRingBuffer tmpRingBuffer(fAtomBufferUiOut, fAtomBufferUiOutTmpData);
@@ -2245,15 +2543,22 @@ public:
 #ifndef LV2_UIS_ONLY_INPROCESS
                 if (fUI.type == UI::TYPE_BRIDGE)
                 {
+                    // must be done before translating URIDs for the UI
+                    inspectAtomForParameterChange(localAtom);
+
                     if (fPipeServer.isPipeRunning())
+                    {
+                        if (! fHostToUiURIDs.empty())
+                            lv2_atom_remap_urids(localAtom, lv2_atom_total_size(localAtom), fHostToUiURIDs);
+
                         fPipeServer.writeLv2AtomMessage(portIndex, localAtom);
+                    }
+
+                    continue;
                 }
-                else
 #endif
-                {
-                    if (hasPortEvent && ! fNeedsUiClose)
-                        fUI.descriptor->port_event(fUI.handle, portIndex, lv2_atom_total_size(localAtom), kUridAtomTransferEvent, localAtom);
-                }
+                if (hasPortEvent && ! fNeedsUiClose)
+                    fUI.descriptor->port_event(fUI.handle, portIndex, lv2_atom_total_size(localAtom), kUridAtomTransferEvent, localAtom);
 
                 inspectAtomForParameterChange(localAtom);
             }
@@ -2350,6 +2655,12 @@ public:
         if (pData->active)
             deactivate();
 
+        if (fWorkerPool != nullptr)
+        {
+            fWorkerPool->removeClient(this);
+            fWorkerPool = nullptr;
+        }
+
         clearBuffers();
 
         const float sampleRate(static_cast<float>(pData->engine->getSampleRate()));
@@ -3261,6 +3572,9 @@ public:
             fAtomBufferRealtime = static_cast<LV2_Atom*>(std::malloc(fAtomBufferRealtimeSize));
             fAtomBufferWorkerInTmpData = new uint8_t[fAtomBufferRealtimeSize];
             carla_mlock(fAtomBufferRealtime, fAtomBufferRealtimeSize);
+
+            if ((fWorkerPool = pData->engine->getWorkerPool()) != nullptr)
+                fWorkerPool->addClient(this);
         }
 
         if (fRdfDescriptor->ParameterCount > 0 ||
@@ -4413,36 +4727,31 @@ public:
                 fExt.worker->end_run(fHandle2);
         }
 
-#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
         // Control Output
 
-        if (pData->event.portOut != nullptr)
+        for (uint32_t k=0; k < pData->param.count; ++k)
         {
-            uint8_t  channel;
-            uint16_t param;
-            float    value;
+            if (pData->param.data[k].type != PARAMETER_OUTPUT)
+                continue;
 
-            for (uint32_t k=0; k < pData->param.count; ++k)
-            {
-                if (pData->param.data[k].type != PARAMETER_OUTPUT)
-                    continue;
+            if (fStrictBounds >= 0 && (pData->param.data[k].hints & PARAMETER_IS_STRICT_BOUNDS) != 0)
+                // plugin is responsible to ensure correct bounds
+                pData->param.ranges[k].fixValue(fParamBuffers[k]);
 
-                if (fStrictBounds >= 0 && (pData->param.data[k].hints & PARAMETER_IS_STRICT_BOUNDS) != 0)
-                    // plugin is responsible to ensure correct bounds
-                    pData->param.ranges[k].fixValue(fParamBuffers[k]);
+            pData->param.updateOutputValue(k, fParamBuffers[k]);
 
-                if (pData->param.data[k].mappedControlIndex > 0)
-                {
-                    channel = pData->param.data[k].midiChannel;
-                    param   = static_cast<uint16_t>(pData->param.data[k].mappedControlIndex);
-                    value   = pData->param.ranges[k].getNormalizedValue(fParamBuffers[k]);
-                    pData->event.portOut->writeControlEvent(0, channel, kEngineControlEventTypeParameter,
-                                                            param, -1, value);
-                }
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+            if (pData->event.portOut != nullptr && pData->param.data[k].mappedControlIndex > 0)
+            {
+                const uint8_t  channel = pData->param.data[k].midiChannel;
+                const uint16_t param   = static_cast<uint16_t>(pData->param.data[k].mappedControlIndex);
+                const float    value   = pData->param.ranges[k].getNormalizedValue(fParamBuffers[k]);
+                pData->event.portOut->writeControlEvent(0, channel, kEngineControlEventTypeParameter,
+                                                        param, -1, value);
             }
-        } // End of Control Output
 #endif
+        } // End of Control Output
 
         // --------------------------------------------------------------------------------------------------------
         // Events/MIDI Output
@@ -4654,77 +4963,9 @@ public:
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue;
-            float* const oldBufLeft = pData->postProc.extraBuffer;
+        // Post-processing (dry/wet, volume, balance and panning)
 
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-# ifndef BUILD_BRIDGE
-                        if (k < pData->latency.frames && pData->latency.buffers != nullptr)
-                            bufValue = pData->latency.buffers[c][k];
-                        else if (pData->latency.frames < frames)
-                            bufValue = fAudioInBuffers[c][k-pData->latency.frames];
-                        else
-# endif
-                            bufValue = fAudioInBuffers[c][k];
-
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, fAudioOutBuffers[i], frames);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
-        } // End of Post-processing
+        pData->postProcess(fAudioInBuffers, 0, true, fAudioOutBuffers, 0, audioOut, timeOffset, frames);
 
 # ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
@@ -5702,7 +5943,9 @@ public:
     {
         parameterId = UINT32_MAX;
 
-        if (urid >= fCustomURIDs.size())
+        const char* const uri = fUridTable.unmap(urid);
+
+        if (uri == nullptr)
             return false;
 
         for (uint32_t i=0; i < fRdfDescriptor->ParameterCount; ++i)
@@ -5721,9 +5964,7 @@ public:
                 continue;
             }
 
-            const std::string& uri(fCustomURIDs[urid]);
-
-            if (uri != rdfParam.URI)
+            if (rdfParam.URI == nullptr || std::strcmp(uri, rdfParam.URI) != 0)
                 continue;
 
             const int32_t rindex = static_cast<int32_t>(fRdfDescriptor->PortCount + i);
@@ -5749,25 +5990,37 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("CarlaPluginLV2::getCustomURID(\"%s\")", uri);
 
-        const std::string    s_uri(uri);
-        const std::ptrdiff_t s_pos(std::find(fCustomURIDs.begin(), fCustomURIDs.end(), s_uri) - fCustomURIDs.begin());
+        return fUridTable.map(uri);
+    }
 
-        if (s_pos <= 0 || s_pos >= INT32_MAX)
-            return kUridNull;
+    LV2_URID handlePluginURIDMap(const char* const uri)
+    {
+        const LV2_URID urid = getCustomURID(uri);
 
-        const LV2_URID urid     = static_cast<LV2_URID>(s_pos);
-        const LV2_URID uriCount = static_cast<LV2_URID>(fCustomURIDs.size());
+#ifndef LV2_UIS_ONLY_INPROCESS
+        // the URID table is shared between all plugins, keep track of the ids this one uses
+        if (urid >= kUridCount)
+        {
+            bool isNew = false;
 
-        if (urid < uriCount)
-            return urid;
+            {
+                const CarlaMutexLocker cml(fUsedURIDsMutex);
 
-        CARLA_SAFE_ASSERT(urid == uriCount);
+                if (fIsUsedURID.size() <= urid)
+                    fIsUsedURID.resize(urid + 1U, false);
 
-        fCustomURIDs.push_back(uri);
+                if (! fIsUsedURID[urid])
+                {
+                    fIsUsedURID[urid] = true;
+                    fUsedURIDs.push_back(urid);
+                    isNew = true;
+                }
+            }
 
-#ifndef LV2_UIS_ONLY_INPROCESS
-        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
-            fPipeServer.writeLv2UridMessage(urid, uri);
+            // let the bridged UI know about it right away
+            if (isNew && fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
+                sendNewURIDsToUI();
+        }
 #endif
 
         return urid;
@@ -5776,11 +6029,39 @@ public:
     const char* getCustomURIDString(const LV2_URID urid) const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, kUnmapFallback);
-        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.size(), kUnmapFallback);
         carla_debug("CarlaPluginLV2::getCustomURIString(%i)", urid);
 
-        return fCustomURIDs[urid].c_str();
+        const char* const uri = fUridTable.unmap(urid);
+        CARLA_SAFE_ASSERT_UINT2_RETURN(uri != nullptr, urid, fUridTable.getCount(), kUnmapFallback);
+
+        return uri;
+    }
+
+#ifndef LV2_UIS_ONLY_INPROCESS
+    void sendNewURIDsToUI()
+    {
+        std::vector<LV2_URID> urids;
+
+        // copy the pending ids so we do not hold our lock while writing to the pipe
+        {
+            const CarlaMutexLocker cml(fUsedURIDsMutex);
+
+            if (fUsedURIDsSentToUI >= fUsedURIDs.size())
+                return;
+
+            urids.assign(fUsedURIDs.begin() + static_cast<std::ptrdiff_t>(fUsedURIDsSentToUI), fUsedURIDs.end());
+            fUsedURIDsSentToUI = fUsedURIDs.size();
+        }
+
+        for (std::vector<LV2_URID>::const_iterator it = urids.begin(), end = urids.end(); it != end; ++it)
+        {
+            const char* const uri = fUridTable.unmap(*it);
+            CARLA_SAFE_ASSERT_CONTINUE(uri != nullptr);
+
+            fPipeServer.writeLv2UridMessage(*it, uri);
+        }
     }
+#endif
 
     // -------------------------------------------------------------------
 
@@ -6091,7 +6372,55 @@ public:
         atom.size = size;
         atom.type = kUridCarlaAtomWorkerIn;
 
-        return fAtomBufferWorkerIn.putChunk(&atom, data, fEventsOut.ctrlIndex) ? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE;
+        if (! fAtomBufferWorkerIn.putChunk(&atom, data, fEventsOut.ctrlIndex))
+            return LV2_WORKER_ERR_NO_SPACE;
+
+        addQueuedJobs(1);
+
+        if (fWorkerPool != nullptr)
+            fWorkerPool->schedule(this);
+
+        return LV2_WORKER_SUCCESS;
+    }
+
+    void runWork() override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fExt.worker != nullptr && fExt.worker->work != nullptr,);
+
+        if (! fAtomBufferWorkerIn.isDataAvailableForReading())
+            return;
+
+        Lv2AtomRingBuffer tmpRingBuffer(fAtomBufferWorkerIn, fAtomBufferWorkerInTmpData);
+        CARLA_SAFE_ASSERT_RETURN(tmpRingBuffer.isDataAvailableForReading(),);
+
+        const size_t localSize = fAtomBufferWorkerIn.getSize();
+        uint8_t* const localData = new uint8_t[localSize];
+        LV2_Atom* const localAtom = static_cast<LV2_Atom*>(static_cast<void*>(localData));
+        localAtom->size = localSize;
+        uint32_t portIndex;
+
+        for (; tmpRingBuffer.get(portIndex, localAtom); localAtom->size = localSize)
+        {
+            removeQueuedJobs(1);
+            CARLA_SAFE_ASSERT_CONTINUE(localAtom->type == kUridCarlaAtomWorkerIn);
+            fExt.worker->work(fHandle, carla_lv2_worker_respond, this, localAtom->size, LV2_ATOM_BODY_CONST(localAtom));
+        }
+
+        delete[] localData;
+    }
+
+    bool getWorkerStats(EngineWorkerStats& stats) const noexcept override
+    {
+        if (fExt.worker == nullptr)
+            return false;
+
+        stats.queueDepth    = getQueueDepth();
+        stats.maxQueueDepth = getMaxQueueDepth();
+        stats.numJobs       = getNumJobs();
+        stats.lastLatency   = getLastLatency();
+        stats.maxLatency    = getMaxLatency();
+        stats.lastWorkTime  = getLastWorkTime();
+        return true;
     }
 
     LV2_Worker_Status handleWorkerRespond(const uint32_t size, const void* const data)
@@ -6492,17 +6821,22 @@ public:
 
         Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
 
-        if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
-            lv2World.initIfNeeded(opts.pathLV2);
-        else if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
-            lv2World.initIfNeeded(LV2_PATH);
-        else
-            lv2World.initIfNeeded(LILV_DEFAULT_LV2_PATH);
+        {
+            // plugins might be created from project loader threads
+            const CarlaMutexLocker cml(lv2World.mutex);
 
-        // ---------------------------------------------------------------
-        // get plugin from lv2_rdf (lilv)
+            if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
+                lv2World.initIfNeeded(opts.pathLV2);
+            else if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
+                lv2World.initIfNeeded(LV2_PATH);
+            else
+                lv2World.initIfNeeded(LILV_DEFAULT_LV2_PATH);
 
-        fRdfDescriptor = lv2_rdf_new(uri, true);
+            // -----------------------------------------------------------
+            // get plugin from lv2_rdf (lilv)
+
+            fRdfDescriptor = lv2_rdf_new(uri, true);
+        }
 
         if (fRdfDescriptor == nullptr)
         {
@@ -7455,26 +7789,35 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull,);
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
-        carla_debug("CarlaPluginLV2::handleUridMap(%i v " P_SIZE ", \"%s\")", urid, fCustomURIDs.size()-1, uri);
-
-        const std::size_t uriCount(fCustomURIDs.size());
+        carla_debug("CarlaPluginLV2::handleUridMap(%i v %u, \"%s\")", urid, fUridTable.getCount()-1, uri);
 
-        if (urid < uriCount)
+#ifndef LV2_UIS_ONLY_INPROCESS
+        if (urid >= kLv2UridBridgedUiOffset)
         {
-            const char* const ourURI(carla_lv2_urid_unmap(this, urid));
-            CARLA_SAFE_ASSERT_RETURN(ourURI != nullptr && ourURI != kUnmapFallback,);
+            // mapped by the UI itself, atoms using it get translated to and from our own id
+            const LV2_URID hostUrid = fUridTable.map(uri);
+            CARLA_SAFE_ASSERT_RETURN(hostUrid != kUridNull,);
 
-            if (std::strcmp(ourURI, uri) != 0)
-            {
-                carla_stderr2("PLUGIN :: wrong URI '%s' vs '%s'", ourURI,  uri);
-            }
-        }
-        else
-        {
-            CARLA_SAFE_ASSERT_RETURN(urid == uriCount,);
-            fCustomURIDs.push_back(uri);
+            fUiToHostURIDs[urid] = hostUrid;
+            fHostToUiURIDs[hostUrid] = urid;
+            return;
         }
+#endif
+
+        // anything else was sent to the UI by us
+        const char* const ourURI = fUridTable.unmap(urid);
+
+        if (ourURI == nullptr || std::strcmp(ourURI, uri) != 0)
+            carla_stderr2("PLUGIN :: wrong URI '%s' vs '%s'", ourURI != nullptr ? ourURI : "(null)", uri);
+    }
+
+#ifndef LV2_UIS_ONLY_INPROCESS
+    void handleUridsFromUI(LV2_Atom* const atom, const uint32_t size)
+    {
+        if (! fUiToHostURIDs.empty())
+            lv2_atom_remap_urids(atom, size, fUiToHostURIDs);
     }
+#endif
 
     // -------------------------------------------------------------------
 
@@ -7539,6 +7882,9 @@ private:
     LV2_Atom*         fAtomBufferRealtime;
     uint32_t          fAtomBufferRealtimeSize;
 
+    // engine worker threads running our worker jobs, null if run on idle
+    CarlaWorkerPool* fWorkerPool;
+
     CarlaPluginLV2EventData fEventsIn;
     CarlaPluginLV2EventData fEventsOut;
     CarlaPluginLV2Options   fLv2Options;
@@ -7546,7 +7892,18 @@ private:
     CarlaPipeServerLV2      fPipeServer;
 #endif
 
-    std::vector<std::string> fCustomURIDs;
+    Lv2UridTable& fUridTable;
+#ifndef LV2_UIS_ONLY_INPROCESS
+    // URIDs mapped by this plugin, the only ones a bridged UI needs to know about
+    CarlaMutex fUsedURIDsMutex;
+    std::vector<LV2_URID> fUsedURIDs;
+    std::vector<bool> fIsUsedURID;
+    std::size_t fUsedURIDsSentToUI;
+
+    // ids the bridged UI gave to URIs it mapped by itself, see kLv2UridBridgedUiOffset
+    Lv2UridRemap fUiToHostURIDs;
+    Lv2UridRemap fHostToUiURIDs;
+#endif
 
     bool fFirstActive; // first process() call after activate()
     void* fLastStateChunk;
@@ -7862,136 +8219,7 @@ private:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("carla_lv2_urid_map(%p, \"%s\")", handle, uri);
 
-        // Atom types
-        if (std::strcmp(uri, LV2_ATOM__Blank) == 0)
-            return kUridAtomBlank;
-        if (std::strcmp(uri, LV2_ATOM__Bool) == 0)
-            return kUridAtomBool;
-        if (std::strcmp(uri, LV2_ATOM__Chunk) == 0)
-            return kUridAtomChunk;
-        if (std::strcmp(uri, LV2_ATOM__Double) == 0)
-            return kUridAtomDouble;
-        if (std::strcmp(uri, LV2_ATOM__Event) == 0)
-            return kUridAtomEvent;
-        if (std::strcmp(uri, LV2_ATOM__Float) == 0)
-            return kUridAtomFloat;
-        if (std::strcmp(uri, LV2_ATOM__Int) == 0)
-            return kUridAtomInt;
-        if (std::strcmp(uri, LV2_ATOM__Literal) == 0)
-            return kUridAtomLiteral;
-        if (std::strcmp(uri, LV2_ATOM__Long) == 0)
-            return kUridAtomLong;
-        if (std::strcmp(uri, LV2_ATOM__Number) == 0)
-            return kUridAtomNumber;
-        if (std::strcmp(uri, LV2_ATOM__Object) == 0)
-            return kUridAtomObject;
-        if (std::strcmp(uri, LV2_ATOM__Path) == 0)
-            return kUridAtomPath;
-        if (std::strcmp(uri, LV2_ATOM__Property) == 0)
-            return kUridAtomProperty;
-        if (std::strcmp(uri, LV2_ATOM__Resource) == 0)
-            return kUridAtomResource;
-        if (std::strcmp(uri, LV2_ATOM__Sequence) == 0)
-            return kUridAtomSequence;
-        if (std::strcmp(uri, LV2_ATOM__Sound) == 0)
-            return kUridAtomSound;
-        if (std::strcmp(uri, LV2_ATOM__String) == 0)
-            return kUridAtomString;
-        if (std::strcmp(uri, LV2_ATOM__Tuple) == 0)
-            return kUridAtomTuple;
-        if (std::strcmp(uri, LV2_ATOM__URI) == 0)
-            return kUridAtomURI;
-        if (std::strcmp(uri, LV2_ATOM__URID) == 0)
-            return kUridAtomURID;
-        if (std::strcmp(uri, LV2_ATOM__Vector) == 0)
-            return kUridAtomVector;
-        if (std::strcmp(uri, LV2_ATOM__atomTransfer) == 0)
-            return kUridAtomTransferAtom;
-        if (std::strcmp(uri, LV2_ATOM__eventTransfer) == 0)
-            return kUridAtomTransferEvent;
-
-        // BufSize types
-        if (std::strcmp(uri, LV2_BUF_SIZE__maxBlockLength) == 0)
-            return kUridBufMaxLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__minBlockLength) == 0)
-            return kUridBufMinLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__nominalBlockLength) == 0)
-            return kUridBufNominalLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__sequenceSize) == 0)
-            return kUridBufSequenceSize;
-
-        // Log types
-        if (std::strcmp(uri, LV2_LOG__Error) == 0)
-            return kUridLogError;
-        if (std::strcmp(uri, LV2_LOG__Note) == 0)
-            return kUridLogNote;
-        if (std::strcmp(uri, LV2_LOG__Trace) == 0)
-            return kUridLogTrace;
-        if (std::strcmp(uri, LV2_LOG__Warning) == 0)
-            return kUridLogWarning;
-
-        // Patch types
-        if (std::strcmp(uri, LV2_PATCH__Set) == 0)
-            return kUridPatchSet;
-        if (std::strcmp(uri, LV2_PATCH__property) == 0)
-            return kUridPatchProperty;
-        if (std::strcmp(uri, LV2_PATCH__subject) == 0)
-            return kUridPatchSubject;
-        if (std::strcmp(uri, LV2_PATCH__value) == 0)
-            return kUridPatchValue;
-
-        // Time types
-        if (std::strcmp(uri, LV2_TIME__Position) == 0)
-            return kUridTimePosition;
-        if (std::strcmp(uri, LV2_TIME__bar) == 0)
-            return kUridTimeBar;
-        if (std::strcmp(uri, LV2_TIME__barBeat) == 0)
-            return kUridTimeBarBeat;
-        if (std::strcmp(uri, LV2_TIME__beat) == 0)
-            return kUridTimeBeat;
-        if (std::strcmp(uri, LV2_TIME__beatUnit) == 0)
-            return kUridTimeBeatUnit;
-        if (std::strcmp(uri, LV2_TIME__beatsPerBar) == 0)
-            return kUridTimeBeatsPerBar;
-        if (std::strcmp(uri, LV2_TIME__beatsPerMinute) == 0)
-            return kUridTimeBeatsPerMinute;
-        if (std::strcmp(uri, LV2_TIME__frame) == 0)
-            return kUridTimeFrame;
-        if (std::strcmp(uri, LV2_TIME__framesPerSecond) == 0)
-            return kUridTimeFramesPerSecond;
-        if (std::strcmp(uri, LV2_TIME__speed) == 0)
-            return kUridTimeSpeed;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat) == 0)
-            return kUridTimeTicksPerBeat;
-
-        // Others
-        if (std::strcmp(uri, LV2_MIDI__MidiEvent) == 0)
-            return kUridMidiEvent;
-        if (std::strcmp(uri, LV2_PARAMETERS__sampleRate) == 0)
-            return kUridParamSampleRate;
-        if (std::strcmp(uri, LV2_UI__backgroundColor) == 0)
-            return kUridBackgroundColor;
-        if (std::strcmp(uri, LV2_UI__foregroundColor) == 0)
-            return kUridForegroundColor;
-#ifndef CARLA_OS_MAC
-        if (std::strcmp(uri, LV2_UI__scaleFactor) == 0)
-            return kUridScaleFactor;
-#endif
-        if (std::strcmp(uri, LV2_UI__windowTitle) == 0)
-            return kUridWindowTitle;
-
-        // Custom Carla types
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_IN) == 0)
-            return kUridCarlaAtomWorkerIn;
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_RESP) == 0)
-            return kUridCarlaAtomWorkerResp;
-        if (std::strcmp(uri, URI_CARLA_PARAMETER_CHANGE) == 0)
-            return kUridCarlaParameterChange;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TransientWindowId) == 0)
-            return kUridCarlaTransientWindowId;
-
-        // Custom plugin types
-        return ((CarlaPluginLV2*)handle)->getCustomURID(uri);
+        return ((CarlaPluginLV2*)handle)->handlePluginURIDMap(uri);
     }
 
     static const char* carla_lv2_urid_unmap(LV2_URID_Map_Handle handle, LV2_URID urid)
@@ -8000,138 +8228,6 @@ private:
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, nullptr);
         carla_debug("carla_lv2_urid_unmap(%p, %i)", handle, urid);
 
-        switch (urid)
-        {
-        // Atom types
-        case kUridAtomBlank:
-            return LV2_ATOM__Blank;
-        case kUridAtomBool:
-            return LV2_ATOM__Bool;
-        case kUridAtomChunk:
-            return LV2_ATOM__Chunk;
-        case kUridAtomDouble:
-            return LV2_ATOM__Double;
-        case kUridAtomEvent:
-            return LV2_ATOM__Event;
-        case kUridAtomFloat:
-            return LV2_ATOM__Float;
-        case kUridAtomInt:
-            return LV2_ATOM__Int;
-        case kUridAtomLiteral:
-            return LV2_ATOM__Literal;
-        case kUridAtomLong:
-            return LV2_ATOM__Long;
-        case kUridAtomNumber:
-            return LV2_ATOM__Number;
-        case kUridAtomObject:
-            return LV2_ATOM__Object;
-        case kUridAtomPath:
-            return LV2_ATOM__Path;
-        case kUridAtomProperty:
-            return LV2_ATOM__Property;
-        case kUridAtomResource:
-            return LV2_ATOM__Resource;
-        case kUridAtomSequence:
-            return LV2_ATOM__Sequence;
-        case kUridAtomSound:
-            return LV2_ATOM__Sound;
-        case kUridAtomString:
-            return LV2_ATOM__String;
-        case kUridAtomTuple:
-            return LV2_ATOM__Tuple;
-        case kUridAtomURI:
-            return LV2_ATOM__URI;
-        case kUridAtomURID:
-            return LV2_ATOM__URID;
-        case kUridAtomVector:
-            return LV2_ATOM__Vector;
-        case kUridAtomTransferAtom:
-            return LV2_ATOM__atomTransfer;
-        case kUridAtomTransferEvent:
-            return LV2_ATOM__eventTransfer;
-
-        // BufSize types
-        case kUridBufMaxLength:
-            return LV2_BUF_SIZE__maxBlockLength;
-        case kUridBufMinLength:
-            return LV2_BUF_SIZE__minBlockLength;
-        case kUridBufNominalLength:
-            return LV2_BUF_SIZE__nominalBlockLength;
-        case kUridBufSequenceSize:
-            return LV2_BUF_SIZE__sequenceSize;
-
-        // Log types
-        case kUridLogError:
-            return LV2_LOG__Error;
-        case kUridLogNote:
-            return LV2_LOG__Note;
-        case kUridLogTrace:
-            return LV2_LOG__Trace;
-        case kUridLogWarning:
-            return LV2_LOG__Warning;
-
-        // Patch types
-        case kUridPatchSet:
-            return LV2_PATCH__Set;
-        case kUridPatchProperty:
-            return LV2_PATCH__property;
-        case kUridPatchSubject:
-            return LV2_PATCH__subject;
-        case kUridPatchValue:
-            return LV2_PATCH__value;
-
-        // Time types
-        case kUridTimePosition:
-            return LV2_TIME__Position;
-        case kUridTimeBar:
-            return LV2_TIME__bar;
-        case kUridTimeBarBeat:
-            return LV2_TIME__barBeat;
-        case kUridTimeBeat:
-            return LV2_TIME__beat;
-        case kUridTimeBeatUnit:
-            return LV2_TIME__beatUnit;
-        case kUridTimeBeatsPerBar:
-            return LV2_TIME__beatsPerBar;
-        case kUridTimeBeatsPerMinute:
-            return LV2_TIME__beatsPerMinute;
-        case kUridTimeFrame:
-            return LV2_TIME__frame;
-        case kUridTimeFramesPerSecond:
-            return LV2_TIME__framesPerSecond;
-        case kUridTimeSpeed:
-            return LV2_TIME__speed;
-        case kUridTimeTicksPerBeat:
-            return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
-
-        // Others
-        case kUridMidiEvent:
-            return LV2_MIDI__MidiEvent;
-        case kUridParamSampleRate:
-            return LV2_PARAMETERS__sampleRate;
-        case kUridBackgroundColor:
-            return LV2_UI__backgroundColor;
-        case kUridForegroundColor:
-            return LV2_UI__foregroundColor;
-#ifndef CARLA_OS_MAC
-        case kUridScaleFactor:
-            return LV2_UI__scaleFactor;
-#endif
-        case kUridWindowTitle:
-            return LV2_UI__windowTitle;
-
-        // Custom Carla types
-        case kUridCarlaAtomWorkerIn:
-            return URI_CARLA_ATOM_WORKER_IN;
-        case kUridCarlaAtomWorkerResp:
-            return URI_CARLA_ATOM_WORKER_RESP;
-        case kUridCarlaParameterChange:
-            return URI_CARLA_PARAMETER_CHANGE;
-        case kUridCarlaTransientWindowId:
-            return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
-        }
-
-        // Custom plugin types
         return ((CarlaPluginLV2*)handle)->getCustomURIDString(urid);
     }
 
@@ -8317,12 +8413,14 @@ bool CarlaPipeServerLV2::msgReceived(const char* const msg) noexcept
         CARLA_SAFE_ASSERT_UINT2_RETURN(chunk.size() >= sizeof(LV2_Atom), chunk.size(), sizeof(LV2_Atom), true);
 
 #ifdef CARLA_PROPER_CPP11_SUPPORT
-        const LV2_Atom* const atom((const LV2_Atom*)chunk.data());
+        LV2_Atom* const atom((LV2_Atom*)chunk.data());
 #else
-        const LV2_Atom* const atom((const LV2_Atom*)&chunk.front());
+        LV2_Atom* const atom((LV2_Atom*)&chunk.front());
 #endif
         CARLA_SAFE_ASSERT_RETURN(lv2_atom_total_size(atom) == chunk.size(), true);
 
+        kPlugin->handleUridsFromUI(atom, static_cast<uint32_t>(chunk.size()));
+
         try {
             kPlugin->handleUIWrite(index, lv2_atom_total_size(atom), kUridAtomTransferEvent, atom);
         } CARLA_SAFE_EXCEPTION("magReceived atom");
@@ -50,7 +50,8 @@ class NativePluginInitializer
 {
 public:
     NativePluginInitializer() noexcept
-        : fNeedsInit(true) {}
+        : fNeedsInit(true),
+          fMutex() {}
 
     ~NativePluginInitializer() noexcept
     {
@@ -59,6 +60,9 @@ public:
 
     void initIfNeeded() noexcept
     {
+        // plugins can be created from several project loader threads
+        const CarlaMutexLocker cml(fMutex);
+
         if (! fNeedsInit)
             return;
 
@@ -71,6 +75,7 @@ public:
 
 private:
     bool fNeedsInit;
+    CarlaMutex fMutex;
 
 } sPluginInitializer;
 
@@ -271,6 +276,8 @@ public:
     {
         carla_debug("CarlaPluginNative::CarlaPluginNative(%p, %i)", engine, id);
 
+        pData->param.outputsTracked = true;
+
         carla_fill(fCurMidiProgs, 0, MAX_MIDI_CHANNELS);
         carla_zeroStructs(fMidiInEvents, kPluginMaxMidiEvents);
         carla_zeroStructs(fMidiOutEvents, kPluginMaxMidiEvents);
@@ -2256,13 +2263,11 @@ public:
 
         } // End of Plugin processing (no events)
 
-#ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
         // Control Output
 
-        if (pData->event.portOut != nullptr)
         {
-            float value, curValue;
+            float curValue;
 
             for (uint32_t k=0; k < pData->param.count; ++k)
             {
@@ -2271,10 +2276,12 @@ public:
 
                 curValue = fDescriptor->get_parameter_value(fHandle, k);
                 pData->param.ranges[k].fixValue(curValue);
+                pData->param.updateOutputValue(k, curValue);
 
-                if (pData->param.data[k].mappedControlIndex > 0)
+#ifndef BUILD_BRIDGE
+                if (pData->event.portOut != nullptr && pData->param.data[k].mappedControlIndex > 0)
                 {
-                    value = pData->param.ranges[k].getNormalizedValue(curValue);
+                    const float value = pData->param.ranges[k].getNormalizedValue(curValue);
                     pData->event.portOut->writeControlEvent(0,
                                                             pData->param.data[k].midiChannel,
                                                             kEngineControlEventTypeParameter,
@@ -2282,9 +2289,9 @@ public:
                                                             -1,
                                                             value);
                 }
+#endif
             }
         } // End of Control Output
-#endif
     }
 
     bool processSingle(const float* const* const audioIn, float** const audioOut,
@@ -2376,67 +2383,10 @@ public:
         uint32_t i=0;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-
-            bool isPair;
-            float bufValue;
-            float* const oldBufLeft = pData->postProc.extraBuffer;
-
-            for (; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        bufValue = fAudioAndCvInBuffers[(pData->audioIn.count == 1) ? 0 : i][k];
-                        fAudioAndCvOutBuffers[i][k] = (fAudioAndCvOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, fAudioAndCvOutBuffers[i], frames);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioAndCvOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioAndCvOutBuffers[i][k] += fAudioAndCvOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioAndCvOutBuffers[i][k]  = fAudioAndCvOutBuffers[i][k] * balRangeR;
-                            fAudioAndCvOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioAndCvOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
+        // Post-processing (dry/wet, volume, balance and panning)
 
-        } // End of Post-processing
+        pData->postProcess(fAudioAndCvInBuffers, 0, false, fAudioAndCvOutBuffers, 0, audioOut, timeOffset, frames);
+        i = pData->audioOut.count;
 #else
         for (; i < pData->audioOut.count; ++i)
         {
@@ -65,6 +65,8 @@ public:
           fRealName(nullptr)
     {
         carla_debug("CarlaPluginSFZero::CarlaPluginSFZero(%p, %i)", engine, id);
+
+        pData->param.outputsTracked = true;
     }
 
     ~CarlaPluginSFZero() override
@@ -562,6 +564,7 @@ public:
         // Parameter outputs
 
         fNumVoices = static_cast<float>(fSynth.numVoicesUsed());
+        pData->param.updateOutputValue(0, fNumVoices);
     }
 
     bool processSingle(AudioSampleBuffer& audioOutBuffer, const uint32_t frames, const uint32_t timeOffset)
@@ -591,59 +594,16 @@ public:
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
+        // Post-processing (volume, balance and panning)
 
         {
-            const bool doVolume  = carla_isNotEqual(pData->postProc.volume, 1.0f);
-            //const bool doBalance = carla_isNotEqual(pData->postProc.balanceLeft, -1.0f) || carla_isNotEqual(pData->postProc.balanceRight, 1.0f);
-
-            float* outBufferL = audioOutBuffer.getWritePointer(0, timeOffset);
-            float* outBufferR = audioOutBuffer.getWritePointer(1, timeOffset);
-
-#if 0
-            if (doBalance)
-            {
-                float* const oldBufLeft = pData->postProc.extraBuffer;
-
-                // there was a loop here
-                {
-                    if (i % 2 == 0)
-                        carla_copyFloats(oldBufLeft, outBuffer[i], frames);
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
+            float* const outBuffers[2] = {
+                audioOutBuffer.getWritePointer(0, timeOffset),
+                audioOutBuffer.getWritePointer(1, timeOffset),
+            };
 
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            // left
-                            outBuffer[i][k]  = oldBufLeft[k]     * (1.0f - balRangeL);
-                            outBuffer[i][k] += outBuffer[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            outBuffer[i][k]  = outBuffer[i][k] * balRangeR;
-                            outBuffer[i][k] += oldBufLeft[k]   * balRangeL;
-                        }
-                    }
-                }
-            }
-#endif
-
-            if (doVolume)
-            {
-                const float volume = pData->postProc.volume;
-
-                for (uint32_t k=0; k < frames; ++k)
-                {
-                    *outBufferL++ *= volume;
-                    *outBufferR++ *= volume;
-                }
-            }
-
-        } // End of Post-processing
+            pData->postProcess(nullptr, 0, false, outBuffers, 0, outBuffers, 0, frames);
+        }
 #endif
 
         // --------------------------------------------------------------------------------------------------------
@@ -701,7 +661,7 @@ public:
         };
 
         sound->loadRegions();
-        sound->loadSamples(cb);
+        sound->loadSamples(cb, sfzero::kStreamPreloadFrames);
 
         if (fSynth.addSound(sound) == nullptr)
         {
@@ -709,6 +669,10 @@ public:
             return false;
         }
 
+        // long samples are only partially loaded, the rest is streamed from disk
+        if (sound->hasStreamedSamples() && ! fSynth.enableStreaming())
+            carla_stderr2("Failed to start SFZ disk streaming, long samples will be cut short");
+
         sound->dumpToConsole();
 
         // ---------------------------------------------------------------
@@ -1221,6 +1221,8 @@ public:
     {
         carla_debug("CarlaPluginVST3::CarlaPluginVST3(%p, %i)", engine, id);
 
+        pData->param.outputsTracked = true;
+
         carla_zeroStruct(fV3TimeContext);
     }
 
@@ -3101,6 +3103,9 @@ public:
 
                     pData->postponeParameterChangeRtEvent(true, static_cast<int32_t>(i), value);
 
+                    if (pData->param.data[i].type == PARAMETER_OUTPUT)
+                        pData->param.updateOutputValue(i, value);
+
                     if (pData->param.data[i].type == PARAMETER_OUTPUT && pData->param.data[i].mappedControlIndex > 0)
                     {
                         channel = pData->param.data[i].midiChannel;
@@ -3123,77 +3128,14 @@ public:
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // ------------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0
-                                    && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0
-                                    && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f)
-                                          && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue;
-            float* const oldBufLeft = pData->postProc.extraBuffer;
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        bufValue = inBuffer[c][k+timeOffset];
-                        fAudioAndCvOutBuffers[i][k] = (fAudioAndCvOutBuffers[i][k] * pData->postProc.dryWet)
-                                                    + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, fAudioAndCvOutBuffers[i], frames);
-                    }
+        // Post-processing (dry/wet, volume, balance and panning)
 
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
+        pData->postProcess(inBuffer, timeOffset, false,
+                           fAudioAndCvOutBuffers, timeOffset,
+                           outBuffer, timeOffset, frames);
 
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioAndCvOutBuffers[i][k]  = oldBufLeft[k]                 * (1.0f - balRangeL);
-                            fAudioAndCvOutBuffers[i][k] += fAudioAndCvOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioAndCvOutBuffers[i][k]  = fAudioAndCvOutBuffers[i][k] * balRangeR;
-                            fAudioAndCvOutBuffers[i][k] += oldBufLeft[k]               * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] = fAudioAndCvOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
-
-            for (uint32_t i=0, j=pData->audioOut.count; i < pData->cvOut.count; ++i, ++j)
-                carla_copyFloats(cvOut[i] + timeOffset, fAudioAndCvOutBuffers[j] + timeOffset, frames);
-
-        } // End of Post-processing
+        for (uint32_t i=0, j=pData->audioOut.count; i < pData->cvOut.count; ++i, ++j)
+            carla_copyFloats(cvOut[i] + timeOffset, fAudioAndCvOutBuffers[j] + timeOffset, frames);
 #else // BUILD_BRIDGE_ALTERNATIVE_ARCH
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
             carla_copyFloats(outBuffer[i] + timeOffset, fAudioAndCvOutBuffers[i] + timeOffset, frames);
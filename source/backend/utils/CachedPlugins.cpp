@@ -20,6 +20,7 @@
 #include "CarlaNative.h"
 #include "CarlaString.hpp"
 #include "CarlaBackendUtils.hpp"
+#include "CarlaCacheUtils.hpp"
 #include "CarlaLv2Utils.hpp"
 
 #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -37,6 +38,13 @@
 #endif
 
 #include "water/files/File.h"
+#include "water/memory/MemoryBlock.h"
+#include "water/streams/MemoryInputStream.h"
+#include "water/streams/MemoryOutputStream.h"
+
+#include <map>
+#include <set>
+#include <string>
 
 namespace CB = CARLA_BACKEND_NAMESPACE;
 
@@ -185,8 +193,437 @@ static const CarlaCachedPluginInfo* get_cached_plugin_internal(const NativePlugi
 }
 
 // -------------------------------------------------------------------------------------------------------------------
+// LV2 plugin info cache, shared between calls and processes
+// Plugin info is stored per bundle, which is parsed again once any of its turtle files changes.
+// Each plugin also keeps a signature of its UIs, which often live in other bundles.
+
+static const char kLv2CacheMagic[8] = { 'C', 'A', 'R', 'L', 'A', 'L', 'V', '2' };
+static const int  kLv2CacheVersion  = 2;
+
+// Plugin hints depend on the Carla version and on the UI types this build can embed
+static const char* const kLv2CacheBuildId = CARLA_VERSION_STRING
+#if defined(CARLA_OS_MAC)
+    "+cocoa"
+#elif defined(CARLA_OS_WIN)
+    "+windows"
+#elif defined(HAVE_X11)
+    "+x11"
+#endif
+#ifdef CARLA_OS_LINUX
+    "+modgui"
+#endif
+    ;
 
-static const CarlaCachedPluginInfo* get_cached_plugin_lv2(Lv2WorldClass& lv2World, Lilv::Plugin& lilvPlugin)
+// Get the most recent modification time and the total size of the turtle files of a bundle
+static void getLv2BundleSignature(const char* const bundlePath, int64_t& mtime, int64_t& size)
+{
+    using water::File;
+
+    const File bundle(bundlePath);
+    std::vector<File> files;
+    bundle.findChildFiles(files, File::findFiles, false, "*.ttl");
+
+    mtime = bundle.getLastModificationTime();
+    size = 0;
+
+    for (std::vector<File>::const_iterator it = files.begin(); it != files.end(); ++it)
+    {
+        mtime = std::max<int64_t>(mtime, it->getLastModificationTime());
+        size += it->getSize();
+    }
+}
+
+// Get the UIs of a plugin declared in manifests, along with the signature of their bundles if not the plugin one.
+// This only looks at data lilv has loaded already, so it is cheap compared to parsing the plugin.
+static std::string getLv2PluginUiSignature(Lv2WorldClass& lv2World, Lilv::Plugin& lilvPlugin, const char* const bundlePath)
+{
+    const Lilv::Node uiPredicate(lv2World.new_uri(LV2_UI__ui));
+    const Lilv::Node binaryPredicate(lv2World.new_uri(LV2_UI__binary));
+    const water::File pluginBundle(bundlePath);
+
+    std::set<std::string> entries;
+    Lilv::Nodes uiNodes(lv2World.find_nodes(lilvPlugin.get_uri(), uiPredicate, nullptr));
+
+    LILV_FOREACH(nodes, it, uiNodes)
+    {
+        Lilv::Node uiNode(uiNodes.get(it));
+        const char* const uiURI = uiNode.as_uri();
+        CARLA_SAFE_ASSERT_CONTINUE(uiURI != nullptr);
+
+        std::string entry(uiURI);
+
+        Lilv::Nodes binaryNodes(lv2World.find_nodes(uiNode, binaryPredicate, nullptr));
+
+        if (binaryNodes.size() > 0)
+        {
+            if (char* const binary = lilv_file_uri_parse(binaryNodes.get_first().as_uri(), nullptr))
+            {
+                const water::File uiBundle(water::File(binary).getParentDirectory());
+
+                if (uiBundle != pluginBundle)
+                {
+                    int64_t mtime, size;
+                    getLv2BundleSignature(uiBundle.getFullPathName().toRawUTF8(), mtime, size);
+
+                    char sigBuf[64];
+                    std::snprintf(sigBuf, sizeof(sigBuf), " " P_INT64 " " P_INT64, mtime, size);
+                    entry += uiBundle.getFullPathName().toRawUTF8();
+                    entry += sigBuf;
+                }
+
+                lilv_free(binary);
+            }
+        }
+
+        lilv_nodes_free(const_cast<LilvNodes*>(binaryNodes.me));
+        entries.insert(entry);
+    }
+
+    lilv_nodes_free(const_cast<LilvNodes*>(uiNodes.me));
+
+    std::string signature;
+
+    for (std::set<std::string>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        signature += *it;
+        signature += '\n';
+    }
+
+    return signature;
+}
+
+class Lv2PluginInfoCache
+{
+public:
+    static Lv2PluginInfoCache& getInstance()
+    {
+        static Lv2PluginInfoCache instance;
+        return instance;
+    }
+
+    /*
+     * Get the cached info of a plugin, or null if its bundle needs to be parsed.
+     * The info is outdated as well if @a uiSignature does not match the stored one.
+     */
+    const CarlaCachedPluginInfo* get(const char* const bundlePath, const char* const uri, const std::string& uiSignature)
+    {
+        if (! load())
+            return nullptr;
+
+        const std::map<std::string, Bundle>::iterator bit = fBundles.find(bundlePath);
+
+        if (bit == fBundles.end() || ! checkBundle(bundlePath, bit->second))
+            return nullptr;
+
+        const std::map<std::string, Plugin>::const_iterator pit = bit->second.plugins.find(uri);
+
+        if (pit == bit->second.plugins.end() || pit->second.uiSignature != uiSignature)
+            return nullptr;
+
+        const Plugin& plugin(pit->second);
+
+        static CarlaCachedPluginInfo info;
+        info.valid         = plugin.valid;
+        info.category      = static_cast<CB::PluginCategory>(plugin.category);
+        info.hints         = plugin.hints;
+        info.audioIns      = plugin.io[0];
+        info.audioOuts     = plugin.io[1];
+        info.cvIns         = plugin.io[2];
+        info.cvOuts        = plugin.io[3];
+        info.midiIns       = plugin.io[4];
+        info.midiOuts      = plugin.io[5];
+        info.parameterIns  = plugin.io[6];
+        info.parameterOuts = plugin.io[7];
+        info.name          = plugin.name.c_str();
+        info.label         = plugin.label.c_str();
+        info.maker         = plugin.maker.c_str();
+        info.copyright     = plugin.copyright.c_str();
+        return &info;
+    }
+
+    /*
+     * Store the info of a plugin that was just parsed.
+     */
+    void add(const char* const bundlePath, const char* const uri, const std::string& uiSignature,
+             const CarlaCachedPluginInfo& info)
+    {
+        if (! load())
+            return;
+
+        Bundle& bundle(fBundles[bundlePath]);
+        checkBundle(bundlePath, bundle);
+
+        Plugin& plugin(bundle.plugins[uri]);
+        plugin.valid     = info.valid;
+        plugin.category  = static_cast<uint32_t>(info.category);
+        plugin.hints     = info.hints;
+        plugin.io[0]     = info.audioIns;
+        plugin.io[1]     = info.audioOuts;
+        plugin.io[2]     = info.cvIns;
+        plugin.io[3]     = info.cvOuts;
+        plugin.io[4]     = info.midiIns;
+        plugin.io[5]     = info.midiOuts;
+        plugin.io[6]     = info.parameterIns;
+        plugin.io[7]     = info.parameterOuts;
+        plugin.name      = info.name;
+        plugin.label     = info.label;
+        plugin.maker     = info.maker;
+        plugin.copyright = info.copyright;
+        plugin.uiSignature = uiSignature;
+
+        fChanged = true;
+    }
+
+    /*
+     * Write the cache file if anything changed.
+     * Bundles that were not used in this process are kept, unless they no longer exist.
+     * Must be called explicitly once done, nothing is written on exit.
+     */
+    void save()
+    {
+        for (std::map<std::string, Bundle>::iterator it = fBundles.begin(); it != fBundles.end();)
+        {
+            if (! it->second.checked && ! water::File(it->first.c_str()).isDirectory())
+            {
+                fBundles.erase(it++);
+                fChanged = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (! fChanged)
+            return;
+
+        fChanged = false;
+
+        water::MemoryOutputStream out;
+        out.write(kLv2CacheMagic, sizeof(kLv2CacheMagic));
+        out.writeInt(kLv2CacheVersion);
+        out.writeString(kLv2CacheBuildId);
+        out.writeInt(static_cast<int>(fBundles.size()));
+
+        for (std::map<std::string, Bundle>::const_iterator bit = fBundles.begin(); bit != fBundles.end(); ++bit)
+        {
+            const Bundle& bundle(bit->second);
+
+            out.writeString(bit->first.c_str());
+            out.writeInt64(bundle.mtime);
+            out.writeInt64(bundle.size);
+            out.writeInt(static_cast<int>(bundle.plugins.size()));
+
+            for (std::map<std::string, Plugin>::const_iterator pit = bundle.plugins.begin();
+                 pit != bundle.plugins.end(); ++pit)
+            {
+                const Plugin& plugin(pit->second);
+
+                out.writeString(pit->first.c_str());
+                out.writeBool(plugin.valid);
+                out.writeInt(static_cast<int>(plugin.category));
+                out.writeInt(static_cast<int>(plugin.hints));
+
+                for (int i=0; i<8; ++i)
+                    out.writeInt(static_cast<int>(plugin.io[i]));
+
+                out.writeString(plugin.name.c_str());
+                out.writeString(plugin.label.c_str());
+                out.writeString(plugin.maker.c_str());
+                out.writeString(plugin.copyright.c_str());
+                out.writeString(plugin.uiSignature.c_str());
+            }
+        }
+
+        out.write(kLv2CacheMagic, sizeof(kLv2CacheMagic));
+
+        const water::File folder(fFile.getParentDirectory());
+
+        if (! folder.createDirectory().wasOk())
+        {
+            carla_stderr2("Failed to create LV2 cache folder '%s'", folder.getFullPathName().toRawUTF8());
+            return;
+        }
+
+        if (! fFile.replaceWithData(out.getData(), out.getDataSize()))
+            carla_stderr2("Failed to write LV2 cache '%s'", fFile.getFullPathName().toRawUTF8());
+    }
+
+private:
+    struct Plugin {
+        bool valid;
+        uint32_t category;
+        uint32_t hints;
+        uint32_t io[8];
+        std::string name;
+        std::string label;
+        std::string maker;
+        std::string copyright;
+        std::string uiSignature;
+
+        Plugin() noexcept
+            : valid(false),
+              category(0),
+              hints(0),
+              name(),
+              label(),
+              maker(),
+              copyright(),
+              uiSignature()
+        {
+            carla_zeroStructs(io, 8);
+        }
+    };
+
+    struct Bundle {
+        int64_t mtime;
+        int64_t size;
+        bool checked; // signature was compared against the bundle files in this process
+        std::map<std::string, Plugin> plugins;
+
+        Bundle() noexcept
+            : mtime(0),
+              size(0),
+              checked(false),
+              plugins() {}
+    };
+
+    water::File fFile;
+    bool fEnabled;
+    bool fLoaded;
+    bool fChanged;
+    std::map<std::string, Bundle> fBundles;
+
+    Lv2PluginInfoCache()
+        : fFile(),
+          fEnabled(false),
+          fLoaded(false),
+          fChanged(false),
+          fBundles()
+    {
+        water::File folder;
+
+        if (carla_getCacheFolder(folder))
+        {
+            fFile = folder.getChildFile(kLv2CacheFileName);
+            fEnabled = true;
+        }
+    }
+
+    // Compare the stored signature of a bundle with its current files, dropping outdated plugins
+    bool checkBundle(const char* const bundlePath, Bundle& bundle)
+    {
+        if (bundle.checked)
+            return true;
+
+        int64_t mtime, size;
+        getLv2BundleSignature(bundlePath, mtime, size);
+        bundle.checked = true;
+
+        if (bundle.mtime == mtime && bundle.size == size)
+            return true;
+
+        bundle.mtime = mtime;
+        bundle.size = size;
+        bundle.plugins.clear();
+        fChanged = true;
+        return false;
+    }
+
+    // Read the cache file once, returns false if caching is disabled
+    bool load()
+    {
+        if (! fEnabled)
+            return false;
+        if (fLoaded)
+            return true;
+
+        fLoaded = true;
+
+        water::MemoryBlock data;
+
+        if (! fFile.existsAsFile() || ! fFile.loadFileAsData(data))
+            return true;
+
+        water::MemoryInputStream in(data, false);
+        char magic[sizeof(kLv2CacheMagic)];
+
+        if (in.read(magic, sizeof(magic)) == sizeof(magic)
+            && std::memcmp(magic, kLv2CacheMagic, sizeof(magic)) == 0
+            && in.readInt() == kLv2CacheVersion
+            && in.readString() == kLv2CacheBuildId
+            && readBundles(in))
+        {
+            return true;
+        }
+
+        // invalid or from another version or build, rewrite it
+        carla_stderr("LV2 cache '%s' is invalid, ignoring it", fFile.getFullPathName().toRawUTF8());
+        fBundles.clear();
+        fChanged = true;
+        return true;
+    }
+
+    bool readBundles(water::MemoryInputStream& in)
+    {
+        const int numBundles = in.readInt();
+
+        if (numBundles < 0)
+            return false;
+
+        for (int b=0; b<numBundles; ++b)
+        {
+            const water::String bundlePath(in.readString());
+
+            if (bundlePath.isEmpty())
+                return false;
+
+            Bundle& bundle(fBundles[bundlePath.toRawUTF8()]);
+            bundle.mtime = in.readInt64();
+            bundle.size = in.readInt64();
+
+            const int numPlugins = in.readInt();
+
+            if (numPlugins < 0 || numPlugins > in.getNumBytesRemaining())
+                return false;
+
+            for (int p=0; p<numPlugins; ++p)
+            {
+                const water::String uri(in.readString());
+
+                if (uri.isEmpty())
+                    return false;
+
+                Plugin& plugin(bundle.plugins[uri.toRawUTF8()]);
+                plugin.valid    = in.readBool();
+                plugin.category = static_cast<uint32_t>(in.readInt());
+                plugin.hints    = static_cast<uint32_t>(in.readInt());
+
+                for (int i=0; i<8; ++i)
+                    plugin.io[i] = static_cast<uint32_t>(in.readInt());
+
+                plugin.name      = in.readString().toRawUTF8();
+                plugin.label     = in.readString().toRawUTF8();
+                plugin.maker     = in.readString().toRawUTF8();
+                plugin.copyright = in.readString().toRawUTF8();
+                plugin.uiSignature = in.readString().toRawUTF8();
+            }
+        }
+
+        // the magic is repeated at the end, anything truncated or left over means the file is broken
+        char magic[sizeof(kLv2CacheMagic)];
+
+        return in.read(magic, sizeof(magic)) == sizeof(magic)
+            && std::memcmp(magic, kLv2CacheMagic, sizeof(magic)) == 0
+            && in.getNumBytesRemaining() == 0;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(Lv2PluginInfoCache)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+static const CarlaCachedPluginInfo* parse_cached_plugin_lv2(Lv2WorldClass& lv2World, Lilv::Plugin& lilvPlugin)
 {
     static CarlaCachedPluginInfo info;
 
@@ -601,6 +1038,32 @@ static const CarlaCachedPluginInfo* get_cached_plugin_lv2(Lv2WorldClass& lv2Worl
     return &info;
 }
 
+static const CarlaCachedPluginInfo* get_cached_plugin_lv2(Lv2WorldClass& lv2World, Lilv::Plugin& lilvPlugin)
+{
+    // bundle and URI are known from manifests, everything else requires loading the full plugin data
+    char* const bundle = lilv_file_uri_parse(lilvPlugin.get_bundle_uri().as_uri(), nullptr);
+
+    if (bundle == nullptr)
+        return parse_cached_plugin_lv2(lv2World, lilvPlugin);
+
+    const CarlaString uri(lilvPlugin.get_uri().as_uri());
+    Lv2PluginInfoCache& cache(Lv2PluginInfoCache::getInstance());
+
+    // computed before parsing, as that loads more data than what the cache was checked against next time
+    const std::string uiSignature(getLv2PluginUiSignature(lv2World, lilvPlugin, bundle));
+
+    const CarlaCachedPluginInfo* info = cache.get(bundle, uri, uiSignature);
+
+    if (info == nullptr)
+    {
+        info = parse_cached_plugin_lv2(lv2World, lilvPlugin);
+        cache.add(bundle, uri, uiSignature, *info);
+    }
+
+    lilv_free(bundle);
+    return info;
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -792,6 +1255,7 @@ uint carla_get_cached_plugin_count(CB::PluginType ptype, const char* pluginPath)
 
     case CB::PLUGIN_LV2: {
         Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+        const CarlaMutexLocker cml(lv2World.mutex);
         lv2World.initIfNeeded(pluginPath);
         return lv2World.getPluginCount();
     }
@@ -837,6 +1301,7 @@ const CarlaCachedPluginInfo* carla_get_cached_plugin_info(CB::PluginType ptype,
 
     case CB::PLUGIN_LV2: {
         Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+        const CarlaMutexLocker cml(lv2World.mutex);
 
         const LilvPlugin* const cPlugin(lv2World.getPluginFromIndex(index));
         CARLA_SAFE_ASSERT_BREAK(cPlugin != nullptr);
@@ -844,7 +1309,13 @@ const CarlaCachedPluginInfo* carla_get_cached_plugin_info(CB::PluginType ptype,
         Lilv::Plugin lilvPlugin(cPlugin);
         CARLA_SAFE_ASSERT_BREAK(lilvPlugin.get_uri().is_uri());
 
-        return get_cached_plugin_lv2(lv2World, lilvPlugin);
+        const CarlaCachedPluginInfo* const info = get_cached_plugin_lv2(lv2World, lilvPlugin);
+
+        // write cache as soon as the last plugin was listed
+        if (index + 1 == lv2World.getPluginCount())
+            Lv2PluginInfoCache::getInstance().save();
+
+        return info;
     }
 
    #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -19,16 +19,22 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBinaryUtils.hpp"
+#include "CarlaCacheUtils.hpp"
 #include "CarlaJuceUtils.hpp"
+#include "CarlaMappedFileUtils.hpp"
 #include "CarlaPipeUtils.hpp"
 #include "CarlaSha1Utils.hpp"
 #include "CarlaTimeUtils.hpp"
 
 #include "water/files/File.h"
 #include "water/files/FileInputStream.h"
+#include "water/streams/MemoryOutputStream.h"
 #include "water/threads/ChildProcess.h"
 #include "water/text/StringArray.h"
 
+#include <map>
+#include <string>
+
 namespace CB = CARLA_BACKEND_NAMESPACE;
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -87,6 +93,11 @@ struct CarlaPluginDiscoveryOptions {
     } wine;
    #endif
 
+    struct {
+        bool disabled;
+        CarlaString folder; // empty means default
+    } cache;
+
     static CarlaPluginDiscoveryOptions& getInstance() noexcept
     {
         static CarlaPluginDiscoveryOptions instance;
@@ -95,99 +106,966 @@ struct CarlaPluginDiscoveryOptions {
 };
 
 // --------------------------------------------------------------------------------------------------------------------
+// Discovery cache file format
+// A header followed by the binaries sorted by path, the plugins of all binaries and a table of null-terminated strings.
+// Everything is in native byte order, files from other machines are rejected by the version check.
+
+static const char     kDiscoveryCacheMagic[8] = { 'C', 'A', 'R', 'L', 'A', 'D', 'B', '\0' };
+static const uint32_t kDiscoveryCacheVersion  = 1;
+
+struct DiscoveryCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numBinaries;
+    uint32_t numPlugins;
+    uint32_t stringsSize;
+};
+
+struct DiscoveryCacheBinary {
+    int64_t mtime;
+    int64_t size;
+    uint32_t filename;    // offset into strings
+    uint32_t firstPlugin;
+    uint32_t numPlugins;
+    uint32_t reserved;
+};
+
+struct DiscoveryCachePlugin {
+    uint64_t uniqueId;
+    uint32_t label;       // offset into strings
+    uint32_t name;        // offset into strings
+    uint32_t maker;       // offset into strings
+    uint32_t btype;
+    uint32_t category;
+    uint32_t hints;
+    uint32_t audioIns;
+    uint32_t audioOuts;
+    uint32_t cvIns;
+    uint32_t cvOuts;
+    uint32_t midiIns;
+    uint32_t midiOuts;
+    uint32_t parameterIns;
+    uint32_t parameterOuts;
+};
+
+static water::File getDiscoveryCacheFolder()
+{
+    const CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
+
+    if (options.cache.folder.isNotEmpty())
+        return water::File(options.cache.folder.buffer());
+
+    return carla_getDefaultCacheFolder();
+}
+
+// Check if @a filename is inside @a folder, which must end with a separator
+static bool isFileInFolder(const char* const filename, const std::string& folder) noexcept
+{
+    return std::strncmp(filename, folder.c_str(), folder.size()) == 0;
+}
+
+static std::vector<std::string> getFoldersFromPluginPath(const char* const pluginPath)
+{
+    std::vector<std::string> folders;
+
+    if (pluginPath == nullptr || pluginPath[0] == '\0')
+        return folders;
+
+    using water::String;
+    using water::StringArray;
+
+    const StringArray splitPaths(StringArray::fromTokens(pluginPath, CARLA_OS_SPLIT_STR, ""));
+
+    for (String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
+    {
+        if (it->isEmpty())
+            continue;
+
+        String folder(water::File(*it).getFullPathName());
+
+        if (! folder.endsWithChar(CARLA_OS_SEP))
+            folder += CARLA_OS_SEP_STR;
+
+        folders.push_back(folder.toRawUTF8());
+    }
+
+    return folders;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// CarlaPluginDiscoveryCache
+
+/*
+ * On-disk database of discovered plugins, one file per plugin and binary type.
+ * Binaries are identified by filename, modification time and size, a binary without plugins is stored too.
+ * The file is memory-mapped when loaded and only rewritten on save if something changed.
+ */
+class CarlaPluginDiscoveryCache
+{
+public:
+    CarlaPluginDiscoveryCache(const BinaryType btype, const PluginType ptype)
+        : fFile(getDiscoveryCacheFolder().getChildFile(water::String(getPluginTypeAsString(ptype)).toLowerCase()
+                                                       + "-" + CB::getBinaryTypeAsString(btype) + ".db")),
+          fMappedFile(),
+          fBinaries(nullptr),
+          fPlugins(nullptr),
+          fStrings(nullptr),
+          fNumBinaries(0),
+          fNumPlugins(0),
+          fStringsSize(0),
+          fBinaryStates(),
+          fPendingBinaries(),
+          fChanged(false)
+    {
+        load();
+    }
+
+    /*
+     * Report the cached plugins of a binary through @a callback.
+     * If @a sha1sum is null binaries without plugins are not reported, same as during discovery.
+     * Returns false if there is no valid entry for this binary, in which case it needs to be scanned.
+     */
+    bool reportBinary(const char* const filename, const int64_t mtime, const int64_t size,
+                      const PluginType ptype, const char* const sha1sum,
+                      const CarlaPluginDiscoveryCallback callback, void* const callbackPtr)
+    {
+        const int index = findBinary(filename);
+
+        if (index < 0)
+            return false;
+
+        const DiscoveryCacheBinary& binary(fBinaries[index]);
+
+        if (binary.mtime != mtime || binary.size != size)
+            return false;
+
+        fBinaryStates[index] = kBinarySeen;
+
+        if (binary.numPlugins == 0)
+        {
+            if (sha1sum != nullptr)
+                callback(callbackPtr, nullptr, sha1sum);
+            return true;
+        }
+
+        CarlaPluginDiscoveryInfo info;
+        info.ptype = ptype;
+        info.filename = filename;
+
+        for (uint32_t i = binary.firstPlugin, end = binary.firstPlugin + binary.numPlugins; i < end; ++i)
+        {
+            const DiscoveryCachePlugin& plugin(fPlugins[i]);
+
+            info.btype = static_cast<BinaryType>(plugin.btype);
+            info.label = fStrings + plugin.label;
+            info.uniqueId = plugin.uniqueId;
+            info.metadata.name = fStrings + plugin.name;
+            info.metadata.maker = fStrings + plugin.maker;
+            info.metadata.category = static_cast<PluginCategory>(plugin.category);
+            info.metadata.hints = plugin.hints;
+            info.io.audioIns = plugin.audioIns;
+            info.io.audioOuts = plugin.audioOuts;
+            info.io.cvIns = plugin.cvIns;
+            info.io.cvOuts = plugin.cvOuts;
+            info.io.midiIns = plugin.midiIns;
+            info.io.midiOuts = plugin.midiOuts;
+            info.io.parameterIns = plugin.parameterIns;
+            info.io.parameterOuts = plugin.parameterOuts;
+
+            callback(callbackPtr, &info, sha1sum);
+        }
+
+        return true;
+    }
+
+    /*
+     * Keep the entry of a binary that was skipped for other reasons, such as the caller having it cached.
+     */
+    void keepBinary(const char* const filename)
+    {
+        const int index = findBinary(filename);
+
+        if (index >= 0 && fBinaryStates[index] == kBinaryUnseen)
+            fBinaryStates[index] = kBinarySeen;
+    }
+
+    /*
+     * Start a new entry for a binary about to be scanned, replacing any previous one once finished.
+     */
+    void beginBinary(const char* const filename, const int64_t mtime, const int64_t size)
+    {
+        PendingBinary& pending(fPendingBinaries[filename]);
+        pending.mtime = mtime;
+        pending.size = size;
+        pending.finished = false;
+        pending.plugins.clear();
+    }
+
+    void addPlugin(const char* const filename, const CarlaPluginDiscoveryInfo& info)
+    {
+        const std::map<std::string, PendingBinary>::iterator it = fPendingBinaries.find(filename);
+        CARLA_SAFE_ASSERT_RETURN(it != fPendingBinaries.end(),);
+
+        PendingPlugin plugin;
+        plugin.uniqueId = info.uniqueId;
+        plugin.label = info.label;
+        plugin.name = info.metadata.name;
+        plugin.maker = info.metadata.maker;
+        plugin.btype = static_cast<uint32_t>(info.btype);
+        plugin.category = static_cast<uint32_t>(info.metadata.category);
+        plugin.hints = info.metadata.hints;
+        plugin.io[0] = info.io.audioIns;
+        plugin.io[1] = info.io.audioOuts;
+        plugin.io[2] = info.io.cvIns;
+        plugin.io[3] = info.io.cvOuts;
+        plugin.io[4] = info.io.midiIns;
+        plugin.io[5] = info.io.midiOuts;
+        plugin.io[6] = info.io.parameterIns;
+        plugin.io[7] = info.io.parameterOuts;
+        it->second.plugins.push_back(plugin);
+    }
+
+    /*
+     * Mark the entry of a scanned binary as complete.
+     * Binaries that never finish, for example because discovery was stopped, are not stored.
+     */
+    void finishBinary(const char* const filename)
+    {
+        const std::map<std::string, PendingBinary>::iterator it = fPendingBinaries.find(filename);
+        CARLA_SAFE_ASSERT_RETURN(it != fPendingBinaries.end(),);
+
+        it->second.finished = true;
+        fChanged = true;
+
+        const int index = findBinary(filename);
+
+        if (index >= 0)
+            fBinaryStates[index] = kBinaryReplaced;
+    }
+
+    /*
+     * Drop the entry of a binary whose scan did not finish, such as after a crash or timeout.
+     * Any previous entry is outdated too, so the binary gets scanned again next time.
+     */
+    void discardBinary(const char* const filename)
+    {
+        fPendingBinaries.erase(filename);
+
+        const int index = findBinary(filename);
+
+        if (index >= 0)
+        {
+            fBinaryStates[index] = kBinaryRemoved;
+            fChanged = true;
+        }
+    }
+
+    /*
+     * Remove entries inside @a folder that were not part of this discovery, as their binaries are gone.
+     * Only to be used once all binaries in that folder have been handled.
+     */
+    void removeUnseenBinaries(const std::string& folder)
+    {
+        for (uint32_t i=0; i<fNumBinaries; ++i)
+        {
+            if (fBinaryStates[i] != kBinaryUnseen || ! isFileInFolder(fStrings + fBinaries[i].filename, folder))
+                continue;
+
+            fBinaryStates[i] = kBinaryRemoved;
+            fChanged = true;
+        }
+    }
+
+    /*
+     * Remove all entries inside @a folder, or all of them if @a folder is empty.
+     * If @a onlyInvalid is true, only entries of binaries without plugins are removed.
+     */
+    void removeBinaries(const std::string& folder, const bool onlyInvalid)
+    {
+        for (uint32_t i=0; i<fNumBinaries; ++i)
+        {
+            if (onlyInvalid && fBinaries[i].numPlugins != 0)
+                continue;
+            if (! folder.empty() && ! isFileInFolder(fStrings + fBinaries[i].filename, folder))
+                continue;
+
+            fBinaryStates[i] = kBinaryRemoved;
+            fChanged = true;
+        }
+
+        for (std::map<std::string, PendingBinary>::iterator it = fPendingBinaries.begin(); it != fPendingBinaries.end();)
+        {
+            if (onlyInvalid && ! it->second.plugins.empty())
+                ++it;
+            else if (folder.empty() || isFileInFolder(it->first.c_str(), folder))
+                fPendingBinaries.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+    /*
+     * Write all changes to disk.
+     */
+    bool save()
+    {
+        if (! fChanged)
+            return true;
+
+        std::map<std::string, PendingBinary> binaries;
+
+        // cached entries that are still valid
+        for (uint32_t i=0; i<fNumBinaries; ++i)
+        {
+            if (fBinaryStates[i] == kBinaryRemoved || fBinaryStates[i] == kBinaryReplaced)
+                continue;
+
+            const DiscoveryCacheBinary& binary(fBinaries[i]);
+
+            PendingBinary& entry(binaries[fStrings + binary.filename]);
+            entry.mtime = binary.mtime;
+            entry.size = binary.size;
+            entry.finished = true;
+
+            for (uint32_t j = binary.firstPlugin, end = binary.firstPlugin + binary.numPlugins; j < end; ++j)
+            {
+                const DiscoveryCachePlugin& plugin(fPlugins[j]);
+
+                PendingPlugin pending;
+                pending.uniqueId = plugin.uniqueId;
+                pending.label = fStrings + plugin.label;
+                pending.name = fStrings + plugin.name;
+                pending.maker = fStrings + plugin.maker;
+                pending.btype = plugin.btype;
+                pending.category = plugin.category;
+                pending.hints = plugin.hints;
+                std::memcpy(pending.io, &plugin.audioIns, sizeof(pending.io));
+                entry.plugins.push_back(pending);
+            }
+        }
+
+        // newly scanned entries
+        for (std::map<std::string, PendingBinary>::const_iterator it = fPendingBinaries.begin();
+             it != fPendingBinaries.end(); ++it)
+        {
+            if (it->second.finished)
+                binaries[it->first] = it->second;
+        }
+
+        std::vector<DiscoveryCacheBinary> outBinaries;
+        std::vector<DiscoveryCachePlugin> outPlugins;
+        std::string outStrings;
+        std::map<std::string, uint32_t> stringOffsets;
+
+        outBinaries.reserve(binaries.size());
+
+        for (std::map<std::string, PendingBinary>::const_iterator it = binaries.begin(); it != binaries.end(); ++it)
+        {
+            DiscoveryCacheBinary binary;
+            carla_zeroStruct(binary);
+            binary.mtime = it->second.mtime;
+            binary.size = it->second.size;
+            binary.filename = addString(outStrings, stringOffsets, it->first);
+            binary.firstPlugin = static_cast<uint32_t>(outPlugins.size());
+            binary.numPlugins = static_cast<uint32_t>(it->second.plugins.size());
+            outBinaries.push_back(binary);
+
+            for (std::vector<PendingPlugin>::const_iterator cit = it->second.plugins.begin();
+                 cit != it->second.plugins.end(); ++cit)
+            {
+                DiscoveryCachePlugin plugin;
+                plugin.uniqueId = cit->uniqueId;
+                plugin.label = addString(outStrings, stringOffsets, cit->label);
+                plugin.name = addString(outStrings, stringOffsets, cit->name);
+                plugin.maker = addString(outStrings, stringOffsets, cit->maker);
+                plugin.btype = cit->btype;
+                plugin.category = cit->category;
+                plugin.hints = cit->hints;
+                std::memcpy(&plugin.audioIns, cit->io, sizeof(cit->io));
+                outPlugins.push_back(plugin);
+            }
+        }
+
+        DiscoveryCacheHeader header;
+        std::memcpy(header.magic, kDiscoveryCacheMagic, sizeof(header.magic));
+        header.version = kDiscoveryCacheVersion;
+        header.numBinaries = static_cast<uint32_t>(outBinaries.size());
+        header.numPlugins = static_cast<uint32_t>(outPlugins.size());
+        header.stringsSize = static_cast<uint32_t>(outStrings.size());
+
+        water::MemoryOutputStream out;
+        out.write(&header, sizeof(header));
+
+        if (! outBinaries.empty())
+            out.write(outBinaries.data(), outBinaries.size() * sizeof(DiscoveryCacheBinary));
+        if (! outPlugins.empty())
+            out.write(outPlugins.data(), outPlugins.size() * sizeof(DiscoveryCachePlugin));
+        if (! outStrings.empty())
+            out.write(outStrings.data(), outStrings.size());
+
+        // the file might be replaced next, which is not possible while mapped on some systems
+        unload();
+        fChanged = false;
+
+        const water::File folder(fFile.getParentDirectory());
+
+        if (! folder.createDirectory().wasOk())
+        {
+            carla_stderr2("Failed to create plugin discovery cache folder '%s'", folder.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        if (! fFile.replaceWithData(out.getData(), out.getDataSize()))
+        {
+            carla_stderr2("Failed to write plugin discovery cache '%s'", fFile.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    enum BinaryState {
+        kBinaryUnseen,
+        kBinarySeen,
+        kBinaryReplaced,
+        kBinaryRemoved
+    };
+
+    struct PendingPlugin {
+        uint64_t uniqueId;
+        std::string label;
+        std::string name;
+        std::string maker;
+        uint32_t btype;
+        uint32_t category;
+        uint32_t hints;
+        uint32_t io[8];
+    };
+
+    struct PendingBinary {
+        int64_t mtime;
+        int64_t size;
+        bool finished;
+        std::vector<PendingPlugin> plugins;
+    };
+
+    const water::File fFile;
+    CarlaMappedFile fMappedFile;
+
+    // pointers into the mapped file
+    const DiscoveryCacheBinary* fBinaries;
+    const DiscoveryCachePlugin* fPlugins;
+    const char* fStrings;
+    uint32_t fNumBinaries;
+    uint32_t fNumPlugins;
+    uint32_t fStringsSize;
+
+    std::vector<uint8_t> fBinaryStates;
+    std::map<std::string, PendingBinary> fPendingBinaries;
+    bool fChanged;
+
+    void load()
+    {
+        if (! fFile.existsAsFile())
+            return;
+
+        const water::String filename(fFile.getFullPathName());
+
+        if (! fMappedFile.open(filename.toRawUTF8()))
+            return;
+
+        const uint8_t* const data = static_cast<const uint8_t*>(fMappedFile.getData());
+        const std::size_t size = fMappedFile.getSize();
+
+        if (size < sizeof(DiscoveryCacheHeader))
+            return invalidate(filename);
+
+        const DiscoveryCacheHeader& header(*reinterpret_cast<const DiscoveryCacheHeader*>(data));
+
+        if (std::memcmp(header.magic, kDiscoveryCacheMagic, sizeof(header.magic)) != 0
+            || header.version != kDiscoveryCacheVersion)
+            return invalidate(filename);
+
+        const uint64_t binariesSize = static_cast<uint64_t>(header.numBinaries) * sizeof(DiscoveryCacheBinary);
+        const uint64_t pluginsSize = static_cast<uint64_t>(header.numPlugins) * sizeof(DiscoveryCachePlugin);
+
+        if (sizeof(header) + binariesSize + pluginsSize + header.stringsSize != size)
+            return invalidate(filename);
+
+        fBinaries = reinterpret_cast<const DiscoveryCacheBinary*>(data + sizeof(header));
+        fPlugins = reinterpret_cast<const DiscoveryCachePlugin*>(data + sizeof(header) + binariesSize);
+        fStrings = reinterpret_cast<const char*>(data + sizeof(header) + binariesSize + pluginsSize);
+        fNumBinaries = header.numBinaries;
+        fNumPlugins = header.numPlugins;
+        fStringsSize = header.stringsSize;
+
+        // make sure all offsets point to valid places, so the rest of the code can trust them
+        if (fStringsSize != 0 && fStrings[fStringsSize - 1] != '\0')
+            return invalidate(filename);
+
+        for (uint32_t i=0; i<fNumBinaries; ++i)
+        {
+            const DiscoveryCacheBinary& binary(fBinaries[i]);
+
+            if (binary.filename >= fStringsSize
+                || binary.firstPlugin > fNumPlugins
+                || binary.numPlugins > fNumPlugins - binary.firstPlugin)
+                return invalidate(filename);
+
+            if (i != 0 && std::strcmp(fStrings + fBinaries[i - 1].filename, fStrings + binary.filename) >= 0)
+                return invalidate(filename);
+        }
+
+        for (uint32_t i=0; i<fNumPlugins; ++i)
+        {
+            const DiscoveryCachePlugin& plugin(fPlugins[i]);
+
+            if (plugin.label >= fStringsSize || plugin.name >= fStringsSize || plugin.maker >= fStringsSize)
+                return invalidate(filename);
+        }
+
+        fBinaryStates.resize(fNumBinaries, kBinaryUnseen);
+    }
+
+    void unload() noexcept
+    {
+        fMappedFile.close();
+        fBinaries = nullptr;
+        fPlugins = nullptr;
+        fStrings = nullptr;
+        fNumBinaries = fNumPlugins = fStringsSize = 0;
+        fBinaryStates.clear();
+    }
+
+    void invalidate(const water::String& filename)
+    {
+        carla_stderr2("Plugin discovery cache '%s' is invalid, ignoring it", filename.toRawUTF8());
+        unload();
+        fChanged = true;
+    }
+
+    int findBinary(const char* const filename) const noexcept
+    {
+        uint32_t low = 0, high = fNumBinaries;
+
+        while (low < high)
+        {
+            const uint32_t mid = low + (high - low) / 2;
+            const int cmp = std::strcmp(fStrings + fBinaries[mid].filename, filename);
+
+            if (cmp == 0)
+                return static_cast<int>(mid);
+
+            if (cmp < 0)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        return -1;
+    }
+
+    static uint32_t addString(std::string& strings, std::map<std::string, uint32_t>& offsets, const std::string& str)
+    {
+        const std::map<std::string, uint32_t>::const_iterator it = offsets.find(str);
+
+        if (it != offsets.end())
+            return it->second;
+
+        const uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(str.c_str(), str.size() + 1);
+        offsets[str] = offset;
+        return offset;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginDiscoveryCache)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// Time without messages from a discovery process before its current binary is skipped, in ms
+static const uint32_t kDiscoveryTimeout = 30000;
+
+// Number of discovery processes to run at once, one per CPU unless set with CARLA_DISCOVERY_JOBS
+static uint getDiscoveryJobCount() noexcept
+{
+    if (const char* const envJobs = std::getenv("CARLA_DISCOVERY_JOBS"))
+    {
+        const int jobs = std::atoi(envJobs);
+
+        if (jobs > 0)
+            return static_cast<uint>(jobs);
+    }
+
+   #ifdef CARLA_OS_WIN
+    SYSTEM_INFO systemInfo;
+    ::GetSystemInfo(&systemInfo);
+    const long cpus = static_cast<long>(systemInfo.dwNumberOfProcessors);
+   #else
+    const long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+   #endif
+
+    return cpus > 0 ? static_cast<uint>(cpus) : 1U;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * Runs discovery on a list of binaries, spread over several discovery processes.
+ * Native binaries are sent to discovery processes running in server mode, which scan many binaries without a new
+ * process for each one. Binaries that need wine still get a process of their own, as their prefix may differ.
+ * A process that crashes or stops replying only takes its current binary with it, a new one is started for the next.
+ * All callbacks are triggered from idle().
+ */
+class CarlaPluginDiscovery
+{
+public:
+    CarlaPluginDiscovery(const char* const discoveryTool,
+                         const BinaryType btype,
+                         const PluginType ptype,
+                         const char* const pluginPath,
+                         const std::vector<water::File>&& binaries,
+                         const CarlaPluginDiscoveryCallback discoveryCb,
+                         const CarlaPluginCheckCacheCallback checkCacheCb,
+                         void* const callbackPtr)
+        : fBinaryType(btype),
+          fPluginType(ptype),
+          fDiscoveryCallback(discoveryCb),
+          fCheckCacheCallback(checkCacheCb),
+          fCallbackPtr(callbackPtr),
+          fNextBinaryIndex(0),
+          fBinaryCount(static_cast<uint>(binaries.size())),
+          fBinaries(binaries),
+          fDiscoveryTool(discoveryTool),
+          fWorkers(),
+          fCache(CarlaPluginDiscoveryOptions::getInstance().cache.disabled
+                 ? nullptr : new CarlaPluginDiscoveryCache(btype, ptype)),
+          fCacheFolders(getFoldersFromPluginPath(pluginPath)),
+          fCacheCompleted(false)
+    {
+        const uint numWorkers = std::max(1U, std::min(getDiscoveryJobCount(), fBinaryCount));
+
+        for (uint i=0; i<numWorkers; ++i)
+        {
+            if (! startNextBinary(addWorker()))
+                break;
+        }
+    }
+
+    CarlaPluginDiscovery(const char* const discoveryTool,
+                         const BinaryType btype,
+                         const PluginType ptype,
+                         const CarlaPluginDiscoveryCallback discoveryCb,
+                         const CarlaPluginCheckCacheCallback checkCacheCb,
+                         void* const callbackPtr)
+        : fBinaryType(btype),
+          fPluginType(ptype),
+          fDiscoveryCallback(discoveryCb),
+          fCheckCacheCallback(checkCacheCb),
+          fCallbackPtr(callbackPtr),
+          fNextBinaryIndex(0),
+          fBinaryCount(0),
+          fDiscoveryTool(discoveryTool),
+          fWorkers(),
+          fCache(),
+          fCacheFolders(),
+          fCacheCompleted(false)
+    {
+        startAll(addWorker());
+    }
+
+    ~CarlaPluginDiscovery();
+
+    bool idle();
+    void skip();
+
+private:
+    class Worker;
+
+    const BinaryType fBinaryType;
+    const PluginType fPluginType;
+    const CarlaPluginDiscoveryCallback fDiscoveryCallback;
+    const CarlaPluginCheckCacheCallback fCheckCacheCallback;
+    void* const fCallbackPtr;
+
+    uint fNextBinaryIndex;
+    const uint fBinaryCount;
+    const std::vector<water::File> fBinaries;
+    const CarlaString fDiscoveryTool;
+
+    std::vector<Worker*> fWorkers;
+
+    // results of binaries scanned before, null if disabled or not used for this plugin type
+    CarlaScopedPointer<CarlaPluginDiscoveryCache> fCache;
+    const std::vector<std::string> fCacheFolders;
+    bool fCacheCompleted;
+
+    Worker* addWorker();
+    void startAll(Worker* worker);
+    bool startNextBinary(Worker* worker);
+    void binaryFinished(Worker* worker);
+
+   #ifndef CARLA_OS_WIN
+    water::String getHelperTool() const
+    {
+        const CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
+
+        water::String helperTool;
+
+        switch (fBinaryType)
+        {
+        case CB::BINARY_WIN32:
+            if (options.wine.executable.isNotEmpty())
+                helperTool = options.wine.executable.buffer();
+            else
+                helperTool = "wine";
+            break;
+
+        case CB::BINARY_WIN64:
+            if (options.wine.executable.isNotEmpty())
+            {
+                helperTool = options.wine.executable.buffer();
+
+                if (helperTool[0] == CARLA_OS_SEP && water::File(helperTool + "64").existsAsFile())
+                    helperTool += "64";
+            }
+            else
+            {
+                helperTool = "wine";
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        return helperTool;
+    }
+   #endif
+
+    static CarlaString makeHash(const water::File& file, const water::String& filename)
+    {
+        CarlaSha1 sha1;
+
+        /* do we want this? it is not exactly needed and makes discovery slow..
+        if (file.existsAsFile() && file.getSize() < 20*1024*1024) // dont bother hashing > 20Mb files
+        {
+            water::FileInputStream stream(file);
+
+            if (stream.openedOk())
+            {
+                uint8_t block[8192];
+                for (int r; r = stream.read(block, sizeof(block)), r > 0;)
+                    sha1.write(block, r);
+            }
+        }
+        */
+
+        sha1.write(filename.toRawUTF8(), filename.length());
+
+        const int64_t mtime = file.getLastModificationTime();
+        sha1.write(&mtime, sizeof(mtime));
+
+        return CarlaString(sha1.resultAsString());
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginDiscovery)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// CarlaPluginDiscovery::Worker
 
-class CarlaPluginDiscovery : private CarlaPipeServer
+/*
+ * A single discovery process and the binary it is currently scanning.
+ */
+class CarlaPluginDiscovery::Worker : private CarlaPipeServer
 {
 public:
-    CarlaPluginDiscovery(const char* const discoveryTool,
-                         const BinaryType btype,
-                         const PluginType ptype,
-                         const std::vector<water::File>&& binaries,
-                         const CarlaPluginDiscoveryCallback discoveryCb,
-                         const CarlaPluginCheckCacheCallback checkCacheCb,
-                         void* const callbackPtr)
-        : fBinaryType(btype),
-          fPluginType(ptype),
-          fDiscoveryCallback(discoveryCb),
-          fCheckCacheCallback(checkCacheCb),
-          fCallbackPtr(callbackPtr),
+    Worker(CarlaPluginDiscovery* const discovery) noexcept
+        : kDiscovery(discovery),
+          fScanning(false),
+          fServerMode(false),
+          fRetryAsX64(false),
           fPluginsFoundInBinary(false),
-          fBinaryIndex(0),
-          fBinaryCount(static_cast<uint>(binaries.size())),
-          fBinaries(binaries),
-          fDiscoveryTool(discoveryTool),
+          fBinaryCompleted(false),
+          fBinaryIndex(kNoBinary),
+          fStartTime(0),
           fLastMessageTime(0),
+          fNextSha1Sum(),
           fNextLabel(nullptr),
           fNextMaker(nullptr),
-          fNextName(nullptr)
+          fNextName(nullptr) {}
+
+    ~Worker()
     {
-        start();
+        stopPipeServer(5000);
+        std::free(fNextLabel);
+        std::free(fNextMaker);
+        std::free(fNextName);
     }
 
-    CarlaPluginDiscovery(const char* const discoveryTool,
-                         const BinaryType btype,
-                         const PluginType ptype,
-                         const CarlaPluginDiscoveryCallback discoveryCb,
-                         const CarlaPluginCheckCacheCallback checkCacheCb,
-                         void* const callbackPtr)
-        : fBinaryType(btype),
-          fPluginType(ptype),
-          fDiscoveryCallback(discoveryCb),
-          fCheckCacheCallback(checkCacheCb),
-          fCallbackPtr(callbackPtr),
-          fPluginsFoundInBinary(false),
-          fBinaryIndex(0),
-          fBinaryCount(1),
-          fDiscoveryTool(discoveryTool),
-          fLastMessageTime(0),
-          fNextLabel(nullptr),
-          fNextMaker(nullptr),
-          fNextName(nullptr)
+    bool hasBinary() const noexcept
     {
-        start();
+        return fBinaryIndex != kNoBinary;
     }
 
-    ~CarlaPluginDiscovery()
+    bool hasFoundPlugins() const noexcept
     {
-        stopPipeServer(5000);
-        std::free(fNextLabel);
-        std::free(fNextMaker);
-        std::free(fNextName);
+        return fPluginsFoundInBinary;
     }
 
-    bool idle()
+    // whether the discovery process got to the end of the current binary, instead of crashing or being skipped
+    bool hasCompletedBinary() const noexcept
     {
-        if (isPipeRunning())
-        {
-            idlePipe();
+        return fBinaryCompleted;
+    }
+
+    bool isScanning() const noexcept
+    {
+        return fScanning;
+    }
+
+    uint32_t getStartTime() const noexcept
+    {
+        return fStartTime;
+    }
 
-            // automatically skip a plugin if 30s passes without a reply
-            const uint32_t timeNow = carla_gettime_ms();
+    const char* getSha1Sum() const noexcept
+    {
+        return fNextSha1Sum;
+    }
 
-            if (timeNow - fLastMessageTime < 30000)
-                return true;
+    uint takeBinaryIndex() noexcept
+    {
+        const uint index = fBinaryIndex;
+        fBinaryIndex = kNoBinary;
+        return index;
+    }
+
+    /*
+     * Scan all plugins of the current type in a single process, used for types without binaries.
+     */
+    void startAll()
+    {
+        prepare();
+
+        // LV2 plugin info is cached by the discovery process itself
+        const CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
+        const CarlaScopedEnvVar sev(kCacheFolderEnvVar,
+                                    options.cache.disabled ? "" : getDiscoveryCacheFolder().getFullPathName().toRawUTF8());
+
+       #ifndef CARLA_OS_WIN
+        const water::String helperTool(kDiscovery->getHelperTool());
 
-            carla_stdout("Plugin took too long to respond, skipping...");
+        if (helperTool.isNotEmpty())
+            startPipeServer(helperTool.toRawUTF8(), kDiscovery->fDiscoveryTool,
+                            getPluginTypeAsString(kDiscovery->fPluginType), ":all");
+        else
+       #endif
+            startPipeServer(kDiscovery->fDiscoveryTool, getPluginTypeAsString(kDiscovery->fPluginType), ":all");
+    }
+
+    /*
+     * Start scanning the binary at @a index.
+     */
+    void start(const uint index, const water::String& filename, const CarlaString& sha1sum)
+    {
+        prepare();
+
+        fBinaryIndex = index;
+        fNextSha1Sum = sha1sum;
+
+        carla_stdout("Scanning \"%s\"...", filename.toRawUTF8());
+
+       #ifndef CARLA_OS_WIN
+        const water::String helperTool(kDiscovery->getHelperTool());
+
+        if (helperTool.isNotEmpty())
+        {
+            startSingle(helperTool, filename);
+            return;
+        }
+       #endif
+
+        if (fServerMode && ! (isPipeRunning() && isClientRunning()))
+        {
             stopPipeServer(1000);
+            fServerMode = false;
         }
 
-        // report binary as having no plugins
-        if (fCheckCacheCallback != nullptr && !fPluginsFoundInBinary && !fBinaries.empty())
+        if (! fServerMode)
         {
-            const water::File file(fBinaries[fBinaryIndex]);
-            const water::String filename(file.getFullPathName());
+            stopPipeServer(1000);
 
-            makeHash(file, filename);
+            if (! startPipeServer(kDiscovery->fDiscoveryTool,
+                                  getPluginTypeAsString(kDiscovery->fPluginType), ":server"))
+                return;
 
-            if (! fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), fNextSha1Sum))
-                fDiscoveryCallback(fCallbackPtr, nullptr, fNextSha1Sum);
+            fServerMode = true;
         }
 
-        if (++fBinaryIndex == fBinaryCount)
+        const CarlaMutexLocker cml(getPipeLock());
+
+        if (writeMessage("discover\n", 9) && writeAndFixMessage(filename.toRawUTF8()))
+            syncMessages();
+    }
+
+    /*
+     * Handle messages from the discovery process.
+     * Returns false once the current binary is done.
+     */
+    bool idle()
+    {
+        if (! fScanning)
             return false;
 
-        start();
-        return true;
+        if (isPipeRunning())
+        {
+            idlePipe();
+
+            // got the "done" message from the discovery server
+            if (! fScanning)
+            {
+                if (fRetryAsX64)
+                {
+                    fRetryAsX64 = false;
+                    fBinaryCompleted = false;
+                    fScanning = true;
+                    startSingle(water::String(), kDiscovery->fBinaries[fBinaryIndex].getFullPathName());
+                    return true;
+                }
+
+                return false;
+            }
+
+            if (! isPipeRunning())
+            {
+                // single binary process has finished
+            }
+            else if (! isClientRunning())
+            {
+                // read anything written right before the process went away
+                idlePipe();
+                carla_stdout("Discovery process stopped unexpectedly, skipping...");
+
+                // nothing can be written to a dead process, close the pipes before reaping it
+                closePipeServer();
+                stopPipeServer(1000);
+            }
+            else if (carla_gettime_ms() - fLastMessageTime < kDiscoveryTimeout)
+            {
+                return true;
+            }
+            else
+            {
+                carla_stdout("Plugin took too long to respond, skipping...");
+                stopPipeServer(1000);
+            }
+        }
+
+        fScanning = fServerMode = false;
+        return false;
     }
 
     void skip()
@@ -201,7 +1079,7 @@ protected:
     {
         fLastMessageTime = carla_gettime_ms();
 
-        if (std::strcmp(msg, "warning") == 0 || std::strcmp(msg, "error") == 0)
+        if (std::strcmp(msg, "warning") == 0 || std::strcmp(msg, "error") == 0 || std::strcmp(msg, "info") == 0)
         {
             const char* text = nullptr;
             readNextLineAsString(text, false);
@@ -231,11 +1109,11 @@ protected:
             if (fNextInfo.metadata.name == nullptr)
                 fNextInfo.metadata.name = gPluginsDiscoveryNullCharPtr;
 
-            if (fBinaries.empty())
+            if (kDiscovery->fBinaries.empty())
             {
                 char* filename = nullptr;
 
-                if (fPluginType == CB::PLUGIN_LV2)
+                if (kDiscovery->fPluginType == CB::PLUGIN_LV2)
                 {
                     do {
                         const char* const slash = std::strchr(fNextLabel, CARLA_OS_SEP);
@@ -247,20 +1125,24 @@ protected:
                     } while (false);
                 }
 
-                fNextInfo.ptype = fPluginType;
-                fDiscoveryCallback(fCallbackPtr, &fNextInfo, nullptr);
+                fNextInfo.ptype = kDiscovery->fPluginType;
+                kDiscovery->fDiscoveryCallback(kDiscovery->fCallbackPtr, &fNextInfo, nullptr);
 
                 std::free(filename);
             }
             else
             {
+                CARLA_SAFE_ASSERT_RETURN(fBinaryIndex != kNoBinary, true);
                 CARLA_SAFE_ASSERT(fNextSha1Sum.isNotEmpty());
-                const water::String filename(fBinaries[fBinaryIndex].getFullPathName());
+                const water::String filename(kDiscovery->fBinaries[fBinaryIndex].getFullPathName());
                 fNextInfo.filename = filename.toRawUTF8();
-                fNextInfo.ptype = fPluginType;
+                fNextInfo.ptype = kDiscovery->fPluginType;
                 fPluginsFoundInBinary = true;
                 carla_stdout("Found %s from %s", fNextInfo.metadata.name, fNextInfo.filename);
-                fDiscoveryCallback(fCallbackPtr, &fNextInfo, fNextSha1Sum);
+                kDiscovery->fDiscoveryCallback(kDiscovery->fCallbackPtr, &fNextInfo, fNextSha1Sum);
+
+                if (kDiscovery->fCache != nullptr)
+                    kDiscovery->fCache->addPlugin(fNextInfo.filename, fNextInfo);
             }
 
             std::free(fNextLabel);
@@ -369,8 +1251,22 @@ protected:
             return true;
         }
 
+        if (std::strcmp(msg, "done") == 0)
+        {
+            const char* result = nullptr;
+            readNextLineAsString(result, false);
+            fRetryAsX64 = result != nullptr && std::strcmp(result, "retry") == 0;
+            fBinaryCompleted = true;
+            fScanning = false;
+            return true;
+        }
+
         if (std::strcmp(msg, "exiting") == 0)
         {
+            // single binary processes only exit by themselves once done
+            if (! fServerMode)
+                fBinaryCompleted = true;
+
             stopPipeServer(1000);
             return true;
         }
@@ -380,18 +1276,18 @@ protected:
     }
 
 private:
-    const BinaryType fBinaryType;
-    const PluginType fPluginType;
-    const CarlaPluginDiscoveryCallback fDiscoveryCallback;
-    const CarlaPluginCheckCacheCallback fCheckCacheCallback;
-    void* const fCallbackPtr;
+    static const uint kNoBinary = static_cast<uint>(-1);
 
+    CarlaPluginDiscovery* const kDiscovery;
+
+    bool fScanning;
+    bool fServerMode;
+    bool fRetryAsX64;
     bool fPluginsFoundInBinary;
+    bool fBinaryCompleted;
     uint fBinaryIndex;
-    const uint fBinaryCount;
-    const std::vector<water::File> fBinaries;
-    const CarlaString fDiscoveryTool;
 
+    uint32_t fStartTime;
     uint32_t fLastMessageTime;
 
     CarlaPluginDiscoveryInfo fNextInfo;
@@ -400,135 +1296,207 @@ private:
     char* fNextMaker;
     char* fNextName;
 
-    void start()
+    void prepare() noexcept
+    {
+        fScanning = true;
+        fRetryAsX64 = false;
+        fPluginsFoundInBinary = false;
+        fBinaryCompleted = false;
+        fStartTime = fLastMessageTime = carla_gettime_ms();
+    }
+
+    // start a discovery process for a single binary, through @a helperTool if not empty
+    void startSingle(const water::String& helperTool, const water::String& filename)
     {
         using water::File;
         using water::String;
 
-        fLastMessageTime = carla_gettime_ms();
-        fPluginsFoundInBinary = false;
-        fNextSha1Sum.clear();
+        stopPipeServer(1000);
+        fServerMode = false;
 
        #ifndef CARLA_OS_WIN
         const CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
 
-        String helperTool;
+        String winePrefix;
 
-        switch (fBinaryType)
-        {
-        case CB::BINARY_WIN32:
-            if (options.wine.executable.isNotEmpty())
-                helperTool = options.wine.executable.buffer();
-            else
-                helperTool = "wine";
-            break;
+        if (options.wine.autoPrefix)
+            winePrefix = findWinePrefix(filename);
 
-        case CB::BINARY_WIN64:
-            if (options.wine.executable.isNotEmpty())
-            {
-                helperTool = options.wine.executable.buffer();
+        if (winePrefix.isEmpty())
+        {
+            const char* const envWinePrefix = std::getenv("WINEPREFIX");
 
-                if (helperTool[0] == CARLA_OS_SEP && File(helperTool + "64").existsAsFile())
-                    helperTool += "64";
-            }
+            if (envWinePrefix != nullptr && envWinePrefix[0] != '\0')
+                winePrefix = envWinePrefix;
+            else if (options.wine.fallbackPrefix != nullptr && options.wine.fallbackPrefix[0] != '\0')
+                winePrefix = options.wine.fallbackPrefix.buffer();
             else
-            {
-                helperTool = "wine";
-            }
-            break;
-
-        default:
-            break;
+                winePrefix = File::getSpecialLocation(File::userHomeDirectory).getFullPathName() + "/.wine";
         }
+
+        const CarlaScopedEnvVar sev1("WINEDEBUG", "-all");
+        const CarlaScopedEnvVar sev2("WINEPREFIX", winePrefix.toRawUTF8());
+
+        if (helperTool.isNotEmpty())
+            startPipeServer(helperTool.toRawUTF8(), kDiscovery->fDiscoveryTool,
+                            getPluginTypeAsString(kDiscovery->fPluginType), filename.toRawUTF8());
+        else
        #endif
+            startPipeServer(kDiscovery->fDiscoveryTool,
+                            getPluginTypeAsString(kDiscovery->fPluginType), filename.toRawUTF8());
+
+        // unused
+        (void)helperTool;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// CarlaPluginDiscovery
+
+CarlaPluginDiscovery::~CarlaPluginDiscovery()
+{
+    for (std::vector<Worker*>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+        delete *it;
+
+    if (fCache != nullptr)
+        fCache->save();
+}
+
+bool CarlaPluginDiscovery::idle()
+{
+    bool running = false;
+
+    for (std::vector<Worker*>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+    {
+        Worker* const worker = *it;
 
-        if (fBinaries.empty())
+        if (worker->idle())
         {
-           #ifndef CARLA_OS_WIN
-            if (helperTool.isNotEmpty())
-                startPipeServer(helperTool.toRawUTF8(), fDiscoveryTool, getPluginTypeAsString(fPluginType), ":all");
-            else
-           #endif
-                startPipeServer(fDiscoveryTool, getPluginTypeAsString(fPluginType), ":all");
+            running = true;
+            continue;
         }
-        else
-        {
-            const File file(fBinaries[fBinaryIndex]);
-            const String filename(file.getFullPathName());
 
-            if (fCheckCacheCallback != nullptr)
-            {
-                makeHash(file, filename);
+        if (worker->hasBinary())
+            binaryFinished(worker);
 
-                if (fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), fNextSha1Sum))
-                {
-                    fPluginsFoundInBinary = true;
-                    carla_debug("Skipping \"%s\", using cache", filename.toRawUTF8());
-                    return;
-                }
-            }
+        if (startNextBinary(worker))
+            running = true;
+    }
 
-           #ifndef CARLA_OS_WIN
-            String winePrefix;
+    // all binaries in the plugin path have been seen, anything else cached for it is gone
+    if (! running && fCache != nullptr && ! fCacheCompleted)
+    {
+        fCacheCompleted = true;
 
-            if (options.wine.autoPrefix)
-                winePrefix = findWinePrefix(filename);
+        for (std::vector<std::string>::const_iterator it = fCacheFolders.begin(); it != fCacheFolders.end(); ++it)
+            fCache->removeUnseenBinaries(*it);
+    }
 
-            if (winePrefix.isEmpty())
-            {
-                const char* const envWinePrefix = std::getenv("WINEPREFIX");
-
-                if (envWinePrefix != nullptr && envWinePrefix[0] != '\0')
-                    winePrefix = envWinePrefix;
-                else if (options.wine.fallbackPrefix != nullptr && options.wine.fallbackPrefix[0] != '\0')
-                    winePrefix = options.wine.fallbackPrefix.buffer();
-                else
-                    winePrefix = File::getSpecialLocation(File::userHomeDirectory).getFullPathName() + "/.wine";
-            }
+    return running;
+}
 
-            const CarlaScopedEnvVar sev1("WINEDEBUG", "-all");
-            const CarlaScopedEnvVar sev2("WINEPREFIX", winePrefix.toRawUTF8());
-           #endif
+void CarlaPluginDiscovery::skip()
+{
+    // skip the binary that has been running for longest, which is most likely the one stuck
+    Worker* oldestWorker = nullptr;
 
-            carla_stdout("Scanning \"%s\"...", filename.toRawUTF8());
+    for (std::vector<Worker*>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+    {
+        Worker* const worker = *it;
 
-           #ifndef CARLA_OS_WIN
-            if (helperTool.isNotEmpty())
-                startPipeServer(helperTool.toRawUTF8(), fDiscoveryTool, getPluginTypeAsString(fPluginType), filename.toRawUTF8());
-            else
-           #endif
-                startPipeServer(fDiscoveryTool, getPluginTypeAsString(fPluginType), filename.toRawUTF8());
-        }
+        if (! worker->isScanning())
+            continue;
+
+        if (oldestWorker == nullptr || worker->getStartTime() < oldestWorker->getStartTime())
+            oldestWorker = worker;
     }
 
-    void makeHash(const water::File& file, const water::String& filename)
+    if (oldestWorker != nullptr)
+        oldestWorker->skip();
+}
+
+CarlaPluginDiscovery::Worker* CarlaPluginDiscovery::addWorker()
+{
+    Worker* const worker = new Worker(this);
+    fWorkers.push_back(worker);
+    return worker;
+}
+
+void CarlaPluginDiscovery::startAll(Worker* const worker)
+{
+    worker->startAll();
+}
+
+bool CarlaPluginDiscovery::startNextBinary(Worker* const worker)
+{
+    while (fNextBinaryIndex < fBinaryCount)
     {
-        CarlaSha1 sha1;
+        const uint index = fNextBinaryIndex++;
+        const water::File& file(fBinaries[index]);
+        const water::String filename(file.getFullPathName());
 
-        /* do we want this? it is not exactly needed and makes discovery slow..
-        if (file.existsAsFile() && file.getSize() < 20*1024*1024) // dont bother hashing > 20Mb files
+        CarlaString sha1sum;
+
+        if (fCheckCacheCallback != nullptr)
         {
-            water::FileInputStream stream(file);
+            sha1sum = makeHash(file, filename);
 
-            if (stream.openedOk())
+            if (fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), sha1sum))
             {
-                uint8_t block[8192];
-                for (int r; r = stream.read(block, sizeof(block)), r > 0;)
-                    sha1.write(block, r);
+                carla_debug("Skipping \"%s\", using cache", filename.toRawUTF8());
+
+                if (fCache != nullptr)
+                    fCache->keepBinary(filename.toRawUTF8());
+                continue;
             }
         }
-        */
 
-        sha1.write(filename.toRawUTF8(), filename.length());
+        if (fCache != nullptr)
+        {
+            const int64_t mtime = file.getLastModificationTime();
+            const int64_t size = file.getSize();
 
-        const int64_t mtime = file.getLastModificationTime();
-        sha1.write(&mtime, sizeof(mtime));
+            if (fCache->reportBinary(filename.toRawUTF8(), mtime, size, fPluginType,
+                                     fCheckCacheCallback != nullptr ? sha1sum.buffer() : nullptr,
+                                     fDiscoveryCallback, fCallbackPtr))
+            {
+                carla_debug("Skipping \"%s\", using discovery cache", filename.toRawUTF8());
+                continue;
+            }
 
-        fNextSha1Sum = sha1.resultAsString();
+            fCache->beginBinary(filename.toRawUTF8(), mtime, size);
+        }
+
+        worker->start(index, filename, sha1sum);
+        return true;
     }
 
-    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginDiscovery)
-};
+    return false;
+}
+
+// report binary as having no plugins
+void CarlaPluginDiscovery::binaryFinished(Worker* const worker)
+{
+    const uint index = worker->takeBinaryIndex();
+    const water::String filename(fBinaries[index].getFullPathName());
+
+    // results of crashed, stuck or skipped binaries are not kept, they might be fine next time
+    if (fCache != nullptr)
+    {
+        if (worker->hasCompletedBinary())
+            fCache->finishBinary(filename.toRawUTF8());
+        else
+            fCache->discardBinary(filename.toRawUTF8());
+    }
+
+    if (fCheckCacheCallback == nullptr || worker->hasFoundPlugins())
+        return;
+
+    if (! fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), worker->getSha1Sum()))
+        fDiscoveryCallback(fCallbackPtr, nullptr, worker->getSha1Sum());
+}
 
 // --------------------------------------------------------------------------------------------------------------------
 
@@ -763,7 +1731,7 @@ CarlaPluginDiscoveryHandle carla_plugin_discovery_start(const char* const discov
             return nullptr;
     }
 
-    return new CarlaPluginDiscovery(discoveryTool, btype, ptype, std::move(files),
+    return new CarlaPluginDiscovery(discoveryTool, btype, ptype, pluginPath, std::move(files),
                                     discoveryCb, checkCacheCb, callbackPtr);
 }
 
@@ -782,6 +1750,59 @@ void carla_plugin_discovery_stop(const CarlaPluginDiscoveryHandle handle)
     delete static_cast<CarlaPluginDiscovery*>(handle);
 }
 
+void carla_plugin_discovery_set_cache_folder(const char* const folder)
+{
+    CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
+
+    if (folder == nullptr)
+    {
+        options.cache.disabled = true;
+        options.cache.folder.clear();
+        return;
+    }
+
+    options.cache.disabled = false;
+
+    if (folder[0] != '\0')
+        options.cache.folder = folder;
+    else
+        options.cache.folder.clear();
+}
+
+void carla_plugin_discovery_clear_cache(const BinaryType btype, const PluginType ptype, const char* const pluginPath,
+                                        const bool onlyInvalid)
+{
+    CARLA_SAFE_ASSERT_RETURN(btype != CB::BINARY_NONE,);
+    CARLA_SAFE_ASSERT_RETURN(ptype != CB::PLUGIN_NONE,);
+
+    if (CarlaPluginDiscoveryOptions::getInstance().cache.disabled)
+        return;
+
+    // LV2 info is cached per bundle by the discovery process, it is always removed as a whole
+    if (ptype == CB::PLUGIN_LV2)
+    {
+        if (! onlyInvalid)
+            getDiscoveryCacheFolder().getChildFile(kLv2CacheFileName).deleteFile();
+        return;
+    }
+
+    CarlaPluginDiscoveryCache cache(btype, ptype);
+
+    if (pluginPath == nullptr || pluginPath[0] == '\0')
+    {
+        cache.removeBinaries(std::string(), onlyInvalid);
+    }
+    else
+    {
+        const std::vector<std::string> folders(getFoldersFromPluginPath(pluginPath));
+
+        for (std::vector<std::string>::const_iterator it = folders.begin(); it != folders.end(); ++it)
+            cache.removeBinaries(*it, onlyInvalid);
+    }
+
+    cache.save();
+}
+
 void carla_plugin_discovery_set_option(const EngineOption option, const int value, const char* const valueStr)
 {
     switch (option)
@@ -172,8 +172,7 @@ public:
 
         if (fPorts.numMidiIns > 0)
         {
-            uint32_t engineEventIndex = 0;
-            carla_zeroStructs(pData->events.in, kMaxEngineEventInternalCount);
+            pData->events.in.clear();
 
             for (uint32_t i=0; i < fPorts.numMidiIns; ++i)
             {
@@ -190,12 +189,12 @@ public:
 
                     const uint8_t* const data((const uint8_t*)(event + 1));
 
-                    EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
+                    EngineEvent& engineEvent(pData->events.in.data[pData->events.in.count++]);
 
                     engineEvent.time = (uint32_t)event->time.frames;
                     engineEvent.fillFromMidiData((uint8_t)event->body.size, data, (uint8_t)i);
 
-                    if (engineEventIndex >= kMaxEngineEventInternalCount)
+                    if (pData->events.in.count >= kMaxEngineEventInternalCount)
                         break;
                 }
             }
@@ -203,7 +202,7 @@ public:
 
         if (fPorts.numMidiOuts > 0)
         {
-            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+            pData->events.out.clear();
         }
 
         if (fPlugin->tryLock(fIsOffline))
@@ -224,13 +223,13 @@ public:
                 uint8_t mdataTmp[EngineMidiEvent::kDataSize];
                 const uint8_t* mdataPtr;
 
-                for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+                for (uint32_t i=0; i < pData->events.out.count; ++i)
                 {
-                    const EngineEvent& engineEvent(pData->events.out[i]);
+                    const EngineEvent& engineEvent(pData->events.out.data[i]);
 
                     /**/ if (engineEvent.type == kEngineEventTypeNull)
                     {
-                        break;
+                        continue;
                     }
                     else if (engineEvent.type == kEngineEventTypeControl)
                     {
@@ -22,6 +22,7 @@
 #include "CarlaLv2Utils.hpp"
 #include "CarlaMIDI.h"
 #include "LinkedList.hpp"
+#include "Lv2UridTable.hpp"
 
 #include "water/files/File.h"
 
@@ -116,6 +117,146 @@ enum CarlaLv2URIDs {
     kUridCount
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// URIs of the fixed URIDs above, must match the host side
+
+static const char* carla_lv2_fixed_urid_unmap(const LV2_URID urid) noexcept
+{
+    switch (urid)
+    {
+    // Atom types
+    case kUridAtomBlank:
+        return LV2_ATOM__Blank;
+    case kUridAtomBool:
+        return LV2_ATOM__Bool;
+    case kUridAtomChunk:
+        return LV2_ATOM__Chunk;
+    case kUridAtomDouble:
+        return LV2_ATOM__Double;
+    case kUridAtomEvent:
+        return LV2_ATOM__Event;
+    case kUridAtomFloat:
+        return LV2_ATOM__Float;
+    case kUridAtomInt:
+        return LV2_ATOM__Int;
+    case kUridAtomLiteral:
+        return LV2_ATOM__Literal;
+    case kUridAtomLong:
+        return LV2_ATOM__Long;
+    case kUridAtomNumber:
+        return LV2_ATOM__Number;
+    case kUridAtomObject:
+        return LV2_ATOM__Object;
+    case kUridAtomPath:
+        return LV2_ATOM__Path;
+    case kUridAtomProperty:
+        return LV2_ATOM__Property;
+    case kUridAtomResource:
+        return LV2_ATOM__Resource;
+    case kUridAtomSequence:
+        return LV2_ATOM__Sequence;
+    case kUridAtomSound:
+        return LV2_ATOM__Sound;
+    case kUridAtomString:
+        return LV2_ATOM__String;
+    case kUridAtomTuple:
+        return LV2_ATOM__Tuple;
+    case kUridAtomURI:
+        return LV2_ATOM__URI;
+    case kUridAtomURID:
+        return LV2_ATOM__URID;
+    case kUridAtomVector:
+        return LV2_ATOM__Vector;
+    case kUridAtomTransferAtom:
+        return LV2_ATOM__atomTransfer;
+    case kUridAtomTransferEvent:
+        return LV2_ATOM__eventTransfer;
+
+    // BufSize types
+    case kUridBufMaxLength:
+        return LV2_BUF_SIZE__maxBlockLength;
+    case kUridBufMinLength:
+        return LV2_BUF_SIZE__minBlockLength;
+    case kUridBufNominalLength:
+        return LV2_BUF_SIZE__nominalBlockLength;
+    case kUridBufSequenceSize:
+        return LV2_BUF_SIZE__sequenceSize;
+
+    // Log types
+    case kUridLogError:
+        return LV2_LOG__Error;
+    case kUridLogNote:
+        return LV2_LOG__Note;
+    case kUridLogTrace:
+        return LV2_LOG__Trace;
+    case kUridLogWarning:
+        return LV2_LOG__Warning;
+
+    // Patch types
+    case kUridPatchSet:
+        return LV2_PATCH__Set;
+    case kUridPatchProperty:
+        return LV2_PATCH__property;
+    case kUridPatchSubject:
+        return LV2_PATCH__subject;
+    case kUridPatchValue:
+        return LV2_PATCH__value;
+
+    // Time types
+    case kUridTimePosition:
+        return LV2_TIME__Position;
+    case kUridTimeBar:
+        return LV2_TIME__bar;
+    case kUridTimeBarBeat:
+        return LV2_TIME__barBeat;
+    case kUridTimeBeat:
+        return LV2_TIME__beat;
+    case kUridTimeBeatUnit:
+        return LV2_TIME__beatUnit;
+    case kUridTimeBeatsPerBar:
+        return LV2_TIME__beatsPerBar;
+    case kUridTimeBeatsPerMinute:
+        return LV2_TIME__beatsPerMinute;
+    case kUridTimeFrame:
+        return LV2_TIME__frame;
+    case kUridTimeFramesPerSecond:
+        return LV2_TIME__framesPerSecond;
+    case kUridTimeSpeed:
+        return LV2_TIME__speed;
+    case kUridTimeTicksPerBeat:
+        return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
+
+    // Others
+    case kUridMidiEvent:
+        return LV2_MIDI__MidiEvent;
+    case kUridParamSampleRate:
+        return LV2_PARAMETERS__sampleRate;
+    case kUridBackgroundColor:
+        return LV2_UI__backgroundColor;
+    case kUridForegroundColor:
+        return LV2_UI__foregroundColor;
+#ifndef CARLA_OS_MAC
+    case kUridScaleFactor:
+        return LV2_UI__scaleFactor;
+#endif
+    case kUridWindowTitle:
+        return LV2_UI__windowTitle;
+
+    // Custom Carla types
+    case kUridCarlaAtomWorkerIn:
+        return URI_CARLA_ATOM_WORKER_IN;
+    case kUridCarlaAtomWorkerResp:
+        return URI_CARLA_ATOM_WORKER_RESP;
+    case kUridCarlaParameterChange:
+        return URI_CARLA_PARAMETER_CHANGE;
+    case kUridCarlaTransientWindowId:
+        return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
+    }
+
+
+    return nullptr;
+}
+
 // LV2 Feature Ids
 enum CarlaLv2Features {
     // DSP features
@@ -286,10 +427,15 @@ public:
           fControlDesignatedPort(0),
           fLv2Options(),
           fUiOptions(),
-          fCustomURIDs(kUridCount, std::string("urn:null")),
+          fUridTable(),
+          fLocalUridTable(),
           fExt()
     {
-        CARLA_SAFE_ASSERT(fCustomURIDs.size() == kUridCount);
+        for (LV2_URID urid = 1; urid < kUridCount; ++urid)
+        {
+            const LV2_URID mapped = fUridTable.map(carla_lv2_fixed_urid_unmap(urid));
+            CARLA_SAFE_ASSERT_UINT2(mapped == urid, mapped, urid);
+        }
 
         carla_zeroPointers(fFeatures, kFeatureCount+1);
 
@@ -769,10 +915,20 @@ public:
 
     void dspURIDReceived(const LV2_URID urid, const char* const uri) override
     {
-        CARLA_SAFE_ASSERT_RETURN(urid == fCustomURIDs.size(),);
+        CARLA_SAFE_ASSERT_RETURN(urid != kUridNull,);
+        CARLA_SAFE_ASSERT_RETURN(urid < kLv2UridBridgedUiOffset,);
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
 
-        fCustomURIDs.push_back(uri);
+        // already known, sent twice
+        if (const char* const ourURI = fUridTable.unmap(urid))
+        {
+            if (std::strcmp(ourURI, uri) != 0)
+                carla_stderr2("UI :: wrong URI '%s' vs '%s'", ourURI, uri);
+            return;
+        }
+
+        const bool mapped = fUridTable.mapWithId(urid, uri);
+        CARLA_SAFE_ASSERT_UINT2(mapped, urid, fUridTable.getCount());
     }
 
     void uiOptionsChanged(const BridgeFormatOptions& opts) override
@@ -857,21 +1013,18 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("CarlaLv2Client::getCustomURID(\"%s\")", uri);
 
-        const std::string    s_uri(uri);
-        const std::ptrdiff_t s_pos(std::find(fCustomURIDs.begin(), fCustomURIDs.end(), s_uri) - fCustomURIDs.begin());
+        // once mapped here, keep using our own id even if the host sends its own later
+        if (const LV2_URID localUrid = fLocalUridTable.find(uri))
+            return kLv2UridBridgedUiOffset + localUrid;
 
-        if (s_pos <= 0 || s_pos >= INT32_MAX)
-            return kUridNull;
-
-        const LV2_URID urid     = static_cast<LV2_URID>(s_pos);
-        const LV2_URID uriCount = static_cast<LV2_URID>(fCustomURIDs.size());
-
-        if (urid < uriCount)
+        if (const LV2_URID urid = fUridTable.find(uri))
             return urid;
 
-        CARLA_SAFE_ASSERT(urid == uriCount);
+        // the host table can grow at any time, so new ids come from a separate range
+        const LV2_URID localUrid = fLocalUridTable.map(uri);
+        CARLA_SAFE_ASSERT_RETURN(localUrid != kUridNull, kUridNull);
 
-        fCustomURIDs.push_back(uri);
+        const LV2_URID urid = kLv2UridBridgedUiOffset + localUrid;
 
         if (isPipeRunning())
             writeLv2UridMessage(urid, uri);
@@ -882,10 +1035,14 @@ public:
     const char* getCustomURIDString(const LV2_URID urid) const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, kUnmapFallback);
-        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.size(), kUnmapFallback);
         carla_debug("CarlaLv2Client::getCustomURIDString(%i)", urid);
 
-        return fCustomURIDs[urid].c_str();
+        const char* const uri = urid >= kLv2UridBridgedUiOffset
+                              ? fLocalUridTable.unmap(urid - kLv2UridBridgedUiOffset)
+                              : fUridTable.unmap(urid);
+        CARLA_SAFE_ASSERT_UINT2_RETURN(uri != nullptr, urid, fUridTable.getCount(), kUnmapFallback);
+
+        return uri;
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -1065,7 +1222,8 @@ private:
     Lv2PluginOptions          fLv2Options;
 
     Options fUiOptions;
-    std::vector<std::string> fCustomURIDs;
+    Lv2UridTable fUridTable;
+    Lv2UridTable fLocalUridTable;
 
     struct Extensions {
         const LV2_Options_Interface* options;
@@ -1211,135 +1369,6 @@ private:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("carla_lv2_urid_map(%p, \"%s\")", handle, uri);
 
-        // Atom types
-        if (std::strcmp(uri, LV2_ATOM__Blank) == 0)
-            return kUridAtomBlank;
-        if (std::strcmp(uri, LV2_ATOM__Bool) == 0)
-            return kUridAtomBool;
-        if (std::strcmp(uri, LV2_ATOM__Chunk) == 0)
-            return kUridAtomChunk;
-        if (std::strcmp(uri, LV2_ATOM__Double) == 0)
-            return kUridAtomDouble;
-        if (std::strcmp(uri, LV2_ATOM__Event) == 0)
-            return kUridAtomEvent;
-        if (std::strcmp(uri, LV2_ATOM__Float) == 0)
-            return kUridAtomFloat;
-        if (std::strcmp(uri, LV2_ATOM__Int) == 0)
-            return kUridAtomInt;
-        if (std::strcmp(uri, LV2_ATOM__Literal) == 0)
-            return kUridAtomLiteral;
-        if (std::strcmp(uri, LV2_ATOM__Long) == 0)
-            return kUridAtomLong;
-        if (std::strcmp(uri, LV2_ATOM__Number) == 0)
-            return kUridAtomNumber;
-        if (std::strcmp(uri, LV2_ATOM__Object) == 0)
-            return kUridAtomObject;
-        if (std::strcmp(uri, LV2_ATOM__Path) == 0)
-            return kUridAtomPath;
-        if (std::strcmp(uri, LV2_ATOM__Property) == 0)
-            return kUridAtomProperty;
-        if (std::strcmp(uri, LV2_ATOM__Resource) == 0)
-            return kUridAtomResource;
-        if (std::strcmp(uri, LV2_ATOM__Sequence) == 0)
-            return kUridAtomSequence;
-        if (std::strcmp(uri, LV2_ATOM__Sound) == 0)
-            return kUridAtomSound;
-        if (std::strcmp(uri, LV2_ATOM__String) == 0)
-            return kUridAtomString;
-        if (std::strcmp(uri, LV2_ATOM__Tuple) == 0)
-            return kUridAtomTuple;
-        if (std::strcmp(uri, LV2_ATOM__URI) == 0)
-            return kUridAtomURI;
-        if (std::strcmp(uri, LV2_ATOM__URID) == 0)
-            return kUridAtomURID;
-        if (std::strcmp(uri, LV2_ATOM__Vector) == 0)
-            return kUridAtomVector;
-        if (std::strcmp(uri, LV2_ATOM__atomTransfer) == 0)
-            return kUridAtomTransferAtom;
-        if (std::strcmp(uri, LV2_ATOM__eventTransfer) == 0)
-            return kUridAtomTransferEvent;
-
-        // BufSize types
-        if (std::strcmp(uri, LV2_BUF_SIZE__maxBlockLength) == 0)
-            return kUridBufMaxLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__minBlockLength) == 0)
-            return kUridBufMinLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__nominalBlockLength) == 0)
-            return kUridBufNominalLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__sequenceSize) == 0)
-            return kUridBufSequenceSize;
-
-        // Log types
-        if (std::strcmp(uri, LV2_LOG__Error) == 0)
-            return kUridLogError;
-        if (std::strcmp(uri, LV2_LOG__Note) == 0)
-            return kUridLogNote;
-        if (std::strcmp(uri, LV2_LOG__Trace) == 0)
-            return kUridLogTrace;
-        if (std::strcmp(uri, LV2_LOG__Warning) == 0)
-            return kUridLogWarning;
-
-        // Patch types
-        if (std::strcmp(uri, LV2_PATCH__Set) == 0)
-            return kUridPatchSet;
-        if (std::strcmp(uri, LV2_PATCH__property) == 0)
-            return kUridPatchProperty;
-        if (std::strcmp(uri, LV2_PATCH__subject) == 0)
-            return kUridPatchSubject;
-        if (std::strcmp(uri, LV2_PATCH__value) == 0)
-            return kUridPatchValue;
-
-        // Time types
-        if (std::strcmp(uri, LV2_TIME__Position) == 0)
-            return kUridTimePosition;
-        if (std::strcmp(uri, LV2_TIME__bar) == 0)
-            return kUridTimeBar;
-        if (std::strcmp(uri, LV2_TIME__barBeat) == 0)
-            return kUridTimeBarBeat;
-        if (std::strcmp(uri, LV2_TIME__beat) == 0)
-            return kUridTimeBeat;
-        if (std::strcmp(uri, LV2_TIME__beatUnit) == 0)
-            return kUridTimeBeatUnit;
-        if (std::strcmp(uri, LV2_TIME__beatsPerBar) == 0)
-            return kUridTimeBeatsPerBar;
-        if (std::strcmp(uri, LV2_TIME__beatsPerMinute) == 0)
-            return kUridTimeBeatsPerMinute;
-        if (std::strcmp(uri, LV2_TIME__frame) == 0)
-            return kUridTimeFrame;
-        if (std::strcmp(uri, LV2_TIME__framesPerSecond) == 0)
-            return kUridTimeFramesPerSecond;
-        if (std::strcmp(uri, LV2_TIME__speed) == 0)
-            return kUridTimeSpeed;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat) == 0)
-            return kUridTimeTicksPerBeat;
-
-        // Others
-        if (std::strcmp(uri, LV2_MIDI__MidiEvent) == 0)
-            return kUridMidiEvent;
-        if (std::strcmp(uri, LV2_PARAMETERS__sampleRate) == 0)
-            return kUridParamSampleRate;
-        if (std::strcmp(uri, LV2_UI__backgroundColor) == 0)
-            return kUridBackgroundColor;
-        if (std::strcmp(uri, LV2_UI__foregroundColor) == 0)
-            return kUridForegroundColor;
-#ifndef CARLA_OS_MAC
-        if (std::strcmp(uri, LV2_UI__scaleFactor) == 0)
-            return kUridScaleFactor;
-#endif
-        if (std::strcmp(uri, LV2_UI__windowTitle) == 0)
-            return kUridWindowTitle;
-
-        // Custom Carla types
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_IN) == 0)
-            return kUridCarlaAtomWorkerIn;
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_RESP) == 0)
-            return kUridCarlaAtomWorkerResp;
-        if (std::strcmp(uri, URI_CARLA_PARAMETER_CHANGE) == 0)
-            return kUridCarlaParameterChange;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TransientWindowId) == 0)
-            return kUridCarlaTransientWindowId;
-
-        // Custom plugin types
         return ((CarlaLv2Client*)handle)->getCustomURID(uri);
     }
 
@@ -1349,138 +1378,6 @@ private:
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, nullptr);
         carla_debug("carla_lv2_urid_unmap(%p, %i)", handle, urid);
 
-        switch (urid)
-        {
-        // Atom types
-        case kUridAtomBlank:
-            return LV2_ATOM__Blank;
-        case kUridAtomBool:
-            return LV2_ATOM__Bool;
-        case kUridAtomChunk:
-            return LV2_ATOM__Chunk;
-        case kUridAtomDouble:
-            return LV2_ATOM__Double;
-        case kUridAtomEvent:
-            return LV2_ATOM__Event;
-        case kUridAtomFloat:
-            return LV2_ATOM__Float;
-        case kUridAtomInt:
-            return LV2_ATOM__Int;
-        case kUridAtomLiteral:
-            return LV2_ATOM__Literal;
-        case kUridAtomLong:
-            return LV2_ATOM__Long;
-        case kUridAtomNumber:
-            return LV2_ATOM__Number;
-        case kUridAtomObject:
-            return LV2_ATOM__Object;
-        case kUridAtomPath:
-            return LV2_ATOM__Path;
-        case kUridAtomProperty:
-            return LV2_ATOM__Property;
-        case kUridAtomResource:
-            return LV2_ATOM__Resource;
-        case kUridAtomSequence:
-            return LV2_ATOM__Sequence;
-        case kUridAtomSound:
-            return LV2_ATOM__Sound;
-        case kUridAtomString:
-            return LV2_ATOM__String;
-        case kUridAtomTuple:
-            return LV2_ATOM__Tuple;
-        case kUridAtomURI:
-            return LV2_ATOM__URI;
-        case kUridAtomURID:
-            return LV2_ATOM__URID;
-        case kUridAtomVector:
-            return LV2_ATOM__Vector;
-        case kUridAtomTransferAtom:
-            return LV2_ATOM__atomTransfer;
-        case kUridAtomTransferEvent:
-            return LV2_ATOM__eventTransfer;
-
-        // BufSize types
-        case kUridBufMaxLength:
-            return LV2_BUF_SIZE__maxBlockLength;
-        case kUridBufMinLength:
-            return LV2_BUF_SIZE__minBlockLength;
-        case kUridBufNominalLength:
-            return LV2_BUF_SIZE__nominalBlockLength;
-        case kUridBufSequenceSize:
-            return LV2_BUF_SIZE__sequenceSize;
-
-        // Log types
-        case kUridLogError:
-            return LV2_LOG__Error;
-        case kUridLogNote:
-            return LV2_LOG__Note;
-        case kUridLogTrace:
-            return LV2_LOG__Trace;
-        case kUridLogWarning:
-            return LV2_LOG__Warning;
-
-        // Patch types
-        case kUridPatchSet:
-            return LV2_PATCH__Set;
-        case kUridPatchProperty:
-            return LV2_PATCH__property;
-        case kUridPatchSubject:
-            return LV2_PATCH__subject;
-        case kUridPatchValue:
-            return LV2_PATCH__value;
-
-        // Time types
-        case kUridTimePosition:
-            return LV2_TIME__Position;
-        case kUridTimeBar:
-            return LV2_TIME__bar;
-        case kUridTimeBarBeat:
-            return LV2_TIME__barBeat;
-        case kUridTimeBeat:
-            return LV2_TIME__beat;
-        case kUridTimeBeatUnit:
-            return LV2_TIME__beatUnit;
-        case kUridTimeBeatsPerBar:
-            return LV2_TIME__beatsPerBar;
-        case kUridTimeBeatsPerMinute:
-            return LV2_TIME__beatsPerMinute;
-        case kUridTimeFrame:
-            return LV2_TIME__frame;
-        case kUridTimeFramesPerSecond:
-            return LV2_TIME__framesPerSecond;
-        case kUridTimeSpeed:
-            return LV2_TIME__speed;
-        case kUridTimeTicksPerBeat:
-            return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
-
-        // Others
-        case kUridMidiEvent:
-            return LV2_MIDI__MidiEvent;
-        case kUridParamSampleRate:
-            return LV2_PARAMETERS__sampleRate;
-        case kUridBackgroundColor:
-            return LV2_UI__backgroundColor;
-        case kUridForegroundColor:
-            return LV2_UI__foregroundColor;
-#ifndef CARLA_OS_MAC
-        case kUridScaleFactor:
-            return LV2_UI__scaleFactor;
-#endif
-        case kUridWindowTitle:
-            return LV2_UI__windowTitle;
-
-        // Custom Carla types
-        case kUridCarlaAtomWorkerIn:
-            return URI_CARLA_ATOM_WORKER_IN;
-        case kUridCarlaAtomWorkerResp:
-            return URI_CARLA_ATOM_WORKER_RESP;
-        case kUridCarlaParameterChange:
-            return URI_CARLA_PARAMETER_CHANGE;
-        case kUridCarlaTransientWindowId:
-            return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
-        }
-
-        // Custom types
         return ((CarlaLv2Client*)handle)->getCustomURIDString(urid);
     }
 
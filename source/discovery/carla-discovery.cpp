@@ -137,12 +137,38 @@ public:
         return true;
     }
 
+    /*
+     * Take the next binary requested by the host while running in server mode.
+     */
+    bool takeNextFilename(CarlaString& filename) noexcept
+    {
+        if (fNextFilename.isEmpty())
+            return false;
+
+        filename = fNextFilename;
+        fNextFilename.clear();
+        return true;
+    }
+
 protected:
     bool msgReceived(const char* const msg) noexcept
     {
+        if (std::strcmp(msg, "discover") == 0)
+        {
+            const char* filename = nullptr;
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(filename, false), true);
+            CARLA_SAFE_ASSERT(fNextFilename.isEmpty());
+
+            fNextFilename = filename;
+            return true;
+        }
+
         carla_stdout("discovery msgReceived %s", msg);
         return true;
     }
+
+private:
+    CarlaString fNextFilename;
 };
 #else
 class DiscoveryPipe
@@ -1092,6 +1118,10 @@ static bool do_vst2_check(lib_t& libHandle, const char* const filename, const bo
 {
     VST_Function vstFn = nullptr;
 
+    // clear state left from the previous binary when running in server mode
+    gVstIsProcessing = gVstNeedsIdle = gVstWantsMidi = gVstWantsTime = false;
+    gVstCurrentUniqueId = 0;
+
    #ifdef CARLA_OS_MAC
     BundleLoader bundleLoader;
 
@@ -2608,20 +2638,12 @@ static void do_jsfx_check(const char* const filename, bool doInit)
 #endif // HAVE_YSFX
 
 // --------------------------------------------------------------------------------------------------------------------
-// main entry point
+// discovery of a single binary
 
-int main(int argc, const char* argv[])
+// returns false if the binary could not be loaded,
+// retryAsX64lugin is set if it should be scanned again in x86_64 mode
+static bool do_discovery(const PluginType type, const char* const filename, bool& retryAsX64lugin)
 {
-    if (argc != 3 && argc != 7)
-    {
-        carla_stdout("usage: %s <type> </path/to/plugin>", argv[0]);
-        return 1;
-    }
-
-    const char* const stype    = argv[1];
-    const char* const filename = argv[2];
-    const PluginType  type     = getPluginTypeFromString(stype);
-
     CarlaString filenameCheck(filename);
     filenameCheck.toLower();
 
@@ -2665,37 +2687,7 @@ int main(int argc, const char* argv[])
     if (type != PLUGIN_SF2 && filenameCheck.contains("fluidsynth", true))
     {
         DISCOVERY_OUT("info", "skipping fluidsynth based plugin");
-        return 0;
-    }
-
-    // ----------------------------------------------------------------------------------------------------------------
-    // Initialize OS features
-
-    // we want stuff in English so we can parse error messages
-    ::setlocale(LC_ALL, "C");
-   #ifndef CARLA_OS_WIN
-    carla_setenv("LC_ALL", "C");
-   #endif
-
-  #ifdef CARLA_OS_WIN
-    OleInitialize(nullptr);
-    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
-   #ifndef __WINPTHREADS_VERSION
-    // (non-portable) initialization of statically linked pthread library
-    pthread_win32_process_attach_np();
-    pthread_win32_thread_attach_np();
-   #endif
-  #endif
-
-    // ----------------------------------------------------------------------------------------------------------------
-    // Initialize pipe
-
-    if (argc == 7)
-    {
-        gPipe = new DiscoveryPipe;
-
-        if (! gPipe->initPipeClient(argv))
-            return 1;
+        return true;
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -2707,8 +2699,7 @@ int main(int argc, const char* argv[])
         if (handle == nullptr)
         {
             print_lib_error(filename);
-            gPipe = nullptr;
-            return 1;
+            return false;
         }
     }
 
@@ -2726,8 +2717,7 @@ int main(int argc, const char* argv[])
         if (! lib_close(handle))
         {
             print_lib_error(filename);
-            gPipe = nullptr;
-            return 1;
+            return false;
         }
 
         handle = lib_open(filename);
@@ -2735,20 +2725,10 @@ int main(int argc, const char* argv[])
         if (handle == nullptr)
         {
             print_lib_error(filename);
-            gPipe = nullptr;
-            return 1;
+            return false;
         }
     }
 
-   #ifndef BUILD_BRIDGE
-    if (std::strcmp(filename, ":all") == 0)
-    {
-        do_cached_check(type);
-        gPipe = nullptr;
-        return 0;
-    }
-   #endif
-
    #ifdef CARLA_OS_MAC
     // Plugin might be in quarentine due to Apple stupid notarization rules, let's remove that if possible
     switch (type)
@@ -2765,9 +2745,6 @@ int main(int argc, const char* argv[])
     }
    #endif
 
-    // some macOS plugins have not been yet ported to arm64, re-run them in x86_64 mode if discovery fails
-    bool retryAsX64lugin = false;
-
     switch (type)
     {
     case PLUGIN_LADSPA:
@@ -2837,6 +2814,116 @@ int main(int argc, const char* argv[])
     if (openLib && handle != nullptr)
         lib_close(handle);
 
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// server mode, discovery of many binaries requested by the host through the pipe
+
+#ifndef BUILDING_CARLA_FOR_WINE
+static void do_discovery_server(const PluginType type)
+{
+    CarlaString filename;
+
+    while (gPipe->isPipeRunning())
+    {
+        gPipe->idlePipe();
+
+        if (! gPipe->takeNextFilename(filename))
+        {
+            carla_msleep(5);
+            continue;
+        }
+
+        bool retryAsX64lugin = false;
+        do_discovery(type, filename, retryAsX64lugin);
+
+       #if !(defined(CARLA_OS_MAC) && defined(__aarch64__))
+        retryAsX64lugin = false;
+       #endif
+
+        // let the host know this binary is done, x86_64 retries need a process of their own
+        gPipe->writeDiscoveryMessage("done", retryAsX64lugin ? "retry" : "ok");
+    }
+}
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// main entry point
+
+int main(int argc, const char* argv[])
+{
+    if (argc != 3 && argc != 7)
+    {
+        carla_stdout("usage: %s <type> </path/to/plugin>", argv[0]);
+        return 1;
+    }
+
+    const char* const stype    = argv[1];
+    const char* const filename = argv[2];
+    const PluginType  type     = getPluginTypeFromString(stype);
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Initialize OS features
+
+    // we want stuff in English so we can parse error messages
+    ::setlocale(LC_ALL, "C");
+   #ifndef CARLA_OS_WIN
+    carla_setenv("LC_ALL", "C");
+   #endif
+
+  #ifdef CARLA_OS_WIN
+    OleInitialize(nullptr);
+    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+   #ifndef __WINPTHREADS_VERSION
+    // (non-portable) initialization of statically linked pthread library
+    pthread_win32_process_attach_np();
+    pthread_win32_thread_attach_np();
+   #endif
+  #endif
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Initialize pipe
+
+    if (argc == 7)
+    {
+        gPipe = new DiscoveryPipe;
+
+        if (! gPipe->initPipeClient(argv))
+            return 1;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+   #ifndef BUILD_BRIDGE
+    if (std::strcmp(filename, ":all") == 0)
+    {
+        do_cached_check(type);
+        gPipe = nullptr;
+        return 0;
+    }
+   #endif
+
+   #ifndef BUILDING_CARLA_FOR_WINE
+    if (std::strcmp(filename, ":server") == 0)
+    {
+        CARLA_SAFE_ASSERT_RETURN(gPipe != nullptr, 1);
+
+        do_discovery_server(type);
+        gPipe = nullptr;
+        return 0;
+    }
+   #endif
+
+    // some macOS plugins have not been yet ported to arm64, re-run them in x86_64 mode if discovery fails
+    bool retryAsX64lugin = false;
+
+    if (! do_discovery(type, filename, retryAsX64lugin))
+    {
+        gPipe = nullptr;
+        return 1;
+    }
+
     if (retryAsX64lugin)
     {
        #if defined(CARLA_OS_MAC) && defined(__aarch64__)
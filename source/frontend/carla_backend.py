@@ -140,6 +140,14 @@ MAX_PATCHBAY_PLUGINS = 255
 # @see ENGINE_OPTION_MAX_PARAMETERS
 MAX_DEFAULT_PARAMETERS = 200
 
+# Maximum number of threads used for processing, including the audio thread.
+# @see ENGINE_OPTION_PROCESS_THREADS, ENGINE_OPTION_RACK_LANES
+MAX_PROCESS_THREADS = 32
+
+# Maximum number of non-realtime worker threads.
+# @see ENGINE_OPTION_WORKER_THREADS
+MAX_WORKER_THREADS = 16
+
 # The "plugin Id" for the global Carla instance.
 # Currently only used for audio peaks.
 MAIN_CARLA_PLUGIN_ID = 0xFFFF
@@ -1026,6 +1034,52 @@ ENGINE_OPTION_CLIENT_NAME_PREFIX = 34
 # Treat loaded plugins as standalone (that is, there is no host UI to manage them)
 ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
 
+# Number of threads used to process the internal patchbay graph, including the audio thread.
+# Independent branches of the graph are then processed in parallel.
+# Default is 1, meaning everything runs serially in the audio thread.
+# @note Only used in ENGINE_PROCESS_MODE_PATCHBAY, and only applied on engine start
+ENGINE_OPTION_PROCESS_THREADS = 36
+
+# Number of parallel stereo lanes the rack can be split into.
+# Lane 0 is the main chain, which every plugin belongs to unless moved to another lane with set_plugin_rack_lane().
+# Each lane runs its plugins serially, in order of Id, on its own thread.
+# Lanes start from the rack inputs or from silence, see ENGINE_OPTION_RACK_LANE_INPUTS,
+# all receive the rack input events, and their audio outputs are summed together.
+# If a plugin is assigned to a lane that does not exist, the whole rack runs serially and a warning is logged.
+# Default is 1, meaning the classic single serial chain.
+# @note Only used in ENGINE_PROCESS_MODE_CONTINUOUS_RACK, and only applied on engine start
+ENGINE_OPTION_RACK_LANES = 37
+
+# Number of non-realtime threads that run work scheduled by plugins from the audio thread,
+# like LV2 worker jobs (sample loading, IR swapping, etc).
+# Default is 2, 0 means the work is run from the engine idle calls instead.
+# @note Only applied on engine start
+ENGINE_OPTION_WORKER_THREADS = 38
+
+# Integration window used for RMS and true-peak plugin meters, in milliseconds.
+# Default is 300, valid range is 10 to 10000.
+# @note Meters are only computed for plugins being watched
+ENGINE_OPTION_METER_WINDOW = 39
+
+# Number of threads used to create plugins when loading a project.
+# Plugins that need the main thread (bridges, VST2, VST3, CLAP, AU, JSFX and JACK applications) are still
+# created on it, while the others are created in parallel.
+# Their state is always restored on the main thread, once they have been added to the engine.
+# Default is 1, meaning plugins are loaded one after another.
+ENGINE_OPTION_LOADER_THREADS = 40
+
+# Minimum size of plugin chunks stored as raw files next to saved projects, in KiB.
+# Such chunks are kept in a "<project-name>.chunks" folder, named after their SHA1 hash,
+# instead of being base64-encoded inside the project file.
+# Default is 0, which keeps all chunks inside the project file.
+ENGINE_OPTION_EXTERNAL_CHUNKS = 41
+
+# Which rack lanes are fed by the rack inputs, as a bitmask of lane indexes.
+# Lanes not set here start from silence, like a layered synth followed by its own effects.
+# Default is 1, meaning only the main chain receives the rack inputs.
+# @see ENGINE_OPTION_RACK_LANES
+ENGINE_OPTION_RACK_LANE_INPUTS = 42
+
 # ---------------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -1825,6 +1879,22 @@ class CarlaHostMeta():
     def switch_plugins(self, pluginIdA, pluginIdB):
         raise NotImplementedError
 
+    # Get the rack lane a plugin runs on, 0 being the main chain.
+    # @param pluginId Plugin
+    # @see ENGINE_OPTION_RACK_LANES
+    @abstractmethod
+    def get_plugin_rack_lane(self, pluginId):
+        raise NotImplementedError
+
+    # Move a plugin to another rack lane, 0 being the main chain.
+    # The lane is stored in the plugin state, and so saved in projects.
+    # @param pluginId Plugin
+    # @param lane     New lane, must be lower than ENGINE_OPTION_RACK_LANES for the rack to run in parallel
+    # @see ENGINE_OPTION_RACK_LANES and ENGINE_OPTION_RACK_LANE_INPUTS
+    @abstractmethod
+    def set_plugin_rack_lane(self, pluginId, lane):
+        raise NotImplementedError
+
     # Load a plugin state.
     # @param pluginId Plugin
     # @param filename Path to plugin state
@@ -2402,6 +2472,12 @@ class CarlaHostNull(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return False
 
+    def get_plugin_rack_lane(self, pluginId):
+        return 0
+
+    def set_plugin_rack_lane(self, pluginId, lane):
+        return False
+
     def load_plugin_state(self, pluginId, filename):
         return False
 
@@ -2724,6 +2800,12 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_switch_plugins.argtypes = (c_void_p, c_uint, c_uint)
         self.lib.carla_switch_plugins.restype = c_bool
 
+        self.lib.carla_get_plugin_rack_lane.argtypes = (c_void_p, c_uint)
+        self.lib.carla_get_plugin_rack_lane.restype = c_uint
+
+        self.lib.carla_set_plugin_rack_lane.argtypes = (c_void_p, c_uint, c_uint)
+        self.lib.carla_set_plugin_rack_lane.restype = c_bool
+
         self.lib.carla_load_plugin_state.argtypes = (c_void_p, c_uint, c_char_p)
         self.lib.carla_load_plugin_state.restype = c_bool
 
@@ -3047,6 +3129,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return bool(self.lib.carla_switch_plugins(self.handle, pluginIdA, pluginIdB))
 
+    def get_plugin_rack_lane(self, pluginId):
+        return int(self.lib.carla_get_plugin_rack_lane(self.handle, pluginId))
+
+    def set_plugin_rack_lane(self, pluginId, lane):
+        return bool(self.lib.carla_set_plugin_rack_lane(self.handle, pluginId, lane))
+
     def load_plugin_state(self, pluginId, filename):
         return bool(self.lib.carla_load_plugin_state(self.handle, pluginId, filename.encode("utf-8")))
 
@@ -3277,6 +3365,7 @@ class PluginStoreInfo():
         self.customDataCount = 0
         self.customData      = []
         self.peaks = [0.0, 0.0, 0.0, 0.0]
+        self.rackLane = 0
 
 # ---------------------------------------------------------------------------------------------------------------------
 # Carla Host object for plugins (using pipes)
@@ -3454,6 +3543,15 @@ class CarlaHostPlugin(CarlaHostMeta):
             self._switchPlugins(pluginIdA, pluginIdB)
         return ret
 
+    def get_plugin_rack_lane(self, pluginId):
+        return self.fPluginsInfo[pluginId].rackLane
+
+    def set_plugin_rack_lane(self, pluginId, lane):
+        ret = self.sendMsgAndSetError(["set_plugin_rack_lane", pluginId, lane])
+        if ret:
+            self.fPluginsInfo[pluginId].rackLane = lane
+        return ret
+
     def load_plugin_state(self, pluginId, filename):
         return self.sendMsgAndSetError(["load_plugin_state", pluginId, filename])
 
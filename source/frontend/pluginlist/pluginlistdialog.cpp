@@ -1284,6 +1284,13 @@ void PluginListDialog::timerEvent(QTimerEvent* const event)
             if (p->discovery.dialog)
                 p->discovery.dialog->progressBar->setFormat(ui.label->text());
 
+            // the backend keeps a discovery cache of its own, make sure it does not skip what we want rescanned
+            if (p->discovery.ignoreCache || p->discovery.checkInvalid)
+                carla_plugin_discovery_clear_cache(p->discovery.btype,
+                                                   p->discovery.ptype,
+                                                   path.toUtf8().constData(),
+                                                   !p->discovery.ignoreCache);
+
             p->discovery.handle = carla_plugin_discovery_start(p->discovery.tool.toUtf8().constData(),
                                                                p->discovery.btype,
                                                                p->discovery.ptype,
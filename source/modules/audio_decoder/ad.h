@@ -76,6 +76,15 @@ int64_t ad_seek  (void *sf, int64_t pos);
  */
 ssize_t ad_read  (void *sf, float* out, size_t len);
 
+/** read deinterleaved audio data, one buffer per channel
+ * uncompressed files are converted straight into the buffers, other formats go through ad_read()
+ * @param sf decoder handle
+ * @param out array of channels buffers, each with room for \a frames floats
+ * @param frames number of frames to read
+ * @return number of frames read, 0 at end of file or -1 on error
+ */
+ssize_t ad_read_planar(void *sf, float** out, size_t frames);
+
 /** get the current playing bit_rate
  *
  * @param sf decoder handle
@@ -123,7 +123,8 @@ static const ad_plugin ad_dr_mp3 = {
 	&ad_info_dr_mp3,
 	&ad_seek_dr_mp3,
 	&ad_read_dr_mp3,
-	&ad_get_bitrate_dr_mp3
+	&ad_get_bitrate_dr_mp3,
+	NULL
 #else
 	&ad_eval_null,
 	&ad_open_null,
@@ -131,7 +132,8 @@ static const ad_plugin ad_dr_mp3 = {
 	&ad_info_null,
 	&ad_seek_null,
 	&ad_read_null,
-	&ad_bit_rate_null
+	&ad_bit_rate_null,
+	NULL
 #endif
 };
 
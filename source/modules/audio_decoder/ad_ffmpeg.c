@@ -359,7 +359,8 @@ static const ad_plugin ad_ffmpeg = {
   &ad_info_ffmpeg,
   &ad_seek_ffmpeg,
   &ad_read_ffmpeg,
-  &ad_bitrate_null
+  &ad_bitrate_null,
+  NULL
 #else
   &ad_eval_null,
   &ad_open_null,
@@ -367,7 +368,8 @@ static const ad_plugin ad_ffmpeg = {
   &ad_info_null,
   &ad_seek_null,
   &ad_read_null,
-  &ad_bitrate_null
+  &ad_bitrate_null,
+  NULL
 #endif
 };
 
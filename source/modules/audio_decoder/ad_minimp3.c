@@ -152,7 +152,8 @@ static const ad_plugin ad_minimp3 = {
 	&ad_info_minimp3,
 	&ad_seek_minimp3,
 	&ad_read_minimp3,
-	&ad_get_bitrate_minimp3
+	&ad_get_bitrate_minimp3,
+	NULL
 #else
 	&ad_eval_null,
 	&ad_open_null,
@@ -160,7 +161,8 @@ static const ad_plugin ad_minimp3 = {
 	&ad_info_null,
 	&ad_seek_null,
 	&ad_read_null,
-	&ad_bitrate_null
+	&ad_bitrate_null,
+	NULL
 #endif
 };
 
@@ -0,0 +1,591 @@
+/**
+   Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 2.1, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+/* Uncompressed WAV and AIFF files, read with positioned reads and converted to float.
+ * Opening only parses the headers, samples are read in small blocks into a conversion buffer.
+ * Files using any other encoding are left to the other backends.
+ *
+ * Files are not memory mapped on purpose, a mapped file that gets truncated would crash us with SIGBUS.
+ * A short read instead simply ends the file early. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "ad_plugin.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#ifdef _MSC_VER
+#define strcasecmp stricmp
+#endif
+
+/* max size of a single read, in bytes */
+#define PCM_READ_BLOCK_SIZE (256 * 1024)
+
+typedef enum {
+	PCM_U8,
+	PCM_S8,
+	PCM_S16,
+	PCM_S24,
+	PCM_S32,
+	PCM_F32,
+	PCM_F64
+} pcm_format;
+
+/* internal abstraction */
+
+typedef struct {
+#ifdef _WIN32
+	HANDLE file;
+#else
+	int fd;
+#endif
+	uint64_t file_size;
+	uint64_t data_offset; ///< first frame
+	int64_t frames;
+	int64_t pos;
+	unsigned int channels;
+	unsigned int sample_rate;
+	unsigned int frame_size;
+	pcm_format format;
+	int big_endian;
+	int bit_depth;
+	uint8_t *buffer; ///< raw file data, before conversion
+	size_t buffer_size;
+} pcm_audio_decoder;
+
+/* file access */
+
+static int open_file(pcm_audio_decoder *priv, const char *fn) {
+#ifdef _WIN32
+	LARGE_INTEGER size;
+	priv->file = CreateFileA(fn, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+	                         FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (priv->file == INVALID_HANDLE_VALUE)
+		return 0;
+	if (!GetFileSizeEx(priv->file, &size) || size.QuadPart <= 0) {
+		CloseHandle(priv->file);
+		return 0;
+	}
+	priv->file_size = (uint64_t)size.QuadPart;
+#else
+	struct stat st;
+	const int fd = open(fn, O_RDONLY);
+	if (fd < 0)
+		return 0;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return 0;
+	}
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+	priv->fd = fd;
+	priv->file_size = (uint64_t)st.st_size;
+#endif
+	return 1;
+}
+
+static void close_file(pcm_audio_decoder *priv) {
+#ifdef _WIN32
+	CloseHandle(priv->file);
+#else
+	close(priv->fd);
+#endif
+}
+
+/* read up to @a size bytes at @a offset, returns the number of bytes read, which is less than @a size at the end of
+ * the file or on errors. */
+static size_t read_at(pcm_audio_decoder *priv, uint64_t offset, void *buf, size_t size) {
+	size_t done = 0;
+
+	while (done < size) {
+#ifdef _WIN32
+		OVERLAPPED ov;
+		DWORD ret = 0;
+		const DWORD chunk = size - done > 0x40000000 ? 0x40000000 : (DWORD)(size - done);
+		memset(&ov, 0, sizeof(ov));
+		ov.Offset = (DWORD)(offset & 0xffffffff);
+		ov.OffsetHigh = (DWORD)(offset >> 32);
+		if (!ReadFile(priv->file, (uint8_t*)buf + done, chunk, &ret, &ov) || ret == 0)
+			break;
+#else
+		const ssize_t ret = pread(priv->fd, (uint8_t*)buf + done, size - done, (off_t)offset);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			break;
+#endif
+		done += (size_t)ret;
+		offset += (uint64_t)ret;
+	}
+
+	return done;
+}
+
+/* header parsing */
+
+static uint16_t read_u16(const uint8_t *p, int be) {
+	return be ? (uint16_t)((p[0] << 8) | p[1])
+	          : (uint16_t)((p[1] << 8) | p[0]);
+}
+
+static uint32_t read_u32(const uint8_t *p, int be) {
+	return be ? ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]
+	          : ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+/* 80-bit IEEE 754 extended, as used for the AIFF sample rate */
+static double read_extended(const uint8_t *p) {
+	const int exponent = ((p[0] & 0x7f) << 8) | p[1];
+	uint64_t mantissa = 0;
+	int i;
+	for (i = 0; i < 8; ++i)
+		mantissa = (mantissa << 8) | p[2 + i];
+	if (exponent == 0 && mantissa == 0)
+		return 0.0;
+	double value = (double)mantissa;
+	int e = exponent - 16383 - 63;
+	for (; e > 0; --e) value *= 2.0;
+	for (; e < 0; ++e) value /= 2.0;
+	return (p[0] & 0x80) ? -value : value;
+}
+
+static int set_pcm_format(pcm_audio_decoder *priv, int is_float, int bits) {
+	if (is_float) {
+		if (bits == 32) { priv->format = PCM_F32; return 1; }
+		if (bits == 64) { priv->format = PCM_F64; return 1; }
+		return 0;
+	}
+	switch (bits) {
+		case 8:  priv->format = priv->big_endian ? PCM_S8 : PCM_U8; return 1;
+		case 16: priv->format = PCM_S16; return 1;
+		case 24: priv->format = PCM_S24; return 1;
+		case 32: priv->format = PCM_S32; return 1;
+	}
+	return 0;
+}
+
+/* chunk header plus as much of its contents as the parsers need */
+#define PCM_CHUNK_READ_SIZE 48
+
+/* read the header of the chunk at @a off into @a chunk, plus up to @a body_size bytes of its contents */
+static int read_chunk(pcm_audio_decoder *priv, uint64_t off, uint8_t chunk[PCM_CHUNK_READ_SIZE], size_t body_size) {
+	if (body_size > PCM_CHUNK_READ_SIZE - 8)
+		body_size = PCM_CHUNK_READ_SIZE - 8;
+	memset(chunk, 0, PCM_CHUNK_READ_SIZE);
+	return read_at(priv, off, chunk, 8 + body_size) == 8 + body_size;
+}
+
+static int parse_wav(pcm_audio_decoder *priv) {
+	const uint64_t size = priv->file_size;
+	uint8_t chunk[PCM_CHUNK_READ_SIZE];
+	uint64_t off = 12;
+	int has_fmt = 0;
+
+	if (size < 12 || read_at(priv, 0, chunk, 12) != 12 || memcmp(chunk, "RIFF", 4) || memcmp(chunk + 8, "WAVE", 4))
+		return 0;
+
+	priv->big_endian = 0;
+
+	while (off + 8 <= size) {
+		if (!read_chunk(priv, off, chunk, 0))
+			return 0;
+
+		const uint64_t chunk_size = read_u32(chunk + 4, 0);
+		const uint64_t avail = size - off - 8;
+
+		if (!memcmp(chunk, "fmt ", 4)) {
+			if (chunk_size < 16 || chunk_size > avail)
+				return 0;
+			if (!read_chunk(priv, off, chunk, (size_t)chunk_size))
+				return 0;
+			unsigned int tag = read_u16(chunk + 8, 0);
+			const unsigned int block_align = read_u16(chunk + 20, 0);
+			const unsigned int bits = read_u16(chunk + 22, 0);
+			priv->channels = read_u16(chunk + 10, 0);
+			priv->sample_rate = read_u32(chunk + 12, 0);
+
+			/* WAVE_FORMAT_EXTENSIBLE, the sub-format GUID starts with the format tag */
+			if (tag == 0xfffe) {
+				if (chunk_size < 40)
+					return 0;
+				tag = read_u16(chunk + 32, 0);
+			}
+
+			if (tag != 1 && tag != 3)
+				return 0;
+			if (priv->channels == 0 || priv->sample_rate == 0 || block_align != priv->channels * bits / 8)
+				return 0;
+			if (!set_pcm_format(priv, tag == 3, bits))
+				return 0;
+
+			priv->frame_size = block_align;
+			priv->bit_depth = bits;
+			has_fmt = 1;
+		}
+		else if (!memcmp(chunk, "data", 4)) {
+			if (!has_fmt)
+				return 0;
+			/* files being written or over 4GB might have a bogus size, use whatever is there */
+			const uint64_t data_size = chunk_size < avail ? chunk_size : avail;
+			priv->data_offset = off + 8;
+			priv->frames = (int64_t)(data_size / priv->frame_size);
+			return priv->frames > 0;
+		}
+
+		if (chunk_size + (chunk_size & 1) > avail)
+			break;
+
+		off += 8 + chunk_size + (chunk_size & 1);
+	}
+
+	return 0;
+}
+
+static int parse_aiff(pcm_audio_decoder *priv) {
+	const uint64_t size = priv->file_size;
+	uint8_t chunk[PCM_CHUNK_READ_SIZE];
+	uint64_t off = 12;
+	int has_comm = 0, is_aifc;
+
+	if (size < 12 || read_at(priv, 0, chunk, 12) != 12 || memcmp(chunk, "FORM", 4))
+		return 0;
+
+	if (!memcmp(chunk + 8, "AIFF", 4))
+		is_aifc = 0;
+	else if (!memcmp(chunk + 8, "AIFC", 4))
+		is_aifc = 1;
+	else
+		return 0;
+
+	priv->big_endian = 1;
+
+	while (off + 8 <= size) {
+		if (!read_chunk(priv, off, chunk, 0))
+			return 0;
+
+		const uint64_t chunk_size = read_u32(chunk + 4, 1);
+		const uint64_t avail = size - off - 8;
+
+		if (!memcmp(chunk, "COMM", 4)) {
+			if (chunk_size < (is_aifc ? 22u : 18u) || chunk_size > avail)
+				return 0;
+			if (!read_chunk(priv, off, chunk, (size_t)chunk_size))
+				return 0;
+			const unsigned int bits = read_u16(chunk + 14, 1);
+			const double rate = read_extended(chunk + 16);
+			int is_float = 0;
+			priv->channels = read_u16(chunk + 8, 1);
+			priv->frames = read_u32(chunk + 10, 1);
+			priv->sample_rate = rate > 0.0 && rate < 4294967295.0 ? (unsigned int)(rate + 0.5) : 0;
+
+			if (is_aifc) {
+				const uint8_t *const compression = chunk + 26;
+				if (!memcmp(compression, "NONE", 4) || !memcmp(compression, "twos", 4)) {
+				} else if (!memcmp(compression, "sowt", 4)) {
+					priv->big_endian = 0;
+				} else if (!memcmp(compression, "fl32", 4) || !memcmp(compression, "FL32", 4)) {
+					is_float = 1;
+				} else if (!memcmp(compression, "fl64", 4) || !memcmp(compression, "FL64", 4)) {
+					is_float = 1;
+				} else {
+					return 0;
+				}
+			}
+
+			if (priv->channels == 0 || priv->sample_rate == 0 || (bits % 8) != 0)
+				return 0;
+			if (!set_pcm_format(priv, is_float, bits))
+				return 0;
+
+			/* sowt 8-bit data is still signed */
+			if (priv->format == PCM_U8)
+				priv->format = PCM_S8;
+
+			priv->frame_size = priv->channels * bits / 8;
+			priv->bit_depth = bits;
+			has_comm = 1;
+		}
+		else if (!memcmp(chunk, "SSND", 4)) {
+			if (!has_comm || chunk_size < 8 || avail < 8)
+				return 0;
+			if (!read_chunk(priv, off, chunk, 8))
+				return 0;
+			const uint64_t data_offset = read_u32(chunk + 8, 1);
+			const uint64_t data_avail = (chunk_size < avail ? chunk_size : avail) - 8;
+			if (data_offset >= data_avail)
+				return 0;
+			const int64_t avail_frames = (int64_t)((data_avail - data_offset) / priv->frame_size);
+			priv->data_offset = off + 16 + data_offset;
+			if (priv->frames > avail_frames)
+				priv->frames = avail_frames;
+			return priv->frames > 0;
+		}
+
+		if (chunk_size + (chunk_size & 1) > avail)
+			break;
+
+		off += 8 + chunk_size + (chunk_size & 1);
+	}
+
+	return 0;
+}
+
+/* conversion */
+
+static float convert_one(const pcm_audio_decoder *priv, const uint8_t *p) {
+	const int be = priv->big_endian;
+	switch (priv->format) {
+		case PCM_U8:
+			return ((float)p[0] - 128.0f) * (1.0f / 128.0f);
+		case PCM_S8:
+			return (float)(int8_t)p[0] * (1.0f / 128.0f);
+		case PCM_S16:
+			return (float)(int16_t)read_u16(p, be) * (1.0f / 32768.0f);
+		case PCM_S24: {
+			const int32_t v = be ? (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8))
+			                     : (int32_t)(((uint32_t)p[2] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 8));
+			return (float)(v >> 8) * (1.0f / 8388608.0f);
+		}
+		case PCM_S32:
+			return (float)((double)(int32_t)read_u32(p, be) * (1.0 / 2147483648.0));
+		case PCM_F32: {
+			const uint32_t u = read_u32(p, be);
+			float f;
+			memcpy(&f, &u, sizeof(f));
+			return f;
+		}
+		case PCM_F64: {
+			const uint64_t u = be ? ((uint64_t)read_u32(p, 1) << 32) | read_u32(p + 4, 1)
+			                      : ((uint64_t)read_u32(p + 4, 0) << 32) | read_u32(p, 0);
+			double d;
+			memcpy(&d, &u, sizeof(d));
+			return (float)d;
+		}
+	}
+	return 0.0f;
+}
+
+/* convert @a count samples that are @a src_step bytes apart.
+ * the common little-endian formats use plain loops that the compiler can vectorize. */
+static void convert(const pcm_audio_decoder *priv, const uint8_t *src, size_t src_step,
+                    float *dst, size_t count) {
+	size_t i;
+
+	if (!priv->big_endian) {
+		if (priv->format == PCM_S16 && ((uintptr_t)src & 1) == 0 && (src_step & 1) == 0) {
+			const int16_t *s = (const int16_t*) src;
+			const size_t stride = src_step / 2;
+			for (i = 0; i < count; ++i)
+				dst[i] = (float)s[i * stride] * (1.0f / 32768.0f);
+			return;
+		}
+		if (priv->format == PCM_F32 && ((uintptr_t)src & 3) == 0 && (src_step & 3) == 0) {
+			const float *s = (const float*) src;
+			const size_t stride = src_step / 4;
+			if (stride == 1) {
+				memcpy(dst, s, count * sizeof(float));
+				return;
+			}
+			for (i = 0; i < count; ++i)
+				dst[i] = s[i * stride];
+			return;
+		}
+		if (priv->format == PCM_S24) {
+			for (i = 0; i < count; ++i) {
+				const uint8_t *p = src + i * src_step;
+				const int32_t v = (int32_t)(((uint32_t)p[2] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 8));
+				dst[i] = (float)(v >> 8) * (1.0f / 8388608.0f);
+			}
+			return;
+		}
+	}
+
+	for (i = 0; i < count; ++i)
+		dst[i] = convert_one(priv, src + i * src_step);
+}
+
+/* read up to @a frames frames at the current position into the conversion buffer, at most one block at a time.
+ * returns the number of frames read, a short read means the file got truncated and the stream then ends there. */
+static size_t read_frames(pcm_audio_decoder *priv, size_t frames) {
+	const size_t block_frames = PCM_READ_BLOCK_SIZE > priv->frame_size ? PCM_READ_BLOCK_SIZE / priv->frame_size : 1;
+	if (frames > block_frames)
+		frames = block_frames;
+	if ((int64_t)frames > priv->frames - priv->pos)
+		frames = (size_t)(priv->frames - priv->pos);
+	if (frames == 0)
+		return 0;
+
+	const size_t size = frames * priv->frame_size;
+
+	if (priv->buffer_size < size) {
+		uint8_t *const buffer = (uint8_t*) realloc(priv->buffer, size);
+		if (!buffer)
+			return 0;
+		priv->buffer = buffer;
+		priv->buffer_size = size;
+	}
+
+	const size_t done = read_at(priv, priv->data_offset + (uint64_t)priv->pos * priv->frame_size, priv->buffer, size);
+
+	if (done != size) {
+		const int64_t end = priv->pos + (int64_t)(done / priv->frame_size);
+		dbg(1, "short read, file was likely truncated, stopping at frame %lld", (long long)end);
+		priv->frames = end;
+		frames = done / priv->frame_size;
+	}
+
+	return frames;
+}
+
+/* backend api */
+
+static int ad_info_pcm(void *sf, struct adinfo *nfo) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) sf;
+	if (!priv) return -1;
+	if (nfo) {
+		nfo->channels    = priv->channels;
+		nfo->frames      = priv->frames;
+		nfo->sample_rate = priv->sample_rate;
+		nfo->length      = (priv->frames * 1000) / priv->sample_rate;
+		nfo->bit_depth   = priv->bit_depth;
+		nfo->bit_rate    = priv->bit_depth * priv->channels * priv->sample_rate;
+		nfo->meta_data   = NULL;
+		nfo->can_seek    = 1;
+	}
+	return 0;
+}
+
+static void *ad_open_pcm(const char *fn, struct adinfo *nfo) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) calloc(1, sizeof(pcm_audio_decoder));
+	if (!priv)
+		return NULL;
+	if (!open_file(priv, fn)) {
+		free(priv);
+		return NULL;
+	}
+	if (!parse_wav(priv) && !parse_aiff(priv)) {
+		dbg(1, "'%s' is not uncompressed PCM, leaving it to other decoders", fn);
+		close_file(priv);
+		free(priv);
+		return NULL;
+	}
+	ad_info_pcm(priv, nfo);
+	return (void*) priv;
+}
+
+static int ad_close_pcm(void *sf) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) sf;
+	if (!priv) return -1;
+	close_file(priv);
+	free(priv->buffer);
+	free(priv);
+	return 0;
+}
+
+static int64_t ad_seek_pcm(void *sf, int64_t pos) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) sf;
+	if (!priv) return -1;
+	if (pos < 0) pos = 0;
+	if (pos > priv->frames) pos = priv->frames;
+	priv->pos = pos;
+	return pos;
+}
+
+static ssize_t ad_read_pcm(void *sf, float* d, size_t len) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) sf;
+	if (!priv) return -1;
+	const size_t sample_size = priv->frame_size / priv->channels;
+	size_t remaining = len / priv->channels, samples = 0;
+	while (remaining != 0) {
+		const size_t frames = read_frames(priv, remaining);
+		if (frames == 0)
+			break;
+		convert(priv, priv->buffer, sample_size, d + samples, frames * priv->channels);
+		priv->pos += frames;
+		samples += frames * priv->channels;
+		remaining -= frames;
+	}
+	return (ssize_t)samples;
+}
+
+static ssize_t ad_read_planar_pcm(void *sf, float** d, size_t frames) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) sf;
+	if (!priv) return -1;
+	const size_t sample_size = priv->frame_size / priv->channels;
+	size_t done = 0;
+	unsigned int c;
+	while (done < frames) {
+		const size_t remaining = frames - done;
+		const size_t count = read_frames(priv, remaining);
+		if (count == 0)
+			break;
+		/* one channel at a time, straight into each output buffer */
+		for (c = 0; c < priv->channels; ++c)
+			convert(priv, priv->buffer + c * sample_size, priv->frame_size, d[c] + done, count);
+		priv->pos += count;
+		done += count;
+	}
+	return (ssize_t)done;
+}
+
+static int ad_get_bitrate_pcm(void *sf) {
+	pcm_audio_decoder *priv = (pcm_audio_decoder*) sf;
+	if (!priv) return -1;
+	return priv->bit_depth * priv->channels * priv->sample_rate;
+}
+
+static int ad_eval_pcm(const char *f) {
+	char *ext = strrchr(f, '.');
+	if (strstr (f, "://")) return 0;
+	if (!ext) return 0;
+	if (!strcasecmp(ext, ".wav")) return 100;
+	if (!strcasecmp(ext, ".wave")) return 100;
+	if (!strcasecmp(ext, ".bwf")) return 100;
+	if (!strcasecmp(ext, ".aif")) return 100;
+	if (!strcasecmp(ext, ".aiff")) return 100;
+	if (!strcasecmp(ext, ".aifc")) return 100;
+	return 0;
+}
+
+static const ad_plugin ad_pcm = {
+	&ad_eval_pcm,
+	&ad_open_pcm,
+	&ad_close_pcm,
+	&ad_info_pcm,
+	&ad_seek_pcm,
+	&ad_read_pcm,
+	&ad_get_bitrate_pcm,
+	&ad_read_planar_pcm
+};
+
+/* dlopen handler */
+const ad_plugin * adp_get_pcm() {
+	return &ad_pcm;
+}
@@ -41,6 +41,7 @@ int     ad_bitrate_null(void *x) { UNUSED(x); return -1;}
 typedef struct {
 	ad_plugin const *b; ///< decoder back-end
 	void *d; ///< backend data
+	unsigned int channels; ///< for ad_read_planar()
 } adecoder;
 
 /* samplecat api */
@@ -73,6 +74,17 @@ void *ad_open(const char *fn, struct adinfo *nfo) {
 	adecoder *d = (adecoder*) calloc(1, sizeof(adecoder));
 	ad_clear_nfo(nfo);
 
+	// uncompressed files are converted by our own reader, if their encoding is supported
+	if (adp_get_pcm()->eval(fn) > 0) {
+		d->d = adp_get_pcm()->open(fn, nfo);
+		if (d->d) {
+			d->b = adp_get_pcm();
+			d->channels = nfo->channels;
+			return (void*)d;
+		}
+		ad_clear_nfo(nfo);
+	}
+
 	d->b = choose_backend(fn);
 	if (!d->b) {
 		dbg(0, "fatal: no decoder backend available");
@@ -84,6 +96,7 @@ void *ad_open(const char *fn, struct adinfo *nfo) {
 		free(d);
 		return NULL;
 	}
+	d->channels = nfo->channels;
 	return (void*)d;
 }
 
@@ -113,6 +126,37 @@ ssize_t ad_read(void *sf, float* out, size_t len){
 	return d->b->read(d->d, out, len);
 }
 
+ssize_t ad_read_planar(void *sf, float** out, size_t frames) {
+	adecoder *d = (adecoder*) sf;
+	if (!d) return -1;
+	if (d->b->read_planar)
+		return d->b->read_planar(d->d, out, frames);
+
+	/* deinterleave through a small buffer */
+	float buf[4096];
+	const unsigned int chn = d->channels;
+	const size_t buf_frames = chn ? sizeof(buf) / sizeof(float) / chn : 0;
+	size_t done = 0;
+	unsigned int c;
+	if (buf_frames == 0) return -1;
+
+	while (done < frames) {
+		const size_t todo = frames - done < buf_frames ? frames - done : buf_frames;
+		const ssize_t r = d->b->read(d->d, buf, todo * chn);
+		if (r < 0) return done ? (ssize_t)done : -1;
+		const size_t rframes = (size_t)r / chn;
+		for (c = 0; c < chn; ++c) {
+			float *const dst = out[c] + done;
+			size_t f;
+			for (f = 0; f < rframes; ++f)
+				dst[f] = buf[f * chn + c];
+		}
+		done += rframes;
+		if (rframes == 0) break;
+	}
+	return (ssize_t)done;
+}
+
 int ad_get_bitrate(void *sf) {
 	adecoder *d = (adecoder*) sf;
 	if (!d) return -1;
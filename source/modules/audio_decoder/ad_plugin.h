@@ -52,6 +52,7 @@ typedef struct {
 	int64_t (*seek)(void *, int64_t);
 	ssize_t (*read)(void *, float *, size_t);
 	int     (*bitrate)(void *);
+	ssize_t (*read_planar)(void *, float **, size_t); ///< optional, NULL to deinterleave ad_read() data
 } ad_plugin;
 
 int     ad_eval_null(const char *);
@@ -63,6 +64,7 @@ ssize_t ad_read_null(void *, float*, size_t);
 int     ad_bitrate_null(void *);
 
 /* hardcoded backends */
+const ad_plugin * adp_get_pcm();
 const ad_plugin * adp_get_sndfile();
 const ad_plugin * adp_get_dr_mp3();
 const ad_plugin * adp_get_minimp3();
@@ -155,7 +155,8 @@ static const ad_plugin ad_sndfile = {
 	&ad_info_sndfile,
 	&ad_seek_sndfile,
 	&ad_read_sndfile,
-	&ad_get_bitrate_sndfile
+	&ad_get_bitrate_sndfile,
+	NULL
 #else
 	&ad_eval_null,
 	&ad_open_null,
@@ -163,7 +164,8 @@ static const ad_plugin ad_sndfile = {
 	&ad_info_null,
 	&ad_seek_null,
 	&ad_read_null,
-	&ad_bitrate_null
+	&ad_bitrate_null,
+	NULL
 #endif
 };
 
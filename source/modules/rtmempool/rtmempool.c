@@ -1,7 +1,7 @@
 /*
  * RealTime Memory Pool, heavily based on work by Nedko Arnaudov
  * Copyright (C) 2006-2009 Nedko Arnaudov <nedko@arnaudov.name>
- * Copyright (C) 2013-2016 Filipe Coelho <falktx@falktx.com>
+ * Copyright (C) 2013-2023 Filipe Coelho <falktx@falktx.com>
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License as
@@ -16,32 +16,134 @@
  * For a full copy of the GNU General Public License see the GPL.txt file
  */
 
-#include "list.h"
 #include "rtmempool.h"
 #include "rtmempool-lv2.h"
 
 #include <assert.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define RTMEMPOOL_THREAD_SAFETY 0
-
-#if RTMEMPOOL_THREAD_SAFETY
-#define rtmempool_mutex_lock(m) pthread_mutex_lock(m)
-#define rtmempool_mutex_unlock(m) pthread_mutex_unlock(m)
+#ifdef _MSC_VER
+# include <intrin.h>
+# include <time.h>
 #else
-#define rtmempool_mutex_lock(...)
-#define rtmempool_mutex_unlock(...)
+# include <sys/time.h>
 #endif
 
 // ------------------------------------------------------------------------------------------------
+// Free nodes are kept in a lock-free stack (Treiber stack), so that the RT side never takes a lock.
+// The stack head packs a tag and a node index into 64 bits, the tag changes on every push and pop
+// which protects against ABA. Node memory is only released when the pool is destroyed.
+//
+// Growing the pool (malloc) only happens in non-RT context, either from allocate_sleepy or from a
+// shared background thread that keeps pools filled up to their minPreallocated count.
+
+// max nodes per pool, and nodes per chunk of the index table
+#define RTMEMPOOL_MAX_NODES   (1U << 20)
+#define RTMEMPOOL_CHUNK_SHIFT 10
+#define RTMEMPOOL_CHUNK_SIZE  (1U << RTMEMPOOL_CHUNK_SHIFT)
+#define RTMEMPOOL_CHUNK_COUNT (RTMEMPOOL_MAX_NODES / RTMEMPOOL_CHUNK_SIZE)
+
+// how often the refill thread checks pools, in milliseconds
+#define RTMEMPOOL_REFILL_INTERVAL 50
+
+// ------------------------------------------------------------------------------------------------
+// atomics
+
+#ifdef _MSC_VER
+static inline uint32_t rtmempool_load32(volatile uint32_t* ptr)
+{
+    return (uint32_t)_InterlockedOr((volatile long*)ptr, 0);
+}
+
+static inline void rtmempool_store32(volatile uint32_t* ptr, uint32_t value)
+{
+    _InterlockedExchange((volatile long*)ptr, (long)value);
+}
+
+static inline void rtmempool_add32(volatile uint32_t* ptr, int32_t value)
+{
+    _InterlockedExchangeAdd((volatile long*)ptr, value);
+}
+
+static inline uint32_t rtmempool_load32_relaxed(volatile uint32_t* ptr)
+{
+    return *ptr;
+}
 
-typedef struct list_head k_list_head;
+static inline void rtmempool_store32_relaxed(volatile uint32_t* ptr, uint32_t value)
+{
+    *ptr = value;
+}
+
+static inline uint64_t rtmempool_load64(volatile uint64_t* ptr)
+{
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)ptr, 0, 0);
+}
+
+static inline bool rtmempool_cas64(volatile uint64_t* ptr, uint64_t* expected, uint64_t desired)
+{
+    const uint64_t old = (uint64_t)_InterlockedCompareExchange64((volatile __int64*)ptr,
+                                                                  (__int64)desired, (__int64)*expected);
+    if (old == *expected)
+        return true;
+
+    *expected = old;
+    return false;
+}
+#else
+static inline uint32_t rtmempool_load32(volatile uint32_t* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void rtmempool_store32(volatile uint32_t* ptr, uint32_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline void rtmempool_add32(volatile uint32_t* ptr, int32_t value)
+{
+    __atomic_add_fetch(ptr, (uint32_t)value, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t rtmempool_load32_relaxed(volatile uint32_t* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+static inline void rtmempool_store32_relaxed(volatile uint32_t* ptr, uint32_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t rtmempool_load64(volatile uint64_t* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline bool rtmempool_cas64(volatile uint64_t* ptr, uint64_t* expected, uint64_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+#endif
 
 // ------------------------------------------------------------------------------------------------
 
+// same size as the old list header, so that data alignment does not change
+typedef union _RtMemPoolNode
+{
+    struct {
+        uint32_t index; // own index into the pool table
+        volatile uint32_t next; // next free node index + 1, 0 for none
+    } s;
+    void* align[2];
+
+} RtMemPoolNode;
+
 typedef struct _RtMemPool
 {
     char name[RTSAFE_MEMORY_POOL_NAME_MAX];
@@ -50,63 +152,236 @@ typedef struct _RtMemPool
     size_t minPreallocated;
     size_t maxPreallocated;
 
-    k_list_head used;
-    unsigned int usedCount;
+    // index table, chunks are only added by non-RT code and never removed
+    RtMemPoolNode** chunks[RTMEMPOOL_CHUNK_COUNT];
+    volatile uint32_t nodeCount;
 
-    k_list_head unused;
-    unsigned int unusedCount;
+    // free stack head, tag << 32 | (index + 1)
+    volatile uint64_t freeHead;
+    volatile uint32_t unusedCount;
 
+    // serializes growing, never taken by RT calls
     pthread_mutex_t mutex;
 
+    // refill thread registration
+    struct _RtMemPool* nextRegistered;
+    bool registered;
+
 } RtMemPool;
 
 // ------------------------------------------------------------------------------------------------
-// adjust unused list size
 
-static void rtsafe_memory_pool_sleepy(RtMemPool* poolPtr, bool* overMaxOrMallocFailed)
+static inline RtMemPoolNode* rtsafe_memory_pool_get_node(RtMemPool* poolPtr, uint32_t index)
 {
-    k_list_head* nodePtr;
-    k_list_head unused;
-    unsigned int unusedCount;
+    return poolPtr->chunks[index >> RTMEMPOOL_CHUNK_SHIFT][index & (RTMEMPOOL_CHUNK_SIZE - 1)];
+}
+
+static void rtsafe_memory_pool_push(RtMemPool* poolPtr, RtMemPoolNode* nodePtr)
+{
+    uint64_t head = rtmempool_load64(&poolPtr->freeHead);
+    uint64_t newHead;
+
+    do {
+        rtmempool_store32_relaxed(&nodePtr->s.next, (uint32_t)(head & 0xffffffff));
+        newHead = (((head >> 32) + 1) << 32) | (uint64_t)(nodePtr->s.index + 1);
+    }
+    while (! rtmempool_cas64(&poolPtr->freeHead, &head, newHead));
+
+    rtmempool_add32(&poolPtr->unusedCount, 1);
+}
+
+static RtMemPoolNode* rtsafe_memory_pool_pop(RtMemPool* poolPtr)
+{
+    uint64_t head = rtmempool_load64(&poolPtr->freeHead);
+    uint64_t newHead;
+    uint32_t index;
+    RtMemPoolNode* nodePtr;
+
+    do {
+        index = (uint32_t)(head & 0xffffffff);
+
+        if (index == 0)
+            return NULL;
+
+        // the node might have been taken meanwhile, then the tag changed and the exchange fails
+        nodePtr = rtsafe_memory_pool_get_node(poolPtr, index - 1);
+        newHead = (((head >> 32) + 1) << 32) | (uint64_t)rtmempool_load32_relaxed(&nodePtr->s.next);
+    }
+    while (! rtmempool_cas64(&poolPtr->freeHead, &head, newHead));
+
+    rtmempool_add32(&poolPtr->unusedCount, -1);
+    return nodePtr;
+}
 
-    INIT_LIST_HEAD(&unused);
-    unusedCount = 0;
+// ------------------------------------------------------------------------------------------------
+// add new nodes until there are at least `unusedTarget` unused ones, must be called with the pool mutex held
+// returns false if nothing could be added
+
+static bool rtsafe_memory_pool_grow(RtMemPool* poolPtr, size_t unusedTarget)
+{
+    RtMemPoolNode* nodePtr;
+    uint32_t index;
+    bool added = false;
 
-    while (poolPtr->unusedCount + unusedCount < poolPtr->minPreallocated)
+    while (rtmempool_load32(&poolPtr->unusedCount) < unusedTarget)
     {
-        if (poolPtr->usedCount + poolPtr->unusedCount + unusedCount >= poolPtr->maxPreallocated)
-        {
-            *overMaxOrMallocFailed = true;
+        index = poolPtr->nodeCount;
+
+        if (index >= poolPtr->maxPreallocated)
             break;
+
+        if (poolPtr->chunks[index >> RTMEMPOOL_CHUNK_SHIFT] == NULL)
+        {
+            RtMemPoolNode** const chunk = calloc(RTMEMPOOL_CHUNK_SIZE, sizeof(RtMemPoolNode*));
+
+            if (chunk == NULL)
+                break;
+
+            poolPtr->chunks[index >> RTMEMPOOL_CHUNK_SHIFT] = chunk;
         }
 
-        nodePtr = malloc(sizeof(k_list_head) + poolPtr->dataSize);
+        nodePtr = malloc(sizeof(RtMemPoolNode) + poolPtr->dataSize);
 
         if (nodePtr == NULL)
-        {
-            *overMaxOrMallocFailed = true;
             break;
+
+        nodePtr->s.index = index;
+        nodePtr->s.next = 0;
+        poolPtr->chunks[index >> RTMEMPOOL_CHUNK_SHIFT][index & (RTMEMPOOL_CHUNK_SIZE - 1)] = nodePtr;
+        rtmempool_store32(&poolPtr->nodeCount, index + 1);
+
+        rtsafe_memory_pool_push(poolPtr, nodePtr);
+        added = true;
+    }
+
+    return added;
+}
+
+static bool rtsafe_memory_pool_needs_refill(RtMemPool* poolPtr)
+{
+    return rtmempool_load32(&poolPtr->unusedCount) < poolPtr->minPreallocated &&
+           rtmempool_load32(&poolPtr->nodeCount) < poolPtr->maxPreallocated;
+}
+
+// ------------------------------------------------------------------------------------------------
+// background refill thread, shared by all pools
+// lock order is thread mutex, then registry mutex, then pool mutex
+
+static pthread_mutex_t gRefillThreadMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t gRegistryMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gRegistryCond = PTHREAD_COND_INITIALIZER;
+static RtMemPool* gRegisteredPools = NULL;
+static pthread_t gRefillThread;
+static bool gRefillThreadRunning = false;
+
+static void rtsafe_memory_pool_get_wait_time(struct timespec* ts)
+{
+#ifdef _MSC_VER
+    timespec_get(ts, TIME_UTC);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    ts->tv_sec = tv.tv_sec;
+    ts->tv_nsec = tv.tv_usec * 1000;
+#endif
+
+    ts->tv_nsec += RTMEMPOOL_REFILL_INTERVAL * 1000000L;
+
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void* rtsafe_memory_pool_refill_thread(void* arg)
+{
+    RtMemPool* poolPtr;
+    struct timespec ts;
+
+    pthread_mutex_lock(&gRegistryMutex);
+
+    while (gRefillThreadRunning)
+    {
+        for (poolPtr = gRegisteredPools; poolPtr != NULL; poolPtr = poolPtr->nextRegistered)
+        {
+            if (! rtsafe_memory_pool_needs_refill(poolPtr))
+                continue;
+
+            pthread_mutex_lock(&poolPtr->mutex);
+            rtsafe_memory_pool_grow(poolPtr, poolPtr->minPreallocated);
+            pthread_mutex_unlock(&poolPtr->mutex);
         }
 
-        list_add_tail(nodePtr, &unused);
-        ++unusedCount;
+        rtsafe_memory_pool_get_wait_time(&ts);
+        pthread_cond_timedwait(&gRegistryCond, &gRegistryMutex, &ts);
+    }
+
+    pthread_mutex_unlock(&gRegistryMutex);
+
+    return NULL;
+
+    // unused
+    (void)arg;
+}
+
+static void rtsafe_memory_pool_register(RtMemPool* poolPtr)
+{
+    pthread_mutex_lock(&gRefillThreadMutex);
+    pthread_mutex_lock(&gRegistryMutex);
+
+    poolPtr->nextRegistered = gRegisteredPools;
+    gRegisteredPools = poolPtr;
+    poolPtr->registered = true;
+
+    if (! gRefillThreadRunning)
+    {
+        gRefillThreadRunning = true;
+
+        if (pthread_create(&gRefillThread, NULL, rtsafe_memory_pool_refill_thread, NULL) != 0)
+        {
+            // pools keep working, they just only grow from allocate_sleepy
+            fprintf(stderr, "warning: rtsafe_memory_pool failed to create refill thread\n");
+            gRefillThreadRunning = false;
+        }
     }
 
-    rtmempool_mutex_lock(&poolPtr->mutex);
+    pthread_mutex_unlock(&gRegistryMutex);
+    pthread_mutex_unlock(&gRefillThreadMutex);
+}
 
-    poolPtr->unusedCount += unusedCount;
+static void rtsafe_memory_pool_unregister(RtMemPool* poolPtr)
+{
+    RtMemPool** poolPtrPtr;
+    bool stopThread = false;
 
-    while (unusedCount != 0)
+    pthread_mutex_lock(&gRefillThreadMutex);
+    pthread_mutex_lock(&gRegistryMutex);
+
+    for (poolPtrPtr = &gRegisteredPools; *poolPtrPtr != NULL; poolPtrPtr = &(*poolPtrPtr)->nextRegistered)
     {
-        assert(! list_empty(&unused));
+        if (*poolPtrPtr == poolPtr)
+        {
+            *poolPtrPtr = poolPtr->nextRegistered;
+            break;
+        }
+    }
 
-        nodePtr = unused.next;
-        list_del(nodePtr);
-        list_add_tail(nodePtr, &poolPtr->unused);
-        --unusedCount;
+    poolPtr->registered = false;
+
+    if (gRegisteredPools == NULL && gRefillThreadRunning)
+    {
+        gRefillThreadRunning = false;
+        pthread_cond_signal(&gRegistryCond);
+        stopThread = true;
     }
 
-    rtmempool_mutex_unlock(&poolPtr->mutex);
+    pthread_mutex_unlock(&gRegistryMutex);
+
+    if (stopThread)
+        pthread_join(gRefillThread, NULL);
+
+    pthread_mutex_unlock(&gRefillThreadMutex);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -120,10 +395,9 @@ static bool rtsafe_memory_pool_create2(RtMemPool_Handle* handlePtr,
     assert(minPreallocated <= maxPreallocated);
     assert(poolName == NULL || strlen(poolName) < RTSAFE_MEMORY_POOL_NAME_MAX);
 
-    k_list_head* nodePtr;
     RtMemPool* poolPtr;
 
-    poolPtr = malloc(sizeof(RtMemPool));
+    poolPtr = calloc(1, sizeof(RtMemPool));
 
     if (poolPtr == NULL)
     {
@@ -139,35 +413,28 @@ static bool rtsafe_memory_pool_create2(RtMemPool_Handle* handlePtr,
         sprintf(poolPtr->name, "%p", poolPtr);
     }
 
+    if (maxPreallocated > RTMEMPOOL_MAX_NODES)
+    {
+        maxPreallocated = RTMEMPOOL_MAX_NODES;
+    }
+
+    if (minPreallocated > maxPreallocated)
+    {
+        minPreallocated = maxPreallocated;
+    }
+
     poolPtr->dataSize = dataSize;
     poolPtr->minPreallocated = minPreallocated;
     poolPtr->maxPreallocated = maxPreallocated;
 
-    INIT_LIST_HEAD(&poolPtr->used);
-    poolPtr->usedCount = 0;
+    pthread_mutex_init(&poolPtr->mutex, NULL);
 
-    INIT_LIST_HEAD(&poolPtr->unused);
-    poolPtr->unusedCount = 0;
+    rtsafe_memory_pool_grow(poolPtr, poolPtr->minPreallocated);
 
-    pthread_mutexattr_t atts;
-    pthread_mutexattr_init(&atts);
-#ifdef __ARM_ARCH_7A__
-    pthread_mutexattr_setprotocol(&atts, PTHREAD_PRIO_INHERIT);
-#endif
-    pthread_mutex_init(&poolPtr->mutex, &atts);
-    pthread_mutexattr_destroy(&atts);
-
-    while (poolPtr->unusedCount < poolPtr->minPreallocated)
+    // only pools which can grow in the background need the refill thread
+    if (minPreallocated != 0 && minPreallocated < maxPreallocated)
     {
-        nodePtr = malloc(sizeof(k_list_head) + poolPtr->dataSize);
-
-        if (nodePtr == NULL)
-        {
-            break;
-        }
-
-        list_add_tail(nodePtr, &poolPtr->unused);
-        poolPtr->unusedCount++;
+        rtsafe_memory_pool_register(poolPtr);
     }
 
     *handlePtr = (RtMemPool_Handle)poolPtr;
@@ -203,28 +470,31 @@ void rtsafe_memory_pool_destroy(RtMemPool_Handle handle)
 {
     assert(handle);
 
-    k_list_head* nodePtr;
     RtMemPool* poolPtr = (RtMemPool*)handle;
+    RtMemPoolNode* nodePtr;
+    uint32_t i;
+
+    if (poolPtr->registered)
+    {
+        rtsafe_memory_pool_unregister(poolPtr);
+    }
 
     // caller should deallocate all chunks prior releasing pool itself
-    if (poolPtr->usedCount != 0)
+    if (rtmempool_load32(&poolPtr->unusedCount) != rtmempool_load32(&poolPtr->nodeCount))
     {
         fprintf(stderr, "warning: rtsafe_memory_pool_destroy called with nodes still active\n");
     }
 
-    while (poolPtr->unusedCount != 0)
+    // only free nodes are released, nodes still in use are leaked so they stay valid for their owners
+    while ((nodePtr = rtsafe_memory_pool_pop(poolPtr)) != NULL)
     {
-        assert(! list_empty(&poolPtr->unused));
-
-        nodePtr = poolPtr->unused.next;
-
-        list_del(nodePtr);
-        poolPtr->unusedCount--;
-
         free(nodePtr);
     }
 
-    assert(list_empty(&poolPtr->unused));
+    for (i = 0; i < RTMEMPOOL_CHUNK_COUNT && poolPtr->chunks[i] != NULL; ++i)
+    {
+        free(poolPtr->chunks[i]);
+    }
 
     pthread_mutex_destroy(&poolPtr->mutex);
 
@@ -232,33 +502,20 @@ void rtsafe_memory_pool_destroy(RtMemPool_Handle handle)
 }
 
 // ------------------------------------------------------------------------------------------------
-// find entry in unused list, fail if it is empty
+// take a node from the free stack, fail if it is empty
 
 void* rtsafe_memory_pool_allocate_atomic(RtMemPool_Handle handle)
 {
     assert(handle);
 
-    k_list_head* nodePtr;
     RtMemPool* poolPtr = (RtMemPool*)handle;
+    RtMemPoolNode* nodePtr = rtsafe_memory_pool_pop(poolPtr);
 
-    rtmempool_mutex_lock(&poolPtr->mutex);
-
-    if (list_empty(&poolPtr->unused))
+    if (nodePtr == NULL)
     {
-        rtmempool_mutex_unlock(&poolPtr->mutex);
         return NULL;
     }
 
-    nodePtr = poolPtr->unused.next;
-    list_del(nodePtr);
-
-    poolPtr->unusedCount--;
-    poolPtr->usedCount++;
-
-    list_add_tail(nodePtr, &poolPtr->used);
-
-    rtmempool_mutex_unlock(&poolPtr->mutex);
-
     return (nodePtr + 1);
 }
 
@@ -268,36 +525,38 @@ void* rtsafe_memory_pool_allocate_sleepy(RtMemPool_Handle handle)
 {
     assert(handle);
 
-    void* data;
-    bool overMaxOrMallocFailed = false;
     RtMemPool* poolPtr = (RtMemPool*)handle;
+    RtMemPoolNode* nodePtr;
+    bool added;
 
-    do {
-        rtsafe_memory_pool_sleepy(poolPtr, &overMaxOrMallocFailed);
-        data = rtsafe_memory_pool_allocate_atomic((RtMemPool_Handle)poolPtr);
-    }
-    while (data == NULL && ! overMaxOrMallocFailed);
+    for (;;)
+    {
+        if ((nodePtr = rtsafe_memory_pool_pop(poolPtr)) != NULL)
+        {
+            return (nodePtr + 1);
+        }
+
+        pthread_mutex_lock(&poolPtr->mutex);
+        added = rtsafe_memory_pool_grow(poolPtr, poolPtr->minPreallocated != 0 ? poolPtr->minPreallocated : 1);
+        pthread_mutex_unlock(&poolPtr->mutex);
 
-    return data;
+        // over max or malloc failed, try once more in case a node was returned meanwhile
+        if (! added)
+        {
+            nodePtr = rtsafe_memory_pool_pop(poolPtr);
+            return nodePtr != NULL ? (nodePtr + 1) : NULL;
+        }
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
-// move from used to unused list
+// put node back into the free stack
 
 void rtsafe_memory_pool_deallocate(RtMemPool_Handle handle, void* memoryPtr)
 {
     assert(handle);
 
-    RtMemPool* poolPtr = (RtMemPool*)handle;
-
-    rtmempool_mutex_lock(&poolPtr->mutex);
-
-    list_del((k_list_head*)memoryPtr - 1);
-    list_add_tail((k_list_head*)memoryPtr - 1, &poolPtr->unused);
-    poolPtr->usedCount--;
-    poolPtr->unusedCount++;
-
-    rtmempool_mutex_unlock(&poolPtr->mutex);
+    rtsafe_memory_pool_push((RtMemPool*)handle, (RtMemPoolNode*)memoryPtr - 1);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 #include "SFZSample.h"
 #include "SFZDebug.h"
+#include "SFZStream.h"
 
 #if 0
 #include "water/audioformat/AudioFormatManager.h"
@@ -21,7 +22,7 @@ extern "C" {
 namespace sfzero
 {
 
-bool Sample::load()
+bool Sample::load(int preloadFrames)
 {
 #if 0
     static water::AudioFormatManager afm;
@@ -71,11 +72,21 @@ bool Sample::load()
     }
 
     sampleRate_ = info.sample_rate;
-    sampleLength_ = info.frames/info.channels;
+    sampleLength_ = info.frames;
     // TODO loopStart_, loopEnd_
 
+    // Only keep the start of long samples in memory, streaming is not worth it for short ones.
+    preloadedLength_ = sampleLength_;
+
+    if (preloadFrames > 0 && sampleLength_ > static_cast<water::uint64>(preloadFrames + kStreamRingFrames)
+        && info.channels <= 2)
+    {
+        preloadedLength_ = preloadFrames;
+    }
+
     // read interleaved buffer
-    float* const rbuffer = (float*)std::calloc(1, sizeof(float)*info.frames);
+    const int64_t samplesToRead = static_cast<int64_t>(preloadedLength_) * info.channels;
+    float* const rbuffer = (float*)std::calloc(1, sizeof(float)*samplesToRead);
 
     if (rbuffer == nullptr)
     {
@@ -84,15 +95,12 @@ bool Sample::load()
         return false;
     }
 
-    // Fix for misinformation using libsndfile
-    if (info.frames % info.channels)
-        --info.frames;
-
-    const ssize_t r = ad_read(handle, rbuffer, info.frames);
-    if (r != info.frames)
+    const ssize_t r = ad_read(handle, rbuffer, samplesToRead);
+    if (r != samplesToRead)
     {
         if (r != 0)
-            carla_stderr2("sfzero::Sample::load() - failed to read complete file: " P_SSIZE " vs " P_INT64, r, info.frames);
+            carla_stderr2("sfzero::Sample::load() - failed to read complete file: " P_SSIZE " vs " P_INT64, r, samplesToRead);
+        std::free(rbuffer);
         ad_close(handle);
         return false;
     }
@@ -100,7 +108,7 @@ bool Sample::load()
     // NOTE: We add some extra samples, which will be filled with zeros,
     // so interpolation can be done without having to check for the edge all the time.
 
-    buffer_ = new water::AudioSampleBuffer(info.channels, sampleLength_ + 4, true);
+    buffer_ = new water::AudioSampleBuffer(info.channels, preloadedLength_ + 4, true);
 
     for (int i=info.channels; --i >= 0;)
         buffer_->copyFromInterleavedSource(i, rbuffer, r);
@@ -119,7 +127,7 @@ water::String Sample::getShortName() { return (file_.getFileName()); }
 void Sample::setBuffer(water::AudioSampleBuffer *newBuffer)
 {
   buffer_ = newBuffer;
-  sampleLength_ = buffer_->getNumSamples();
+  sampleLength_ = preloadedLength_ = buffer_->getNumSamples();
 }
 
 water::AudioSampleBuffer *Sample::detachBuffer()
@@ -20,10 +20,13 @@ namespace sfzero
 class Sample
 {
 public:
-  explicit Sample(const water::File &fileIn) : file_(fileIn), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0) {}
+  explicit Sample(const water::File &fileIn) : file_(fileIn), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0), preloadedLength_(0) {}
   virtual ~Sample();
 
-  bool load();
+  // Load the sample into memory.
+  // If preloadFrames is not 0 and the sample is long enough, only that many frames are loaded and
+  // the rest is meant to be streamed from disk.
+  bool load(int preloadFrames = 0);
 
   water::File getFile() { return (file_); }
   water::AudioSampleBuffer *getBuffer() { return (buffer_); }
@@ -35,6 +38,8 @@ public:
   water::uint64 getSampleLength() const { return sampleLength_; }
   water::uint64 getLoopStart() const { return loopStart_; }
   water::uint64 getLoopEnd() const { return loopEnd_; }
+  bool isStreamed() const { return preloadedLength_ < sampleLength_; }
+  water::uint64 getPreloadedLength() const { return preloadedLength_; }
 
 #ifdef DEBUG
   void checkIfZeroed(const char *where);
@@ -45,6 +50,7 @@ private:
   CarlaScopedPointer<water::AudioSampleBuffer> buffer_;
   double sampleRate_;
   water::uint64 sampleLength_, loopStart_, loopEnd_;
+  water::uint64 preloadedLength_;
 
   CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sample)
 };
@@ -82,13 +82,24 @@ void Sound::loadRegions()
   reader.read(file_);
 }
 
-void Sound::loadSamples(const LoadingIdleCallback& cb)
+void Sound::loadSamples(const LoadingIdleCallback& cb, int preloadFrames)
 {
+    // Looping needs random access to the sample data, so looped samples are always fully loaded.
+    water::Array<Sample *> loopedSamples;
+
+    for (int i = 0; i < regions_.size(); ++i)
+    {
+        const Region *region = regions_[i];
+
+        if (region->loop_mode == Region::loop_continuous || region->loop_mode == Region::loop_sustain)
+            loopedSamples.addIfNotAlreadyThere(region->sample);
+    }
+
     for (water::HashMap<water::String, Sample *>::Iterator i(samples_); i.next();)
     {
         Sample* const sample = i.getValue();
 
-        if (sample->load())
+        if (sample->load(loopedSamples.contains(sample) ? 0 : preloadFrames))
         {
             carla_debug("Loaded sample '%s'", sample->getShortName().toRawUTF8());
             cb.callback(cb.callbackPtr);
@@ -100,6 +111,17 @@ void Sound::loadSamples(const LoadingIdleCallback& cb)
     }
 }
 
+bool Sound::hasStreamedSamples()
+{
+    for (water::HashMap<water::String, Sample *>::Iterator i(samples_); i.next();)
+    {
+        if (i.getValue()->isStreamed())
+            return true;
+    }
+
+    return false;
+}
+
 Region *Sound::getRegionFor(int note, int velocity, Region::Trigger trigger)
 {
   int numRegions = regions_.size();
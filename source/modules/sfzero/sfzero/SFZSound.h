@@ -40,7 +40,10 @@ public:
   void addUnsupportedOpcode(const water::String &opcode);
 
   virtual void loadRegions();
-  virtual void loadSamples(const LoadingIdleCallback& cb);
+  // If preloadFrames is not 0, long samples which are never looped only get their start loaded,
+  // and need a Synth with streaming enabled to be played entirely.
+  virtual void loadSamples(const LoadingIdleCallback& cb, int preloadFrames = 0);
+  bool hasStreamedSamples();
 
   Region *getRegionFor(int note, int velocity, Region::Trigger trigger = Region::attack);
   int getNumRegions();
@@ -0,0 +1,217 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+
+#include "SFZStream.h"
+#include "SFZSample.h"
+
+extern "C" {
+#include "audio_decoder/ad.h"
+}
+
+namespace sfzero
+{
+
+Stream::Stream()
+    : requestSample_(nullptr), requestStart_(0), requestGen_(0), readPos_(0), readyGen_(0), writePos_(0),
+      handle_(nullptr), handleGen_(0), channels_(0), filePos_(0), fileEnd_(0), readBuffer_(nullptr)
+{
+  ring_[0] = new float[kStreamRingFrames];
+  ring_[1] = new float[kStreamRingFrames];
+  readBuffer_ = new float[kStreamReadFrames * 2];
+
+  carla_zeroFloats(ring_[0], kStreamRingFrames);
+  carla_zeroFloats(ring_[1], kStreamRingFrames);
+}
+
+Stream::~Stream()
+{
+  close();
+
+  delete[] ring_[0];
+  delete[] ring_[1];
+  delete[] readBuffer_;
+}
+
+void Stream::start(Sample *sample, int startFrame) noexcept
+{
+  requestSample_.store(sample, std::memory_order_relaxed);
+  requestStart_.store(startFrame, std::memory_order_relaxed);
+  requestGen_.fetch_add(1, std::memory_order_release);
+}
+
+void Stream::stop() noexcept
+{
+  requestSample_.store(nullptr, std::memory_order_relaxed);
+  requestGen_.fetch_add(1, std::memory_order_release);
+}
+
+int Stream::getAvailableEnd() const noexcept
+{
+  if (readyGen_.load(std::memory_order_acquire) != requestGen_.load(std::memory_order_relaxed))
+  {
+    return -1;
+  }
+
+  return writePos_.load(std::memory_order_acquire);
+}
+
+void Stream::setReadPosition(int frame) noexcept { readPos_.store(frame, std::memory_order_release); }
+
+bool Stream::process()
+{
+  const uint32_t gen = requestGen_.load(std::memory_order_acquire);
+
+  if (gen != handleGen_)
+  {
+    Sample *const sample = requestSample_.load(std::memory_order_relaxed);
+    const int startFrame = requestStart_.load(std::memory_order_relaxed);
+
+    // request changed while reading it, try again on the next round
+    if (requestGen_.load(std::memory_order_acquire) != gen)
+    {
+      return true;
+    }
+
+    close();
+    handleGen_ = gen;
+
+    if (sample == nullptr)
+    {
+      readyGen_.store(gen, std::memory_order_release);
+      return true;
+    }
+
+    struct adinfo info;
+    carla_zeroStruct(info);
+
+    const water::String filename(sample->getFile().getFullPathName());
+    handle_ = ad_open(filename.toRawUTF8(), &info);
+
+    if (handle_ == nullptr)
+    {
+      carla_stderr2("sfzero::Stream - failed to open '%s'", filename.toRawUTF8());
+      return true;
+    }
+
+    channels_ = static_cast<int>(info.channels);
+    filePos_ = 0;
+    fileEnd_ = static_cast<int>(sample->getSampleLength());
+
+    if (channels_ < 1 || channels_ > 2)
+    {
+      carla_stderr2("sfzero::Stream - '%s' has an unsupported channel count", filename.toRawUTF8());
+      fileEnd_ = 0;
+    }
+    else if (info.can_seek && ad_seek(handle_, startFrame) == startFrame)
+    {
+      filePos_ = startFrame;
+    }
+
+    // no seeking support, skip frames until the start
+    while (filePos_ < startFrame && filePos_ < fileEnd_)
+    {
+      const int frames = std::min(startFrame - filePos_, kStreamReadFrames);
+      const ssize_t r = ad_read(handle_, readBuffer_, static_cast<size_t>(frames * channels_));
+
+      if (r <= 0)
+      {
+        fileEnd_ = filePos_;
+        break;
+      }
+
+      filePos_ += static_cast<int>(r) / channels_;
+    }
+
+    writePos_.store(filePos_, std::memory_order_relaxed);
+    readPos_.store(filePos_, std::memory_order_relaxed);
+    readyGen_.store(gen, std::memory_order_release);
+    return true;
+  }
+
+  if (handle_ == nullptr || filePos_ >= fileEnd_)
+  {
+    return false;
+  }
+
+  const int space = readPos_.load(std::memory_order_acquire) + kStreamRingFrames - filePos_;
+  const int frames = std::min(std::min(space, kStreamReadFrames), fileEnd_ - filePos_);
+
+  // wait until there is enough space, reading very small chunks is slow
+  if (frames < kStreamReadFrames / 4 && frames < fileEnd_ - filePos_)
+  {
+    return false;
+  }
+
+  const ssize_t r = ad_read(handle_, readBuffer_, static_cast<size_t>(frames * channels_));
+
+  if (r <= 0)
+  {
+    fileEnd_ = filePos_;
+    return false;
+  }
+
+  const int framesRead = static_cast<int>(r) / channels_;
+
+  for (int i = 0; i < framesRead; ++i)
+  {
+    const int index = (filePos_ + i) & kStreamRingMask;
+
+    for (int c = 0; c < channels_; ++c)
+    {
+      ring_[c][index] = readBuffer_[i * channels_ + c];
+    }
+  }
+
+  filePos_ += framesRead;
+
+  // the voice moved on meanwhile, do not publish anything
+  if (requestGen_.load(std::memory_order_acquire) == handleGen_)
+  {
+    writePos_.store(filePos_, std::memory_order_release);
+  }
+
+  return true;
+}
+
+void Stream::close()
+{
+  if (handle_ != nullptr)
+  {
+    ad_close(handle_);
+    handle_ = nullptr;
+  }
+}
+
+StreamReader::StreamReader() : CarlaThread("SFZeroStreamReader") {}
+
+StreamReader::~StreamReader() { stopThread(-1); }
+
+void StreamReader::addStream(Stream *stream)
+{
+  CARLA_SAFE_ASSERT_RETURN(! isThreadRunning(),);
+
+  streams_.push_back(stream);
+}
+
+void StreamReader::run()
+{
+  while (! shouldThreadExit())
+  {
+    bool didSomething = false;
+
+    for (std::vector<Stream *>::iterator it = streams_.begin(); it != streams_.end(); ++it)
+    {
+      didSomething |= (*it)->process();
+    }
+
+    if (! didSomething)
+    {
+      carla_msleep(2);
+    }
+  }
+}
+}
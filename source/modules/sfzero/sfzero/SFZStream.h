@@ -0,0 +1,99 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#ifndef SFZSTREAM_H_INCLUDED
+#define SFZSTREAM_H_INCLUDED
+
+#include "SFZCommon.h"
+
+#include "CarlaThread.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace sfzero
+{
+
+class Sample;
+
+// Frames kept in memory for streamed samples, the rest is read from disk while playing.
+static const int kStreamPreloadFrames = 32768;
+
+// Frames of the per-voice ring buffer, must be a power of 2.
+static const int kStreamRingFrames = 16384;
+static const int kStreamRingMask = kStreamRingFrames - 1;
+
+// Max frames read from disk at once.
+static const int kStreamReadFrames = 2048;
+
+// Disk stream of a single voice.
+// The voice (RT) requests a sample and start frame, the reader thread opens the file and keeps
+// the ring buffer filled ahead of the voice. Streamed samples never loop, so playback only moves forward.
+class Stream
+{
+public:
+  Stream();
+  ~Stream();
+
+  // RT calls.
+  void start(Sample *sample, int startFrame) noexcept;
+  void stop() noexcept;
+
+  // Frames before the returned value are available, as long as they are not before the last setReadPosition().
+  // Returns -1 if the stream is not ready yet.
+  int getAvailableEnd() const noexcept;
+  void setReadPosition(int frame) noexcept;
+  const float *getRing(int channel) const noexcept { return ring_[channel]; }
+
+  // Reader thread calls, returns true if something was done.
+  bool process();
+
+private:
+  float *ring_[2];
+
+  // written by RT
+  std::atomic<Sample *> requestSample_;
+  std::atomic<int> requestStart_;
+  std::atomic<uint32_t> requestGen_;
+  std::atomic<int> readPos_;
+
+  // written by the reader thread
+  std::atomic<uint32_t> readyGen_;
+  std::atomic<int> writePos_;
+
+  // reader thread only
+  void *handle_;
+  uint32_t handleGen_;
+  int channels_;
+  int filePos_, fileEnd_;
+  float *readBuffer_;
+
+  void close();
+
+  CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Stream)
+};
+
+// Background thread serving the streams of all voices of a synth.
+class StreamReader : public CarlaThread
+{
+public:
+  StreamReader();
+  ~StreamReader() override;
+
+  // Must be called while the thread is stopped.
+  void addStream(Stream *stream);
+
+protected:
+  void run() override;
+
+private:
+  std::vector<Stream *> streams_;
+
+  CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamReader)
+};
+}
+
+#endif // SFZSTREAM_H_INCLUDED
@@ -17,6 +17,35 @@ Synth::Synth() : Synthesiser()
     carla_zeroStructs(noteVelocities_, 128);
 }
 
+Synth::~Synth()
+{
+    // voices are deleted later by the base class, stop reading into their streams before that
+    streamReader_.stopThread(-1);
+}
+
+bool Synth::enableStreaming()
+{
+  if (streamReader_.isThreadRunning())
+  {
+    return true;
+  }
+
+  for (int i = voices.size(); --i >= 0;)
+  {
+    Voice *voice = dynamic_cast<Voice *>(voices.getUnchecked(i));
+    if (voice == nullptr)
+    {
+      continue;
+    }
+
+    Stream *stream = new Stream();
+    voice->setStream(stream);
+    streamReader_.addStream(stream);
+  }
+
+  return streamReader_.startThread();
+}
+
 void Synth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
 {
   int i;
@@ -9,6 +9,7 @@
 #define SFZSYNTH_H_INCLUDED
 
 #include "SFZCommon.h"
+#include "SFZStream.h"
 
 #include "water/synthesisers/Synthesiser.h"
 
@@ -19,7 +20,7 @@ class Synth : public water::Synthesiser
 {
 public:
   Synth();
-  virtual ~Synth() {}
+  virtual ~Synth();
 
   void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
   void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
@@ -27,8 +28,13 @@ public:
   int numVoicesUsed();
   water::String voiceInfoString();
 
+  // Give each voice a disk stream and start the reader thread, needed to fully play streamed samples.
+  // Must be called after all voices are added.
+  bool enableStreaming();
+
 private:
   int noteVelocities_[128];
+  StreamReader streamReader_;
   CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Synth)
 };
 }
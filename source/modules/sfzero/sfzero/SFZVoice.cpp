@@ -22,7 +22,8 @@ static const float globalGain = -1.0;
 
 Voice::Voice()
     : region_(nullptr), curMidiNote_(0), curPitchWheel_(0), pitchRatio_(0), noteGainLeft_(0), noteGainRight_(0),
-      sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), numLoops_(0), curVelocity_(0)
+      sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), stream_(nullptr), streaming_(false),
+      numLoops_(0), curVelocity_(0)
 {
   ampeg_.setExponentialDecay(true);
 }
@@ -89,6 +90,26 @@ void Voice::startNote(int midiNoteNumber, float floatVelocity, water::Synthesise
     sampleEnd_ = region_->end + 1;
   }
 
+  // Streamed samples only have their start in memory, the rest is read from disk while playing.
+  if (streaming_)
+  {
+    stream_->stop();
+    streaming_ = false;
+  }
+  if (region_->sample->isStreamed())
+  {
+    const water::int64 preloadedLength = region_->sample->getPreloadedLength();
+    if (stream_ != nullptr)
+    {
+      stream_->start(region_->sample, static_cast<int>(std::max(preloadedLength, region_->offset)));
+      streaming_ = true;
+    }
+    else if (sampleEnd_ > preloadedLength)
+    {
+      sampleEnd_ = preloadedLength;
+    }
+  }
+
   // Loop.
   loopStart_ = loopEnd_ = 0;
   Region::LoopMode loopMode = region_->loop_mode;
@@ -178,6 +199,11 @@ void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSam
   float *outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
 
   int bufferNumSamples = buffer->getNumSamples(); // leoo
+  const int streamEnd = streaming_ ? stream_->getAvailableEnd() : -1;
+  if (streaming_)
+  {
+    bufferNumSamples = static_cast<int>(region_->sample->getSampleLength());
+  }
 
   // Cache some values, to give them at least some chance of ending up in
   // registers.
@@ -203,15 +229,23 @@ void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSam
       nextPos = static_cast<int>(loopStart);
     }
 
-    // Simple linear interpolation with buffer overrun check
-    float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[pos];
-    float nextR = inR ? (nextPos < bufferNumSamples ? inR[nextPos] : inR[pos]) : nextL;
-    float l = (inL[pos] * invAlpha + nextL * alpha);
-    float r = inR ? (inR[pos] * invAlpha + nextR * alpha) : l;
-
-    //// Simple linear interpolation, old version (possible buffer overrun with non-loop??)
-    // float l = (inL[pos] * invAlpha + inL[nextPos] * alpha);
-    // float r = inR ? (inR[pos] * invAlpha + inR[nextPos] * alpha) : l;
+    float l, r;
+    if (streaming_)
+    {
+      renderStreamedFrame(buffer, pos, nextPos, streamEnd, alpha, l, r);
+    }
+    else
+    {
+      // Simple linear interpolation with buffer overrun check
+      float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[pos];
+      float nextR = inR ? (nextPos < bufferNumSamples ? inR[nextPos] : inR[pos]) : nextL;
+      l = (inL[pos] * invAlpha + nextL * alpha);
+      r = inR ? (inR[pos] * invAlpha + nextR * alpha) : l;
+
+      //// Simple linear interpolation, old version (possible buffer overrun with non-loop??)
+      // float l = (inL[pos] * invAlpha + inL[nextPos] * alpha);
+      // float r = inR ? (inR[pos] * invAlpha + inR[nextPos] * alpha) : l;
+    }
 
     float gainLeft = noteGainLeft_ * ampegGain;
     float gainRight = noteGainRight_ * ampegGain;
@@ -264,6 +298,10 @@ void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSam
   }
 
   this->sourceSamplePosition_ = sourceSamplePosition;
+  if (streaming_)
+  {
+    stream_->setReadPosition(static_cast<int>(sourceSamplePosition));
+  }
   ampeg_.setLevel(ampegGain);
   ampeg_.setSamplesUntilNextSegment(samplesUntilNextAmpSegment);
 }
@@ -278,6 +316,8 @@ water::int64 Voice::getOffBy() { return region_ ? region_->off_by : 0; }
 
 void Voice::setRegion(Region *nextRegion) { region_ = nextRegion; }
 
+void Voice::setStream(Stream *stream) { stream_ = stream; }
+
 water::String Voice::infoString()
 {
   const char *egSegmentNames[] = {"delay", "attack", "hold", "decay", "sustain", "release", "done"};
@@ -324,6 +364,11 @@ void Voice::calcPitchRatio()
 
 void Voice::killNote()
 {
+  if (streaming_)
+  {
+    stream_->stop();
+    streaming_ = false;
+  }
   region_ = nullptr;
   clearCurrentNote();
 }
@@ -336,4 +381,37 @@ double Voice::fractionalMidiNoteInHz(double note, double freqOfA)
   return freqOfA * pow(2.0, note / 12.0);
 }
 
+void Voice::renderStreamedFrame(const water::AudioSampleBuffer *buffer, int pos, int nextPos, int streamEnd,
+                                float alpha, float &l, float &r)
+{
+  const int preloadedLength = buffer->getNumSamples() - 4;
+  const int numChannels = buffer->getNumChannels() > 1 ? 2 : 1;
+  const int frames[2] = {pos, nextPos};
+  float values[2][2];
+
+  for (int f = 0; f < 2; ++f)
+  {
+    const int frame = frames[f];
+    for (int c = 0; c < numChannels; ++c)
+    {
+      if (frame < preloadedLength)
+      {
+        values[f][c] = buffer->getReadPointer(c)[frame];
+      }
+      else if (frame < streamEnd)
+      {
+        values[f][c] = stream_->getRing(c)[frame & kStreamRingMask];
+      }
+      else
+      {
+        // Not read from disk yet (underrun), or past the end.
+        values[f][c] = 0.0f;
+      }
+    }
+  }
+
+  l = values[0][0] * (1.0f - alpha) + values[1][0] * alpha;
+  r = numChannels > 1 ? values[0][1] * (1.0f - alpha) + values[1][1] * alpha : l;
+}
+
 }
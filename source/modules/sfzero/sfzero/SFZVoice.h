@@ -9,6 +9,9 @@
 #define SFZVOICE_H_INCLUDED
 
 #include "SFZEG.h"
+#include "SFZStream.h"
+
+#include "CarlaScopeUtils.hpp"
 
 #include "water/synthesisers/Synthesiser.h"
 
@@ -40,6 +43,9 @@ public:
   // Set the region to be used by the next startNote().
   void setRegion(Region *nextRegion);
 
+  // Set the disk stream for playing streamed samples, takes ownership.
+  void setStream(Stream *stream);
+
   water::String infoString();
 
 private:
@@ -52,6 +58,10 @@ private:
   water::int64 sampleEnd_;
   water::int64 loopStart_, loopEnd_;
 
+  // Disk streaming, used when the region sample is only partially loaded.
+  CarlaScopedPointer<Stream> stream_;
+  bool streaming_;
+
   // Info only.
   int numLoops_;
   int curVelocity_;
@@ -59,6 +69,8 @@ private:
   void calcPitchRatio();
   void killNote();
   double fractionalMidiNoteInHz(double note, double freqOfA = 440.0);
+  void renderStreamedFrame(const water::AudioSampleBuffer *buffer, int pos, int nextPos, int streamEnd, float alpha,
+                           float &l, float &r);
 
   CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Voice)
 };
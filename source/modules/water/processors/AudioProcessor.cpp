@@ -89,6 +89,18 @@ void AudioProcessor::suspendProcessing (const bool shouldBeSuspended)
 void AudioProcessor::reset() {}
 void AudioProcessor::reconfigure() {}
 
+bool AudioProcessor::startBlockWithCV (AudioSampleBuffer&, const AudioSampleBuffer&, AudioSampleBuffer&, MidiBuffer&)
+{
+    return false;
+}
+
+bool AudioProcessor::canStartBlocks() const
+{
+    return false;
+}
+
+void AudioProcessor::finishBlockWithCV (AudioSampleBuffer&, const AudioSampleBuffer&, AudioSampleBuffer&, MidiBuffer&) {}
+
 uint AudioProcessor::getTotalNumInputChannels(ChannelType t) const noexcept
 {
     switch (t)
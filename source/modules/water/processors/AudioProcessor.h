@@ -159,6 +159,30 @@ public:
                                      AudioSampleBuffer& cvOutBuffer,
                                      MidiBuffer& midiMessages) = 0;
 
+    /** Starts processing a block without waiting for it to complete.
+
+        Processors that do their work somewhere else (like in a separate process) can
+        implement this so that several of them can run at the same time.
+        When this returns true, finishBlockWithCV() must be called with the same buffers
+        before they are used for anything else. Returning false means this is not supported,
+        and processBlockWithCV() is used instead.
+    */
+    virtual bool startBlockWithCV (AudioSampleBuffer& audioBuffer,
+                                   const AudioSampleBuffer& cvInBuffer,
+                                   AudioSampleBuffer& cvOutBuffer,
+                                   MidiBuffer& midiMessages);
+
+    /** Returns true if startBlockWithCV() can succeed for this processor.
+        The graph only pays for running blocks asynchronously when one of its processors does.
+    */
+    virtual bool canStartBlocks() const;
+
+    /** Completes a block previously started with startBlockWithCV(). */
+    virtual void finishBlockWithCV (AudioSampleBuffer& audioBuffer,
+                                    const AudioSampleBuffer& cvInBuffer,
+                                    AudioSampleBuffer& cvOutBuffer,
+                                    MidiBuffer& midiMessages);
+
     //==============================================================================
     /** Returns the total number of input channels. */
     uint getTotalNumInputChannels(ChannelType t) const noexcept;
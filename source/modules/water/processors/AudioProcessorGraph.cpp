@@ -27,6 +27,21 @@ namespace water {
 namespace GraphRenderingOps
 {
 
+/** The kinds of shared buffers an op can touch, used for working out which ops can run in parallel. */
+enum BufferType
+{
+    audioBufferType = 0,
+    cvBufferType,
+    midiBufferType,
+    graphIOBufferType, // the graph's own input and output buffers
+    numBufferTypes
+};
+
+static inline int getBufferKey (const BufferType type, const int index) noexcept
+{
+    return index * numBufferTypes + type;
+}
+
 struct AudioGraphRenderingOpBase
 {
     AudioGraphRenderingOpBase() noexcept {}
@@ -36,6 +51,26 @@ struct AudioGraphRenderingOpBase
                           AudioSampleBuffer& sharedCVBufferChans,
                           const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                           const int numSamples) = 0;
+
+    /** Adds the keys of the shared buffers this op reads from and writes to. */
+    virtual void getBufferUsage (Array<int>& reads, Array<int>& writes) const = 0;
+
+    /** Starts the op without waiting for it to complete, so other work can happen meanwhile.
+        Returns false if this op cannot do that, perform() must then be used instead.
+        A successful start must be followed by finish().
+    */
+    virtual bool start (AudioSampleBuffer&, AudioSampleBuffer&, const OwnedArray<MidiBuffer>&, const int)
+    {
+        return false;
+    }
+
+    /** Returns true if start() can succeed for this op. */
+    virtual bool canStart() const
+    {
+        return false;
+    }
+
+    virtual void finish() {}
 };
 
 // use CRTP
@@ -71,6 +106,11 @@ struct ClearChannelOp  : public AudioGraphRenderingOp<ClearChannelOp>
             sharedAudioBufferChans.clear (channelNum, 0, numSamples);
     }
 
+    void getBufferUsage (Array<int>&, Array<int>& writes) const override
+    {
+        writes.add (getBufferKey (isCV ? cvBufferType : audioBufferType, channelNum));
+    }
+
     const int channelNum;
     const bool isCV;
 
@@ -94,6 +134,13 @@ struct CopyChannelOp  : public AudioGraphRenderingOp<CopyChannelOp>
             sharedAudioBufferChans.copyFrom (dstChannelNum, 0, sharedAudioBufferChans, srcChannelNum, 0, numSamples);
     }
 
+    void getBufferUsage (Array<int>& reads, Array<int>& writes) const override
+    {
+        const BufferType type = isCV ? cvBufferType : audioBufferType;
+        reads.add (getBufferKey (type, srcChannelNum));
+        writes.add (getBufferKey (type, dstChannelNum));
+    }
+
     const int srcChannelNum, dstChannelNum;
     const bool isCV;
 
@@ -117,6 +164,14 @@ struct AddChannelOp  : public AudioGraphRenderingOp<AddChannelOp>
             sharedAudioBufferChans.addFrom (dstChannelNum, 0, sharedAudioBufferChans, srcChannelNum, 0, numSamples);
     }
 
+    void getBufferUsage (Array<int>& reads, Array<int>& writes) const override
+    {
+        const BufferType type = isCV ? cvBufferType : audioBufferType;
+        reads.add (getBufferKey (type, srcChannelNum));
+        reads.add (getBufferKey (type, dstChannelNum));
+        writes.add (getBufferKey (type, dstChannelNum));
+    }
+
     const int srcChannelNum, dstChannelNum;
     const bool isCV;
 
@@ -135,6 +190,11 @@ struct ClearMidiBufferOp  : public AudioGraphRenderingOp<ClearMidiBufferOp>
         sharedMidiBuffers.getUnchecked (bufferNum)->clear();
     }
 
+    void getBufferUsage (Array<int>&, Array<int>& writes) const override
+    {
+        writes.add (getBufferKey (midiBufferType, bufferNum));
+    }
+
     const int bufferNum;
 
     CARLA_DECLARE_NON_COPYABLE (ClearMidiBufferOp)
@@ -154,6 +214,12 @@ struct CopyMidiBufferOp  : public AudioGraphRenderingOp<CopyMidiBufferOp>
         *sharedMidiBuffers.getUnchecked (dstBufferNum) = *sharedMidiBuffers.getUnchecked (srcBufferNum);
     }
 
+    void getBufferUsage (Array<int>& reads, Array<int>& writes) const override
+    {
+        reads.add (getBufferKey (midiBufferType, srcBufferNum));
+        writes.add (getBufferKey (midiBufferType, dstBufferNum));
+    }
+
     const int srcBufferNum, dstBufferNum;
 
     CARLA_DECLARE_NON_COPYABLE (CopyMidiBufferOp)
@@ -174,6 +240,13 @@ struct AddMidiBufferOp  : public AudioGraphRenderingOp<AddMidiBufferOp>
             ->addEvents (*sharedMidiBuffers.getUnchecked (srcBufferNum), 0, numSamples, 0);
     }
 
+    void getBufferUsage (Array<int>& reads, Array<int>& writes) const override
+    {
+        reads.add (getBufferKey (midiBufferType, srcBufferNum));
+        reads.add (getBufferKey (midiBufferType, dstBufferNum));
+        writes.add (getBufferKey (midiBufferType, dstBufferNum));
+    }
+
     const int srcBufferNum, dstBufferNum;
 
     CARLA_DECLARE_NON_COPYABLE (AddMidiBufferOp)
@@ -211,6 +284,13 @@ struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
         }
     }
 
+    void getBufferUsage (Array<int>& reads, Array<int>& writes) const override
+    {
+        const BufferType type = isCV ? cvBufferType : audioBufferType;
+        reads.add (getBufferKey (type, channel));
+        writes.add (getBufferKey (type, channel));
+    }
+
 private:
     HeapBlock<float> buffer;
     const int channel, bufferSize;
@@ -237,7 +317,9 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
           totalAudioChans (jmax (1U, totalNumChans)),
           totalCVIns (cvInChannelsUsed.size()),
           totalCVOuts (cvOutChannelsUsed.size()),
-          midiBufferToUse (midiBuffer)
+          midiBufferToUse (midiBuffer),
+          startedMidiBuffer (nullptr),
+          startedNumSamples (0)
     {
         audioChannels.calloc (totalAudioChans);
         cvInChannels.calloc (totalCVIns);
@@ -256,14 +338,7 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         HeapBlock<float*>& cvInChannelsCopy  = cvInChannels;
         HeapBlock<float*>& cvOutChannelsCopy = cvOutChannels;
 
-        for (uint i = 0; i < totalAudioChans; ++i)
-            audioChannelsCopy[i] = sharedAudioBufferChans.getWritePointer (audioChannelsToUse.getUnchecked (i), 0);
-
-        for (uint i = 0; i < totalCVIns; ++i)
-            cvInChannels[i] = sharedCVBufferChans.getWritePointer (cvInChannelsToUse.getUnchecked (i), 0);
-
-        for (uint i = 0; i < totalCVOuts; ++i)
-            cvOutChannels[i] = sharedCVBufferChans.getWritePointer (cvOutChannelsToUse.getUnchecked (i), 0);
+        setChannelPointers (sharedAudioBufferChans, sharedCVBufferChans);
 
         AudioSampleBuffer audioBuffer (audioChannelsCopy, totalAudioChans, numSamples);
         AudioSampleBuffer cvInBuffer  (cvInChannelsCopy, totalCVIns, numSamples);
@@ -290,10 +365,95 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         processor->processBlockWithCV (audioBuffer, cvInBuffer, cvOutBuffer, midiMessages);
     }
 
+    bool start (AudioSampleBuffer& sharedAudioBufferChans,
+                AudioSampleBuffer& sharedCVBufferChans,
+                const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                const int numSamples) override
+    {
+        if (processor->isSuspended())
+            return false;
+
+        setChannelPointers (sharedAudioBufferChans, sharedCVBufferChans);
+
+        AudioSampleBuffer audioBuffer (audioChannels, totalAudioChans, numSamples);
+        AudioSampleBuffer cvInBuffer  (cvInChannels, totalCVIns, numSamples);
+        AudioSampleBuffer cvOutBuffer (cvOutChannels, totalCVOuts, numSamples);
+        MidiBuffer& midiBuffer (*sharedMidiBuffers.getUnchecked (midiBufferToUse));
+
+        // kept locked until finish()
+        processor->getCallbackLock().lock();
+
+        if (! processor->startBlockWithCV (audioBuffer, cvInBuffer, cvOutBuffer, midiBuffer))
+        {
+            processor->getCallbackLock().unlock();
+            return false;
+        }
+
+        startedMidiBuffer = &midiBuffer;
+        startedNumSamples = numSamples;
+        return true;
+    }
+
+    bool canStart() const override
+    {
+        return processor->canStartBlocks();
+    }
+
+    void finish() override
+    {
+        CARLA_SAFE_ASSERT_RETURN (startedMidiBuffer != nullptr,);
+
+        AudioSampleBuffer audioBuffer (audioChannels, totalAudioChans, startedNumSamples);
+        AudioSampleBuffer cvInBuffer  (cvInChannels, totalCVIns, startedNumSamples);
+        AudioSampleBuffer cvOutBuffer (cvOutChannels, totalCVOuts, startedNumSamples);
+
+        processor->finishBlockWithCV (audioBuffer, cvInBuffer, cvOutBuffer, *startedMidiBuffer);
+        processor->getCallbackLock().unlock();
+
+        startedMidiBuffer = nullptr;
+        startedNumSamples = 0;
+    }
+
+    void getBufferUsage (Array<int>& reads, Array<int>& writes) const override
+    {
+        // audio is processed in-place
+        for (uint i = 0; i < totalAudioChans; ++i)
+        {
+            const int key = getBufferKey (audioBufferType, static_cast<int> (audioChannelsToUse.getUnchecked (static_cast<int> (i))));
+            reads.add (key);
+            writes.add (key);
+        }
+
+        for (uint i = 0; i < totalCVIns; ++i)
+            reads.add (getBufferKey (cvBufferType, static_cast<int> (cvInChannelsToUse.getUnchecked (static_cast<int> (i)))));
+
+        for (uint i = 0; i < totalCVOuts; ++i)
+            writes.add (getBufferKey (cvBufferType, static_cast<int> (cvOutChannelsToUse.getUnchecked (static_cast<int> (i)))));
+
+        reads.add (getBufferKey (midiBufferType, midiBufferToUse));
+        writes.add (getBufferKey (midiBufferType, midiBufferToUse));
+
+        // io nodes access the graph's own buffers, serialize them
+        if (dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor*> (processor) != nullptr)
+            writes.add (getBufferKey (graphIOBufferType, 0));
+    }
+
     const AudioProcessorGraph::Node::Ptr node;
     AudioProcessor* const processor;
 
 private:
+    void setChannelPointers (AudioSampleBuffer& sharedAudioBufferChans, AudioSampleBuffer& sharedCVBufferChans)
+    {
+        for (uint i = 0; i < totalAudioChans; ++i)
+            audioChannels[i] = sharedAudioBufferChans.getWritePointer (audioChannelsToUse.getUnchecked (i), 0);
+
+        for (uint i = 0; i < totalCVIns; ++i)
+            cvInChannels[i] = sharedCVBufferChans.getWritePointer (cvInChannelsToUse.getUnchecked (i), 0);
+
+        for (uint i = 0; i < totalCVOuts; ++i)
+            cvOutChannels[i] = sharedCVBufferChans.getWritePointer (cvOutChannelsToUse.getUnchecked (i), 0);
+    }
+
     Array<uint> audioChannelsToUse;
     Array<uint> cvInChannelsToUse;
     Array<uint> cvOutChannelsToUse;
@@ -305,6 +465,8 @@ private:
     const uint totalCVIns;
     const uint totalCVOuts;
     const int midiBufferToUse;
+    MidiBuffer* startedMidiBuffer;
+    int startedNumSamples;
 
     CARLA_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
@@ -959,6 +1121,118 @@ private:
     CARLA_DECLARE_NON_COPYABLE (RenderingOpSequenceCalculator)
 };
 
+//==============================================================================
+/** Works out which rendering ops must finish before each op can start.
+
+    Ops are ordered by any read/write, write/read or write/write access to the same
+    shared buffer, keeping the result identical to running them serially in sequence order.
+*/
+static void calculateRenderingOpDependencies (const Array<void*>& renderingOps,
+                                              AudioProcessorGraph::RenderingOpDependencies& deps)
+{
+    const int numOps = renderingOps.size();
+
+    Array<int> lastWriter;
+    OwnedArray<Array<int> > readersSinceWrite;
+    OwnedArray<SortedSet<int> > predecessors;
+    Array<int> reads, writes;
+
+    for (int i = 0; i < numOps; ++i)
+    {
+        const AudioGraphRenderingOpBase* const op
+            = static_cast<const AudioGraphRenderingOpBase*> (renderingOps.getUnchecked (i));
+
+        SortedSet<int>* const preds = new SortedSet<int>();
+        predecessors.add (preds);
+
+        reads.clearQuick();
+        writes.clearQuick();
+        op->getBufferUsage (reads, writes);
+
+        int maxKey = -1;
+        for (int j = 0; j < reads.size(); ++j)
+            maxKey = jmax (maxKey, reads.getUnchecked (j));
+        for (int j = 0; j < writes.size(); ++j)
+            maxKey = jmax (maxKey, writes.getUnchecked (j));
+
+        while (lastWriter.size() <= maxKey)
+        {
+            lastWriter.add (-1);
+            readersSinceWrite.add (new Array<int>());
+        }
+
+        for (int j = 0; j < reads.size(); ++j)
+        {
+            const int key = reads.getUnchecked (j);
+
+            if (lastWriter.getUnchecked (key) >= 0)
+                preds->add (lastWriter.getUnchecked (key));
+        }
+
+        for (int j = 0; j < writes.size(); ++j)
+        {
+            const int key = writes.getUnchecked (j);
+            const Array<int>& readers (*readersSinceWrite.getUnchecked (key));
+
+            if (lastWriter.getUnchecked (key) >= 0)
+                preds->add (lastWriter.getUnchecked (key));
+
+            for (int k = 0; k < readers.size(); ++k)
+                preds->add (readers.getUnchecked (k));
+        }
+
+        preds->removeValue (i);
+
+        for (int j = 0; j < reads.size(); ++j)
+            readersSinceWrite.getUnchecked (reads.getUnchecked (j))->addIfNotAlreadyThere (i);
+
+        for (int j = 0; j < writes.size(); ++j)
+        {
+            const int key = writes.getUnchecked (j);
+            lastWriter.set (key, i);
+            readersSinceWrite.getUnchecked (key)->clearQuick();
+        }
+    }
+
+    // flatten into successor lists
+    Array<uint> numSuccessors;
+    numSuccessors.insertMultiple (0, 0, numOps);
+
+    deps.numDependencies.clearQuick();
+
+    for (int i = 0; i < numOps; ++i)
+    {
+        const SortedSet<int>& preds (*predecessors.getUnchecked (i));
+
+        deps.numDependencies.add (static_cast<uint> (preds.size()));
+
+        for (int j = 0; j < preds.size(); ++j)
+            numSuccessors.getReference (preds.getUnchecked (j)) += 1;
+    }
+
+    deps.successorOffsets.clearQuick();
+    deps.successorOffsets.add (0);
+
+    for (int i = 0; i < numOps; ++i)
+        deps.successorOffsets.add (deps.successorOffsets.getUnchecked (i) + numSuccessors.getUnchecked (i));
+
+    deps.successors.clearQuick();
+    deps.successors.insertMultiple (0, 0, static_cast<int> (deps.successorOffsets.getLast()));
+
+    Array<uint> fillPositions (deps.successorOffsets);
+
+    for (int i = 0; i < numOps; ++i)
+    {
+        const SortedSet<int>& preds (*predecessors.getUnchecked (i));
+
+        for (int j = 0; j < preds.size(); ++j)
+        {
+            uint& pos (fillPositions.getReference (preds.getUnchecked (j)));
+            deps.successors.set (static_cast<int> (pos++), static_cast<uint> (i));
+        }
+    }
+}
+
 //==============================================================================
 // Holds a fast lookup table for checking which nodes are inputs to others.
 class ConnectionLookupTable
@@ -1182,7 +1456,8 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
 
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
-    : lastNodeId (0), audioAndCVBuffers (new AudioProcessorGraphBufferHelpers),
+    : lastNodeId (0), parallelRenderer (nullptr), currentNumSamples (0), hasAsyncRenderingOps (false),
+      audioAndCVBuffers (new AudioProcessorGraphBufferHelpers),
       currentMidiInputBuffer (nullptr), isPrepared (false), needsReorder (false)
 {
 }
@@ -1440,13 +1715,34 @@ static void deleteRenderOpArray (Array<void*>& ops)
         delete static_cast<GraphRenderingOps::AudioGraphRenderingOpBase*> (ops.getUnchecked(i));
 }
 
+static void swapRenderOpDependencies (AudioProcessorGraph::RenderingOpDependencies& a,
+                                      AudioProcessorGraph::RenderingOpDependencies& b) noexcept
+{
+    a.numDependencies.swapWith (b.numDependencies);
+    a.successorOffsets.swapWith (b.successorOffsets);
+    a.successors.swapWith (b.successors);
+}
+
+template <class PipelineState>
+static void swapPipelineState (PipelineState& a, PipelineState& b) noexcept
+{
+    a.pending.swapWith (b.pending);
+    a.ready.swapWith (b.ready);
+    a.started.swapWith (b.started);
+}
+
 void AudioProcessorGraph::clearRenderingSequence()
 {
     Array<void*> oldOps;
+    RenderingOpDependencies oldDependencies;
+    PipelineState oldPipelineState;
 
     {
         const CarlaRecursiveMutexLocker cml (getCallbackLock());
         renderingOps.swapWith (oldOps);
+        swapRenderOpDependencies (renderingOpDependencies, oldDependencies);
+        swapPipelineState (pipelineState, oldPipelineState);
+        hasAsyncRenderingOps = false;
     }
 
     deleteRenderOpArray (oldOps);
@@ -1475,6 +1771,9 @@ bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
 void AudioProcessorGraph::buildRenderingSequence()
 {
     Array<void*> newRenderingOps;
+    RenderingOpDependencies newDependencies;
+    PipelineState newPipelineState;
+    bool newHasAsyncRenderingOps = false;
     int numAudioRenderingBuffersNeeded = 2;
     int numCVRenderingBuffersNeeded = 0;
     int numMidiBuffersNeeded = 1;
@@ -1507,6 +1806,26 @@ void AudioProcessorGraph::buildRenderingSequence()
         numAudioRenderingBuffersNeeded = calculator.getNumAudioBuffersNeeded();
         numCVRenderingBuffersNeeded = calculator.getNumCVBuffersNeeded();
         numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
+
+        // dependencies are needed for both parallel and pipelined rendering
+        GraphRenderingOps::calculateRenderingOpDependencies (newRenderingOps, newDependencies);
+
+        newPipelineState.pending.insertMultiple (0, 0, newRenderingOps.size());
+        newPipelineState.ready.insertMultiple (0, 0, newRenderingOps.size());
+        newPipelineState.started.insertMultiple (0, 0, newRenderingOps.size());
+
+        // pipelining has a cost on every op, only use it if some op can run asynchronously
+        for (int i = 0; i < newRenderingOps.size(); ++i)
+        {
+            if (static_cast<GraphRenderingOps::AudioGraphRenderingOpBase*> (newRenderingOps.getUnchecked(i))->canStart())
+            {
+                newHasAsyncRenderingOps = true;
+                break;
+            }
+        }
+
+        if (parallelRenderer != nullptr)
+            parallelRenderer->prepareRenderingSequence (static_cast<uint> (newRenderingOps.size()));
     }
 
     {
@@ -1524,6 +1843,9 @@ void AudioProcessorGraph::buildRenderingSequence()
             midiBuffers.add (new MidiBuffer());
 
         renderingOps.swapWith (newRenderingOps);
+        swapRenderOpDependencies (renderingOpDependencies, newDependencies);
+        swapPipelineState (pipelineState, newPipelineState);
+        hasAsyncRenderingOps = newHasAsyncRenderingOps;
     }
 
     // delete the old ones..
@@ -1647,13 +1969,29 @@ void AudioProcessorGraph::processAudioAndCV (AudioSampleBuffer& audioBuffer,
     currentAudioOutputBuffer.clear();
     currentCVOutputBuffer.clear();
     currentMidiOutputBuffer.clear();
+    currentNumSamples = numSamples;
 
-    for (int i = 0; i < renderingOps.size(); ++i)
+    // ops and their dependencies are swapped together, a mismatch means we are mid-rebuild
+    const bool hasDependencies = renderingOpDependencies.numDependencies.size() == renderingOps.size()
+                              && pipelineState.pending.size() == renderingOps.size();
+
+    if (hasDependencies && parallelRenderer != nullptr && parallelRenderer->performRenderingSequence (*this, renderingOpDependencies))
     {
-        GraphRenderingOps::AudioGraphRenderingOpBase* const op
-            = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
+        // done
+    }
+    else if (hasDependencies && hasAsyncRenderingOps)
+    {
+        performRenderingSequencePipelined (numSamples);
+    }
+    else
+    {
+        for (int i = 0; i < renderingOps.size(); ++i)
+        {
+            GraphRenderingOps::AudioGraphRenderingOpBase* const op
+                = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
 
-        op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples);
+            op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples);
+        }
     }
 
     for (uint32_t i = 0; i < audioBuffer.getNumChannels(); ++i)
@@ -1698,6 +2036,97 @@ const CarlaRecursiveMutex& AudioProcessorGraph::getReorderMutex() const
     return reorderMutex;
 }
 
+void AudioProcessorGraph::setParallelRenderer (ParallelRenderer* const renderer)
+{
+    const CarlaRecursiveMutexLocker cml (reorderMutex);
+
+    {
+        const CarlaRecursiveMutexLocker cml2 (getCallbackLock());
+        parallelRenderer = renderer;
+    }
+
+    if (isPrepared)
+        buildRenderingSequence();
+}
+
+void AudioProcessorGraph::performRenderingOp (const uint index) noexcept
+{
+    GraphRenderingOps::AudioGraphRenderingOpBase* const op
+        = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked (static_cast<int> (index));
+
+    op->perform (audioAndCVBuffers->renderingAudioBuffers,
+                 audioAndCVBuffers->renderingCVBuffers,
+                 midiBuffers,
+                 currentNumSamples);
+}
+
+void AudioProcessorGraph::performRenderingSequencePipelined (const int numSamples) noexcept
+{
+    AudioSampleBuffer& renderingAudioBuffers (audioAndCVBuffers->renderingAudioBuffers);
+    AudioSampleBuffer& renderingCVBuffers (audioAndCVBuffers->renderingCVBuffers);
+
+    const uint numOps = static_cast<uint> (renderingOps.size());
+    const uint* const numDependencies = renderingOpDependencies.numDependencies.begin();
+    const uint* const successorOffsets = renderingOpDependencies.successorOffsets.begin();
+    const uint* const successors = renderingOpDependencies.successors.begin();
+
+    uint* const pending = pipelineState.pending.begin();
+    uint* const ready = pipelineState.ready.begin();
+    uint* const started = pipelineState.started.begin();
+
+    // every op goes through each queue at most once, so they never wrap
+    uint readyHead = 0, readyTail = 0;
+    uint startedHead = 0, startedTail = 0;
+
+    for (uint i = 0; i < numOps; ++i)
+    {
+        pending[i] = numDependencies[i];
+
+        if (pending[i] == 0)
+            ready[readyTail++] = i;
+    }
+
+    while (readyHead != readyTail || startedHead != startedTail)
+    {
+        uint index;
+
+        if (readyHead != readyTail)
+        {
+            // run whatever is ready, starting async ops as soon as possible
+            index = ready[readyHead++];
+
+            GraphRenderingOps::AudioGraphRenderingOpBase* const op
+                = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked (static_cast<int> (index));
+
+            if (op->start (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples))
+            {
+                started[startedTail++] = index;
+                continue;
+            }
+
+            op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples);
+        }
+        else
+        {
+            // nothing else to do, wait for the oldest async op
+            index = started[startedHead++];
+
+            GraphRenderingOps::AudioGraphRenderingOpBase* const op
+                = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked (static_cast<int> (index));
+
+            op->finish();
+        }
+
+        for (uint i = successorOffsets[index]; i < successorOffsets[index + 1]; ++i)
+        {
+            const uint successor = successors[i];
+
+            if (--pending[successor] == 0)
+                ready[readyTail++] = successor;
+        }
+    }
+}
+
 //==============================================================================
 AudioProcessorGraph::AudioGraphIOProcessor::AudioGraphIOProcessor (const IODeviceType deviceType)
     : type (deviceType), graph (nullptr)
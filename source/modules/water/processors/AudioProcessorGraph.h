@@ -388,6 +388,52 @@ public:
     void reorderNowIfNeeded();
     const CarlaRecursiveMutex& getReorderMutex() const;
 
+    //==============================================================================
+    /** Describes which rendering ops must finish before each op can start.
+
+        For op i, numDependencies[i] is the number of ops it waits for, and the ops waiting
+        on it are successors[successorOffsets[i]] up to successors[successorOffsets[i+1]].
+    */
+    struct RenderingOpDependencies
+    {
+        Array<uint> numDependencies;
+        Array<uint> successorOffsets;
+        Array<uint> successors;
+    };
+
+    /** Interface for running the rendering ops of a graph on several threads.
+
+        @see setParallelRenderer
+    */
+    class ParallelRenderer
+    {
+    public:
+        virtual ~ParallelRenderer() {}
+
+        /** Called outside of the audio thread before a new rendering sequence is put in place. */
+        virtual void prepareRenderingSequence (uint numOps) = 0;
+
+        /** Called from the audio thread during processing.
+
+            Implementations must call AudioProcessorGraph::performRenderingOp() once for each op,
+            never starting an op before all of its dependencies have finished, and return true.
+            Returning false makes the graph run all ops serially instead.
+        */
+        virtual bool performRenderingSequence (AudioProcessorGraph& graph,
+                                               const RenderingOpDependencies& deps) noexcept = 0;
+    };
+
+    /** Sets the object used for running independent rendering ops in parallel.
+        Passing nullptr makes the graph run everything serially on the audio thread.
+        The renderer is not owned by the graph and must outlive it, or be removed first.
+    */
+    void setParallelRenderer (ParallelRenderer* renderer);
+
+    /** Runs a single rendering op for the block currently being processed.
+        Only to be called by a ParallelRenderer during performRenderingSequence().
+    */
+    void performRenderingOp (uint index) noexcept;
+
 private:
     //==============================================================================
     // void processAudio (AudioSampleBuffer& audioBuffer, MidiBuffer& midiMessages);
@@ -402,6 +448,22 @@ private:
     uint32 lastNodeId;
     OwnedArray<MidiBuffer> midiBuffers;
     Array<void*> renderingOps;
+    RenderingOpDependencies renderingOpDependencies;
+    ParallelRenderer* parallelRenderer;
+    int currentNumSamples;
+
+    /** Scratch space for running the ops on the audio thread while others that were
+        started asynchronously are still busy, sized together with the ops. */
+    struct PipelineState
+    {
+        Array<uint> pending;
+        Array<uint> ready;
+        Array<uint> started;
+    };
+    PipelineState pipelineState;
+    bool hasAsyncRenderingOps;
+
+    void performRenderingSequencePipelined (int numSamples) noexcept;
 
     friend class AudioGraphIOProcessor;
     struct AudioProcessorGraphBufferHelpers;
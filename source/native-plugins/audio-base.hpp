@@ -20,11 +20,16 @@
 
 #include "CarlaMathUtils.hpp"
 #include "CarlaMemUtils.hpp"
+#include "CarlaMutex.hpp"
 #include "CarlaRingBuffer.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+#include "CarlaTimeUtils.hpp"
+#include "LinkedList.hpp"
 
-extern "C" {
-#include "audio_decoder/ad.h"
-}
+#include "audio-peaks.hpp"
+
+#include <atomic>
 
 #if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))
 # pragma GCC diagnostic push
@@ -42,8 +47,11 @@ typedef struct adinfo ADInfo;
 // --------------------------------------------------------------------------------------------------------------------
 // tuning
 
-// disk streaming buffer size
-static constexpr const uint16_t kFileReaderBufferSize = 1024;
+// disk streaming buffer size, in interleaved samples read per chunk
+static constexpr const uint16_t kFileReaderBufferSize = 8192;
+
+// number of disk streaming threads, shared by all readers
+static constexpr const uint8_t kFileReaderNumThreads = 2;
 
 // if reading a file smaller than this, load it all in memory
 static constexpr const uint16_t kMinLengthSeconds = 30;
@@ -51,15 +59,6 @@ static constexpr const uint16_t kMinLengthSeconds = 30;
 // size of the audio file ring buffer
 static constexpr const uint16_t kRingBufferLengthSeconds = 6;
 
-static inline
-constexpr float max4f(const float a, const float b, const float c, const float d) noexcept
-{
-    return a > b && a > c && a > d ? a :
-           b > a && b > c && b > d ? b :
-           c > a && c > b && c > d ? c :
-           d;
-}
-
 // --------------------------------------------------------------------------------------------------------------------
 
 struct AudioMemoryPool {
@@ -74,6 +73,7 @@ struct AudioMemoryPool {
         destroy();
     }
 
+    // allocates the buffers, the audio thread does not use them until publish() is called
     void create(const uint32_t desiredNumFrames)
     {
         CARLA_ASSERT(buffer[0] == nullptr);
@@ -84,9 +84,13 @@ struct AudioMemoryPool {
         buffer[1] = new float[desiredNumFrames];
         carla_mlock(buffer[0], sizeof(float)*desiredNumFrames);
         carla_mlock(buffer[1], sizeof(float)*desiredNumFrames);
+    }
 
+    // makes the first filledNumFrames frames of the buffers available to the audio thread
+    void publish(const uint32_t filledNumFrames) noexcept
+    {
         const CarlaMutexLocker cml(mutex);
-        numFrames = desiredNumFrames;
+        numFrames = filledNumFrames;
     }
 
     void destroy() noexcept
@@ -114,7 +118,292 @@ struct AudioMemoryPool {
 
 // --------------------------------------------------------------------------------------------------------------------
 
-class AudioFileReader
+/*
+ * Something that streams audio from disk into ring buffers, refilled by the AudioStreamPool threads.
+ */
+class AudioStreamClient
+{
+public:
+    AudioStreamClient() noexcept
+        : fPending(false),
+          fBusy(false) {}
+
+    virtual ~AudioStreamClient() {}
+
+protected:
+    /*
+     * Number of frames that can still be played before running out of data.
+     * Clients closest to an underrun are refilled first.
+     * Called from the pool threads, so it must not look at state owned by the audio thread.
+     */
+    virtual uint32_t getStreamDeadline() const noexcept = 0;
+
+    /*
+     * Read more data from disk, called from one of the pool threads.
+     */
+    virtual void readPoll() = 0;
+
+private:
+    // set by the audio thread when a refill is needed, cleared right before doing it
+    std::atomic<bool> fPending;
+
+    // set while a pool thread is refilling this client
+    std::atomic<bool> fBusy;
+
+    friend class AudioStreamPool;
+
+    CARLA_DECLARE_NON_COPYABLE(AudioStreamClient)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * Disk streaming threads shared by all audio file readers of the process.
+ *
+ * The audio thread calls schedule() when a client has room for more data, which only sets a flag and posts a
+ * semaphore. Pool threads then refill pending clients one at a time, the one with the least buffered data first.
+ * Threads are started with the first client and stopped when the last one goes away.
+ */
+class AudioStreamPool
+{
+public:
+    static AudioStreamPool& getInstance() noexcept
+    {
+        static AudioStreamPool pool;
+        return pool;
+    }
+
+    /*
+     * Register a client, so that the pool threads pick up its refills.
+     * Returns false if the pool has no threads, the client must then be refilled some other way.
+     */
+    bool addClient(AudioStreamClient* const client)
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr, false);
+
+        const CarlaMutexLocker cml1(fThreadsMutex);
+
+        if (fNumClients == 0)
+            _startThreads();
+
+        if (fNumThreads == 0)
+            return false;
+
+        {
+            const CarlaMutexLocker cml2(fClientsMutex);
+            fClients.append(client);
+        }
+
+        ++fNumClients;
+        return true;
+    }
+
+    /*
+     * Unregister a client, waiting for its running refill to finish.
+     */
+    void removeClient(AudioStreamClient* const client) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        const CarlaMutexLocker cml(fThreadsMutex);
+
+        {
+            const CarlaMutexLocker cml2(fClientsMutex);
+
+            if (! fClients.removeOne(client))
+                return;
+        }
+
+        while (client->fBusy.load())
+            carla_msleep(1);
+
+        client->fPending.store(false);
+
+        if (--fNumClients == 0)
+            _stopThreads();
+    }
+
+    /*
+     * Mark a client as needing a refill and wake up a pool thread.
+     * RT safe, never blocks or allocates.
+     */
+    void schedule(AudioStreamClient* const client) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        if (client->fPending.exchange(true))
+            return;
+
+        if (! fPosted.exchange(true))
+            carla_sem_post(fSem);
+    }
+
+private:
+    // protects thread start/stop and the client count
+    CarlaMutex fThreadsMutex;
+    uint fNumClients;
+
+    // protects the client list
+    CarlaMutex fClientsMutex;
+    LinkedList<AudioStreamClient*> fClients;
+
+    // posted when there are pending refills, fPosted avoids posting it twice
+    carla_sem_t fSem;
+    std::atomic<bool> fPosted;
+
+    class StreamThread;
+    StreamThread* fThreads[kFileReaderNumThreads];
+    uint fNumThreads;
+
+    AudioStreamPool() noexcept
+        : fThreadsMutex(),
+          fNumClients(0),
+          fClientsMutex(),
+          fClients(),
+          fPosted(false),
+          fNumThreads(0)
+    {
+        carla_sem_create2(fSem, false);
+        carla_zeroPointers(fThreads, kFileReaderNumThreads);
+    }
+
+    ~AudioStreamPool() noexcept
+    {
+        _stopThreads();
+        carla_sem_destroy2(fSem);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    class StreamThread : public CarlaThread
+    {
+    public:
+        StreamThread(AudioStreamPool* const pool) noexcept
+            : CarlaThread("AudioStreamPool"),
+              kPool(pool) {}
+
+    protected:
+        void run() override
+        {
+            while (! shouldThreadExit())
+            {
+                if (! carla_sem_timedwait(kPool->fSem, 100))
+                    continue;
+
+                kPool->fPosted.store(false);
+
+                bool morePending;
+
+                while (AudioStreamClient* const client = kPool->_claimMostUrgentClient(morePending))
+                {
+                    // let another thread take care of the other clients
+                    if (morePending && ! kPool->fPosted.exchange(true))
+                        carla_sem_post(kPool->fSem);
+
+                    try {
+                        client->readPoll();
+                    } CARLA_SAFE_EXCEPTION("AudioStreamClient::readPoll");
+
+                    client->fBusy.store(false);
+                }
+            }
+        }
+
+    private:
+        AudioStreamPool* const kPool;
+
+        CARLA_DECLARE_NON_COPYABLE(StreamThread)
+    };
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // assumes threads lock is active
+    void _startThreads()
+    {
+        for (uint i=0; i<kFileReaderNumThreads; ++i)
+        {
+            fThreads[i] = new StreamThread(this);
+
+            if (! fThreads[i]->startThread())
+            {
+                carla_stderr2("AudioStreamPool: failed to start disk streaming thread %u", i);
+                delete fThreads[i];
+                fThreads[i] = nullptr;
+                break;
+            }
+
+            fNumThreads = i + 1;
+        }
+    }
+
+    // assumes threads lock is active
+    void _stopThreads() noexcept
+    {
+        for (uint i=0; i<kFileReaderNumThreads; ++i)
+        {
+            if (fThreads[i] != nullptr)
+                fThreads[i]->signalThreadShouldExit();
+        }
+
+        for (uint i=0; i<kFileReaderNumThreads; ++i)
+        {
+            if (fThreads[i] == nullptr)
+                continue;
+
+            fThreads[i]->stopThread(-1);
+            delete fThreads[i];
+            fThreads[i] = nullptr;
+        }
+
+        fNumThreads = 0;
+    }
+
+    // find the pending client closest to an underrun that no other thread is refilling, and mark it busy
+    AudioStreamClient* _claimMostUrgentClient(bool& morePending) noexcept
+    {
+        AudioStreamClient* claimed = nullptr;
+        uint32_t claimedDeadline = UINT32_MAX;
+        morePending = false;
+
+        const CarlaMutexLocker cml(fClientsMutex);
+
+        for (LinkedList<AudioStreamClient*>::Itenerator it = fClients.begin2(); it.valid(); it.next())
+        {
+            AudioStreamClient* const client = it.getValue(nullptr);
+            CARLA_SAFE_ASSERT_CONTINUE(client != nullptr);
+
+            if (! client->fPending.load() || client->fBusy.load())
+                continue;
+
+            const uint32_t deadline = client->getStreamDeadline();
+
+            if (claimed != nullptr)
+            {
+                morePending = true;
+
+                if (deadline >= claimedDeadline)
+                    continue;
+            }
+
+            claimed = client;
+            claimedDeadline = deadline;
+        }
+
+        if (claimed != nullptr)
+        {
+            claimed->fBusy.store(true);
+            claimed->fPending.store(false);
+        }
+
+        return claimed;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(AudioStreamPool)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class AudioFileReader : public AudioStreamClient
 {
 public:
     enum QuadMode {
@@ -124,6 +413,7 @@ public:
     };
 
     AudioFileReader()
+        : AudioStreamClient()
     {
         ad_clear_nfo(&fFileNfo);
     }
@@ -135,6 +425,8 @@ public:
 
     void destroy()
     {
+        stopStreaming();
+
         const CarlaMutexLocker cml(fReaderMutex);
 
         cleanup();
@@ -145,6 +437,11 @@ public:
         return fCurrentBitRate;
     }
 
+    uint32_t getUnderrunCount() const noexcept
+    {
+        return fUnderrunCount;
+    }
+
     float getLastPlayPosition() const noexcept
     {
         return fLastPlayPosition;
@@ -172,6 +469,8 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(filename != nullptr && *filename != '\0', false);
 
+        stopStreaming();
+
         const CarlaMutexLocker cml(fReaderMutex);
 
         cleanup();
@@ -260,7 +559,16 @@ public:
         }
         else
         {
-            readFilePreview(previewDataSize, previewData);
+            // use cached peaks for the preview if possible, generate them in the background otherwise
+            if (fPeaks.loadFromCache(filename, fFileNfo.channels, numFileFrames))
+            {
+                computePreviewFromPeaks(previewDataSize, previewData);
+            }
+            else
+            {
+                carla_zeroFloats(previewData, previewDataSize);
+                fPeaksThread.start(filename);
+            }
 
             // cache only the first few initial seconds, let disk streaming handle the rest
             const uint64_t initialFrames = std::min<uint64_t>(numFileFrames,
@@ -285,6 +593,27 @@ public:
         fTotalResampledFrames = numResampledFrames;
         fSampleRate = sampleRate;
 
+        if (! fEntireFileLoaded)
+            fStreaming = AudioStreamPool::getInstance().addClient(this);
+
+        return true;
+    }
+
+    /*
+     * Request more data to be read from disk by the shared streaming threads, to be called when tickFrames() returns
+     * true. Returns false if this reader is not handled by them, readPoll() must then be called some other way.
+     * RT safe.
+     */
+    bool scheduleRead() noexcept
+    {
+        if (! fStreaming)
+            return false;
+
+        // the streaming threads cannot look at our ring buffer, tell them how urgent this read is
+        // relocations need to happen as soon as possible
+        fStreamDeadline = fNextFileReadPos != -1 ? 0 : fRingBufferR.getReadableDataSize() / sizeof(float);
+
+        AudioStreamPool::getInstance().schedule(this);
         return true;
     }
 
@@ -352,12 +681,16 @@ public:
         {
             // ring buffer is good, waiting for data reads
             if (fRingBufferFramePos == numPoolFrames)
+            {
+                fStreamReady = true;
                 return false;
+            }
 
             // out of bounds, host likely has repositioned transport
             if (fRingBufferFramePos > numPoolFrames)
             {
                 fNextFileReadPos = 0;
+                fStreamReady = false;
                 return true;
             }
 
@@ -368,6 +701,7 @@ public:
                 fRingBufferL.skipRead(framesUpToPoolEnd * sizeof(float));
                 fRingBufferR.skipRead(framesUpToPoolEnd * sizeof(float));
                 fRingBufferFramePos = numPoolFrames;
+                fStreamReady = true;
             }
 
             return true;
@@ -388,6 +722,8 @@ public:
                 if (fNextFileReadPos == -1)
                     fNextFileReadPos = framePos - frames;
 
+                fStreamReady = false;
+
                 return true;
             }
 
@@ -406,7 +742,15 @@ public:
             carla_zeroFloats(outL, frames);
             carla_zeroFloats(outR, frames);
             carla_zeroFloats(playCV, frames);
-            return framePos < fTotalResampledFrames;
+
+            if (framePos >= fTotalResampledFrames)
+                return false;
+
+            // still filling up after a load or relocation, not an underrun
+            if (fStreamReady)
+                ++fUnderrunCount;
+
+            return true;
         }
 
         fRingBufferL.readCustomData(outL, usableFrames * sizeof(float));
@@ -414,6 +758,7 @@ public:
         carla_fillFloatsWithSingleValue(playCV, 10.f, usableFrames);
 
         fRingBufferFramePos += usableFrames;
+        fStreamReady = true;
         totalFramesAvailable -= usableFrames;
 
         if (frames != usableFrames)
@@ -429,82 +774,49 @@ public:
             carla_zeroFloats(outL + usableFrames, frames - usableFrames);
             carla_zeroFloats(outR + usableFrames, frames - usableFrames);
             carla_zeroFloats(playCV + usableFrames, frames - usableFrames);
+
+            if (fStreamReady && fRingBufferFramePos < fTotalResampledFrames)
+                ++fUnderrunCount;
         }
 
-        return totalFramesAvailable <= fSampleRate * 2;
+        // nothing else to read
+        if (fRingBufferFramePos + totalFramesAvailable >= fTotalResampledFrames)
+            return false;
+
+        // read ahead as soon as there is room for a full chunk
+        return fRingBufferR.getWritableDataSize() >= kFileReaderBufferSize * sizeof(float);
     }
 
-    void readFilePreview(uint32_t previewDataSize, float* const previewData)
+    /*
+     * Check if peaks generated in the background are ready, so that readPeaksPreview() can be called.
+     * RT safe.
+     */
+    bool hasPendingPreview() const noexcept
     {
-        carla_zeroFloats(previewData, previewDataSize);
+        return fPeaksThread.isFinished();
+    }
 
-        if (fFileNfo.can_seek == 0)
-            return;
+    /*
+     * Fill @a previewData from the peaks generated in the background.
+     * Returns false if there are no new peaks.
+     */
+    bool readPeaksPreview(const uint32_t previewDataSize, float* const previewData)
+    {
+        const CarlaMutexLocker cml(fReaderMutex);
 
-        const uint fileNumFrames = static_cast<uint>(fFileNfo.frames);
-        const float fileNumFramesF = static_cast<float>(fileNumFrames);
-        const float previewDataSizeF = static_cast<float>(previewDataSize);
-        const uint channels = fFileNfo.channels;
-        const uint samplesPerRun = channels * 4;
-        const uint maxSampleToRead = fileNumFrames - samplesPerRun;
-        const uint8_t quadoffs = fQuadMode == kQuad3and4 ? 2 : 0;
-        float tmp[16] = {};
+        std::vector<uint8_t> data;
 
-        for (uint i=0; i<previewDataSize; ++i)
-        {
-            const float posF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
-            const uint pos = carla_fixedValue(0U, maxSampleToRead, static_cast<uint>(posF));
+        if (! fPeaksThread.takeData(data))
+            return false;
 
-            ad_seek(fFilePtr, pos);
-            ad_read(fFilePtr, tmp, samplesPerRun);
+        if (! fPeaks.loadFromData(data, fFileNfo.channels, static_cast<uint64_t>(fFileNfo.frames)))
+            return false;
 
-            switch (channels)
-            {
-            case 1:
-                previewData[i] = max4f(std::fabs(tmp[0]),
-                                       std::fabs(tmp[1]),
-                                       std::fabs(tmp[2]),
-                                       std::fabs(tmp[3]));
-                break;
-            case 2:
-                previewData[i] = max4f(std::fabs(tmp[0]),
-                                       std::fabs(tmp[2]),
-                                       std::fabs(tmp[4]),
-                                       std::fabs(tmp[6]));
-                previewData[i] = std::max(previewData[i], max4f(std::fabs(tmp[1]),
-                                                                std::fabs(tmp[3]),
-                                                                std::fabs(tmp[5]),
-                                                                std::fabs(tmp[7])));
-                break;
-            case 4:
-                if (fQuadMode == kQuadAll)
-                {
-                    previewData[i] = max4f(std::fabs(tmp[0]) + std::fabs(tmp[4])
-                                           + std::fabs(tmp[8]) + std::fabs(tmp[12]),
-                                           std::fabs(tmp[1]) + std::fabs(tmp[5])
-                                           + std::fabs(tmp[9]) + std::fabs(tmp[13]),
-                                           std::fabs(tmp[2]) + std::fabs(tmp[6])
-                                           + std::fabs(tmp[10]) + std::fabs(tmp[14]),
-                                           std::fabs(tmp[3]) + std::fabs(tmp[7])
-                                           + std::fabs(tmp[11]) + std::fabs(tmp[15]));
-                }
-                else
-                {
-                    previewData[i] = max4f(std::fabs(tmp[quadoffs+0]),
-                                           std::fabs(tmp[quadoffs+4]),
-                                           std::fabs(tmp[quadoffs+8]),
-                                           std::fabs(tmp[quadoffs+12]));
-                    previewData[i] = std::max(previewData[i], max4f(std::fabs(tmp[quadoffs+1]),
-                                                                    std::fabs(tmp[quadoffs+5]),
-                                                                    std::fabs(tmp[quadoffs+9]),
-                                                                    std::fabs(tmp[quadoffs+13])));
-                }
-                break;
-            }
-        }
+        computePreviewFromPeaks(previewDataSize, previewData);
+        return true;
     }
 
-    void readPoll()
+    void readPoll() override
     {
         const CarlaMutexLocker cml(fReaderMutex);
 
@@ -646,6 +958,33 @@ public:
                             sizeof(float) * prev_inp_count * channels);
             }
         }
+        else if (channels <= 2)
+        {
+            // convert straight into per-channel buffers, then write each ring buffer at once
+            float bufferL[kFileReaderBufferSize / 2];
+            float bufferR[kFileReaderBufferSize / 2];
+            float* buffers[2] = { bufferL, channels == 1 ? bufferL : bufferR };
+            ssize_t r;
+
+            while (fRingBufferR.getWritableDataSize() >= sizeof(bufferL))
+            {
+                r = ad_read_planar(fFilePtr, buffers, sizeof(bufferL)/sizeof(float));
+
+                if (r < 0)
+                {
+                    carla_stderr("R: ad_read_planar failed");
+                    break;
+                }
+
+                if (r == 0)
+                    break;
+
+                fRingBufferL.writeCustomData(buffers[0], r * sizeof(float));
+                fRingBufferR.writeCustomData(buffers[1], r * sizeof(float));
+                fRingBufferL.commitWrite();
+                fRingBufferR.commitWrite();
+            }
+        }
         else
         {
             float buffer[kFileReaderBufferSize];
@@ -704,16 +1043,30 @@ public:
             }
         }
 
+        // do not lose a relocation requested by the audio thread while we were reading
         if (nextFileReadPos != -1)
-            fNextFileReadPos = -1;
+        {
+            int64_t expected = nextFileReadPos;
+            fNextFileReadPos.compare_exchange_strong(expected, -1);
+        }
+    }
+
+protected:
+    uint32_t getStreamDeadline() const noexcept override
+    {
+        return fStreamDeadline;
     }
 
 private:
     bool fEntireFileLoaded = false;
+    bool fStreaming = false;
     QuadMode fQuadMode = kQuad1and2;
     int fCurrentBitRate = 0;
+    uint32_t fUnderrunCount = 0;
+    bool fStreamReady = false; // ring buffer has served data since the last load or relocation
     float fLastPlayPosition = 0.f;
-    int64_t fNextFileReadPos = -1;
+    std::atomic<int64_t> fNextFileReadPos { -1 }; // relocation requested by the audio thread, -1 if none
+    std::atomic<uint32_t> fStreamDeadline { 0 }; // published by the audio thread when scheduling a read
     uint64_t fTotalResampledFrames = 0;
 
     void*  fFilePtr = nullptr;
@@ -726,6 +1079,9 @@ private:
     Resampler     fResampler;
     CarlaMutex    fReaderMutex;
 
+    AudioPeaks       fPeaks;
+    AudioPeaksThread fPeaksThread;
+
     struct PreviousResampledBuffer {
         float* buffer = nullptr;
         uint32_t frames = 0;
@@ -734,18 +1090,33 @@ private:
     CarlaHeapRingBuffer fRingBufferL, fRingBufferR;
     uint64_t fRingBufferFramePos = 0;
 
+    // must be called without the reader lock, as streaming threads might be waiting for it
+    void stopStreaming() noexcept
+    {
+        if (! fStreaming)
+            return;
+
+        fStreaming = false;
+        AudioStreamPool::getInstance().removeClient(this);
+    }
+
     // assumes reader lock is active
     void cleanup()
     {
         fEntireFileLoaded = false;
         fCurrentBitRate = 0;
+        fUnderrunCount = 0;
+        fStreamReady = false;
         fLastPlayPosition = 0.f;
         fNextFileReadPos = -1;
+        fStreamDeadline = 0;
         fTotalResampledFrames = 0;
         fSampleRate = 0;
         fRingBufferFramePos = 0;
         fResampleRatio = 1.0;
 
+        fPeaksThread.stop();
+        fPeaks.clear();
         fResampler.clear();
         fInitialMemoryPool.destroy();
         fRingBufferL.deleteBuffer();
@@ -762,9 +1133,51 @@ private:
         fPreviousResampledBuffer.frames = 0;
     }
 
+    // assumes reader lock is active
+    void computePreviewFromPeaks(const uint32_t previewDataSize, float* const previewData) const noexcept
+    {
+        switch (fFileNfo.channels)
+        {
+        case 1:
+            fPeaks.computePreview(previewDataSize, previewData, 0, 1, false);
+            break;
+        case 2:
+            fPeaks.computePreview(previewDataSize, previewData, 0, 2, false);
+            break;
+        case 4:
+            if (fQuadMode == kQuadAll)
+                fPeaks.computePreview(previewDataSize, previewData, 0, 4, true);
+            else
+                fPeaks.computePreview(previewDataSize, previewData, fQuadMode == kQuad3and4 ? 2 : 0, 2, false);
+            break;
+        default:
+            carla_zeroFloats(previewData, previewDataSize);
+            break;
+        }
+    }
+
     void readIntoInitialMemoryPool(const uint numFrames, const uint numResampledFrames)
     {
         const uint channels = fFileNfo.channels;
+
+        if (numFrames == numResampledFrames && channels <= 2)
+        {
+            // no resampling or mixing needed, convert straight into the memory pool
+            // the pool is not published yet, so we can write to it without taking its lock
+            float* buffers[2] = { fInitialMemoryPool.buffer[0], fInitialMemoryPool.buffer[1] };
+
+            ad_seek(fFilePtr, 0);
+            const ssize_t rv = ad_read_planar(fFilePtr, buffers, numFrames);
+            CARLA_SAFE_ASSERT_INT2_RETURN(rv == static_cast<ssize_t>(numFrames), rv, numFrames,);
+
+            if (channels == 1)
+                carla_copyFloats(buffers[1], buffers[0], numFrames);
+
+            fCurrentBitRate = ad_get_bitrate(fFilePtr);
+            fInitialMemoryPool.publish(numFrames);
+            return;
+        }
+
         const uint fileBufferSize = numFrames * channels;
 
         float* const fileBuffer = (float*)std::malloc(fileBufferSize * sizeof(float));
@@ -779,6 +1192,7 @@ private:
         fCurrentBitRate = ad_get_bitrate(fFilePtr);
 
         float* resampledBuffer;
+        uint poolFrames;
 
         if (numFrames != numResampledFrames)
         {
@@ -791,54 +1205,53 @@ private:
             fResampler.out_data = resampledBuffer;
             fResampler.process();
 
-            fInitialMemoryPool.numFrames = numResampledFrames - fResampler.out_count;
-            rv = fInitialMemoryPool.numFrames * channels;
+            poolFrames = numResampledFrames - fResampler.out_count;
+            rv = poolFrames * channels;
         }
         else
         {
             resampledBuffer = fileBuffer;
+            poolFrames = numFrames;
         }
 
+        // the pool is not published yet, so we can write to it without taking its lock
+        switch (channels)
         {
-            // lock, and put data asap
-            const CarlaMutexLocker cml(fInitialMemoryPool.mutex);
-
-            switch (channels)
+        case 1:
+            for (ssize_t i=0; i < rv; ++i)
+                fInitialMemoryPool.buffer[0][i] = fInitialMemoryPool.buffer[1][i] = resampledBuffer[i];
+            break;
+        case 2:
+            for (ssize_t i=0, j=0; i < rv; ++j)
+            {
+                fInitialMemoryPool.buffer[0][j] = resampledBuffer[i++];
+                fInitialMemoryPool.buffer[1][j] = resampledBuffer[i++];
+            }
+            break;
+        case 4:
+            if (fQuadMode == kQuadAll)
             {
-            case 1:
-                for (ssize_t i=0; i < rv; ++i)
-                    fInitialMemoryPool.buffer[0][i] = fInitialMemoryPool.buffer[1][i] = resampledBuffer[i];
-                break;
-            case 2:
                 for (ssize_t i=0, j=0; i < rv; ++j)
                 {
-                    fInitialMemoryPool.buffer[0][j] = resampledBuffer[i++];
-                    fInitialMemoryPool.buffer[1][j] = resampledBuffer[i++];
-                }
-                break;
-            case 4:
-                if (fQuadMode == kQuadAll)
-                {
-                    for (ssize_t i=0, j=0; i < rv; ++j)
-                    {
-                        fInitialMemoryPool.buffer[0][j] = fInitialMemoryPool.buffer[1][j]
-                            = resampledBuffer[i] + resampledBuffer[i+1] + resampledBuffer[i+2] + resampledBuffer[i+3];
-                        i += 4;
-                    }
+                    fInitialMemoryPool.buffer[0][j] = fInitialMemoryPool.buffer[1][j]
+                        = resampledBuffer[i] + resampledBuffer[i+1] + resampledBuffer[i+2] + resampledBuffer[i+3];
+                    i += 4;
                 }
-                else
+            }
+            else
+            {
+                for (ssize_t i = fQuadMode == kQuad3and4 ? 2 : 0, j = 0; i < rv; ++j)
                 {
-                    for (ssize_t i = fQuadMode == kQuad3and4 ? 2 : 0, j = 0; i < rv; ++j)
-                    {
-                        fInitialMemoryPool.buffer[0][j] = resampledBuffer[i];
-                        fInitialMemoryPool.buffer[1][j] = resampledBuffer[i+1];
-                        i += 4;
-                    }
+                    fInitialMemoryPool.buffer[0][j] = resampledBuffer[i];
+                    fInitialMemoryPool.buffer[1][j] = resampledBuffer[i+1];
+                    i += 4;
                 }
-                break;
             }
+            break;
         }
 
+        fInitialMemoryPool.publish(poolFrames);
+
         if (resampledBuffer != fileBuffer)
             std::free(resampledBuffer);
 
@@ -114,6 +114,7 @@ public:
         kParameterInfoLength,
         kParameterInfoPosition,
         kParameterInfoPoolFill,
+        kParameterInfoUnderruns,
         kParameterCount
     };
 
@@ -282,6 +283,16 @@ protected:
             param.ranges.max = 100.0f;
             param.unit = "%";
             break;
+        case kParameterInfoUnderruns:
+            param.name  = "Underruns";
+            param.hints = static_cast<NativeParameterHints>(NATIVE_PARAMETER_IS_AUTOMATABLE|
+                                                            NATIVE_PARAMETER_IS_ENABLED|
+                                                            NATIVE_PARAMETER_IS_INTEGER|
+                                                            NATIVE_PARAMETER_IS_OUTPUT);
+            param.ranges.def = 0.0f;
+            param.ranges.min = 0.0f;
+            param.ranges.max = (float)UINT32_MAX;
+            break;
         default:
             return nullptr;
         }
@@ -307,6 +318,8 @@ protected:
             return fLastPosition;
         case kParameterInfoPoolFill:
             return fReadableBufferFill;
+        case kParameterInfoUnderruns:
+            return static_cast<float>(fReader.getUnderrunCount());
         case kParameterInfoBitRate:
             return static_cast<float>(fReader.getCurrentBitRate());
         }
@@ -422,6 +435,13 @@ protected:
             return;
         }
 
+        // peaks were generated in the background, send the new preview on idle
+        if (! fPendingPreviewUpdate && fReader.hasPendingPreview())
+        {
+            fPendingPreviewUpdate = true;
+            hostRequestIdle();
+        }
+
         bool playing;
         uint64_t framePos;
 
@@ -451,7 +471,9 @@ protected:
 
         bool needsIdleRequest = false;
 
-        if (fReader.tickFrames(outBuffer, 0, frames, framePos, fLoopMode, isOffline()) && ! fPendingFileRead)
+        // disk reads are done by the shared streaming threads, or on idle if those are not available
+        if (fReader.tickFrames(outBuffer, 0, frames, framePos, fLoopMode, isOffline())
+            && ! fReader.scheduleRead() && ! fPendingFileRead)
         {
             fPendingFileRead = true;
             needsIdleRequest = true;
@@ -524,6 +546,16 @@ protected:
             fPendingFileRead = false;
             fReader.readPoll();
         }
+
+        if (fPendingPreviewUpdate)
+        {
+            fPendingPreviewUpdate = false;
+
+            constexpr uint32_t kPreviewDataLen = sizeof(fPreviewData)/sizeof(float);
+
+            if (fReader.readPeaksPreview(kPreviewDataLen, fPreviewData))
+                hostSendPreviewBufferData('f', kPreviewDataLen, fPreviewData);
+        }
     }
 
     void sampleRateChanged(const double sampleRate) override
@@ -662,6 +694,7 @@ private:
     bool fDoProcess = false;
     bool fPendingFileRead = false;
     bool fPendingFileReload = false;
+    bool fPendingPreviewUpdate = false;
     AudioFileReader::QuadMode fQuadMode = AudioFileReader::kQuad1and2;
 
     uint32_t fInternalTransportFrame = 0;
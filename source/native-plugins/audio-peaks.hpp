@@ -0,0 +1,634 @@
+/*
+ * Carla Native Plugins
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the GPL.txt file
+ */
+
+#ifndef AUDIO_PEAKS_HPP_INCLUDED
+#define AUDIO_PEAKS_HPP_INCLUDED
+
+#include "CarlaCacheUtils.hpp"
+#include "CarlaMappedFileUtils.hpp"
+#include "CarlaSha1Utils.hpp"
+#include "CarlaString.hpp"
+#include "CarlaThread.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <vector>
+
+extern "C" {
+#include "audio_decoder/ad.h"
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// tuning
+
+// number of frames per peak in the finest level
+static constexpr const uint32_t kPeaksBaseFramesPerPeak = 512;
+
+// each level has this many times less peaks than the previous one
+static constexpr const uint32_t kPeaksLevelFactor = 4;
+
+// no more levels are added once a level has this many peaks or less
+static constexpr const uint32_t kPeaksMinPeaksPerLevel = 256;
+
+// samples decoded at once while generating peaks
+static constexpr const uint32_t kPeaksReadBufferSize = 8192;
+
+// peak files not written for this long are removed from the cache, in days
+static constexpr const int64_t kPeaksCacheMaxAge = 90;
+
+// oldest peak files are removed once the cache grows beyond this size, in bytes
+static constexpr const int64_t kPeaksCacheMaxSize = 256 * 1024 * 1024;
+
+// --------------------------------------------------------------------------------------------------------------------
+// peak file layout
+
+/*
+ * Peak files start with this header, followed by one AudioPeaksLevel per level and then the peak data.
+ * Each peak is stored as a min/max pair of int16 values per channel, interleaved.
+ * Files are only used by the machine that writes them, so values are in native byte order.
+ */
+struct AudioPeaksHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t channels;
+    int64_t fileTime;
+    int64_t fileSize;
+    uint64_t numFrames;
+    uint32_t numLevels;
+    uint32_t reserved;
+};
+
+struct AudioPeaksLevel {
+    uint32_t framesPerPeak;
+    uint32_t numPeaks;
+    uint64_t offset; // in bytes, from the start of the file
+};
+
+static const char kPeaksMagic[8] = { 'C','A','R','L','A','P','K','S' };
+static constexpr const uint32_t kPeaksVersion = 1;
+
+static inline
+int16_t carla_peakFromFloat(const float value) noexcept
+{
+    return static_cast<int16_t>(carla_fixedValue(-1.f, 1.f, value) * 32767.f);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * Min/max peaks of an audio file at several zoom levels, used for previews.
+ * Peaks are kept in the cache folder, named after the file path and checked against its modification time and size.
+ */
+class AudioPeaks
+{
+public:
+    AudioPeaks() noexcept
+        : fMappedFile(),
+          fOwnedData(),
+          fData(nullptr),
+          fSize(0) {}
+
+    void clear() noexcept
+    {
+        fMappedFile.close();
+        fOwnedData.clear();
+        fData = nullptr;
+        fSize = 0;
+    }
+
+    bool isValid() const noexcept
+    {
+        return fData != nullptr;
+    }
+
+    /*
+     * Map the cached peaks of @a filename, if they exist and match the current file.
+     */
+    bool loadFromCache(const char* const filename, const uint channels, const uint64_t numFrames) noexcept
+    {
+        clear();
+
+        water::File peakFile;
+        int64_t fileTime, fileSize;
+
+        if (! getPeakFile(filename, peakFile, fileTime, fileSize))
+            return false;
+
+        if (! peakFile.existsAsFile())
+            return false;
+
+        if (! fMappedFile.open(peakFile.getFullPathName().toRawUTF8()))
+            return false;
+
+        if (! validate(static_cast<const uint8_t*>(fMappedFile.getData()), fMappedFile.getSize(),
+                       channels, fileTime, fileSize, numFrames))
+        {
+            carla_stderr("AudioPeaks: ignoring outdated or invalid peak file for '%s'", filename);
+            fMappedFile.close();
+            return false;
+        }
+
+        fData = static_cast<const uint8_t*>(fMappedFile.getData());
+        fSize = fMappedFile.getSize();
+
+        // pruneCache() goes by modification time, so keep peaks that are in use around the longest
+        carla_touchCacheFile(peakFile);
+        return true;
+    }
+
+    /*
+     * Use freshly generated peak data, which is kept in memory.
+     */
+    bool loadFromData(std::vector<uint8_t>& data, const uint channels, const uint64_t numFrames) noexcept
+    {
+        clear();
+
+        if (! validate(data.data(), data.size(), channels, -1, -1, numFrames))
+            return false;
+
+        fOwnedData.swap(data);
+        fData = fOwnedData.data();
+        fSize = fOwnedData.size();
+        return true;
+    }
+
+    /*
+     * Fill @a previewData with the absolute peak value of @a previewDataSize evenly spaced regions of the file.
+     * Uses channels from @a channelOffset to @a channelOffset + @a numChannels, summed or as their maximum.
+     */
+    void computePreview(const uint32_t previewDataSize, float* const previewData,
+                        const uint channelOffset, const uint numChannels, const bool sumChannels) const noexcept
+    {
+        carla_zeroFloats(previewData, previewDataSize);
+        CARLA_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        AudioPeaksHeader header;
+        std::memcpy(&header, fData, sizeof(header));
+        CARLA_SAFE_ASSERT_RETURN(channelOffset + numChannels <= header.channels,);
+
+        // use the coarsest level that still has at least one peak per preview point
+        const uint64_t framesPerPoint = std::max<uint64_t>(1, header.numFrames / previewDataSize);
+        AudioPeaksLevel level;
+        std::memcpy(&level, fData + sizeof(header), sizeof(level));
+
+        for (uint32_t l=1; l<header.numLevels; ++l)
+        {
+            AudioPeaksLevel next;
+            std::memcpy(&next, fData + sizeof(header) + sizeof(next) * l, sizeof(next));
+
+            if (next.framesPerPeak > framesPerPoint)
+                break;
+
+            level = next;
+        }
+
+        if (level.numPeaks == 0)
+            return;
+
+        const int16_t* const peaks = reinterpret_cast<const int16_t*>(fData + level.offset);
+        const uint peakStride = header.channels * 2;
+
+        for (uint32_t i=0; i<previewDataSize; ++i)
+        {
+            const uint64_t startFrame = header.numFrames * i / previewDataSize;
+            const uint64_t endFrame = header.numFrames * (i + 1) / previewDataSize;
+
+            const uint32_t firstPeak = std::min<uint64_t>(startFrame / level.framesPerPeak, level.numPeaks - 1);
+            const uint32_t lastPeak = carla_fixedValue<uint64_t>(firstPeak + 1, level.numPeaks,
+                                                                 (endFrame + level.framesPerPeak - 1)
+                                                                 / level.framesPerPeak);
+            float value = 0.f;
+
+            for (uint32_t p=firstPeak; p<lastPeak; ++p)
+            {
+                const int16_t* const peak = peaks + p * peakStride + channelOffset * 2;
+                float peakValue = 0.f;
+
+                for (uint c=0; c<numChannels; ++c)
+                {
+                    const float absValue = static_cast<float>(std::max(-static_cast<int>(peak[c * 2]),
+                                                                       static_cast<int>(peak[c * 2 + 1])))
+                                         / 32767.f;
+
+                    if (sumChannels)
+                        peakValue += absValue;
+                    else if (absValue > peakValue)
+                        peakValue = absValue;
+                }
+
+                if (peakValue > value)
+                    value = peakValue;
+            }
+
+            previewData[i] = value;
+        }
+    }
+
+    /*
+     * Get the cache file used for the peaks of @a filename, and the file details stored in it.
+     * Returns false if caching is disabled or the file does not exist.
+     */
+    static bool getPeakFile(const char* const filename, water::File& peakFile, int64_t& fileTime, int64_t& fileSize)
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+
+        const water::File file(filename);
+
+        if (! file.existsAsFile())
+            return false;
+
+        water::File cacheFolder;
+
+        if (! carla_getCacheFolder(cacheFolder))
+            return false;
+
+        const CarlaString fullPath(file.getFullPathName().toRawUTF8());
+
+        CarlaSha1 sha1;
+        sha1.write(fullPath.buffer(), fullPath.length());
+
+        CarlaString peakFilename(sha1.resultAsString());
+        peakFilename += ".peaks";
+
+        peakFile = cacheFolder.getChildFile("peaks").getChildFile(peakFilename.buffer());
+        fileTime = file.getLastModificationTime();
+        fileSize = file.getSize();
+        return true;
+    }
+
+    /*
+     * Remove peak files that were not used for too long, and then the least recently used ones until the cache size
+     * is within limits.
+     * @a keepFile is never removed, meant for the file that was just written.
+     */
+    static void pruneCache(const water::File& peaksFolder, const water::File& keepFile)
+    {
+        std::vector<water::File> files;
+        peaksFolder.findChildFiles(files, water::File::findFiles, false, "*.peaks");
+
+        const int64_t minTime = (static_cast<int64_t>(std::time(nullptr)) - kPeaksCacheMaxAge * 24 * 60 * 60) * 1000;
+
+        std::vector<std::pair<int64_t, water::File> > entries;
+        entries.reserve(files.size());
+
+        int64_t totalSize = 0;
+
+        for (std::vector<water::File>::const_iterator it = files.begin(); it != files.end(); ++it)
+        {
+            if (*it == keepFile)
+            {
+                totalSize += it->getSize();
+                continue;
+            }
+
+            const int64_t mtime = it->getLastModificationTime();
+
+            if (mtime < minTime)
+            {
+                it->deleteFile();
+                continue;
+            }
+
+            totalSize += it->getSize();
+            entries.push_back(std::make_pair(mtime, *it));
+        }
+
+        if (totalSize <= kPeaksCacheMaxSize)
+            return;
+
+        std::sort(entries.begin(), entries.end(), compareCacheEntries);
+
+        for (std::vector<std::pair<int64_t, water::File> >::const_iterator it = entries.begin();
+             it != entries.end() && totalSize > kPeaksCacheMaxSize; ++it)
+        {
+            const int64_t size = it->second.getSize();
+
+            if (it->second.deleteFile())
+                totalSize -= size;
+        }
+    }
+
+    /*
+     * Decode a whole file from @a filePtr and compute its peaks into @a data, ready to be written as a peak file.
+     * Returns false on read errors or if @a thread is asked to stop meanwhile.
+     */
+    static bool generate(void* const filePtr, const struct adinfo& nfo, const int64_t fileTime, const int64_t fileSize,
+                         std::vector<uint8_t>& data, CarlaThread* const thread)
+    {
+        const uint channels = nfo.channels;
+        CARLA_SAFE_ASSERT_RETURN(channels == 1 || channels == 2 || channels == 4, false);
+
+        // finest level, straight from the file
+        std::vector<int16_t> basePeaks;
+        basePeaks.reserve(static_cast<std::size_t>(nfo.frames / kPeaksBaseFramesPerPeak + 1) * channels * 2);
+
+        float buffer[kPeaksReadBufferSize];
+        float peakMin[4], peakMax[4];
+        uint32_t peakFrames = 0;
+
+        for (uint c=0; c<channels; ++c)
+            peakMin[c] = peakMax[c] = 0.f;
+
+        for (;;)
+        {
+            if (thread->shouldThreadExit())
+                return false;
+
+            const ssize_t r = ad_read(filePtr, buffer, kPeaksReadBufferSize);
+
+            if (r < 0)
+            {
+                carla_stderr("AudioPeaks: ad_read failed");
+                return false;
+            }
+
+            if (r == 0)
+                break;
+
+            for (ssize_t i=0; i + static_cast<ssize_t>(channels) <= r; i += channels)
+            {
+                for (uint c=0; c<channels; ++c)
+                {
+                    const float v = buffer[i + c];
+
+                    if (v < peakMin[c])
+                        peakMin[c] = v;
+                    if (v > peakMax[c])
+                        peakMax[c] = v;
+                }
+
+                if (++peakFrames == kPeaksBaseFramesPerPeak)
+                {
+                    for (uint c=0; c<channels; ++c)
+                    {
+                        basePeaks.push_back(carla_peakFromFloat(peakMin[c]));
+                        basePeaks.push_back(carla_peakFromFloat(peakMax[c]));
+                        peakMin[c] = peakMax[c] = 0.f;
+                    }
+
+                    peakFrames = 0;
+                }
+            }
+        }
+
+        if (peakFrames != 0)
+        {
+            for (uint c=0; c<channels; ++c)
+            {
+                basePeaks.push_back(carla_peakFromFloat(peakMin[c]));
+                basePeaks.push_back(carla_peakFromFloat(peakMax[c]));
+            }
+        }
+
+        const uint peakStride = channels * 2;
+        const uint32_t numBasePeaks = static_cast<uint32_t>(basePeaks.size() / peakStride);
+        CARLA_SAFE_ASSERT_RETURN(numBasePeaks != 0, false);
+
+        // find out the size of all levels
+        std::vector<AudioPeaksLevel> levels;
+        uint64_t offset = sizeof(AudioPeaksHeader);
+
+        for (uint32_t framesPerPeak = kPeaksBaseFramesPerPeak, numPeaks = numBasePeaks;;
+             framesPerPeak *= kPeaksLevelFactor, numPeaks = (numPeaks + kPeaksLevelFactor - 1) / kPeaksLevelFactor)
+        {
+            const AudioPeaksLevel level = { framesPerPeak, numPeaks, 0 };
+            levels.push_back(level);
+
+            if (numPeaks <= kPeaksMinPeaksPerLevel)
+                break;
+        }
+
+        offset += sizeof(AudioPeaksLevel) * levels.size();
+
+        for (AudioPeaksLevel& level : levels)
+        {
+            level.offset = offset;
+            offset += sizeof(int16_t) * peakStride * level.numPeaks;
+        }
+
+        data.resize(offset);
+
+        // write header, level table and base peaks
+        AudioPeaksHeader header;
+        carla_zeroStruct(header);
+        std::memcpy(header.magic, kPeaksMagic, sizeof(header.magic));
+        header.version = kPeaksVersion;
+        header.channels = channels;
+        header.fileTime = fileTime;
+        header.fileSize = fileSize;
+        header.numFrames = static_cast<uint64_t>(nfo.frames);
+        header.numLevels = static_cast<uint32_t>(levels.size());
+
+        std::memcpy(data.data(), &header, sizeof(header));
+        std::memcpy(data.data() + sizeof(header), levels.data(), sizeof(AudioPeaksLevel) * levels.size());
+        std::memcpy(data.data() + levels[0].offset, basePeaks.data(), sizeof(int16_t) * basePeaks.size());
+
+        // each other level merges groups of peaks from the previous one
+        for (std::size_t l=1; l<levels.size(); ++l)
+        {
+            const int16_t* const src = reinterpret_cast<const int16_t*>(data.data() + levels[l-1].offset);
+            int16_t* const dst = reinterpret_cast<int16_t*>(data.data() + levels[l].offset);
+
+            for (uint32_t p=0; p<levels[l].numPeaks; ++p)
+            {
+                const uint32_t first = p * kPeaksLevelFactor;
+                const uint32_t last = std::min(first + kPeaksLevelFactor, levels[l-1].numPeaks);
+
+                for (uint c=0; c<channels; ++c)
+                {
+                    int16_t min = src[first * peakStride + c * 2];
+                    int16_t max = src[first * peakStride + c * 2 + 1];
+
+                    for (uint32_t s=first+1; s<last; ++s)
+                    {
+                        min = std::min(min, src[s * peakStride + c * 2]);
+                        max = std::max(max, src[s * peakStride + c * 2 + 1]);
+                    }
+
+                    dst[p * peakStride + c * 2] = min;
+                    dst[p * peakStride + c * 2 + 1] = max;
+                }
+            }
+        }
+
+        return true;
+    }
+
+private:
+    static bool compareCacheEntries(const std::pair<int64_t, water::File>& a,
+                                    const std::pair<int64_t, water::File>& b) noexcept
+    {
+        return a.first < b.first;
+    }
+
+    CarlaMappedFile fMappedFile;
+    std::vector<uint8_t> fOwnedData;
+    const uint8_t* fData;
+    std::size_t fSize;
+
+    // negative file time or size skips checking them
+    static bool validate(const uint8_t* const data, const std::size_t size, const uint channels,
+                         const int64_t fileTime, const int64_t fileSize, const uint64_t numFrames) noexcept
+    {
+        AudioPeaksHeader header;
+        CARLA_SAFE_ASSERT_RETURN(size >= sizeof(header), false);
+        std::memcpy(&header, data, sizeof(header));
+
+        if (std::memcmp(header.magic, kPeaksMagic, sizeof(header.magic)) != 0 || header.version != kPeaksVersion)
+            return false;
+        if (header.channels != channels || header.numFrames != numFrames || header.numLevels == 0)
+            return false;
+        if ((fileTime >= 0 && header.fileTime != fileTime) || (fileSize >= 0 && header.fileSize != fileSize))
+            return false;
+        if (size < sizeof(header) + sizeof(AudioPeaksLevel) * header.numLevels)
+            return false;
+
+        for (uint32_t l=0; l<header.numLevels; ++l)
+        {
+            AudioPeaksLevel level;
+            std::memcpy(&level, data + sizeof(header) + sizeof(level) * l, sizeof(level));
+
+            if (level.framesPerPeak == 0 || level.offset % sizeof(int16_t) != 0)
+                return false;
+            if (level.offset + sizeof(int16_t) * channels * 2 * level.numPeaks > size)
+                return false;
+        }
+
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(AudioPeaks)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * Generates the peaks of a file in the background, using its own decoder instance, and writes them to the cache.
+ */
+class AudioPeaksThread : public CarlaThread
+{
+public:
+    AudioPeaksThread() noexcept
+        : CarlaThread("AudioPeaksThread"),
+          fFilename(),
+          fData(),
+          fFinished(false) {}
+
+    ~AudioPeaksThread() noexcept override
+    {
+        stop();
+    }
+
+    /*
+     * Start generating peaks for @a filename, stopping any previous generation.
+     */
+    void start(const char* const filename)
+    {
+        stop();
+
+        fFilename = filename;
+        fData.clear();
+        fFinished.store(false);
+
+        startThread();
+    }
+
+    /*
+     * Stop generating peaks, discarding any results.
+     */
+    void stop() noexcept
+    {
+        stopThread(-1);
+        fData.clear();
+        fFinished.store(false);
+    }
+
+    /*
+     * Check if peaks have been generated and not taken yet.
+     */
+    bool isFinished() const noexcept
+    {
+        return fFinished.load();
+    }
+
+    /*
+     * Take the generated peak data.
+     */
+    bool takeData(std::vector<uint8_t>& data)
+    {
+        if (! fFinished.exchange(false))
+            return false;
+
+        stopThread(-1);
+        data.swap(fData);
+        fData.clear();
+        return ! data.empty();
+    }
+
+protected:
+    void run() override
+    {
+        water::File peakFile;
+        int64_t fileTime, fileSize;
+        const bool hasPeakFile = AudioPeaks::getPeakFile(fFilename, peakFile, fileTime, fileSize);
+
+        struct adinfo nfo;
+        ad_clear_nfo(&nfo);
+
+        void* const filePtr = ad_open(fFilename, &nfo);
+        CARLA_SAFE_ASSERT_RETURN(filePtr != nullptr,);
+
+        const bool ok = AudioPeaks::generate(filePtr, nfo,
+                                             hasPeakFile ? fileTime : 0,
+                                             hasPeakFile ? fileSize : 0,
+                                             fData, this);
+        ad_close(filePtr);
+
+        if (! ok)
+        {
+            fData.clear();
+            return;
+        }
+
+        carla_debug("AudioPeaksThread: generated peaks for '%s'", fFilename.buffer());
+
+        if (hasPeakFile)
+        {
+            if (! peakFile.getParentDirectory().createDirectory().wasOk())
+                carla_stderr2("AudioPeaksThread: failed to create peaks folder");
+            else if (! peakFile.replaceWithData(fData.data(), fData.size()))
+                carla_stderr2("AudioPeaksThread: failed to write '%s'", peakFile.getFullPathName().toRawUTF8());
+            else
+                AudioPeaks::pruneCache(peakFile.getParentDirectory(), peakFile);
+        }
+
+        fFinished.store(true);
+    }
+
+private:
+    CarlaString fFilename;
+    std::vector<uint8_t> fData;
+    std::atomic<bool> fFinished;
+
+    CARLA_DECLARE_NON_COPYABLE(AudioPeaksThread)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // AUDIO_PEAKS_HPP_INCLUDED
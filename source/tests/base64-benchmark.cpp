@@ -0,0 +1,272 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBase64Utils.hpp"
+#include "CarlaString.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+// --------------------------------------------------------------------------------------------------------------------
+// Base64 as previously done, one character at a time
+
+static const char* const kOldBase64Chars =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+static CarlaString encodeOld(const void* const data, const std::size_t dataSize)
+{
+    static const std::size_t kTmpBufSize = 65536U;
+
+    const uchar* bytesToEncode((const uchar*)data);
+
+    uint i=0, j=0;
+    uint charArray3[3], charArray4[4];
+
+    char* const strBuf = new char[kTmpBufSize+1];
+    strBuf[kTmpBufSize] = '\0';
+    std::size_t strBufIndex = 0;
+
+    CarlaString ret;
+
+    for (std::size_t s=0; s<dataSize; ++s)
+    {
+        charArray3[i++] = *(bytesToEncode++);
+
+        if (i == 3)
+        {
+            charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
+            charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
+            charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
+            charArray4[3] =   charArray3[2] & 0x3f;
+
+            for (i=0; i<4; ++i)
+                strBuf[strBufIndex++] = kOldBase64Chars[charArray4[i]];
+
+            if (strBufIndex >= kTmpBufSize-7)
+            {
+                strBuf[strBufIndex] = '\0';
+                strBufIndex = 0;
+                ret += strBuf;
+            }
+
+            i = 0;
+        }
+    }
+
+    if (i != 0)
+    {
+        for (j=i; j<3; ++j)
+            charArray3[j] = '\0';
+
+        charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
+        charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
+        charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
+        charArray4[3] =   charArray3[2] & 0x3f;
+
+        for (j=0; j<4 && i<3 && j<i+1; ++j)
+            strBuf[strBufIndex++] = kOldBase64Chars[charArray4[j]];
+
+        for (; i++ < 3;)
+            strBuf[strBufIndex++] = '=';
+    }
+
+    if (strBufIndex != 0)
+    {
+        strBuf[strBufIndex] = '\0';
+        ret += strBuf;
+    }
+
+    delete[] strBuf;
+    return ret;
+}
+
+static uint8_t findOldBase64CharIndex(const char c)
+{
+    for (uint8_t i=0; i<64; ++i)
+    {
+        if (kOldBase64Chars[i] == c)
+            return i;
+    }
+
+    return 0;
+}
+
+static std::vector<uint8_t> decodeOld(const char* const base64string)
+{
+    std::vector<uint8_t> vector;
+
+    uint i=0, j=0;
+    uint charArray3[3], charArray4[4];
+
+    vector.reserve(std::strlen(base64string)*3/4 + 4);
+
+    for (std::size_t l=0, len=std::strlen(base64string); l<len; ++l)
+    {
+        const char c = base64string[l];
+
+        if (c == '\0' || c == '=')
+            break;
+        if (c == ' ' || c == '\n')
+            continue;
+        if (! (std::isalnum(c) || c == '+' || c == '/'))
+            continue;
+
+        charArray4[i++] = static_cast<uint>(c);
+
+        if (i == 4)
+        {
+            for (i=0; i<4; ++i)
+                charArray4[i] = findOldBase64CharIndex(static_cast<char>(charArray4[i]));
+
+            charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
+            charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
+            charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+
+            for (i=0; i<3; ++i)
+                vector.push_back(static_cast<uint8_t>(charArray3[i]));
+
+            i = 0;
+        }
+    }
+
+    if (i != 0)
+    {
+        for (j=0; j<i && j<4; ++j)
+            charArray4[j] = findOldBase64CharIndex(static_cast<char>(charArray4[j]));
+
+        for (j=i; j<4; ++j)
+            charArray4[j] = 0;
+
+        charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
+        charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
+        charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+
+        for (j=0; i>0 && j<i-1; j++)
+            vector.push_back(static_cast<uint8_t>(charArray3[j]));
+    }
+
+    return vector;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// Split into lines the same way project files do
+static CarlaString splitLines(const CarlaString& base64)
+{
+    static const std::size_t kLineWidth = 120;
+
+    const std::size_t len = base64.length();
+    char* const strBuf = static_cast<char*>(std::malloc(len + len / kLineWidth + 2));
+
+    std::size_t w = 0;
+
+    for (std::size_t r=0; r<len; r+=kLineWidth)
+    {
+        const std::size_t n = std::min(kLineWidth, len - r);
+        std::memcpy(strBuf + w, base64.buffer() + r, n);
+        w += n;
+        strBuf[w++] = '\n';
+    }
+
+    strBuf[w] = '\0';
+    return CarlaString(strBuf, false);
+}
+
+static double toMBps(const std::size_t size, const uint64_t timeUs, const uint iterations)
+{
+    return static_cast<double>(size) * iterations / static_cast<double>(timeUs != 0 ? timeUs : 1);
+}
+
+static bool benchmark(const std::size_t size, const uint iterations)
+{
+    std::vector<uint8_t> data(size);
+
+    for (std::size_t i=0; i<size; ++i)
+        data[i] = static_cast<uint8_t>(std::rand());
+
+    CarlaString oldEncoded, newEncoded;
+    std::vector<uint8_t> oldDecoded, newDecoded;
+    uint64_t oldEncodeTime = 0, newEncodeTime = 0, oldDecodeTime = 0, newDecodeTime = 0;
+    uint64_t t;
+
+    for (uint n=0; n<iterations; ++n)
+    {
+        t = carla_gettime_us();
+        oldEncoded = encodeOld(data.data(), size);
+        oldEncodeTime += carla_gettime_us() - t;
+
+        t = carla_gettime_us();
+        newEncoded = CarlaString::asBase64(data.data(), size);
+        newEncodeTime += carla_gettime_us() - t;
+    }
+
+    if (oldEncoded != newEncoded)
+    {
+        std::printf("encoding mismatch for %lu bytes\n", static_cast<ulong>(size));
+        return false;
+    }
+
+    const CarlaString split(splitLines(newEncoded));
+
+    for (uint n=0; n<iterations; ++n)
+    {
+        t = carla_gettime_us();
+        oldDecoded = decodeOld(split);
+        oldDecodeTime += carla_gettime_us() - t;
+
+        t = carla_gettime_us();
+        carla_getChunkFromBase64String_impl(newDecoded, split);
+        newDecodeTime += carla_gettime_us() - t;
+    }
+
+    if (oldDecoded != data || newDecoded != data)
+    {
+        std::printf("decoding mismatch for %lu bytes\n", static_cast<ulong>(size));
+        return false;
+    }
+
+    std::printf("%3lu MB encode: old %8.1f MB/s, new %8.1f MB/s, speedup %.2fx\n",
+                static_cast<ulong>(size / (1024 * 1024)),
+                toMBps(size, oldEncodeTime, iterations), toMBps(size, newEncodeTime, iterations),
+                static_cast<double>(oldEncodeTime) / static_cast<double>(newEncodeTime != 0 ? newEncodeTime : 1));
+    std::printf("%3lu MB decode: old %8.1f MB/s, new %8.1f MB/s, speedup %.2fx\n",
+                static_cast<ulong>(size / (1024 * 1024)),
+                toMBps(size, oldDecodeTime, iterations), toMBps(size, newDecodeTime, iterations),
+                static_cast<double>(oldDecodeTime) / static_cast<double>(newDecodeTime != 0 ? newDecodeTime : 1));
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    std::printf("Base64 kernels: %s\n", carla_getBase64KernelsName());
+
+    if (! benchmark(1024 * 1024, 20))
+        return 1;
+
+    if (! benchmark(64 * 1024 * 1024, 1))
+        return 1;
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
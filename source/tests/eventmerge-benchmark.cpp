@@ -0,0 +1,197 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineUtils.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// --------------------------------------------------------------------------------------------------------------------
+// Event handoff between rack plugins, for a plugin without MIDI out
+
+// as previously done, events written by the plugin were dropped
+static void handoffOld(EngineEventBuffer& eventsIn, EngineEventBuffer& eventsOut)
+{
+    if (eventsIn.count != 0)
+        return;
+
+    eventsIn.swapWith(eventsOut);
+    eventsOut.clear();
+}
+
+// as done now, events written by the plugin get merged into the input
+static void handoffNew(EngineEventBuffer& eventsIn, EngineEventBuffer& eventsOut)
+{
+    if (eventsIn.count != 0)
+    {
+        if (eventsOut.count != 0)
+        {
+            eventsIn.mergeFrom(eventsOut);
+            eventsOut.clear();
+        }
+        return;
+    }
+
+    eventsIn.swapWith(eventsOut);
+    eventsOut.clear();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void fillSorted(EngineEventBuffer& buffer, const uint32_t count, const uint8_t channel)
+{
+    buffer.clear();
+
+    uint32_t time = 0;
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        EngineEvent* const event = buffer.append();
+        CARLA_SAFE_ASSERT_RETURN(event != nullptr,);
+
+        // few distinct times, so that ties are common
+        time += static_cast<uint32_t>(std::rand() % 3);
+
+        event->type    = kEngineEventTypeMidi;
+        event->time    = time;
+        event->channel = channel;
+        event->midi.size = 3;
+        event->midi.data[0] = 0x90;
+        event->midi.data[1] = static_cast<uint8_t>(i % 128);
+        event->midi.data[2] = 100;
+    }
+}
+
+static bool eventsMatch(const EngineEvent& a, const EngineEvent& b)
+{
+    return a.type == b.type && a.time == b.time && a.channel == b.channel && a.midi.data[1] == b.midi.data[1];
+}
+
+static bool compare(const uint32_t countIn, const uint32_t countOut)
+{
+    EngineEventBuffer eventsIn, eventsOut;
+    eventsIn.alloc();
+    eventsOut.alloc();
+
+    fillSorted(eventsIn, countIn, 0);
+    fillSorted(eventsOut, countOut, 1);
+
+    // reference, a stable sort of both, inputs first
+    std::vector<EngineEvent> expected(eventsIn.data, eventsIn.data + eventsIn.count);
+    expected.insert(expected.end(), eventsOut.data, eventsOut.data + eventsOut.count);
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const EngineEvent& a, const EngineEvent& b) { return a.time < b.time; });
+
+    if (expected.size() > kMaxEngineEventInternalCount)
+        expected.resize(kMaxEngineEventInternalCount);
+
+    eventsIn.mergeFrom(eventsOut);
+
+    bool ok = eventsIn.count == expected.size();
+
+    for (uint32_t i=0; ok && i<eventsIn.count; ++i)
+        ok = eventsMatch(eventsIn.data[i], expected[i]);
+
+    for (uint32_t i=eventsIn.count; ok && i<kMaxEngineEventInternalCount; ++i)
+        ok = eventsIn.data[i].type == kEngineEventTypeNull;
+
+    if (! ok)
+        std::printf("merge mismatch with %u + %u events\n", countIn, countOut);
+
+    eventsIn.free();
+    eventsOut.free();
+    return ok;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t kIterations = 200000;
+
+static void benchmark(const uint32_t countIn, const uint32_t countOut)
+{
+    EngineEventBuffer sourceIn, sourceOut, eventsIn, eventsOut;
+    sourceIn.alloc();
+    sourceOut.alloc();
+    eventsIn.alloc();
+    eventsOut.alloc();
+
+    fillSorted(sourceIn, countIn, 0);
+    fillSorted(sourceOut, countOut, 1);
+
+    uint64_t oldTime = 0, newTime = 0;
+    uint64_t t;
+
+    // buffers are reset the same way for both, so the difference is the handoff itself
+    t = carla_gettime_ns();
+    for (uint32_t n=0; n<kIterations; ++n)
+    {
+        eventsIn.copyFrom(sourceIn);
+        eventsOut.copyFrom(sourceOut);
+        handoffOld(eventsIn, eventsOut);
+    }
+    oldTime = carla_gettime_ns() - t;
+
+    t = carla_gettime_ns();
+    for (uint32_t n=0; n<kIterations; ++n)
+    {
+        eventsIn.copyFrom(sourceIn);
+        eventsOut.copyFrom(sourceOut);
+        handoffNew(eventsIn, eventsOut);
+    }
+    newTime = carla_gettime_ns() - t;
+
+    std::printf("%4u input + %4u plugin events: old %8.1f ns, new %8.1f ns (%u vs %u events kept)\n",
+                countIn, countOut,
+                static_cast<double>(oldTime) / kIterations,
+                static_cast<double>(newTime) / kIterations,
+                countIn != 0 ? countIn : countOut,
+                std::min<uint32_t>(countIn + countOut, kMaxEngineEventInternalCount));
+
+    sourceIn.free();
+    sourceOut.free();
+    eventsIn.free();
+    eventsOut.free();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    static const uint32_t kCounts[][2] = {
+        { 0, 0 }, { 1, 0 }, { 16, 0 }, { 256, 0 },
+        { 0, 1 }, { 0, 16 }, { 0, 256 },
+        { 1, 1 }, { 16, 16 }, { 256, 256 }, { 1500, 1500 },
+    };
+
+    for (uint32_t i=0; i<sizeof(kCounts)/sizeof(kCounts[0]); ++i)
+    {
+        if (! compare(kCounts[i][0], kCounts[i][1]))
+            return 1;
+    }
+
+    for (uint32_t i=0; i<sizeof(kCounts)/sizeof(kCounts[0]); ++i)
+        benchmark(kCounts[i][0], kCounts[i][1]);
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
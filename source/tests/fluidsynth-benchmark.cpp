@@ -0,0 +1,201 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaHost.h"
+#include "CarlaEngine.hpp"
+#include "CarlaMIDI.h"
+
+#include "CarlaTimeUtils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// --------------------------------------------------------------------------------------------------------------------
+// Loads a SoundFont in several instances and renders dense MIDI with the Dummy engine as fast as possible.
+// Usage: fluidsynth-benchmark [--periods N] [--buffer-size N] [--sample-rate N] [--plugins N]
+//                             [--cpu-cores N] [--notes N] soundfont
+// Every period, each instance releases its previous chord and starts a new one of --notes keys across all channels.
+// Compare runs with different --cpu-cores values to see how a single instance scales.
+
+static void usage(const char* const argv0)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [--periods N] [--buffer-size N] [--sample-rate N] [--plugins N] "
+                 "[--cpu-cores N] [--notes N] soundfont\n",
+                 argv0);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t periods = 2000;
+    int bufferSize = 256;
+    int sampleRate = 48000;
+    uint numPlugins = 1;
+    int cpuCores = 1;
+    uint numNotes = 8;
+    const char* soundFont = nullptr;
+
+    for (int i=1; i<argc; ++i)
+    {
+        const char* const arg = argv[i];
+
+        if (std::strcmp(arg, "--periods") == 0 && i + 1 < argc)
+            periods = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--buffer-size") == 0 && i + 1 < argc)
+            bufferSize = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--sample-rate") == 0 && i + 1 < argc)
+            sampleRate = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--plugins") == 0 && i + 1 < argc)
+            numPlugins = static_cast<uint>(std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--cpu-cores") == 0 && i + 1 < argc)
+            cpuCores = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--notes") == 0 && i + 1 < argc)
+            numNotes = static_cast<uint>(std::atoi(argv[++i]));
+        else if (arg[0] != '-' && soundFont == nullptr)
+            soundFont = arg;
+        else
+            return usage(argv[0]), 1;
+    }
+
+    // each note is sent as note-on and later note-off, keep within the external note pool
+    if (periods == 0 || bufferSize <= 0 || sampleRate <= 0 || numPlugins == 0 || cpuCores <= 0 ||
+        numNotes == 0 || numNotes > 64 || soundFont == nullptr)
+        return usage(argv[0]), 1;
+
+    const CarlaHostHandle handle = carla_standalone_host_init();
+
+    char resourceDir[1024];
+    std::snprintf(resourceDir, sizeof(resourceDir), "%s/resources", carla_get_library_folder());
+    carla_set_engine_option(handle, ENGINE_OPTION_PATH_RESOURCES, 0, resourceDir);
+
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE, ENGINE_PROCESS_MODE_CONTINUOUS_RACK, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_BUFFER_SIZE, bufferSize, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_SAMPLE_RATE, sampleRate, nullptr);
+
+    if (! carla_engine_init(handle, "Dummy", "fluidsynth-benchmark"))
+    {
+        std::fprintf(stderr, "Failed to start engine: %s\n", carla_get_last_error(handle));
+        return 1;
+    }
+
+    bool ok = true;
+
+    char cpuCoresStr[16];
+    std::snprintf(cpuCoresStr, sizeof(cpuCoresStr), "%i", cpuCores);
+
+    for (uint i=0; i<numPlugins && ok; ++i)
+    {
+        const uint64_t start = carla_gettime_us();
+
+        if (! carla_add_plugin(handle, BINARY_NATIVE, PLUGIN_SF2,
+                               soundFont, "", "benchmark", 0, nullptr, PLUGIN_OPTIONS_NULL))
+        {
+            std::fprintf(stderr, "Failed to add plugin: %s\n", carla_get_last_error(handle));
+            ok = false;
+            break;
+        }
+
+        const uint64_t loaded = carla_gettime_us();
+
+        if (cpuCores != 1)
+            carla_set_custom_data(handle, i, CUSTOM_DATA_TYPE_STRING, "cpuCores", cpuCoresStr);
+
+        std::printf("plugin %3u: loaded in %.3f ms, cpu cores set in %.3f ms\n", i,
+                    static_cast<double>(loaded - start) / 1000.0,
+                    static_cast<double>(carla_gettime_us() - loaded) / 1000.0);
+    }
+
+    CarlaEngine* const engine = carla_get_engine_from_handle(handle);
+    EngineFreewheelStats stats;
+
+    std::vector<uint32_t> periodTimes;
+    std::vector<uint64_t> pluginTimes(numPlugins, 0);
+    uint64_t totalTime = 0;
+
+    if (ok)
+        periodTimes.reserve(periods);
+
+    // render one period at a time, so new notes can be queued in between
+    for (uint32_t p=0; p<periods && ok; ++p)
+    {
+        for (uint i=0; i<numPlugins; ++i)
+        {
+            for (uint n=0; n<numNotes; ++n)
+            {
+                const uint8_t channel = static_cast<uint8_t>(n % MAX_MIDI_CHANNELS);
+
+                if (p != 0)
+                    carla_send_midi_note(handle, i, channel, static_cast<uint8_t>(36 + ((p - 1) * 7 + n * 5) % 60), 0);
+
+                carla_send_midi_note(handle, i, channel, static_cast<uint8_t>(36 + (p * 7 + n * 5) % 60),
+                                     static_cast<uint8_t>(40 + (p * 13 + n * 11) % 88));
+            }
+        }
+
+        if (! engine->renderFreewheel(1, stats))
+        {
+            std::fprintf(stderr, "Failed to render: %s\n", carla_get_last_error(handle));
+            ok = false;
+            break;
+        }
+
+        periodTimes.push_back(stats.maxPeriodTime);
+        totalTime += stats.totalTime;
+
+        for (uint i=0; i<numPlugins; ++i)
+            pluginTimes[i] += engine->getPluginProcessTime(i);
+    }
+
+    if (ok)
+    {
+        std::sort(periodTimes.begin(), periodTimes.end());
+
+        const double audioTime = static_cast<double>(periods) * bufferSize / sampleRate * 1000000.0;
+
+        std::printf("%u instances, %i cpu cores each, %u notes per period\n", numPlugins, cpuCores, numNotes);
+        std::printf("%u periods of %i frames at %i Hz\n", periods, bufferSize, sampleRate);
+        std::printf("total %.3f ms, %.1fx realtime\n",
+                    static_cast<double>(totalTime) / 1000.0,
+                    totalTime != 0 ? audioTime / static_cast<double>(totalTime) : 0.0);
+        std::printf("period us: min %u, avg %u, p50 %u, p90 %u, p99 %u, max %u\n",
+                    periodTimes.front(),
+                    static_cast<uint32_t>(totalTime / periods),
+                    periodTimes[periods / 2],
+                    periodTimes[periods * 9 / 10],
+                    periodTimes[periods * 99 / 100],
+                    periodTimes.back());
+
+        for (uint i=0; i<numPlugins; ++i)
+        {
+            std::printf("plugin %3u: %10.3f ms, %5.1f%% of total\n", i,
+                        static_cast<double>(pluginTimes[i]) / 1000.0,
+                        totalTime != 0 ? static_cast<double>(pluginTimes[i]) * 100.0 / static_cast<double>(totalTime)
+                                       : 0.0);
+        }
+    }
+
+    carla_engine_close(handle);
+    return ok ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
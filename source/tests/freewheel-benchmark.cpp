@@ -0,0 +1,149 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaHost.h"
+#include "CarlaEngine.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// --------------------------------------------------------------------------------------------------------------------
+// Renders a graph with the Dummy engine as fast as possible, without any audio hardware.
+// Usage: freewheel-benchmark [--patchbay] [--periods N] [--buffer-size N] [--sample-rate N] [--plugins N] [project]
+// Without a project, a chain of internal gain plugins is used.
+
+static void usage(const char* const argv0)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [--patchbay] [--periods N] [--buffer-size N] [--sample-rate N] [--plugins N] [project]\n",
+                 argv0);
+}
+
+int main(int argc, char* argv[])
+{
+    bool patchbay = false;
+    uint32_t periods = 10000;
+    int bufferSize = 256;
+    int sampleRate = 48000;
+    uint numPlugins = 8;
+    const char* project = nullptr;
+
+    for (int i=1; i<argc; ++i)
+    {
+        const char* const arg = argv[i];
+
+        if (std::strcmp(arg, "--patchbay") == 0)
+            patchbay = true;
+        else if (std::strcmp(arg, "--periods") == 0 && i + 1 < argc)
+            periods = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--buffer-size") == 0 && i + 1 < argc)
+            bufferSize = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--sample-rate") == 0 && i + 1 < argc)
+            sampleRate = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--plugins") == 0 && i + 1 < argc)
+            numPlugins = static_cast<uint>(std::atoi(argv[++i]));
+        else if (arg[0] != '-' && project == nullptr)
+            project = arg;
+        else
+            return usage(argv[0]), 1;
+    }
+
+    if (periods == 0 || bufferSize <= 0 || sampleRate <= 0)
+        return usage(argv[0]), 1;
+
+    const CarlaHostHandle handle = carla_standalone_host_init();
+
+    char resourceDir[1024];
+    std::snprintf(resourceDir, sizeof(resourceDir), "%s/resources", carla_get_library_folder());
+    carla_set_engine_option(handle, ENGINE_OPTION_PATH_RESOURCES, 0, resourceDir);
+
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE,
+                            patchbay ? ENGINE_PROCESS_MODE_PATCHBAY : ENGINE_PROCESS_MODE_CONTINUOUS_RACK, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_BUFFER_SIZE, bufferSize, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_SAMPLE_RATE, sampleRate, nullptr);
+
+    if (! carla_engine_init(handle, "Dummy", "freewheel-benchmark"))
+    {
+        std::fprintf(stderr, "Failed to start engine: %s\n", carla_get_last_error(handle));
+        return 1;
+    }
+
+    bool ok = true;
+
+    if (project != nullptr)
+    {
+        if (! carla_load_project(handle, project))
+        {
+            std::fprintf(stderr, "Failed to load project: %s\n", carla_get_last_error(handle));
+            ok = false;
+        }
+    }
+    else
+    {
+        for (uint i=0; i<numPlugins && ok; ++i)
+        {
+            if (! carla_add_plugin(handle, BINARY_NATIVE, PLUGIN_INTERNAL,
+                                   "", "", "audiogain_s", 0, nullptr, PLUGIN_OPTIONS_NULL))
+            {
+                std::fprintf(stderr, "Failed to add plugin: %s\n", carla_get_last_error(handle));
+                ok = false;
+            }
+        }
+    }
+
+    CarlaEngine* const engine = carla_get_engine_from_handle(handle);
+    EngineFreewheelStats stats;
+
+    if (ok && ! engine->renderFreewheel(periods, stats))
+    {
+        std::fprintf(stderr, "Failed to render: %s\n", carla_get_last_error(handle));
+        ok = false;
+    }
+
+    if (ok)
+    {
+        std::printf("%s mode, %u periods of %i frames at %i Hz\n",
+                    patchbay ? "patchbay" : "rack", stats.numPeriods, bufferSize, sampleRate);
+        std::printf("total %.3f ms, %.1fx realtime\n",
+                    static_cast<double>(stats.totalTime) / 1000.0, static_cast<double>(stats.realtimeFactor));
+        std::printf("period us: min %u, avg %u, p50 %u, p90 %u, p99 %u, max %u\n",
+                    stats.minPeriodTime, stats.avgPeriodTime,
+                    stats.p50PeriodTime, stats.p90PeriodTime, stats.p99PeriodTime, stats.maxPeriodTime);
+
+        const uint32_t count = carla_get_current_plugin_count(handle);
+
+        for (uint i=0; i<count; ++i)
+        {
+            const uint64_t time = engine->getPluginProcessTime(i);
+
+            std::printf("plugin %3u: %10.3f ms, %5.1f%% of total - %s\n", i,
+                        static_cast<double>(time) / 1000.0,
+                        stats.totalTime != 0 ? static_cast<double>(time) * 100.0 / static_cast<double>(stats.totalTime)
+                                             : 0.0,
+                        carla_get_plugin_info(handle, i)->name);
+        }
+    }
+
+    carla_engine_close(handle);
+    return ok ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
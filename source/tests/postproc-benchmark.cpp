@@ -0,0 +1,250 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaPostProcUtils.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// --------------------------------------------------------------------------------------------------------------------
+// Post-processing as previously done in each plugin type, one effect per pass
+
+static void postProcessOld(const float* const* const inBuffers, float* const* const wetBuffers,
+                           float* const* const outBuffers, float* const extraBuffer,
+                           const uint32_t numChannels, const uint32_t frames,
+                           const float dryWet, const float volume, const float balanceLeft, const float balanceRight)
+{
+    const bool doDryWet  = carla_isNotEqual(dryWet, 1.0f);
+    const bool doBalance = ! (carla_isEqual(balanceLeft, -1.0f) && carla_isEqual(balanceRight, 1.0f));
+
+    bool isPair;
+    float* const oldBufLeft = extraBuffer;
+
+    for (uint32_t i=0; i < numChannels; ++i)
+    {
+        if (doDryWet)
+        {
+            for (uint32_t k=0; k < frames; ++k)
+                wetBuffers[i][k] = (wetBuffers[i][k] * dryWet) + (inBuffers[i][k] * (1.0f - dryWet));
+        }
+
+        if (doBalance)
+        {
+            isPair = (i % 2 == 0);
+
+            if (isPair)
+                carla_copyFloats(oldBufLeft, wetBuffers[i], frames);
+
+            float balRangeL = (balanceLeft  + 1.0f)/2.0f;
+            float balRangeR = (balanceRight + 1.0f)/2.0f;
+
+            for (uint32_t k=0; k < frames; ++k)
+            {
+                if (isPair)
+                {
+                    wetBuffers[i][k]  = oldBufLeft[k]        * (1.0f - balRangeL);
+                    wetBuffers[i][k] += wetBuffers[i+1][k] * (1.0f - balRangeR);
+                }
+                else
+                {
+                    wetBuffers[i][k]  = wetBuffers[i][k] * balRangeR;
+                    wetBuffers[i][k] += oldBufLeft[k]    * balRangeL;
+                }
+            }
+        }
+
+        for (uint32_t k=0; k < frames; ++k)
+            outBuffers[i][k] = wetBuffers[i][k] * volume;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Post-processing through the shared kernels
+
+static void postProcessNew(const float* const* const inBuffers, const float* const* const wetBuffers,
+                           float* const* const outBuffers,
+                           const uint32_t numChannels, const uint32_t frames,
+                           const CarlaPostProcGains& gains, const CarlaPostProcGains* const steps)
+{
+    const bool doDryWet = carla_isNotEqual(gains.dryWet, 1.0f) || steps != nullptr;
+
+    for (uint32_t i=0; i + 1 < numChannels; i += 2)
+        carla_postProcStereo(wetBuffers[i], wetBuffers[i+1],
+                             doDryWet ? inBuffers[i] : nullptr, doDryWet ? inBuffers[i+1] : nullptr,
+                             outBuffers[i], outBuffers[i+1], frames, gains, steps);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t kNumChannels = 2;
+static const uint32_t kIterations  = 200000;
+
+struct Buffers {
+    float* in[kNumChannels];
+    float* wet[kNumChannels];
+    float* out[kNumChannels];
+    float* extra;
+    float* source;
+    const uint32_t frames;
+
+    Buffers(const uint32_t f)
+        : frames(f)
+    {
+        for (uint32_t i=0; i<kNumChannels; ++i)
+        {
+            in[i]  = new float[frames];
+            wet[i] = new float[frames];
+            out[i] = new float[frames];
+
+            for (uint32_t k=0; k<frames; ++k)
+                in[i][k] = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+        }
+
+        extra  = new float[frames];
+        source = new float[frames * kNumChannels];
+
+        for (uint32_t k=0; k<frames * kNumChannels; ++k)
+            source[k] = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+    }
+
+    ~Buffers()
+    {
+        for (uint32_t i=0; i<kNumChannels; ++i)
+        {
+            delete[] in[i];
+            delete[] wet[i];
+            delete[] out[i];
+        }
+
+        delete[] extra;
+        delete[] source;
+    }
+
+    // plugins overwrite their output buffers on every run
+    void resetWet()
+    {
+        for (uint32_t i=0; i<kNumChannels; ++i)
+            carla_copyFloats(wet[i], source + i * frames, frames);
+    }
+};
+
+static bool compare(const uint32_t frames, const float dryWet, const float volume,
+                    const float balanceLeft, const float balanceRight)
+{
+    Buffers a(frames), b(frames);
+
+    // same input on both
+    for (uint32_t i=0; i<kNumChannels; ++i)
+        carla_copyFloats(b.in[i], a.in[i], frames);
+    carla_copyFloats(b.source, a.source, frames * kNumChannels);
+
+    a.resetWet();
+    b.resetWet();
+
+    postProcessOld(a.in, a.wet, a.out, a.extra, kNumChannels, frames, dryWet, volume, balanceLeft, balanceRight);
+    postProcessNew(b.in, b.wet, b.out, kNumChannels, frames,
+                   carla_postProcGains(dryWet, volume, balanceLeft, balanceRight, 0.0f), nullptr);
+
+    for (uint32_t i=0; i<kNumChannels; ++i)
+    {
+        for (uint32_t k=0; k<frames; ++k)
+        {
+            if (std::fabs(a.out[i][k] - b.out[i][k]) > 1e-5f)
+            {
+                std::printf("mismatch at channel %u frame %u: %f vs %f\n", i, k,
+                            static_cast<double>(a.out[i][k]), static_cast<double>(b.out[i][k]));
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void benchmark(const char* const name, const uint32_t frames, const bool ramp,
+                      const float dryWet, const float volume, const float balanceLeft, const float balanceRight)
+{
+    Buffers buffers(frames);
+
+    const CarlaPostProcGains start = carla_postProcGains(1.0f, 1.0f, -1.0f, 1.0f, 0.0f);
+    const CarlaPostProcGains gains = carla_postProcGains(dryWet, volume, balanceLeft, balanceRight, 0.0f);
+
+    CarlaPostProcGains steps;
+    steps.dryWet = (gains.dryWet - start.dryWet) / static_cast<float>(frames);
+    steps.volume = (gains.volume - start.volume) / static_cast<float>(frames);
+    steps.gainLL = (gains.gainLL - start.gainLL) / static_cast<float>(frames);
+    steps.gainRL = (gains.gainRL - start.gainRL) / static_cast<float>(frames);
+    steps.gainLR = (gains.gainLR - start.gainLR) / static_cast<float>(frames);
+    steps.gainRR = (gains.gainRR - start.gainRR) / static_cast<float>(frames);
+
+    uint64_t oldTime = 0, newTime = 0;
+    uint64_t t;
+
+    for (uint32_t n=0; n<kIterations; ++n)
+    {
+        buffers.resetWet();
+        t = carla_gettime_us();
+        postProcessOld(buffers.in, buffers.wet, buffers.out, buffers.extra, kNumChannels, frames,
+                       dryWet, volume, balanceLeft, balanceRight);
+        oldTime += carla_gettime_us() - t;
+
+        buffers.resetWet();
+        t = carla_gettime_us();
+        postProcessNew(buffers.in, buffers.wet, buffers.out, kNumChannels, frames,
+                       ramp ? start : gains, ramp ? &steps : nullptr);
+        newTime += carla_gettime_us() - t;
+    }
+
+    std::printf("%-28s %5u frames: old %8.3f us/block, new %8.3f us/block, speedup %.2fx\n",
+                name, frames,
+                static_cast<double>(oldTime) / kIterations,
+                static_cast<double>(newTime) / kIterations,
+                static_cast<double>(oldTime) / static_cast<double>(newTime != 0 ? newTime : 1));
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    std::printf("Vector size: %u floats\n", CarlaPostProcVectorOps::kSize);
+
+    static const uint32_t kBlockSizes[] = { 31, 64, 256, 1024 };
+
+    // the old loops balance the left channel with the right one before its dry/wet is applied,
+    // so only compare dry/wet and balance separately
+    for (uint32_t i=0; i<sizeof(kBlockSizes)/sizeof(kBlockSizes[0]); ++i)
+    {
+        if (! compare(kBlockSizes[i], 0.3f, 0.8f, -1.0f, 1.0f))
+            return 1;
+        if (! compare(kBlockSizes[i], 1.0f, 0.5f, -0.5f, 0.7f))
+            return 1;
+    }
+
+    for (uint32_t i=0; i<sizeof(kBlockSizes)/sizeof(kBlockSizes[0]); ++i)
+    {
+        const uint32_t frames = kBlockSizes[i];
+        benchmark("volume",                      frames, false, 1.0f, 0.5f, -1.0f, 1.0f);
+        benchmark("dry/wet + volume + balance",  frames, false, 0.3f, 0.8f, -0.5f, 0.7f);
+        benchmark("all, new one smoothed",        frames, true,  0.3f, 0.8f, -0.5f, 0.7f);
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -414,6 +414,20 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_CLIENT_NAME_PREFIX";
     case ENGINE_OPTION_PLUGINS_ARE_STANDALONE:
         return "ENGINE_OPTION_PLUGINS_ARE_STANDALONE";
+    case ENGINE_OPTION_PROCESS_THREADS:
+        return "ENGINE_OPTION_PROCESS_THREADS";
+    case ENGINE_OPTION_RACK_LANES:
+        return "ENGINE_OPTION_RACK_LANES";
+    case ENGINE_OPTION_WORKER_THREADS:
+        return "ENGINE_OPTION_WORKER_THREADS";
+    case ENGINE_OPTION_METER_WINDOW:
+        return "ENGINE_OPTION_METER_WINDOW";
+    case ENGINE_OPTION_LOADER_THREADS:
+        return "ENGINE_OPTION_LOADER_THREADS";
+    case ENGINE_OPTION_EXTERNAL_CHUNKS:
+        return "ENGINE_OPTION_EXTERNAL_CHUNKS";
+    case ENGINE_OPTION_RACK_LANE_INPUTS:
+        return "ENGINE_OPTION_RACK_LANE_INPUTS";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
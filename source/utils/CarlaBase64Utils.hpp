@@ -1,7 +1,7 @@
 /*
  * Carla base64 utils, based on http://www.adp-gmbh.ch/cpp/common/base64.html
  * Copyright (C) 2004-2008 René Nyffenegger
- * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ * Copyright (C) 2014-2023 Filipe Coelho <falktx@falktx.com>
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License as
@@ -21,9 +21,20 @@
 
 #include "CarlaUtils.hpp"
 
-#include <cctype>
 #include <vector>
 
+// -----------------------------------------------------------------------
+// Instruction sets in use
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && ! defined(CARLA_OS_WASM) && \
+    (defined(__clang__) || __GNUC__ >= 5)
+# define CARLA_BASE64_X86
+# include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+# define CARLA_BASE64_NEON
+# include <arm_neon.h>
+#endif
+
 // -----------------------------------------------------------------------
 // Helpers
 
@@ -34,87 +45,530 @@ static const char* const kBase64Chars =
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
+// values of kDecodeTable that are not base64 digits
+static const uint8_t kDecodeEnd     = 0xFD; // '=' and '\0'
+static const uint8_t kDecodeSkip    = 0xFE; // whitespace
+static const uint8_t kDecodeInvalid = 0xFF;
+
+static const uint8_t kDecodeTable[256] = {
+    0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFE, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// -----------------------------------------------------------------------
+// Block kernels
+//
+// Encoders consume whole groups of 3 bytes and return how many bytes were encoded.
+// Decoders consume whole groups of 4 base64 digits, stopping at the first block with anything else in it
+// (whitespace, padding or invalid characters), and return how many characters were decoded.
+// Whatever is left is handled by the generic code.
+
+static inline
+std::size_t encodeBlocksGeneric(const uint8_t*, std::size_t, char*) noexcept
+{
+    return 0;
+}
+
 static inline
-uint8_t findBase64CharIndex(const char c)
+std::size_t decodeBlocksGeneric(const char*, std::size_t, uint8_t*) noexcept
 {
-    static const uint8_t kBase64CharsLen(static_cast<uint8_t>(std::strlen(kBase64Chars)));
+    return 0;
+}
+
+#ifdef CARLA_BASE64_X86
+// SSSE3 and AVX2 versions, see "Base64 encoding and decoding at almost the speed of a memory copy"
+// by Wojciech Muła and Daniel Lemire
+
+__attribute__((target("ssse3")))
+static inline
+__m128i encodeLookupSSSE3(const __m128i indices) noexcept
+{
+    const __m128i shiftLUT = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
 
-    for (uint8_t i=0; i<kBase64CharsLen; ++i)
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    result = _mm_shuffle_epi8(shiftLUT, result);
+    return _mm_add_epi8(result, indices);
+}
+
+__attribute__((target("ssse3")))
+static inline
+std::size_t encodeBlocksSSSE3(const uint8_t* const src, const std::size_t srcSize, char* const dst) noexcept
+{
+    std::size_t s = 0, d = 0;
+
+    // reads 16 bytes to encode 12
+    for (; s + 16 <= srcSize; s += 12, d += 16)
     {
-        if (kBase64Chars[i] == c)
-            return i;
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + s));
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+        const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + d), encodeLookupSSSE3(_mm_or_si128(t0, t1)));
     }
 
-    carla_stderr2("findBase64CharIndex('%c') - failed", c);
-    return 0;
+    return s;
+}
+
+__attribute__((target("ssse3")))
+static inline
+bool decodeLookupSSSE3(const __m128i in, __m128i& values) noexcept
+{
+    const __m128i shiftLUT = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i maskLUT = _mm_setr_epi8(static_cast<char>(0xa8),
+                                          static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                                          static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                                          static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                                          static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m128i bitposLUT = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+                                            0, 0, 0, 0, 0, 0, 0, 0);
+
+    const __m128i higherNibble = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    const __m128i lowerNibble  = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+
+    // reject anything that is not a base64 digit
+    const __m128i mask = _mm_shuffle_epi8(maskLUT, lowerNibble);
+    const __m128i bit  = _mm_shuffle_epi8(bitposLUT, higherNibble);
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(mask, bit), _mm_setzero_si128())) != 0)
+        return false;
+
+    // '/' shares its higher nibble with '+'
+    const __m128i isSlash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    const __m128i shift = _mm_or_si128(_mm_andnot_si128(isSlash, _mm_shuffle_epi8(shiftLUT, higherNibble)),
+                                       _mm_and_si128(isSlash, _mm_set1_epi8(16)));
+
+    values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+__attribute__((target("ssse3")))
+static inline
+__m128i decodePackSSSE3(const __m128i values) noexcept
+{
+    const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3")))
+static inline
+void decodeStore12SSSE3(uint8_t* const dst, const __m128i bytes) noexcept
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), bytes);
+
+    const int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+    std::memcpy(dst + 8, &last, 4);
+}
+
+__attribute__((target("ssse3")))
+static inline
+std::size_t decodeBlocksSSSE3(const char* const src, const std::size_t srcLen, uint8_t* const dst) noexcept
+{
+    std::size_t s = 0, d = 0;
+    __m128i values;
+
+    for (; s + 16 <= srcLen; s += 16, d += 12)
+    {
+        if (! decodeLookupSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + s)), values))
+            break;
+
+        decodeStore12SSSE3(dst + d, decodePackSSSE3(values));
+    }
+
+    return s;
+}
+
+__attribute__((target("avx2")))
+static inline
+std::size_t encodeBlocksAVX2(const uint8_t* const src, const std::size_t srcSize, char* const dst) noexcept
+{
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shiftLUT = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                              '/' - 63, 'A', 0, 0,
+                                              'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                              '/' - 63, 'A', 0, 0);
+
+    std::size_t s = 0, d = 0;
+
+    // reads 28 bytes to encode 24, 12 per lane
+    for (; s + 28 <= srcSize; s += 24, d += 32)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + s));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + s + 12));
+
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+
+        const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                                              _mm256_set1_epi32(0x04000040));
+        const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                                              _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t0, t1);
+
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLUT, result), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + d), result);
+    }
+
+    return s + encodeBlocksSSSE3(src + s, srcSize - s, dst + d);
+}
+
+__attribute__((target("avx2")))
+static inline
+std::size_t decodeBlocksAVX2(const char* const src, const std::size_t srcLen, uint8_t* const dst) noexcept
+{
+    const __m256i shiftLUT = _mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i maskLUT = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(static_cast<char>(0xa8),
+                      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                      static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54));
+    const __m256i bitposLUT = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i packShuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    std::size_t s = 0, d = 0;
+
+    for (; s + 32 <= srcLen; s += 32, d += 24)
+    {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + s));
+
+        const __m256i higherNibble = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0f));
+        const __m256i lowerNibble  = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+
+        const __m256i mask = _mm256_shuffle_epi8(maskLUT, lowerNibble);
+        const __m256i bit  = _mm256_shuffle_epi8(bitposLUT, higherNibble);
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(mask, bit), _mm256_setzero_si256())) != 0)
+            break;
+
+        const __m256i isSlash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        const __m256i shift = _mm256_blendv_epi8(_mm256_shuffle_epi8(shiftLUT, higherNibble),
+                                                 _mm256_set1_epi8(16), isSlash);
+        const __m256i values = _mm256_add_epi8(in, shift);
+
+        const __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i packed = _mm256_shuffle_epi8(_mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000)),
+                                                   packShuffle);
+
+        decodeStore12SSSE3(dst + d, _mm256_castsi256_si128(packed));
+        decodeStore12SSSE3(dst + d + 12, _mm256_extracti128_si256(packed, 1));
+    }
+
+    return s + decodeBlocksSSSE3(src + s, srcLen - s, dst + d);
+}
+#endif // CARLA_BASE64_X86
+
+#ifdef CARLA_BASE64_NEON
+static inline
+uint8x16x4_t loadTableNEON(const uint8_t* const table) noexcept
+{
+    uint8x16x4_t ret;
+    ret.val[0] = vld1q_u8(table);
+    ret.val[1] = vld1q_u8(table + 16);
+    ret.val[2] = vld1q_u8(table + 32);
+    ret.val[3] = vld1q_u8(table + 48);
+    return ret;
 }
 
 static inline
-bool isBase64Char(const char c)
+std::size_t encodeBlocksNEON(const uint8_t* const src, const std::size_t srcSize, char* const dst) noexcept
 {
-    return (std::isalnum(c) || (c == '+') || (c == '/'));
+    const uint8x16x4_t table = loadTableNEON(reinterpret_cast<const uint8_t*>(kBase64Chars));
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+
+    std::size_t s = 0, d = 0;
+
+    for (; s + 48 <= srcSize; s += 48, d += 64)
+    {
+        const uint8x16x3_t in = vld3q_u8(src + s);
+        uint8x16x4_t out;
+
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+
+        for (int i=0; i<4; ++i)
+            out.val[i] = vqtbl4q_u8(table, out.val[i]);
+
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + d), out);
+    }
+
+    return s;
+}
+
+static inline
+std::size_t decodeBlocksNEON(const char* const src, const std::size_t srcLen, uint8_t* const dst) noexcept
+{
+    const uint8x16x4_t tableLo = loadTableNEON(kDecodeTable);
+    const uint8x16x4_t tableHi = loadTableNEON(kDecodeTable + 64);
+    const uint8x16_t offset = vdupq_n_u8(64);
+
+    std::size_t s = 0, d = 0;
+
+    for (; s + 64 <= srcLen; s += 64, d += 48)
+    {
+        const uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t*>(src + s));
+        uint8x16x4_t values;
+
+        for (int i=0; i<4; ++i)
+            values.val[i] = vqtbx4q_u8(vqtbl4q_u8(tableLo, in.val[i]), tableHi, vsubq_u8(in.val[i], offset));
+
+        // non-digits map to values above 63, non-ASCII characters are out of both tables
+        const uint8x16_t valuesOr = vorrq_u8(vorrq_u8(values.val[0], values.val[1]),
+                                             vorrq_u8(values.val[2], values.val[3]));
+        const uint8x16_t inputOr  = vorrq_u8(vorrq_u8(in.val[0], in.val[1]), vorrq_u8(in.val[2], in.val[3]));
+
+        if (vmaxvq_u8(valuesOr) > 63 || vmaxvq_u8(inputOr) > 127)
+            break;
+
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+
+        vst3q_u8(dst + d, out);
+    }
+
+    return s;
+}
+#endif // CARLA_BASE64_NEON
+
+// -----------------------------------------------------------------------
+// Kernel selection
+
+struct Kernels {
+    const char* name;
+    std::size_t (*encodeBlocks)(const uint8_t* src, std::size_t srcSize, char* dst);
+    std::size_t (*decodeBlocks)(const char* src, std::size_t srcLen, uint8_t* dst);
+};
+
+/*
+ * Pick the best kernels for the running CPU.
+ * SSSE3 and AVX2 are detected at runtime, NEON is used when enabled at build time.
+ */
+static inline
+Kernels detectKernels() noexcept
+{
+   #if defined(CARLA_BASE64_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        static const Kernels kernels = { "AVX2", encodeBlocksAVX2, decodeBlocksAVX2 };
+        return kernels;
+    }
+
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        static const Kernels kernels = { "SSSE3", encodeBlocksSSSE3, decodeBlocksSSSE3 };
+        return kernels;
+    }
+   #elif defined(CARLA_BASE64_NEON)
+    static const Kernels kernels = { "NEON", encodeBlocksNEON, decodeBlocksNEON };
+    return kernels;
+   #endif
+
+    static const Kernels genericKernels = { "generic", encodeBlocksGeneric, decodeBlocksGeneric };
+    return genericKernels;
+}
+
+static inline
+const Kernels& getKernels() noexcept
+{
+    static const Kernels kernels = detectKernels();
+    return kernels;
 }
 
 } // namespace CarlaBase64Helpers
 
 // -----------------------------------------------------------------------
 
+/*
+ * Get the name of the base64 kernels in use, for debugging and benchmarks.
+ */
 static inline
-void carla_getChunkFromBase64String_impl(std::vector<uint8_t>& vector, const char* const base64string)
+const char* carla_getBase64KernelsName() noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr,);
+    return CarlaBase64Helpers::getKernels().name;
+}
 
-    uint i=0, j=0;
-    uint charArray3[3], charArray4[4];
+/*
+ * Get the length of base64 encoded @a dataSize bytes, including padding but not the null terminator.
+ */
+static inline
+std::size_t carla_getBase64EncodedSize(const std::size_t dataSize) noexcept
+{
+    return (dataSize + 2) / 3 * 4;
+}
 
-    vector.clear();
-    vector.reserve(std::strlen(base64string)*3/4 + 4);
+/*
+ * Get the max amount of bytes decoded from @a base64len base64 characters.
+ */
+static inline
+std::size_t carla_getBase64MaxDecodedSize(const std::size_t base64len) noexcept
+{
+    return base64len / 4 * 3 + 3;
+}
+
+/*
+ * Encode @a dataSize bytes of @a data as base64 into @a dst.
+ * @a dst must have space for at least carla_getBase64EncodedSize(dataSize) + 1 characters, it will be null-terminated.
+ * Returns the length of the encoded string.
+ */
+static inline
+std::size_t carla_base64Encode(const void* const data, const std::size_t dataSize, char* const dst) noexcept
+{
+    using namespace CarlaBase64Helpers;
+    CARLA_SAFE_ASSERT_RETURN(dst != nullptr, 0);
+
+    const uint8_t* const src = static_cast<const uint8_t*>(data);
 
-    for (std::size_t l=0, len=std::strlen(base64string); l<len; ++l)
+    if (src == nullptr || dataSize == 0)
     {
-        const char c = base64string[l];
+        dst[0] = '\0';
+        return 0;
+    }
 
-        if (c == '\0' || c == '=')
-            break;
-        if (c == ' ' || c == '\n')
-            continue;
+    std::size_t s = getKernels().encodeBlocks(src, dataSize, dst);
+    std::size_t d = s / 3 * 4;
 
-         CARLA_SAFE_ASSERT_CONTINUE(CarlaBase64Helpers::isBase64Char(c));
+    for (; s + 3 <= dataSize; s += 3, d += 4)
+    {
+        const uint32_t v = (static_cast<uint32_t>(src[s]) << 16) | (static_cast<uint32_t>(src[s+1]) << 8) | src[s+2];
+
+        dst[d]   = kBase64Chars[(v >> 18) & 0x3f];
+        dst[d+1] = kBase64Chars[(v >> 12) & 0x3f];
+        dst[d+2] = kBase64Chars[(v >> 6) & 0x3f];
+        dst[d+3] = kBase64Chars[v & 0x3f];
+    }
+
+    if (s < dataSize)
+    {
+        const bool two = s + 2 == dataSize;
+        const uint32_t v = (static_cast<uint32_t>(src[s]) << 16) | (two ? static_cast<uint32_t>(src[s+1]) << 8 : 0);
+
+        dst[d]   = kBase64Chars[(v >> 18) & 0x3f];
+        dst[d+1] = kBase64Chars[(v >> 12) & 0x3f];
+        dst[d+2] = two ? kBase64Chars[(v >> 6) & 0x3f] : '=';
+        dst[d+3] = '=';
+        d += 4;
+    }
 
-        charArray4[i++] = static_cast<uint>(c);
+    dst[d] = '\0';
+    return d;
+}
 
-        if (i == 4)
+/*
+ * Decode @a base64len characters of the base64 string @a base64string into @a dst.
+ * Whitespace is ignored, decoding stops at the first padding or null character.
+ * @a dst must have space for at least carla_getBase64MaxDecodedSize(base64len) bytes.
+ * Returns the amount of bytes decoded.
+ */
+static inline
+std::size_t carla_base64Decode(const char* const base64string, const std::size_t base64len, uint8_t* const dst) noexcept
+{
+    using namespace CarlaBase64Helpers;
+    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(dst != nullptr, 0);
+
+    const Kernels& kernels(getKernels());
+
+    std::size_t s = 0, d = 0;
+    uint32_t accum = 0;
+    uint count = 0;
+
+    while (s < base64len)
+    {
+        // vector code can only start at the beginning of a group of 4 digits
+        if (count == 0)
         {
-            for (i=0; i<4; ++i)
-                charArray4[i] = CarlaBase64Helpers::findBase64CharIndex(static_cast<char>(charArray4[i]));
+            const std::size_t decoded = kernels.decodeBlocks(base64string + s, base64len - s, dst + d);
+            s += decoded;
+            d += decoded / 4 * 3;
+
+            if (s >= base64len)
+                break;
+        }
 
-            charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-            charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-            charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+        const uint8_t value = kDecodeTable[static_cast<uint8_t>(base64string[s++])];
 
-            for (i=0; i<3; ++i)
-                vector.push_back(static_cast<uint8_t>(charArray3[i]));
+        if (value == kDecodeEnd)
+            break;
+        if (value == kDecodeSkip)
+            continue;
+
+        CARLA_SAFE_ASSERT_CONTINUE(value != kDecodeInvalid);
 
-            i = 0;
+        accum = (accum << 6) | value;
+
+        if (++count == 4)
+        {
+            dst[d++] = static_cast<uint8_t>(accum >> 16);
+            dst[d++] = static_cast<uint8_t>(accum >> 8);
+            dst[d++] = static_cast<uint8_t>(accum);
+            accum = 0;
+            count = 0;
         }
     }
 
-    if (i != 0)
+    // trailing digits without padding
+    if (count > 1)
     {
-        for (j=0; j<i && j<4; ++j)
-            charArray4[j] = CarlaBase64Helpers::findBase64CharIndex(static_cast<char>(charArray4[j]));
-
-        for (j=i; j<4; ++j)
-            charArray4[j] = 0;
+        accum <<= 6 * (4 - count);
 
-        charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-        charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-        charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+        dst[d++] = static_cast<uint8_t>(accum >> 16);
 
-        for (j=0; i>0 && j<i-1; j++)
-            vector.push_back(static_cast<uint8_t>(charArray3[j]));
+        if (count == 3)
+            dst[d++] = static_cast<uint8_t>(accum >> 8);
     }
 
+    return d;
+}
+
+// -----------------------------------------------------------------------
+
+static inline
+void carla_getChunkFromBase64String_impl(std::vector<uint8_t>& vector, const char* const base64string)
+{
+    vector.clear();
+    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr,);
+
+    const std::size_t len = std::strlen(base64string);
+
+    // reserved vectors are reused as-is
+    vector.resize(carla_getBase64MaxDecodedSize(len));
+    vector.resize(carla_base64Decode(base64string, len, &vector.front()));
 }
 
 static inline
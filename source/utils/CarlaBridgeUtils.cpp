@@ -294,6 +294,24 @@ bool BridgeRtClientControl::waitForClient(const uint msecs) noexcept
     return jackbridge_sem_timedwait(&data->sem.client, msecs, true);
 }
 
+bool BridgeRtClientControl::postClient() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(isServer, false);
+
+    jackbridge_sem_post(&data->sem.server, true);
+    return true;
+}
+
+bool BridgeRtClientControl::waitForClientReply(const uint msecs) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(msecs > 0, false);
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(isServer, false);
+
+    return jackbridge_sem_timedwait(&data->sem.client, msecs, true);
+}
+
 bool BridgeRtClientControl::writeOpcode(const PluginBridgeRtClientOpcode opcode) noexcept
 {
     return writeUInt(static_cast<uint32_t>(opcode));
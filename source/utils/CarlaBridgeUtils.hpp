@@ -282,6 +282,9 @@ struct CARLA_API BridgeRtClientControl : public CarlaRingBufferControl<SmallStac
 
     // non-bridge, server
     bool waitForClient(const uint msecs) noexcept;
+    // same as above split in two, so several clients can run at once
+    bool postClient() noexcept;
+    bool waitForClientReply(const uint msecs) noexcept;
     bool writeOpcode(const PluginBridgeRtClientOpcode opcode) noexcept;
 
     // bridge, client
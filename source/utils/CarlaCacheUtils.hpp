@@ -0,0 +1,113 @@
+/*
+ * Carla cache utils
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_CACHE_UTILS_HPP_INCLUDED
+#define CARLA_CACHE_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include "water/files/File.h"
+
+#ifdef CARLA_OS_WIN
+# include <sys/utime.h>
+#else
+# include <utime.h>
+#endif
+
+// -----------------------------------------------------------------------
+// cache folder
+
+/*
+ * Environment variable used to pass the host cache folder to discovery processes.
+ * An empty value means caching is disabled.
+ */
+static const char* const kCacheFolderEnvVar = "CARLA_DISCOVERY_CACHE_FOLDER";
+
+/*
+ * Name of the LV2 plugin info cache file, inside the cache folder.
+ */
+static const char* const kLv2CacheFileName = "lv2-bundles.db";
+
+/*
+ * Get the default folder for Carla caches, following the conventions of each OS.
+ */
+static inline
+water::File carla_getDefaultCacheFolder()
+{
+    using water::File;
+
+    const File home(File::getSpecialLocation(File::userHomeDirectory));
+
+   #if defined(CARLA_OS_WIN)
+    const char* const localAppData = std::getenv("LOCALAPPDATA");
+
+    if (localAppData != nullptr && localAppData[0] != '\0')
+        return File(localAppData).getChildFile("Carla");
+
+    return home.getChildFile("AppData").getChildFile("Local").getChildFile("Carla");
+   #elif defined(CARLA_OS_MAC)
+    return home.getChildFile("Library").getChildFile("Caches").getChildFile("Carla");
+   #else
+    const char* const xdgCacheHome = std::getenv("XDG_CACHE_HOME");
+
+    if (xdgCacheHome != nullptr && xdgCacheHome[0] == '/')
+        return File(xdgCacheHome).getChildFile("carla");
+
+    return home.getChildFile(".cache").getChildFile("carla");
+   #endif
+}
+
+/*
+ * Get the cache folder to use in the current process.
+ * Returns false if caching was disabled by the host.
+ */
+static inline
+bool carla_getCacheFolder(water::File& folder)
+{
+    if (const char* const envFolder = std::getenv(kCacheFolderEnvVar))
+    {
+        if (envFolder[0] == '\0')
+            return false;
+
+        if (water::File::isAbsolutePath(envFolder))
+        {
+            folder = water::File(envFolder);
+            return true;
+        }
+    }
+
+    folder = carla_getDefaultCacheFolder();
+    return true;
+}
+
+/*
+ * Mark a cache file as recently used by setting its modification time to now.
+ * Cache pruning removes the files with the oldest modification time first.
+ */
+static inline
+bool carla_touchCacheFile(const water::File& file)
+{
+   #ifdef CARLA_OS_WIN
+    return ::_wutime(file.getFullPathName().toUTF16().c_str(), nullptr) == 0;
+   #else
+    return ::utime(file.getFullPathName().toRawUTF8(), nullptr) == 0;
+   #endif
+}
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_CACHE_UTILS_HPP_INCLUDED
@@ -0,0 +1,105 @@
+/*
+ * Carla chunk file utils
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_CHUNK_FILE_UTILS_HPP_INCLUDED
+#define CARLA_CHUNK_FILE_UTILS_HPP_INCLUDED
+
+#include "CarlaMappedFileUtils.hpp"
+#include "CarlaSha1Utils.hpp"
+#include "CarlaString.hpp"
+
+#include "water/files/File.h"
+
+// -----------------------------------------------------------------------
+// raw chunk files, named after the SHA1 hash of their contents
+
+/*
+ * Extension of raw chunk files.
+ */
+static const char* const kChunkFileExtension = ".chunk";
+
+/*
+ * Get the name of the raw chunk file of @a data.
+ * Identical chunks always get the same name.
+ */
+static inline
+CarlaString carla_getChunkFileName(const void* const data, const std::size_t size) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr && size != 0, CarlaString());
+
+    CarlaSha1 sha1;
+    sha1.write(data, size);
+
+    CarlaString filename(sha1.resultAsString());
+    filename += kChunkFileExtension;
+    return filename;
+}
+
+/*
+ * Check if @a filename is a valid raw chunk file name.
+ * Used to reject path separators and other unexpected names coming from project files.
+ */
+static inline
+bool carla_isValidChunkFileName(const char* const filename) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr, false);
+
+    for (int i=0; i<40; ++i)
+    {
+        const char c = filename[i];
+
+        if (! ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+            return false;
+    }
+
+    return std::strcmp(filename + 40, kChunkFileExtension) == 0;
+}
+
+/*
+ * Write raw chunk @a data into @a folder, creating it if needed.
+ * Nothing is written if the folder already contains this chunk.
+ * Returns the chunk file name, or an empty string on failure.
+ */
+static inline
+CarlaString carla_writeChunkFile(const water::File& folder, const void* const data, const std::size_t size)
+{
+    const CarlaString filename(carla_getChunkFileName(data, size));
+    CARLA_SAFE_ASSERT_RETURN(filename.isNotEmpty(), filename);
+
+    const water::File file(folder.getChildFile(filename.buffer()));
+
+    if (file.existsAsFile() && file.getSize() == static_cast<water::int64>(size))
+        return filename;
+
+    if (! folder.createDirectory().wasOk())
+    {
+        carla_stderr2("Failed to create chunks folder '%s'", folder.getFullPathName().toRawUTF8());
+        return CarlaString();
+    }
+
+    if (! file.replaceWithData(data, size))
+    {
+        carla_stderr2("Failed to write chunk file '%s'", file.getFullPathName().toRawUTF8());
+        return CarlaString();
+    }
+
+    return filename;
+}
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_CHUNK_FILE_UTILS_HPP_INCLUDED
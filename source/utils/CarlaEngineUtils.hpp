@@ -122,53 +122,44 @@ const char* EngineControlEventType2Str(const EngineControlEventType type) noexce
 // -----------------------------------------------------------------------
 
 static inline
-void fillEngineEventsFromWaterMidiBuffer(EngineEvent engineEvents[kMaxEngineEventInternalCount], const water::MidiBuffer& midiBuffer)
+void fillEngineEventsFromWaterMidiBuffer(EngineEventBuffer& engineEvents, const water::MidiBuffer& midiBuffer)
 {
     const uint8_t* midiData;
     int numBytes, sampleNumber;
-    ushort engineEventIndex = 0;
 
-    for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
-    {
-        const EngineEvent& engineEvent(engineEvents[i]);
-
-        if (engineEvent.type != kEngineEventTypeNull)
-            continue;
-
-        engineEventIndex = i;
-        break;
-    }
-
-    for (water::MidiBuffer::Iterator midiBufferIterator(midiBuffer); midiBufferIterator.getNextEvent(midiData, numBytes, sampleNumber) && engineEventIndex < kMaxEngineEventInternalCount;)
+    for (water::MidiBuffer::Iterator midiBufferIterator(midiBuffer); midiBufferIterator.getNextEvent(midiData, numBytes, sampleNumber);)
     {
         CARLA_SAFE_ASSERT_CONTINUE(numBytes > 0);
         CARLA_SAFE_ASSERT_CONTINUE(sampleNumber >= 0);
         CARLA_SAFE_ASSERT_CONTINUE(numBytes < 0xFF /* uint8_t max */);
 
-        EngineEvent& engineEvent(engineEvents[engineEventIndex++]);
+        EngineEvent* const engineEvent = engineEvents.append();
+
+        if (engineEvent == nullptr)
+            break;
 
-        engineEvent.time = static_cast<uint32_t>(sampleNumber);
-        engineEvent.fillFromMidiData(static_cast<uint8_t>(numBytes), midiData, 0);
+        engineEvent->time = static_cast<uint32_t>(sampleNumber);
+        engineEvent->fillFromMidiData(static_cast<uint8_t>(numBytes), midiData, 0);
     }
 }
 
 // -----------------------------------------------------------------------
 
 static inline
-void fillWaterMidiBufferFromEngineEvents(water::MidiBuffer& midiBuffer, const EngineEvent engineEvents[kMaxEngineEventInternalCount])
+void fillWaterMidiBufferFromEngineEvents(water::MidiBuffer& midiBuffer, const EngineEventBuffer& engineEvents)
 {
     uint8_t size     = 0;
     uint8_t mdata[3] = { 0, 0, 0 };
     uint8_t mdataTmp[EngineMidiEvent::kDataSize];
     const uint8_t* mdataPtr;
 
-    for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+    for (uint32_t i=0; i < engineEvents.count; ++i)
     {
-        const EngineEvent& engineEvent(engineEvents[i]);
+        const EngineEvent& engineEvent(engineEvents.data[i]);
 
         /**/ if (engineEvent.type == kEngineEventTypeNull)
         {
-            break;
+            continue;
         }
         else if (engineEvent.type == kEngineEventTypeControl)
         {
@@ -19,6 +19,7 @@
 #define CARLA_LV2_UTILS_HPP_INCLUDED
 
 #include "CarlaMathUtils.hpp"
+#include "CarlaMutex.hpp"
 #include "CarlaStringList.hpp"
 #include "CarlaMIDI.h"
 
@@ -293,6 +294,9 @@ public:
 
     bool needsInit;
 
+    // lilv is not thread-safe, held while using the world from threads other than the main one
+    CarlaMutex mutex;
+
     const LilvPlugins* allPlugins;
     const LilvPlugin** cachedPlugins;
     uint pluginCount;
@@ -429,6 +433,7 @@ public:
           rdfs_range         (new_uri(NS_rdfs "range")),
 
           needsInit(true),
+          mutex(),
           allPlugins(nullptr),
           cachedPlugins(nullptr),
           pluginCount(0) {}
@@ -540,6 +545,8 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uridMap != nullptr, nullptr);
         CARLA_SAFE_ASSERT_RETURN(! needsInit, nullptr);
 
+        const CarlaMutexLocker cml(mutex);
+
         LilvNode* const uriNode(lilv_new_uri(this->me, uri));
         CARLA_SAFE_ASSERT_RETURN(uriNode != nullptr, nullptr);
 
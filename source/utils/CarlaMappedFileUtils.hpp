@@ -0,0 +1,184 @@
+/*
+ * Carla mapped file utils
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_MAPPED_FILE_UTILS_HPP_INCLUDED
+#define CARLA_MAPPED_FILE_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#ifndef CARLA_OS_WIN
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+// -----------------------------------------------------------------------
+// CarlaMappedFile
+
+/*
+ * Private memory mapping of a whole file.
+ */
+class CarlaMappedFile
+{
+public:
+    CarlaMappedFile() noexcept
+        : fData(nullptr),
+          fSize(0)
+         #ifdef CARLA_OS_WIN
+        , fFile(INVALID_HANDLE_VALUE),
+          fMap(nullptr)
+         #endif
+    {
+    }
+
+    ~CarlaMappedFile() noexcept
+    {
+        close();
+    }
+
+    /*
+     * Map @a filename into memory, closing any previous mapping.
+     * Pages are copy-on-write, so writing into the data does not change the file.
+     * Empty files cannot be mapped.
+     */
+    bool open(const char* const filename) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+
+        close();
+
+       #ifdef CARLA_OS_WIN
+        const HANDLE file = ::CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                          OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        CARLA_SAFE_ASSERT_RETURN(file != INVALID_HANDLE_VALUE, false);
+
+        LARGE_INTEGER size;
+
+        if (! ::GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+        {
+            ::CloseHandle(file);
+            return false;
+        }
+
+        const HANDLE map = ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+
+        if (map == nullptr)
+        {
+            ::CloseHandle(file);
+            return false;
+        }
+
+        void* const ptr = ::MapViewOfFile(map, FILE_MAP_COPY, 0, 0, 0);
+
+        if (ptr == nullptr)
+        {
+            const DWORD errorCode = ::GetLastError();
+            carla_stderr2("MapViewOfFile failed for '%s', errorCode:%u", filename, errorCode);
+            ::CloseHandle(map);
+            ::CloseHandle(file);
+            return false;
+        }
+
+        fData = ptr;
+        fSize = static_cast<std::size_t>(size.QuadPart);
+        fFile = file;
+        fMap  = map;
+       #else
+        const int fd = ::open(filename, O_RDONLY);
+        CARLA_SAFE_ASSERT_RETURN(fd >= 0, false);
+
+        struct stat st;
+
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        const std::size_t size = static_cast<std::size_t>(st.st_size);
+        void* const ptr = ::mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+
+        if (ptr == MAP_FAILED)
+        {
+            carla_stderr2("CarlaMappedFile::open() - mmap failed: %s", std::strerror(errno));
+            return false;
+        }
+
+       #ifdef POSIX_MADV_SEQUENTIAL
+        ::posix_madvise(ptr, size, POSIX_MADV_SEQUENTIAL);
+       #endif
+
+        fData = ptr;
+        fSize = size;
+       #endif
+
+        return true;
+    }
+
+    /*
+     * Unmap the current file, if any.
+     */
+    void close() noexcept
+    {
+        if (fData == nullptr)
+            return;
+
+       #ifdef CARLA_OS_WIN
+        ::UnmapViewOfFile(fData);
+        ::CloseHandle(fMap);
+        ::CloseHandle(fFile);
+        fFile = INVALID_HANDLE_VALUE;
+        fMap  = nullptr;
+       #else
+        const int ret = ::munmap(fData, fSize);
+        CARLA_SAFE_ASSERT(ret == 0);
+       #endif
+
+        fData = nullptr;
+        fSize = 0;
+    }
+
+    const void* getData() const noexcept
+    {
+        return fData;
+    }
+
+    std::size_t getSize() const noexcept
+    {
+        return fSize;
+    }
+
+private:
+    void* fData;
+    std::size_t fSize;
+
+   #ifdef CARLA_OS_WIN
+    HANDLE fFile;
+    HANDLE fMap;
+   #endif
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaMappedFile)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_MAPPED_FILE_UTILS_HPP_INCLUDED
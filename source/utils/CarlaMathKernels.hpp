@@ -0,0 +1,331 @@
+/*
+ * Carla math kernels
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_MATH_KERNELS_HPP_INCLUDED
+#define CARLA_MATH_KERNELS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// --------------------------------------------------------------------------------------------------------------------
+// Instruction sets in use
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && ! defined(CARLA_OS_WASM)
+# define CARLA_MATH_KERNELS_X86
+# include <immintrin.h>
+# if defined(__SSE2__)
+#  define CARLA_MATH_KERNELS_SSE2
+# endif
+# if defined(__clang__) || __GNUC__ >= 5
+#  define CARLA_MATH_KERNELS_AVX2
+# endif
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+# define CARLA_MATH_KERNELS_NEON
+# include <arm_neon.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Kernel table
+
+/*
+ * Float buffer operations, in the best variant for the running CPU.
+ *
+ * The fused ones touch each buffer only once, for code that would otherwise copy or add a buffer
+ * and then scan it again for peaks.
+ * All "maxAbs" kernels return the highest absolute value, not limited to 1.
+ */
+struct CarlaMathKernels {
+    const char* name;
+
+    void  (*add)(float* dest, const float* src, std::size_t count);
+    void  (*addWithGain)(float* dest, const float* src, float gain, std::size_t count);
+    void  (*copyWithGain)(float* dest, const float* src, float gain, std::size_t count);
+    void  (*multiply)(float* data, float gain, std::size_t count);
+    float (*findMaxAbs)(const float* data, std::size_t count);
+    float (*copyAndFindMaxAbs)(float* dest, const float* src, std::size_t count);
+    float (*addAndFindMaxAbs)(float* dest, const float* src, std::size_t count);
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Generic variant, also used for the last few samples of the vector ones
+
+static inline
+void carla_mathKernelAddGeneric(float* dest, const float* src, const std::size_t count) noexcept
+{
+    for (std::size_t i=0; i<count; ++i)
+        dest[i] += src[i];
+}
+
+static inline
+void carla_mathKernelAddWithGainGeneric(float* dest, const float* src, const float gain, const std::size_t count) noexcept
+{
+    for (std::size_t i=0; i<count; ++i)
+        dest[i] += src[i] * gain;
+}
+
+static inline
+void carla_mathKernelCopyWithGainGeneric(float* dest, const float* src, const float gain, const std::size_t count) noexcept
+{
+    for (std::size_t i=0; i<count; ++i)
+        dest[i] = src[i] * gain;
+}
+
+static inline
+void carla_mathKernelMultiplyGeneric(float* data, const float gain, const std::size_t count) noexcept
+{
+    for (std::size_t i=0; i<count; ++i)
+        data[i] *= gain;
+}
+
+static inline
+float carla_mathKernelFindMaxAbsGeneric(const float* data, const std::size_t count) noexcept
+{
+    float maxf = 0.0f;
+
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const float tmp = std::abs(data[i]);
+
+        if (tmp > maxf)
+            maxf = tmp;
+    }
+
+    return maxf;
+}
+
+static inline
+float carla_mathKernelCopyAndFindMaxAbsGeneric(float* dest, const float* src, const std::size_t count) noexcept
+{
+    float maxf = 0.0f;
+
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const float tmp = std::abs(dest[i] = src[i]);
+
+        if (tmp > maxf)
+            maxf = tmp;
+    }
+
+    return maxf;
+}
+
+static inline
+float carla_mathKernelAddAndFindMaxAbsGeneric(float* dest, const float* src, const std::size_t count) noexcept
+{
+    float maxf = 0.0f;
+
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const float tmp = std::abs(dest[i] += src[i]);
+
+        if (tmp > maxf)
+            maxf = tmp;
+    }
+
+    return maxf;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Vector variants
+//
+// Each variant defines a few primitives and then expands CARLA_MATH_KERNELS_DEFINE_VARIANT,
+// so that all variants share the same code.
+
+#define CARLA_MATH_KERNELS_DEFINE_VARIANT(SUFFIX, ATTR, V, W, LOAD, STORE, SET1, ADD, MUL, ABS, MAX, HMAX)                 \
+                                                                                                                           \
+ATTR static inline void carla_mathKernelAdd##SUFFIX(float* dest, const float* src, const std::size_t count)                \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+        STORE(dest + i, ADD(LOAD(dest + i), LOAD(src + i)));                                                               \
+    carla_mathKernelAddGeneric(dest + vcount, src + vcount, count - vcount);                                               \
+}                                                                                                                          \
+                                                                                                                           \
+ATTR static inline void carla_mathKernelAddWithGain##SUFFIX(float* dest, const float* src, const float gain,               \
+                                                     const std::size_t count)                                              \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    const V vgain = SET1(gain);                                                                                            \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+        STORE(dest + i, ADD(LOAD(dest + i), MUL(LOAD(src + i), vgain)));                                                   \
+    carla_mathKernelAddWithGainGeneric(dest + vcount, src + vcount, gain, count - vcount);                                 \
+}                                                                                                                          \
+                                                                                                                           \
+ATTR static inline void carla_mathKernelCopyWithGain##SUFFIX(float* dest, const float* src, const float gain,              \
+                                                      const std::size_t count)                                             \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    const V vgain = SET1(gain);                                                                                            \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+        STORE(dest + i, MUL(LOAD(src + i), vgain));                                                                        \
+    carla_mathKernelCopyWithGainGeneric(dest + vcount, src + vcount, gain, count - vcount);                                \
+}                                                                                                                          \
+                                                                                                                           \
+ATTR static inline void carla_mathKernelMultiply##SUFFIX(float* data, const float gain, const std::size_t count)           \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    const V vgain = SET1(gain);                                                                                            \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+        STORE(data + i, MUL(LOAD(data + i), vgain));                                                                       \
+    carla_mathKernelMultiplyGeneric(data + vcount, gain, count - vcount);                                                  \
+}                                                                                                                          \
+                                                                                                                           \
+ATTR static inline float carla_mathKernelFindMaxAbs##SUFFIX(const float* data, const std::size_t count)                    \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    V vmax = SET1(0.0f);                                                                                                   \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+        vmax = MAX(vmax, ABS(LOAD(data + i)));                                                                             \
+    return std::max(HMAX(vmax), carla_mathKernelFindMaxAbsGeneric(data + vcount, count - vcount));                         \
+}                                                                                                                          \
+                                                                                                                           \
+ATTR static inline float carla_mathKernelCopyAndFindMaxAbs##SUFFIX(float* dest, const float* src, const std::size_t count) \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    V vmax = SET1(0.0f);                                                                                                   \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+    {                                                                                                                      \
+        const V v = LOAD(src + i);                                                                                         \
+        STORE(dest + i, v);                                                                                                \
+        vmax = MAX(vmax, ABS(v));                                                                                          \
+    }                                                                                                                      \
+    return std::max(HMAX(vmax), carla_mathKernelCopyAndFindMaxAbsGeneric(dest + vcount, src + vcount,                      \
+                                                                         count - vcount));                                 \
+}                                                                                                                          \
+                                                                                                                           \
+ATTR static inline float carla_mathKernelAddAndFindMaxAbs##SUFFIX(float* dest, const float* src, const std::size_t count)  \
+{                                                                                                                          \
+    const std::size_t vcount = count - count % W;                                                                          \
+    V vmax = SET1(0.0f);                                                                                                   \
+    for (std::size_t i=0; i<vcount; i+=W)                                                                                  \
+    {                                                                                                                      \
+        const V v = ADD(LOAD(dest + i), LOAD(src + i));                                                                    \
+        STORE(dest + i, v);                                                                                                \
+        vmax = MAX(vmax, ABS(v));                                                                                          \
+    }                                                                                                                      \
+    return std::max(HMAX(vmax), carla_mathKernelAddAndFindMaxAbsGeneric(dest + vcount, src + vcount,                       \
+                                                                        count - vcount));                                  \
+}
+
+#ifdef CARLA_MATH_KERNELS_SSE2
+static inline
+float carla_mathKernelHMaxSSE2(const __m128 v) noexcept
+{
+    const __m128 v2 = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_max_ss(v2, _mm_shuffle_ps(v2, v2, 1)));
+}
+
+# define CARLA_MATH_KERNELS_ABS_SSE2(v) _mm_andnot_ps(_mm_set1_ps(-0.0f), v)
+
+CARLA_MATH_KERNELS_DEFINE_VARIANT(SSE2, , __m128, 4,
+                                  _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_add_ps, _mm_mul_ps,
+                                  CARLA_MATH_KERNELS_ABS_SSE2, _mm_max_ps, carla_mathKernelHMaxSSE2)
+
+# undef CARLA_MATH_KERNELS_ABS_SSE2
+#endif
+
+#ifdef CARLA_MATH_KERNELS_AVX2
+__attribute__((target("avx2")))
+static inline
+float carla_mathKernelHMaxAVX2(const __m256 v)
+{
+    const __m128 v4 = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const __m128 v2 = _mm_max_ps(v4, _mm_movehl_ps(v4, v4));
+    return _mm_cvtss_f32(_mm_max_ss(v2, _mm_shuffle_ps(v2, v2, 1)));
+}
+
+# define CARLA_MATH_KERNELS_ABS_AVX2(v) _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v)
+
+CARLA_MATH_KERNELS_DEFINE_VARIANT(AVX2, __attribute__((target("avx2"))), __m256, 8,
+                                  _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_add_ps, _mm256_mul_ps,
+                                  CARLA_MATH_KERNELS_ABS_AVX2, _mm256_max_ps, carla_mathKernelHMaxAVX2)
+
+# undef CARLA_MATH_KERNELS_ABS_AVX2
+#endif
+
+#ifdef CARLA_MATH_KERNELS_NEON
+static inline
+float carla_mathKernelHMaxNEON(const float32x4_t v) noexcept
+{
+   #ifdef __aarch64__
+    return vmaxvq_f32(v);
+   #else
+    const float32x2_t v2 = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(v2, v2), 0);
+   #endif
+}
+
+CARLA_MATH_KERNELS_DEFINE_VARIANT(NEON, , float32x4_t, 4,
+                                  vld1q_f32, vst1q_f32, vdupq_n_f32, vaddq_f32, vmulq_f32,
+                                  vabsq_f32, vmaxq_f32, carla_mathKernelHMaxNEON)
+#endif
+
+#undef CARLA_MATH_KERNELS_DEFINE_VARIANT
+
+// --------------------------------------------------------------------------------------------------------------------
+// Variant selection
+
+#define CARLA_MATH_KERNELS_TABLE(NAME, SUFFIX)                                                                       \
+    { NAME,                                                                                                          \
+      carla_mathKernelAdd##SUFFIX, carla_mathKernelAddWithGain##SUFFIX, carla_mathKernelCopyWithGain##SUFFIX,        \
+      carla_mathKernelMultiply##SUFFIX, carla_mathKernelFindMaxAbs##SUFFIX,                                          \
+      carla_mathKernelCopyAndFindMaxAbs##SUFFIX, carla_mathKernelAddAndFindMaxAbs##SUFFIX }
+
+/*
+ * Pick the best kernels for the running CPU.
+ * AVX2 is detected at runtime, SSE2 and NEON are used when enabled at build time.
+ */
+static inline
+CarlaMathKernels carla_detectMathKernels() noexcept
+{
+   #ifdef CARLA_MATH_KERNELS_AVX2
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        static const CarlaMathKernels kernels = CARLA_MATH_KERNELS_TABLE("AVX2", AVX2);
+        return kernels;
+    }
+   #endif
+
+   #if defined(CARLA_MATH_KERNELS_SSE2)
+    static const CarlaMathKernels kernels = CARLA_MATH_KERNELS_TABLE("SSE2", SSE2);
+   #elif defined(CARLA_MATH_KERNELS_NEON)
+    static const CarlaMathKernels kernels = CARLA_MATH_KERNELS_TABLE("NEON", NEON);
+   #else
+    static const CarlaMathKernels kernels = CARLA_MATH_KERNELS_TABLE("generic", Generic);
+   #endif
+    return kernels;
+}
+
+#undef CARLA_MATH_KERNELS_TABLE
+
+/*
+ * Get the kernels in use, detected on first call.
+ */
+static inline
+const CarlaMathKernels& carla_getMathKernels() noexcept
+{
+    static const CarlaMathKernels kernels = carla_detectMathKernels();
+    return kernels;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_MATH_KERNELS_HPP_INCLUDED
@@ -18,7 +18,7 @@
 #ifndef CARLA_MATH_UTILS_HPP_INCLUDED
 #define CARLA_MATH_UTILS_HPP_INCLUDED
 
-#include "CarlaUtils.hpp"
+#include "CarlaMathKernels.hpp"
 
 #include <cmath>
 #include <limits>
@@ -171,16 +171,20 @@ void carla_addFloats(float dest[], const float src[], const std::size_t count) n
     CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(count > 0,);
 
-    for (std::size_t i=0; i<count; ++i)
-    {
-       #ifdef __GNUC__
-        if (!std::isfinite(dest[i]))
-            __builtin_unreachable();
-        if (!std::isfinite(src[i]))
-            __builtin_unreachable();
-       #endif
-        *dest++ += *src++;
-    }
+    carla_getMathKernels().add(dest, src, count);
+}
+
+/*
+ * Add float array values to another float array, with a gain applied to the source.
+ */
+static inline
+void carla_addFloatsWithGain(float dest[], const float src[], const float gain, const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    carla_getMathKernels().addWithGain(dest, src, gain, count);
 }
 
 /*
@@ -255,30 +259,33 @@ float carla_findMaxNormalizedFloat(const float floats[], const std::size_t count
     CARLA_SAFE_ASSERT_RETURN(floats != nullptr, 0.f);
     CARLA_SAFE_ASSERT_RETURN(count > 0, 0.f);
 
-    static constexpr const float kEmptyFloats[8192] = {};
-
-    if (count <= 8192 && std::memcmp(floats, kEmptyFloats, sizeof(float)*count) == 0)
-        return 0.0f;
-
-    float tmp, maxf2 = std::abs(floats[0]);
-
-    for (std::size_t i=1; i<count; ++i)
-    {
-       #ifdef __GNUC__
-        if (!std::isfinite(floats[i]))
-            __builtin_unreachable();
-       #endif
+    return std::min(carla_getMathKernels().findMaxAbs(floats, count), 1.0f);
+}
 
-        tmp = std::abs(floats[i]);
+/*
+ * Copy float array values to another float array, and find the highest absolute and normalized value copied.
+ */
+static inline
+float carla_copyFloatsFindMaxNormalized(float dest[], const float src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr, 0.f);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr, 0.f);
+    CARLA_SAFE_ASSERT_RETURN(count > 0, 0.f);
 
-        if (tmp > maxf2)
-            maxf2 = tmp;
-    }
+    return std::min(carla_getMathKernels().copyAndFindMaxAbs(dest, src, count), 1.0f);
+}
 
-    if (maxf2 > 1.f)
-        maxf2 = 1.f;
+/*
+ * Add float array values to another float array, and find the highest absolute and normalized value of the result.
+ */
+static inline
+float carla_addFloatsFindMaxNormalized(float dest[], const float src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr, 0.f);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr, 0.f);
+    CARLA_SAFE_ASSERT_RETURN(count > 0, 0.f);
 
-    return maxf2;
+    return std::min(carla_getMathKernels().addAndFindMaxAbs(dest, src, count), 1.0f);
 }
 
 /*
@@ -291,20 +298,54 @@ void carla_multiply(float data[], const float& multiplier, const std::size_t cou
     CARLA_SAFE_ASSERT_RETURN(count > 0,);
 
     if (carla_isZero(multiplier))
-    {
         std::memset(data, 0, count*sizeof(float));
-    }
     else
-    {
-        for (std::size_t i=0; i<count; ++i)
-        {
-           #ifdef __GNUC__
-            if (!std::isfinite(data[i]))
-                __builtin_unreachable();
-           #endif
-            *data++ *= multiplier;
-        }
-    }
+        carla_getMathKernels().multiply(data, multiplier, count);
+}
+
+/*
+ * Add array values to another array, float-specific version.
+ */
+template <>
+inline
+void carla_add<float>(float dest[], const float src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(dest != src,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    carla_getMathKernels().add(dest, src, count);
+}
+
+/*
+ * Add array values to another array, with a multiplication factor, float-specific version.
+ */
+template <>
+inline
+void carla_addWithMultiply<float>(float dest[], const float src[], const float& multiplier, const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(dest != src,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    carla_getMathKernels().addWithGain(dest, src, multiplier, count);
+}
+
+/*
+ * Copy array values to another array, with a multiplication factor, float-specific version.
+ */
+template <>
+inline
+void carla_copyWithMultiply<float>(float dest[], const float src[], const float& multiplier, const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(dest != src,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    carla_getMathKernels().copyWithGain(dest, src, multiplier, count);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -40,6 +40,20 @@ bool carla_mlock(void* const ptr, const size_t size)
    #endif
 }
 
+static inline
+bool carla_munlock(void* const ptr, const size_t size)
+{
+   #if defined(CARLA_OS_WASM)
+    // unsupported
+    return false;
+    (void)ptr; (void)size;
+   #elif defined(CARLA_OS_WIN)
+    return ::VirtualUnlock(ptr, size) != FALSE;
+   #else
+    return ::munlock(ptr, size) == 0;
+   #endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 #endif // CARLA_MEM_UTILS_HPP_INCLUDED
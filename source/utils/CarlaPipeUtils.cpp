@@ -1491,6 +1491,30 @@ uintptr_t CarlaPipeServer::getPID() const noexcept
 #endif
 }
 
+bool CarlaPipeServer::isClientRunning() const noexcept
+{
+#ifdef CARLA_OS_WIN
+    if (pData->processInfo.hProcess == INVALID_HANDLE_VALUE)
+        return false;
+
+    return ::WaitForSingleObject(pData->processInfo.hProcess, 0) == WAIT_TIMEOUT;
+#else
+    if (pData->pid <= 0)
+        return false;
+
+    siginfo_t info;
+    carla_zeroStruct(info);
+
+    try {
+        if (::waitid(P_PID, static_cast<id_t>(pData->pid), &info, WEXITED|WNOHANG|WNOWAIT) != 0)
+            return errno != ECHILD;
+    } CARLA_SAFE_EXCEPTION_RETURN("waitid", true);
+
+    // info is left untouched if the process is still running
+    return info.si_pid == 0;
+#endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 bool CarlaPipeServer::startPipeServer(const char* const helperTool,
@@ -281,6 +281,12 @@ public:
      */
     uintptr_t getPID() const noexcept;
 
+    /*!
+     * Check if this pipe's matching client process is still alive.
+     * Does not reap the process, stopPipeServer() still needs to be called after it exits.
+     */
+    bool isClientRunning() const noexcept;
+
     /*!
      * Start the pipe server using @a filename with 2 arguments.
      * @see fail()
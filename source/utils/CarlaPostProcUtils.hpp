@@ -0,0 +1,371 @@
+/*
+ * Carla plugin post-processing utils
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_POST_PROC_UTILS_HPP_INCLUDED
+#define CARLA_POST_PROC_UTILS_HPP_INCLUDED
+
+#include "CarlaMathUtils.hpp"
+
+#if defined(__AVX__)
+# include <immintrin.h>
+#elif defined(__SSE__) || defined(__SSE2_MATH__)
+# include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
+// -----------------------------------------------------------------------
+// Gains applied by the post-processing kernels
+
+/*
+ * A set of post-processing gains, already combined from the plugin dry/wet, volume, balance and panning.
+ *
+ * Stereo pairs go through a 2x2 matrix (balance and panning mix left and right together),
+ * unpaired channels only get dry/wet and volume.
+ */
+struct CarlaPostProcGains {
+    float dryWet; // 1 is fully wet
+    float volume; // unpaired channels
+    float gainLL; // left  to left
+    float gainRL; // right to left
+    float gainLR; // left  to right
+    float gainRR; // right to right
+
+    bool isIdentity() const noexcept
+    {
+        return carla_isEqual(dryWet, 1.0f) && carla_isEqual(volume, 1.0f)
+            && carla_isEqual(gainLL, 1.0f) && carla_isZero(gainRL)
+            && carla_isZero(gainLR)        && carla_isEqual(gainRR, 1.0f);
+    }
+
+    bool isCrossed() const noexcept
+    {
+        return carla_isNotZero(gainRL) || carla_isNotZero(gainLR);
+    }
+
+    bool operator==(const CarlaPostProcGains& other) const noexcept
+    {
+        return carla_isEqual(dryWet, other.dryWet) && carla_isEqual(volume, other.volume)
+            && carla_isEqual(gainLL, other.gainLL) && carla_isEqual(gainRL, other.gainRL)
+            && carla_isEqual(gainLR, other.gainLR) && carla_isEqual(gainRR, other.gainRR);
+    }
+
+    bool operator!=(const CarlaPostProcGains& other) const noexcept
+    {
+        return !operator==(other);
+    }
+};
+
+/*
+ * Combine the plugin post-processing values into gains.
+ * Balance ranges are -1 to 1 (left and right channel position), panning is -1 to 1 and only used on stereo pairs.
+ */
+static inline
+CarlaPostProcGains carla_postProcGains(const float dryWet, const float volume,
+                                       const float balanceLeft, const float balanceRight, const float panning) noexcept
+{
+    const float balRangeL = (balanceLeft  + 1.0f) * 0.5f;
+    const float balRangeR = (balanceRight + 1.0f) * 0.5f;
+    const float panL = volume * (panning > 0.0f ? 1.0f - panning : 1.0f);
+    const float panR = volume * (panning < 0.0f ? 1.0f + panning : 1.0f);
+
+    CarlaPostProcGains gains;
+    gains.dryWet = dryWet;
+    gains.volume = volume;
+    gains.gainLL = panL * (1.0f - balRangeL);
+    gains.gainRL = panL * (1.0f - balRangeR);
+    gains.gainLR = panR * balRangeL;
+    gains.gainRR = panR * balRangeR;
+    return gains;
+}
+
+// -----------------------------------------------------------------------
+// Vector operations, using the widest instruction set enabled at build time
+
+struct CarlaPostProcScalarOps {
+    typedef float V;
+    static const uint32_t kSize = 1;
+
+    static inline V load(const float* const p) noexcept          { return *p; }
+    static inline void store(float* const p, const V v) noexcept  { *p = v; }
+    static inline V set1(const float f) noexcept                  { return f; }
+    static inline V iota() noexcept                               { return 0.0f; }
+    static inline V add(const V a, const V b) noexcept            { return a + b; }
+    static inline V sub(const V a, const V b) noexcept            { return a - b; }
+    static inline V mul(const V a, const V b) noexcept            { return a * b; }
+    static inline V madd(const V a, const V b, const V c) noexcept { return a + b * c; }
+};
+
+#if defined(__AVX__)
+struct CarlaPostProcVectorOps {
+    typedef __m256 V;
+    static const uint32_t kSize = 8;
+
+    static inline V load(const float* const p) noexcept          { return _mm256_loadu_ps(p); }
+    static inline void store(float* const p, const V v) noexcept  { _mm256_storeu_ps(p, v); }
+    static inline V set1(const float f) noexcept                  { return _mm256_set1_ps(f); }
+    static inline V iota() noexcept                               { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+    static inline V add(const V a, const V b) noexcept            { return _mm256_add_ps(a, b); }
+    static inline V sub(const V a, const V b) noexcept            { return _mm256_sub_ps(a, b); }
+    static inline V mul(const V a, const V b) noexcept            { return _mm256_mul_ps(a, b); }
+    static inline V madd(const V a, const V b, const V c) noexcept { return _mm256_add_ps(a, _mm256_mul_ps(b, c)); }
+};
+#elif defined(__SSE__) || defined(__SSE2_MATH__)
+struct CarlaPostProcVectorOps {
+    typedef __m128 V;
+    static const uint32_t kSize = 4;
+
+    static inline V load(const float* const p) noexcept          { return _mm_loadu_ps(p); }
+    static inline void store(float* const p, const V v) noexcept  { _mm_storeu_ps(p, v); }
+    static inline V set1(const float f) noexcept                  { return _mm_set1_ps(f); }
+    static inline V iota() noexcept                               { return _mm_setr_ps(0, 1, 2, 3); }
+    static inline V add(const V a, const V b) noexcept            { return _mm_add_ps(a, b); }
+    static inline V sub(const V a, const V b) noexcept            { return _mm_sub_ps(a, b); }
+    static inline V mul(const V a, const V b) noexcept            { return _mm_mul_ps(a, b); }
+    static inline V madd(const V a, const V b, const V c) noexcept { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+};
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+struct CarlaPostProcVectorOps {
+    typedef float32x4_t V;
+    static const uint32_t kSize = 4;
+
+    static inline V load(const float* const p) noexcept          { return vld1q_f32(p); }
+    static inline void store(float* const p, const V v) noexcept  { vst1q_f32(p, v); }
+    static inline V set1(const float f) noexcept                  { return vdupq_n_f32(f); }
+    static inline V iota() noexcept                               { static const float v[4] = { 0, 1, 2, 3 }; return vld1q_f32(v); }
+    static inline V add(const V a, const V b) noexcept            { return vaddq_f32(a, b); }
+    static inline V sub(const V a, const V b) noexcept            { return vsubq_f32(a, b); }
+    static inline V mul(const V a, const V b) noexcept            { return vmulq_f32(a, b); }
+    static inline V madd(const V a, const V b, const V c) noexcept { return vmlaq_f32(a, b, c); }
+};
+#else
+typedef CarlaPostProcScalarOps CarlaPostProcVectorOps;
+#endif
+
+// -----------------------------------------------------------------------
+// Post-processing kernels (internal)
+
+/*
+ * Process frames [start, end) of a stereo pair.
+ * Gains at frame k are @a gains + @a steps * (rampStart + k).
+ */
+template<class Ops, bool kDryWet, bool kCross, bool kRamp>
+static inline
+void carla_postProcStereoRange(const float* const wetL, const float* const wetR,
+                               const float* const dryL, const float* const dryR,
+                               float* const outL, float* const outR,
+                               const uint32_t start, const uint32_t end,
+                               const CarlaPostProcGains& gains, const CarlaPostProcGains& steps,
+                               const uint32_t rampStart) noexcept
+{
+    typedef typename Ops::V V;
+
+    const V dw0 = Ops::set1(gains.dryWet), dwStep = Ops::set1(steps.dryWet);
+    const V ll0 = Ops::set1(gains.gainLL), llStep = Ops::set1(steps.gainLL);
+    const V rl0 = Ops::set1(gains.gainRL), rlStep = Ops::set1(steps.gainRL);
+    const V lr0 = Ops::set1(gains.gainLR), lrStep = Ops::set1(steps.gainLR);
+    const V rr0 = Ops::set1(gains.gainRR), rrStep = Ops::set1(steps.gainRR);
+    const V iota = Ops::iota();
+
+    for (uint32_t k=start; k < end; k += Ops::kSize)
+    {
+        V dw = dw0, ll = ll0, rl = rl0, lr = lr0, rr = rr0;
+
+        if (kRamp)
+        {
+            const V pos = Ops::add(Ops::set1(static_cast<float>(rampStart + k)), iota);
+            dw = Ops::madd(dw0, dwStep, pos);
+            ll = Ops::madd(ll0, llStep, pos);
+            rl = Ops::madd(rl0, rlStep, pos);
+            lr = Ops::madd(lr0, lrStep, pos);
+            rr = Ops::madd(rr0, rrStep, pos);
+        }
+
+        V left  = Ops::load(wetL + k);
+        V right = Ops::load(wetR + k);
+
+        if (kDryWet)
+        {
+            const V dl = Ops::load(dryL + k);
+            const V dr = Ops::load(dryR + k);
+            left  = Ops::madd(dl, Ops::sub(left,  dl), dw);
+            right = Ops::madd(dr, Ops::sub(right, dr), dw);
+        }
+
+        if (kCross)
+        {
+            Ops::store(outL + k, Ops::madd(Ops::mul(left, ll), right, rl));
+            Ops::store(outR + k, Ops::madd(Ops::mul(left, lr), right, rr));
+        }
+        else
+        {
+            Ops::store(outL + k, Ops::mul(left,  ll));
+            Ops::store(outR + k, Ops::mul(right, rr));
+        }
+    }
+
+    // unused depending on template arguments
+    (void)dryL; (void)dryR; (void)dwStep; (void)llStep; (void)rlStep; (void)lrStep; (void)rrStep; (void)iota; (void)rampStart;
+}
+
+/*
+ * Process frames [start, end) of an unpaired channel.
+ */
+template<class Ops, bool kDryWet, bool kRamp>
+static inline
+void carla_postProcMonoRange(const float* const wet, const float* const dry, float* const out,
+                             const uint32_t start, const uint32_t end,
+                             const CarlaPostProcGains& gains, const CarlaPostProcGains& steps,
+                             const uint32_t rampStart) noexcept
+{
+    typedef typename Ops::V V;
+
+    const V dw0  = Ops::set1(gains.dryWet), dwStep  = Ops::set1(steps.dryWet);
+    const V vol0 = Ops::set1(gains.volume), volStep = Ops::set1(steps.volume);
+    const V iota = Ops::iota();
+
+    for (uint32_t k=start; k < end; k += Ops::kSize)
+    {
+        V dw = dw0, vol = vol0;
+
+        if (kRamp)
+        {
+            const V pos = Ops::add(Ops::set1(static_cast<float>(rampStart + k)), iota);
+            dw  = Ops::madd(dw0,  dwStep,  pos);
+            vol = Ops::madd(vol0, volStep, pos);
+        }
+
+        V value = Ops::load(wet + k);
+
+        if (kDryWet)
+        {
+            const V d = Ops::load(dry + k);
+            value = Ops::madd(d, Ops::sub(value, d), dw);
+        }
+
+        Ops::store(out + k, Ops::mul(value, vol));
+    }
+
+    // unused depending on template arguments
+    (void)dry; (void)dwStep; (void)volStep; (void)iota; (void)rampStart;
+}
+
+template<bool kDryWet, bool kCross, bool kRamp>
+static inline
+void carla_postProcStereoT(const float* const wetL, const float* const wetR,
+                           const float* const dryL, const float* const dryR,
+                           float* const outL, float* const outR, const uint32_t frames,
+                           const CarlaPostProcGains& gains, const CarlaPostProcGains& steps,
+                           const uint32_t rampStart) noexcept
+{
+    const uint32_t vframes = frames - frames % CarlaPostProcVectorOps::kSize;
+
+    carla_postProcStereoRange<CarlaPostProcVectorOps, kDryWet, kCross, kRamp>(wetL, wetR, dryL, dryR, outL, outR,
+                                                                              0, vframes, gains, steps, rampStart);
+    carla_postProcStereoRange<CarlaPostProcScalarOps, kDryWet, kCross, kRamp>(wetL, wetR, dryL, dryR, outL, outR,
+                                                                              vframes, frames, gains, steps, rampStart);
+}
+
+template<bool kDryWet, bool kRamp>
+static inline
+void carla_postProcMonoT(const float* const wet, const float* const dry, float* const out, const uint32_t frames,
+                         const CarlaPostProcGains& gains, const CarlaPostProcGains& steps,
+                         const uint32_t rampStart) noexcept
+{
+    const uint32_t vframes = frames - frames % CarlaPostProcVectorOps::kSize;
+
+    carla_postProcMonoRange<CarlaPostProcVectorOps, kDryWet, kRamp>(wet, dry, out, 0, vframes,
+                                                                    gains, steps, rampStart);
+    carla_postProcMonoRange<CarlaPostProcScalarOps, kDryWet, kRamp>(wet, dry, out, vframes, frames,
+                                                                    gains, steps, rampStart);
+}
+
+// -----------------------------------------------------------------------
+// Post-processing kernels
+
+/*
+ * Apply dry/wet, balance, panning and volume to a stereo pair in a single pass.
+ *
+ * @a wet and @a out buffers may be the same, @a dry buffers are only read when @a dryL is not null.
+ * If @a steps is not null, gains change by that amount per frame, starting at frame @a rampStart.
+ */
+static inline
+void carla_postProcStereo(const float* const wetL, const float* const wetR,
+                          const float* const dryL, const float* const dryR,
+                          float* const outL, float* const outR, const uint32_t frames,
+                          const CarlaPostProcGains& gains, const CarlaPostProcGains* const steps = nullptr,
+                          const uint32_t rampStart = 0) noexcept
+{
+    const bool dryWet = dryL != nullptr && dryR != nullptr;
+    const bool cross  = gains.isCrossed() || (steps != nullptr && steps->isCrossed());
+
+    if (steps != nullptr)
+    {
+        if (dryWet)
+        {
+            if (cross) carla_postProcStereoT<true, true, true>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, *steps, rampStart);
+            else       carla_postProcStereoT<true, false, true>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, *steps, rampStart);
+        }
+        else
+        {
+            if (cross) carla_postProcStereoT<false, true, true>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, *steps, rampStart);
+            else       carla_postProcStereoT<false, false, true>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, *steps, rampStart);
+        }
+    }
+    else
+    {
+        if (dryWet)
+        {
+            if (cross) carla_postProcStereoT<true, true, false>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, gains, rampStart);
+            else       carla_postProcStereoT<true, false, false>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, gains, rampStart);
+        }
+        else
+        {
+            if (cross) carla_postProcStereoT<false, true, false>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, gains, rampStart);
+            else       carla_postProcStereoT<false, false, false>(wetL, wetR, dryL, dryR, outL, outR, frames, gains, gains, rampStart);
+        }
+    }
+}
+
+/*
+ * Apply dry/wet and volume to an unpaired channel in a single pass.
+ * Same rules as carla_postProcStereo().
+ */
+static inline
+void carla_postProcMono(const float* const wet, const float* const dry, float* const out, const uint32_t frames,
+                        const CarlaPostProcGains& gains, const CarlaPostProcGains* const steps = nullptr,
+                        const uint32_t rampStart = 0) noexcept
+{
+    if (steps != nullptr)
+    {
+        if (dry != nullptr)
+            carla_postProcMonoT<true, true>(wet, dry, out, frames, gains, *steps, rampStart);
+        else
+            carla_postProcMonoT<false, true>(wet, dry, out, frames, gains, *steps, rampStart);
+    }
+    else
+    {
+        if (dry != nullptr)
+            carla_postProcMonoT<true, false>(wet, dry, out, frames, gains, gains, rampStart);
+        else
+            carla_postProcMonoT<false, false>(wet, dry, out, frames, gains, gains, rampStart);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_POST_PROC_UTILS_HPP_INCLUDED
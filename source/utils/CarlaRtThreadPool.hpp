@@ -0,0 +1,561 @@
+/*
+ * Carla realtime thread pool
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_RT_THREAD_POOL_HPP_INCLUDED
+#define CARLA_RT_THREAD_POOL_HPP_INCLUDED
+
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+
+#include <atomic>
+#include <sched.h>
+
+// -----------------------------------------------------------------------
+// Maximum number of threads in a pool, including the one calling process()
+
+static const uint kMaxRtThreadPoolThreads = 32;
+
+// -----------------------------------------------------------------------
+// Directed acyclic graph of tasks, as run by CarlaRtThreadPool::process()
+
+struct CarlaRtTaskGraph {
+    // number of tasks in this graph
+    uint numTasks;
+
+    // for each task, number of other tasks that must finish before it can run
+    const uint* numDependencies;
+
+    // for each task, range [successorOffsets[i], successorOffsets[i+1]) within successors
+    const uint* successorOffsets;
+
+    // flattened list of tasks that depend on each task
+    const uint* successors;
+};
+
+// -----------------------------------------------------------------------
+// Interface for running a single task of a CarlaRtTaskGraph
+
+class CarlaRtTaskRunner
+{
+public:
+    virtual ~CarlaRtTaskRunner() {}
+
+    /*
+     * Run a single task.
+     * This is called from the realtime threads of the pool, must not block or allocate.
+     */
+    virtual void runTask(uint taskIndex) noexcept = 0;
+};
+
+// -----------------------------------------------------------------------
+// Statistics about how a single process() cycle was spread across threads
+
+struct CarlaRtThreadPoolStats {
+    // number of threads in the pool, including the caller one
+    uint numThreads;
+
+    // number of tasks that were run
+    uint numTasks;
+
+    // number of tasks taken from another thread's queue
+    uint numSteals;
+
+    // number of tasks run by each thread, the caller one is index 0
+    uint tasksPerThread[kMaxRtThreadPoolThreads];
+
+    // time spent running tasks on each thread, in microseconds
+    uint32_t busyTimePerThread[kMaxRtThreadPoolThreads];
+
+    // wall time of the whole cycle, in microseconds
+    uint32_t cycleTime;
+
+    // sum of busy times divided by (cycle time * numThreads), 1.0 means perfect spread
+    float efficiency;
+
+    CarlaRtThreadPoolStats() noexcept
+        : numThreads(0),
+          numTasks(0),
+          numSteals(0),
+          cycleTime(0),
+          efficiency(0.0f)
+    {
+        carla_zeroStructs(tasksPerThread, kMaxRtThreadPoolThreads);
+        carla_zeroStructs(busyTimePerThread, kMaxRtThreadPoolThreads);
+    }
+};
+
+// -----------------------------------------------------------------------
+// CarlaRtThreadPool class
+
+/*
+ * A pool of pre-spawned realtime threads that run a graph of tasks in parallel.
+ *
+ * The thread calling process() takes part in the work, so a pool of N threads spawns N-1 workers.
+ * Every thread owns a fixed-size work-stealing queue (Chase-Lev),
+ * tasks that become ready are pushed into the queue of the thread that finished their last dependency,
+ * idle threads steal from the others.
+ *
+ * All memory is allocated in start() and reserve(), process() never allocates.
+ */
+class CarlaRtThreadPool
+{
+public:
+    CarlaRtThreadPool(const char* const poolName) noexcept
+        : fName(poolName),
+          fMutex(),
+          fNumThreads(1),
+          fCapacity(0),
+          fPending(nullptr),
+          fRemaining(0),
+          fAccepting(false),
+          fActiveWorkers(0),
+          fGraph(nullptr),
+          fRunner(nullptr),
+          fStats()
+    {
+        for (uint i=0; i<kMaxRtThreadPoolThreads; ++i)
+            fQueues[i].init();
+
+        carla_zeroPointers(fWorkers, kMaxRtThreadPoolThreads);
+    }
+
+    ~CarlaRtThreadPool() noexcept
+    {
+        stop();
+    }
+
+    // -------------------------------------------------------------------
+    // non-RT calls
+
+    /*
+     * Start the pool with @a numThreads threads (including the caller of process()),
+     * able to run graphs of up to @a maxTasks tasks.
+     * A value of 0 or 1 threads is valid, but process() will then refuse to run.
+     */
+    bool start(const uint numThreads, const uint maxTasks)
+    {
+        CARLA_SAFE_ASSERT_RETURN(numThreads <= kMaxRtThreadPoolThreads, false);
+
+        stop();
+
+        if (numThreads <= 1)
+            return true;
+
+        const CarlaMutexLocker cml(fMutex);
+
+        fNumThreads = numThreads;
+
+        if (! _reserve(maxTasks))
+        {
+            fNumThreads = 1;
+            return false;
+        }
+
+        for (uint i=1; i<numThreads; ++i)
+        {
+            fWorkers[i] = new WorkerThread(this, i, fName);
+
+            if (! fWorkers[i]->startThread(true))
+            {
+                carla_stderr2("CarlaRtThreadPool::start(%u, %u) - failed to start worker thread %u",
+                              numThreads, maxTasks, i);
+                delete fWorkers[i];
+                fWorkers[i] = nullptr;
+                fNumThreads = i;
+                break;
+            }
+        }
+
+        return fNumThreads > 1;
+    }
+
+    /*
+     * Stop all worker threads and release memory.
+     */
+    void stop() noexcept
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        for (uint i=1; i<kMaxRtThreadPoolThreads; ++i)
+        {
+            if (fWorkers[i] == nullptr)
+                continue;
+
+            fWorkers[i]->signalThreadShouldExit();
+            fWorkers[i]->wake();
+            fWorkers[i]->stopThread(-1);
+            delete fWorkers[i];
+            fWorkers[i] = nullptr;
+        }
+
+        for (uint i=0; i<kMaxRtThreadPoolThreads; ++i)
+            fQueues[i].clear();
+
+        delete[] fPending;
+        fPending = nullptr;
+        fCapacity = 0;
+        fNumThreads = 1;
+    }
+
+    /*
+     * Make sure graphs of up to @a maxTasks tasks can be processed.
+     * Blocks while a process() call is in progress.
+     */
+    bool reserve(const uint maxTasks)
+    {
+        const CarlaMutexLocker cml(fMutex);
+        return _reserve(maxTasks);
+    }
+
+    /*
+     * Number of threads in the pool, including the caller one.
+     */
+    uint getNumThreads() const noexcept
+    {
+        return fNumThreads;
+    }
+
+    /*
+     * Get statistics of the last process() cycle.
+     * Values are copied without locking, so they might be slightly inconsistent.
+     */
+    void getStats(CarlaRtThreadPoolStats& stats) const noexcept
+    {
+        std::memcpy(&stats, &fStats, sizeof(CarlaRtThreadPoolStats));
+    }
+
+    // -------------------------------------------------------------------
+    // RT call
+
+    /*
+     * Run all tasks of @a graph, honoring their dependencies, and return once all of them have finished.
+     * Returns false without running anything if the pool is not able to do so right now,
+     * in which case the caller is expected to run the tasks serially by itself.
+     */
+    bool process(const CarlaRtTaskGraph& graph, CarlaRtTaskRunner& runner) noexcept
+    {
+        if (fNumThreads <= 1 || graph.numTasks == 0)
+            return false;
+
+        const CarlaMutexTryLocker cmtl(fMutex);
+
+        if (cmtl.wasNotLocked() || graph.numTasks > fCapacity)
+            return false;
+
+        const uint64_t startTime = carla_gettime_us();
+        const uint numThreads = fNumThreads;
+
+        for (uint i=0; i<numThreads; ++i)
+            fQueues[i].reset();
+
+        // initial dependency counts, spread the initial ready tasks across all threads
+        for (uint i=0, q=0; i<graph.numTasks; ++i)
+        {
+            fPending[i].store(graph.numDependencies[i], std::memory_order_relaxed);
+
+            if (graph.numDependencies[i] == 0)
+            {
+                fQueues[q].push(i);
+
+                if (++q == numThreads)
+                    q = 0;
+            }
+        }
+
+        fGraph  = &graph;
+        fRunner = &runner;
+        fRemaining.store(graph.numTasks);
+        fAccepting.store(true);
+
+        for (uint i=1; i<numThreads; ++i)
+            fWorkers[i]->wake();
+
+        _runTasks(0);
+
+        // wait for workers to leave this cycle
+        fAccepting.store(false);
+
+        while (fActiveWorkers.load() != 0)
+            sched_yield();
+
+        fGraph  = nullptr;
+        fRunner = nullptr;
+
+        // collect stats
+        const uint32_t cycleTime = static_cast<uint32_t>(carla_gettime_us() - startTime);
+        uint64_t totalBusyTime = 0;
+        uint numSteals = 0;
+
+        fStats.numThreads = numThreads;
+        fStats.numTasks   = graph.numTasks;
+        fStats.cycleTime  = cycleTime;
+
+        for (uint i=0; i<numThreads; ++i)
+        {
+            fStats.tasksPerThread[i]    = fQueues[i].numRun;
+            fStats.busyTimePerThread[i] = fQueues[i].busyTime;
+            totalBusyTime += fQueues[i].busyTime;
+            numSteals     += fQueues[i].numSteals;
+        }
+
+        fStats.numSteals  = numSteals;
+        fStats.efficiency = cycleTime != 0
+                          ? static_cast<float>(totalBusyTime) / static_cast<float>(cycleTime * numThreads)
+                          : 1.0f;
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    // fixed-size work-stealing queue, indexes only grow during a cycle so there is no wrap-around
+    struct TaskQueue {
+        std::atomic<int> top;
+        std::atomic<int> bottom;
+        uint* tasks;
+
+        // written only by the owner thread, read by the caller after a cycle
+        uint numRun;
+        uint numSteals;
+        uint32_t busyTime;
+
+        void init() noexcept
+        {
+            top.store(0);
+            bottom.store(0);
+            tasks = nullptr;
+            numRun = numSteals = 0;
+            busyTime = 0;
+        }
+
+        void clear() noexcept
+        {
+            delete[] tasks;
+            tasks = nullptr;
+        }
+
+        void reset() noexcept
+        {
+            top.store(0, std::memory_order_relaxed);
+            bottom.store(0, std::memory_order_relaxed);
+            numRun = numSteals = 0;
+            busyTime = 0;
+        }
+
+        // owner only
+        void push(const uint task) noexcept
+        {
+            const int b = bottom.load(std::memory_order_relaxed);
+            tasks[b] = task;
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // owner only
+        bool pop(uint& task) noexcept
+        {
+            const int b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            task = tasks[b];
+
+            if (t != b)
+                return true;
+
+            // last item, race against thieves
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        // any thread
+        bool steal(uint& task) noexcept
+        {
+            int t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return false;
+
+            task = tasks[t];
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst);
+        }
+    };
+
+    class WorkerThread : public CarlaThread
+    {
+    public:
+        WorkerThread(CarlaRtThreadPool* const pool, const uint index, const char* const name) noexcept
+            : CarlaThread(name),
+              kPool(pool),
+              kIndex(index),
+              fPosted(false)
+        {
+            carla_sem_create2(fSem, false);
+        }
+
+        ~WorkerThread() override
+        {
+            carla_sem_destroy2(fSem);
+        }
+
+        void wake() noexcept
+        {
+            if (! fPosted.exchange(true))
+                carla_sem_post(fSem);
+        }
+
+    protected:
+        void run() override
+        {
+            while (! shouldThreadExit())
+            {
+                if (! carla_sem_timedwait(fSem, 100))
+                    continue;
+
+                fPosted.store(false);
+                kPool->_workerCycle(kIndex);
+            }
+        }
+
+    private:
+        CarlaRtThreadPool* const kPool;
+        const uint kIndex;
+        carla_sem_t fSem;
+        std::atomic<bool> fPosted;
+
+        CARLA_DECLARE_NON_COPYABLE(WorkerThread)
+    };
+
+    // -------------------------------------------------------------------
+
+    bool _reserve(const uint maxTasks)
+    {
+        if (maxTasks <= fCapacity)
+            return true;
+
+        std::atomic<uint>* const pending = new std::atomic<uint>[maxTasks];
+
+        for (uint i=0; i<fNumThreads; ++i)
+        {
+            delete[] fQueues[i].tasks;
+            fQueues[i].tasks = new uint[maxTasks];
+        }
+
+        delete[] fPending;
+        fPending = pending;
+        fCapacity = maxTasks;
+        return true;
+    }
+
+    void _workerCycle(const uint index) noexcept
+    {
+        ++fActiveWorkers;
+
+        if (fAccepting.load())
+            _runTasks(index);
+
+        --fActiveWorkers;
+    }
+
+    void _runTasks(const uint index) noexcept
+    {
+        const CarlaRtTaskGraph& graph(*fGraph);
+        CarlaRtTaskRunner& runner(*fRunner);
+        TaskQueue& queue(fQueues[index]);
+        const uint numThreads = fNumThreads;
+        uint task;
+
+        for (;;)
+        {
+            if (! queue.pop(task))
+            {
+                bool stolen = false;
+
+                for (uint i=1; i<numThreads; ++i)
+                {
+                    if (fQueues[(index + i) % numThreads].steal(task))
+                    {
+                        stolen = true;
+                        ++queue.numSteals;
+                        break;
+                    }
+                }
+
+                if (! stolen)
+                {
+                    if (fRemaining.load() == 0)
+                        return;
+
+                    sched_yield();
+                    continue;
+                }
+            }
+
+            const uint64_t taskStartTime = carla_gettime_us();
+
+            runner.runTask(task);
+
+            queue.busyTime += static_cast<uint32_t>(carla_gettime_us() - taskStartTime);
+            ++queue.numRun;
+
+            for (uint i=graph.successorOffsets[task], end=graph.successorOffsets[task+1]; i<end; ++i)
+            {
+                const uint successor = graph.successors[i];
+
+                if (fPending[successor].fetch_sub(1) == 1)
+                    queue.push(successor);
+            }
+
+            --fRemaining;
+        }
+    }
+
+    // -------------------------------------------------------------------
+
+    const CarlaString fName;
+    CarlaMutex fMutex;
+    uint fNumThreads;
+    uint fCapacity;
+
+    TaskQueue fQueues[kMaxRtThreadPoolThreads];
+    WorkerThread* fWorkers[kMaxRtThreadPoolThreads];
+
+    std::atomic<uint>* fPending;
+    std::atomic<uint> fRemaining;
+    std::atomic<bool> fAccepting;
+    std::atomic<uint> fActiveWorkers;
+
+    const CarlaRtTaskGraph* fGraph;
+    CarlaRtTaskRunner* fRunner;
+
+    CarlaRtThreadPoolStats fStats;
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaRtThreadPool)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_RT_THREAD_POOL_HPP_INCLUDED
@@ -194,12 +194,11 @@ void carla_sem_post(carla_sem_t& sem, const bool server = true) noexcept
 #ifndef CARLA_OS_WASM
 /*
  * Wait for a semaphore (lock).
+ * A timeout of 0 only checks if the semaphore is available, without waiting.
  */
 static inline
 bool carla_sem_timedwait(carla_sem_t& sem, const uint msecs, const bool server = true) noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(msecs > 0, false);
-
 #if defined(CARLA_OS_WIN)
     return (::WaitForSingleObject(sem.handle, msecs) == WAIT_OBJECT_0);
 #else
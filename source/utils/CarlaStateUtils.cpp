@@ -201,12 +201,14 @@ CarlaStateSave::CarlaStateSave() noexcept
       balanceRight(1.0f),
       panning(0.0f),
       ctrlChannel(-1),
+      rackLane(0),
      #endif
       currentProgramIndex(-1),
       currentProgramName(nullptr),
       currentMidiBank(-1),
       currentMidiProgram(-1),
       chunk(nullptr),
+      chunkFile(nullptr),
       parameters(),
       customData() {}
 
@@ -247,6 +249,11 @@ void CarlaStateSave::clear() noexcept
         delete[] chunk;
         chunk = nullptr;
     }
+    if (chunkFile != nullptr)
+    {
+        delete[] chunkFile;
+        chunkFile = nullptr;
+    }
 
     uniqueId = 0;
     options  = PLUGIN_OPTIONS_NULL;
@@ -259,6 +266,7 @@ void CarlaStateSave::clear() noexcept
     balanceRight = 1.0f;
     panning      = 0.0f;
     ctrlChannel  = -1;
+    rackLane     = 0;
    #endif
 
     currentProgramIndex = -1;
@@ -370,6 +378,12 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
                             ctrlChannel = static_cast<int8_t>(value-1);
                     }
                 }
+                else if (tag == "RackLane")
+                {
+                    const int value(text.getIntValue());
+                    if (value >= 0 && value < static_cast<int>(MAX_PROCESS_THREADS))
+                        rackLane = static_cast<uint>(value);
+                }
                #endif
 
                 // -------------------------------------------------------
@@ -545,6 +559,10 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
                 {
                     chunk = carla_strdup(text.toRawUTF8());
                 }
+                else if (tag == "ChunkFile")
+                {
+                    chunkFile = carla_strdup(text.toRawUTF8());
+                }
             }
         }
     }
@@ -647,6 +665,9 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         else
             dataXml << "   <ControlChannel>" << int(ctrlChannel+1) << "</ControlChannel>\n";
 
+        if (rackLane != 0)
+            dataXml << "   <RackLane>" << String(rackLane) << "</RackLane>\n";
+
         dataXml << "   <Options>0x" << String::toHexString(static_cast<int>(options)) << "</Options>\n";
 
         content << dataXml;
@@ -768,6 +789,9 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         content << chunkXml;
     }
 
+    if (chunkFile != nullptr && chunkFile[0] != '\0')
+        content << "\n   <ChunkFile>" << xmlSafeString(chunkFile, true) << "</ChunkFile>\n";
+
     content << "  </Data>\n";
 }
 
@@ -84,6 +84,7 @@ struct CarlaStateSave {
     float  balanceRight;
     float  panning;
     int8_t ctrlChannel;
+    uint   rackLane;
    #endif
 
     int32_t     currentProgramIndex;
@@ -91,6 +92,7 @@ struct CarlaStateSave {
     int32_t     currentMidiBank;
     int32_t     currentMidiProgram;
     const char* chunk;
+    const char* chunkFile; // raw chunk file next to the project, used instead of chunk
 
     ParameterList parameters;
     CustomDataList customData;
@@ -27,6 +27,11 @@
 # error Threads do not work under wasm!
 #endif
 
+// -----------------------------------------------------------------------
+// Scheduling priority of realtime threads, also given to threads created by plugin libraries
+
+static const int kCarlaThreadRealtimePriority = 80;
+
 // -----------------------------------------------------------------------
 // CarlaThread class
 
@@ -106,7 +111,7 @@ public:
 
         if (withRealtimePriority)
         {
-            sched_param.sched_priority = 80;
+            sched_param.sched_priority = kCarlaThreadRealtimePriority;
 
            #ifndef CARLA_OS_HAIKU
             if (pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM)          == 0  &&
@@ -0,0 +1,423 @@
+/*
+ * Carla non-realtime worker thread pool
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_WORKER_POOL_HPP_INCLUDED
+#define CARLA_WORKER_POOL_HPP_INCLUDED
+
+#include "CarlaMutex.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+#include "CarlaTimeUtils.hpp"
+#include "LinkedList.hpp"
+
+#include <atomic>
+
+// -----------------------------------------------------------------------
+// Maximum number of threads in a worker pool
+
+static const uint kMaxWorkerPoolThreads = 16;
+
+// -----------------------------------------------------------------------
+// CarlaWorkerClient class
+
+/*
+ * Something that has non-realtime work scheduled from the audio thread, typically a plugin.
+ *
+ * The work of a single client is never run by more than one thread at the same time,
+ * work of different clients runs in parallel.
+ */
+class CarlaWorkerClient
+{
+public:
+    CarlaWorkerClient() noexcept
+        : fPending(false),
+          fBusy(false),
+          fScheduleTime(0),
+          fQueueDepth(0),
+          fMaxQueueDepth(0),
+          fNumJobs(0),
+          fLastLatency(0),
+          fMaxLatency(0),
+          fLastWorkTime(0) {}
+
+    virtual ~CarlaWorkerClient() {}
+
+    /*
+     * Note that @a numJobs more jobs were queued, to be reported as queue depth.
+     * RT safe, to be called before waking the pool.
+     */
+    void addQueuedJobs(const uint32_t numJobs) noexcept
+    {
+        const uint32_t depth = fQueueDepth.fetch_add(numJobs) + numJobs;
+
+        if (depth > fMaxQueueDepth.load(std::memory_order_relaxed))
+            fMaxQueueDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    /*
+     * Note that @a numJobs queued jobs have been run, to be called from runWork().
+     */
+    void removeQueuedJobs(const uint32_t numJobs) noexcept
+    {
+        fQueueDepth.fetch_sub(numJobs);
+        fNumJobs.fetch_add(numJobs, std::memory_order_relaxed);
+    }
+
+    // jobs queued but not run yet
+    uint32_t getQueueDepth() const noexcept { return fQueueDepth.load(std::memory_order_relaxed); }
+
+    // highest queue depth seen so far
+    uint32_t getMaxQueueDepth() const noexcept { return fMaxQueueDepth.load(std::memory_order_relaxed); }
+
+    // number of jobs run so far
+    uint64_t getNumJobs() const noexcept { return fNumJobs.load(std::memory_order_relaxed); }
+
+    // time between the last wake up request and a worker thread picking it up, in microseconds
+    uint32_t getLastLatency() const noexcept { return fLastLatency.load(std::memory_order_relaxed); }
+
+    // highest latency seen so far, in microseconds
+    uint32_t getMaxLatency() const noexcept { return fMaxLatency.load(std::memory_order_relaxed); }
+
+    // time spent in the last runWork() call, in microseconds
+    uint32_t getLastWorkTime() const noexcept { return fLastWorkTime.load(std::memory_order_relaxed); }
+
+protected:
+    /*
+     * Run all pending work of this client.
+     * Called from one of the pool threads, or from the idle thread if the pool has no threads.
+     */
+    virtual void runWork() = 0;
+
+private:
+    // set by the audio thread when there is new work, cleared right before running it
+    std::atomic<bool> fPending;
+
+    // set while a thread is running the work of this client
+    std::atomic<bool> fBusy;
+
+    // when fPending was last set
+    std::atomic<uint64_t> fScheduleTime;
+
+    std::atomic<uint32_t> fQueueDepth;
+    std::atomic<uint32_t> fMaxQueueDepth;
+    std::atomic<uint64_t> fNumJobs;
+    std::atomic<uint32_t> fLastLatency;
+    std::atomic<uint32_t> fMaxLatency;
+    std::atomic<uint32_t> fLastWorkTime;
+
+    friend class CarlaWorkerPool;
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaWorkerClient)
+};
+
+// -----------------------------------------------------------------------
+// CarlaWorkerPool class
+
+/*
+ * A pool of non-realtime threads that run the work of registered clients.
+ *
+ * The audio thread calls schedule() on new work, which only sets a flag and posts a semaphore.
+ * Idle pool threads wake up, claim the pending clients one by one and run their work.
+ *
+ * A pool with no threads is valid, clients must then be run through runNow().
+ */
+class CarlaWorkerPool
+{
+public:
+    CarlaWorkerPool(const char* const poolName) noexcept
+        : fName(poolName),
+          fMutex(),
+          fClients(),
+          fPosted(false),
+          fNumThreads(0)
+    {
+        carla_sem_create2(fSem, false);
+        carla_zeroPointers(fThreads, kMaxWorkerPoolThreads);
+    }
+
+    ~CarlaWorkerPool() noexcept
+    {
+        stop();
+        carla_sem_destroy2(fSem);
+    }
+
+    // -------------------------------------------------------------------
+    // non-RT calls
+
+    /*
+     * Start the pool with @a numThreads threads.
+     */
+    bool start(const uint numThreads)
+    {
+        CARLA_SAFE_ASSERT_RETURN(numThreads <= kMaxWorkerPoolThreads, false);
+
+        stop();
+
+        for (uint i=0; i<numThreads; ++i)
+        {
+            fThreads[i] = new WorkerThread(this, fName);
+
+            if (! fThreads[i]->startThread())
+            {
+                carla_stderr2("CarlaWorkerPool::start(%u) - failed to start thread %u", numThreads, i);
+                delete fThreads[i];
+                fThreads[i] = nullptr;
+                break;
+            }
+
+            fNumThreads = i + 1;
+        }
+
+        return fNumThreads == numThreads;
+    }
+
+    /*
+     * Stop all threads, waiting for running work to finish.
+     * Clients stay registered.
+     */
+    void stop() noexcept
+    {
+        for (uint i=0; i<kMaxWorkerPoolThreads; ++i)
+        {
+            if (fThreads[i] != nullptr)
+                fThreads[i]->signalThreadShouldExit();
+        }
+
+        for (uint i=0; i<kMaxWorkerPoolThreads; ++i)
+        {
+            if (fThreads[i] == nullptr)
+                continue;
+
+            fThreads[i]->stopThread(-1);
+            delete fThreads[i];
+            fThreads[i] = nullptr;
+        }
+
+        fNumThreads = 0;
+    }
+
+    /*
+     * Number of threads in the pool.
+     */
+    uint getNumThreads() const noexcept
+    {
+        return fNumThreads;
+    }
+
+    /*
+     * Register a client, so that the pool threads pick up its work.
+     */
+    void addClient(CarlaWorkerClient* const client) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        const CarlaMutexLocker cml(fMutex);
+
+        for (LinkedList<CarlaWorkerClient*>::Itenerator it = fClients.begin2(); it.valid(); it.next())
+        {
+            if (it.getValue(nullptr) == client)
+                return;
+        }
+
+        fClients.append(client);
+    }
+
+    /*
+     * Unregister a client, waiting for its running work to finish.
+     * Pending work that has not started yet is not run.
+     */
+    void removeClient(CarlaWorkerClient* const client) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        {
+            const CarlaMutexLocker cml(fMutex);
+            fClients.removeOne(client);
+        }
+
+        while (client->fBusy.load())
+            carla_msleep(1);
+    }
+
+    /*
+     * Run the pending work of a client in the calling thread.
+     * Used when the pool has no threads or for offline rendering.
+     */
+    static void runNow(CarlaWorkerClient* const client)
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        if (client->fBusy.exchange(true))
+            return;
+
+        client->fPending.store(false);
+        _runClient(client);
+        client->fBusy.store(false);
+    }
+
+    // -------------------------------------------------------------------
+    // RT call
+
+    /*
+     * Mark a client as having new work and wake up a pool thread.
+     * Never blocks or allocates, can be called from several audio threads at once.
+     */
+    void schedule(CarlaWorkerClient* const client) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        if (client->fPending.exchange(true))
+            return;
+
+        client->fScheduleTime.store(carla_gettime_us(), std::memory_order_relaxed);
+        _wake();
+    }
+
+private:
+    const char* const fName;
+
+    // protects the client list
+    CarlaMutex fMutex;
+    LinkedList<CarlaWorkerClient*> fClients;
+
+    // posted when there is pending work, fPosted avoids posting it twice
+    carla_sem_t fSem;
+    std::atomic<bool> fPosted;
+
+    class WorkerThread;
+    WorkerThread* fThreads[kMaxWorkerPoolThreads];
+    uint fNumThreads;
+
+    // -------------------------------------------------------------------
+
+    class WorkerThread : public CarlaThread
+    {
+    public:
+        WorkerThread(CarlaWorkerPool* const pool, const char* const name) noexcept
+            : CarlaThread(name),
+              kPool(pool) {}
+
+    protected:
+        void run() override
+        {
+            while (! shouldThreadExit())
+            {
+                if (! carla_sem_timedwait(kPool->fSem, 100))
+                    continue;
+
+                kPool->fPosted.store(false);
+
+                bool morePending;
+
+                while (CarlaWorkerClient* const client = kPool->_claimPendingClient(morePending))
+                {
+                    // let another thread take care of the other clients
+                    if (morePending)
+                        kPool->_wake();
+
+                    const uint64_t latency = carla_gettime_us() - client->fScheduleTime.load(std::memory_order_relaxed);
+                    const uint32_t latency32 = latency < UINT32_MAX ? static_cast<uint32_t>(latency) : UINT32_MAX;
+
+                    client->fLastLatency.store(latency32, std::memory_order_relaxed);
+
+                    if (latency32 > client->fMaxLatency.load(std::memory_order_relaxed))
+                        client->fMaxLatency.store(latency32, std::memory_order_relaxed);
+
+                    _runClient(client);
+                    client->fBusy.store(false);
+                }
+            }
+        }
+
+    private:
+        CarlaWorkerPool* const kPool;
+
+        CARLA_DECLARE_NON_COPYABLE(WorkerThread)
+    };
+
+    // -------------------------------------------------------------------
+
+    void _wake() noexcept
+    {
+        if (! fPosted.exchange(true))
+            carla_sem_post(fSem);
+    }
+
+    // find the first client with pending work that no other thread is running, and mark it busy
+    CarlaWorkerClient* _claimPendingClient(bool& morePending) noexcept
+    {
+        CarlaWorkerClient* claimed = nullptr;
+        morePending = false;
+
+        const CarlaMutexLocker cml(fMutex);
+
+        for (LinkedList<CarlaWorkerClient*>::Itenerator it = fClients.begin2(); it.valid(); it.next())
+        {
+            CarlaWorkerClient* const client = it.getValue(nullptr);
+            CARLA_SAFE_ASSERT_CONTINUE(client != nullptr);
+
+            if (! client->fPending.load())
+                continue;
+
+            if (claimed != nullptr)
+            {
+                morePending = true;
+                break;
+            }
+
+            if (client->fBusy.exchange(true))
+                continue;
+
+            // pending might have been cleared by runNow() meanwhile
+            if (! client->fPending.exchange(false))
+            {
+                client->fBusy.store(false);
+                continue;
+            }
+
+            claimed = client;
+        }
+
+        // move it to the back, so that busy clients do not starve the others
+        if (claimed != nullptr)
+        {
+            fClients.removeOne(claimed);
+            fClients.append(claimed);
+        }
+
+        return claimed;
+    }
+
+    static void _runClient(CarlaWorkerClient* const client)
+    {
+        const uint64_t startTime = carla_gettime_us();
+
+        try {
+            client->runWork();
+        } CARLA_SAFE_EXCEPTION("CarlaWorkerClient::runWork");
+
+        const uint64_t workTime = carla_gettime_us() - startTime;
+        client->fLastWorkTime.store(workTime < UINT32_MAX ? static_cast<uint32_t>(workTime) : UINT32_MAX,
+                                    std::memory_order_relaxed);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaWorkerPool)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_WORKER_POOL_HPP_INCLUDED
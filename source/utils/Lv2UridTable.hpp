@@ -0,0 +1,289 @@
+/*
+ * Carla LV2 URID table
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef LV2_URID_TABLE_HPP_INCLUDED
+#define LV2_URID_TABLE_HPP_INCLUDED
+
+#include "CarlaMutex.hpp"
+
+#include "lv2/urid.h"
+
+#include <atomic>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * Bridged UIs give the URIs they map themselves ids starting from here, so they never clash with host ids.
+ * The host keeps track of them and translates the URIDs of atoms going to and coming from the UI.
+ */
+static const LV2_URID kLv2UridBridgedUiOffset = 0x40000000U;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * An interned table of URIs, giving each a stable LV2_URID.
+ *
+ * URIs are found through an open-addressing hash table, ids are turned back into URIs through a paged array.
+ * Looking up URIs and ids that are already known is lock-free and safe to do from the realtime thread.
+ * Adding new URIs takes a lock and may allocate memory.
+ *
+ * Id 0 is reserved as the null URID, the first URI added gets id 1.
+ * Memory is only released on destruction, so returned strings remain valid for the whole lifetime of the table.
+ */
+class Lv2UridTable
+{
+public:
+    Lv2UridTable() noexcept
+        : fMutex(),
+          fCount(1),
+          fHashTable(nullptr),
+          fOldHashTables(nullptr)
+    {
+        carla_zeroPointers(fPages, kNumPages);
+
+        try {
+            fHashTable.store(new HashTable(kInitialHashSize), std::memory_order_release);
+        } CARLA_SAFE_EXCEPTION("Lv2UridTable hash table");
+    }
+
+    ~Lv2UridTable() noexcept
+    {
+        const uint32_t count = fCount.load(std::memory_order_acquire);
+
+        for (uint32_t i=1; i<count; ++i)
+            delete[] fPages[i >> kPageBits][i & kPageMask];
+
+        for (uint32_t i=0; i<kNumPages; ++i)
+            delete[] fPages[i];
+
+        delete fHashTable.load(std::memory_order_acquire);
+
+        for (HashTable* table = fOldHashTables; table != nullptr;)
+        {
+            HashTable* const next = table->next;
+            delete table;
+            table = next;
+        }
+    }
+
+    /*
+     * Find the id of an already mapped URI, returns 0 if it is not mapped yet.
+     * Lock-free and realtime safe.
+     */
+    LV2_URID find(const char* const uri) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr, 0);
+
+        const HashTable* const table = fHashTable.load(std::memory_order_acquire);
+        CARLA_SAFE_ASSERT_RETURN(table != nullptr, 0);
+
+        return _find(*table, uri, _hash(uri));
+    }
+
+    /*
+     * Get the id of a URI, adding it to the table if needed.
+     * Only takes the lock when the URI is new.
+     */
+    LV2_URID map(const char* const uri) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', 0);
+
+        if (const LV2_URID urid = find(uri))
+            return urid;
+
+        const CarlaMutexLocker cml(fMutex);
+
+        // check again, someone else might have just added it
+        if (const LV2_URID urid = find(uri))
+            return urid;
+
+        return _add(uri);
+    }
+
+    /*
+     * Add a URI with an id chosen somewhere else, used to mirror another table.
+     * The id must be the next one to be given, returns false otherwise.
+     */
+    bool mapWithId(const LV2_URID urid, const char* const uri) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', false);
+
+        const CarlaMutexLocker cml(fMutex);
+
+        if (urid != fCount.load(std::memory_order_relaxed))
+            return false;
+
+        return _add(uri) == urid;
+    }
+
+    /*
+     * Get the URI of an id, returns null if the id is unknown.
+     * Lock-free and realtime safe.
+     */
+    const char* unmap(const LV2_URID urid) const noexcept
+    {
+        if (urid == 0 || urid >= fCount.load(std::memory_order_acquire))
+            return nullptr;
+
+        return fPages[urid >> kPageBits][urid & kPageMask];
+    }
+
+    /*
+     * Get the next id to be given, which is also the number of ids including the null one.
+     */
+    uint32_t getCount() const noexcept
+    {
+        return fCount.load(std::memory_order_acquire);
+    }
+
+private:
+    static const uint32_t kPageBits = 10;
+    static const uint32_t kPageSize = 1U << kPageBits;
+    static const uint32_t kPageMask = kPageSize - 1U;
+    static const uint32_t kNumPages = 1024;
+    static const uint32_t kInitialHashSize = 512;
+
+    struct HashTable {
+        const uint32_t mask;
+        std::atomic<uint32_t>* const slots;
+        HashTable* next;
+
+        HashTable(const uint32_t size)
+            : mask(size - 1U),
+              slots(new std::atomic<uint32_t>[size]),
+              next(nullptr)
+        {
+            for (uint32_t i=0; i<size; ++i)
+                slots[i].store(0, std::memory_order_relaxed);
+        }
+
+        ~HashTable() noexcept
+        {
+            delete[] slots;
+        }
+
+        CARLA_DECLARE_NON_COPYABLE(HashTable)
+    };
+
+    // protects writers, readers never lock
+    CarlaMutex fMutex;
+
+    // next id to be given
+    std::atomic<uint32_t> fCount;
+
+    // id to URI, in pages so that growing never moves existing entries
+    const char** fPages[kNumPages];
+
+    // URI to id, replaced by a bigger one as it fills up
+    std::atomic<HashTable*> fHashTable;
+
+    // replaced hash tables, readers might still be using them
+    HashTable* fOldHashTables;
+
+    // FNV-1a
+    static uint32_t _hash(const char* uri) noexcept
+    {
+        uint32_t hash = 2166136261U;
+
+        for (; *uri != '\0'; ++uri)
+        {
+            hash ^= static_cast<uint8_t>(*uri);
+            hash *= 16777619U;
+        }
+
+        return hash;
+    }
+
+    LV2_URID _find(const HashTable& table, const char* const uri, const uint32_t hash) const noexcept
+    {
+        for (uint32_t i = hash & table.mask;; i = (i + 1U) & table.mask)
+        {
+            const uint32_t urid = table.slots[i].load(std::memory_order_acquire);
+
+            if (urid == 0)
+                return 0;
+
+            if (std::strcmp(fPages[urid >> kPageBits][urid & kPageMask], uri) == 0)
+                return urid;
+        }
+    }
+
+    static void _insert(HashTable& table, const uint32_t hash, const LV2_URID urid) noexcept
+    {
+        for (uint32_t i = hash & table.mask;; i = (i + 1U) & table.mask)
+        {
+            if (table.slots[i].load(std::memory_order_relaxed) != 0)
+                continue;
+
+            table.slots[i].store(urid, std::memory_order_release);
+            return;
+        }
+    }
+
+    // must be called with the lock held
+    LV2_URID _add(const char* const uri) noexcept
+    {
+        const uint32_t urid = fCount.load(std::memory_order_relaxed);
+        const uint32_t page = urid >> kPageBits;
+        CARLA_SAFE_ASSERT_RETURN(page < kNumPages, 0);
+
+        HashTable* table = fHashTable.load(std::memory_order_relaxed);
+        CARLA_SAFE_ASSERT_RETURN(table != nullptr, 0);
+
+        // keep the hash table at most half full
+        if ((urid + 1U) * 2U > table->mask + 1U)
+        {
+            HashTable* newTable;
+
+            try {
+                newTable = new HashTable((table->mask + 1U) * 2U);
+            } CARLA_SAFE_EXCEPTION_RETURN("Lv2UridTable::_add grow", 0);
+
+            for (uint32_t i=1; i<urid; ++i)
+                _insert(*newTable, _hash(fPages[i >> kPageBits][i & kPageMask]), i);
+
+            fHashTable.store(newTable, std::memory_order_release);
+
+            table->next = fOldHashTables;
+            fOldHashTables = table;
+            table = newTable;
+        }
+
+        if (fPages[page] == nullptr)
+        {
+            try {
+                fPages[page] = new const char*[kPageSize];
+            } CARLA_SAFE_EXCEPTION_RETURN("Lv2UridTable::_add page", 0);
+        }
+
+        const char* const uriCopy = carla_strdup_safe(uri);
+        CARLA_SAFE_ASSERT_RETURN(uriCopy != nullptr, 0);
+
+        // publish the string first, then the id, then make it findable
+        fPages[page][urid & kPageMask] = uriCopy;
+        fCount.store(urid + 1U, std::memory_order_release);
+        _insert(*table, _hash(uriCopy), urid);
+
+        return urid;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(Lv2UridTable)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // LV2_URID_TABLE_HPP_INCLUDED